@@ -0,0 +1,327 @@
+#include "bench.h"
+#include "raylib.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <direct.h>
+    #include <process.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define rmdir _rmdir
+    #define getpid _getpid
+#else
+    #include <dirent.h>
+    #include <unistd.h>
+#endif
+
+#define BENCH_VERSION 1
+
+//----------------------------------------------------------------------------------
+// Time and random numbers
+//----------------------------------------------------------------------------------
+
+double BenchNow(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+// xorshift32; the state must not be zero
+uint32_t BenchRandom(uint32_t* state) {
+    uint32_t x = *state ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+float BenchRandomFloat(uint32_t* state, float min, float max) {
+    return min + (max - min) * (float)(BenchRandom(state) >> 8) / (float)(1u << 24);
+}
+
+int BenchScaled(const BenchContext* ctx, int count) {
+    double scaled = (double)count * ctx->scale;
+    if (scaled < 1.0) return 1;
+    if (scaled > 1e9) return 1000000000;
+    return (int)scaled;
+}
+
+//----------------------------------------------------------------------------------
+// Files
+//----------------------------------------------------------------------------------
+
+bool BenchPath(const BenchContext* ctx, char* path, int size, const char* name) {
+    int length = snprintf(path, (size_t)size, "%s/%s", ctx->tempDir, name);
+    return length > 0 && length < size;
+}
+
+bool BenchWriteFile(const char* path, const void* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = size == 0 || fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
+
+void BenchRemoveTree(const char* path) {
+    char child[1024];
+#if defined(_WIN32)
+    char pattern[1024];
+    snprintf(pattern, sizeof(pattern), "%s\\*", path);
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(pattern, &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) continue;
+            snprintf(child, sizeof(child), "%s/%s", path, data.cFileName);
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) BenchRemoveTree(child);
+            else remove(child);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* dir = opendir(path);
+    if (dir) {
+        struct dirent* ent;
+        while ((ent = readdir(dir)) != NULL) {
+            if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+            snprintf(child, sizeof(child), "%s/%s", path, ent->d_name);
+
+            // Symlinks are removed, never followed
+            struct stat st;
+            if (lstat(child, &st) == 0 && S_ISDIR(st.st_mode)) BenchRemoveTree(child);
+            else remove(child);
+        }
+        closedir(dir);
+    }
+#endif
+    rmdir(path);
+}
+
+bool BenchCreateDirectory(const BenchContext* ctx, const char* name, int fileCount, char* path, int size) {
+    static const char* words[] = {
+        "brick", "concrete", "metal", "wood", "glass", "tile", "plaster", "grass",
+        "wall", "floor", "ceiling", "door", "window", "crate", "barrel", "pipe",
+        "dirty", "clean", "rusty", "painted", "broken", "large", "small", "dark"
+    };
+    static const char* extensions[] = { ".vtf", ".vmt", ".wav", ".mdl", ".png" };
+    const int wordCount = (int)(sizeof(words) / sizeof(words[0]));
+
+    if (!BenchPath(ctx, path, size, name)) return false;
+    if (mkdir(path, 0700) != 0) return false;
+
+    uint32_t seed = 2024;
+    char file[1024];
+    for (int i = 0; i < fileCount; i++) {
+        const char* a = words[BenchRandom(&seed) % (uint32_t)wordCount];
+        const char* b = words[BenchRandom(&seed) % (uint32_t)wordCount];
+        const char* extension = extensions[BenchRandom(&seed) % 5];
+        snprintf(file, sizeof(file), "%s/%s_%s_%05d%s", path, a, b, i, extension);
+        if (!BenchWriteFile(file, NULL, 0)) return false;
+    }
+    return true;
+}
+
+static bool CreateTempDir(BenchContext* ctx) {
+    const char* base = getenv("TMPDIR");
+#if defined(_WIN32)
+    char tempPath[MAX_PATH];
+    if (!base && GetTempPathA(sizeof(tempPath), tempPath) > 0) base = tempPath;
+#endif
+    if (!base || !base[0]) base = "/tmp";
+
+    for (int attempt = 0; attempt < 100; attempt++) {
+        snprintf(ctx->tempDir, sizeof(ctx->tempDir), "%s/gearbox_bench_%d_%d", base, (int)getpid(), attempt);
+        if (mkdir(ctx->tempDir, 0700) == 0) return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Cases
+//----------------------------------------------------------------------------------
+
+bool BeginBenchCase(BenchContext* ctx, BenchCase* bench, const char* name, int64_t items) {
+    memset(bench, 0, sizeof(*bench));
+    if (ctx->filter && !strstr(name, ctx->filter)) return false;
+
+    snprintf(bench->name, sizeof(bench->name), "%s", name);
+    bench->items = items;
+    bench->warmup = BENCH_WARMUP_SAMPLES;
+    bench->iterations = ctx->iterations;
+    bench->samples = malloc((size_t)bench->iterations * sizeof(double));
+    if (!bench->samples) {
+        TraceLog(LOG_WARNING, "BENCH: Out of memory for %s", name);
+        return false;
+    }
+    fprintf(stderr, "%-40s", name);
+    fflush(stderr);
+    return true;
+}
+
+bool NextBenchSample(BenchCase* bench) {
+    return bench->sample < bench->warmup + bench->iterations;
+}
+
+void BenchStart(BenchCase* bench) {
+    bench->started = BenchNow();
+}
+
+void BenchStop(BenchCase* bench) {
+    double elapsed = BenchNow() - bench->started;
+    if (bench->sample++ >= bench->warmup) bench->samples[bench->sampleCount++] = elapsed;
+}
+
+void SetBenchCounter(BenchCase* bench, const char* name, double value) {
+    for (int i = 0; i < bench->counterCount; i++) {
+        if (strcmp(bench->counters[i].name, name) == 0) { bench->counters[i].value = value; return; }
+    }
+    if (bench->counterCount == BENCH_MAX_COUNTERS) return;
+    bench->counters[bench->counterCount].name = name;
+    bench->counters[bench->counterCount].value = value;
+    bench->counterCount++;
+}
+
+void SetBenchBytes(BenchCase* bench, int64_t bytes) {
+    bench->bytes = bytes;
+}
+
+static int CompareSamples(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Linear interpolation between the closest ranks of sorted samples
+static double Percentile(const double* sorted, int count, double p) {
+    if (count == 1) return sorted[0];
+    double rank = p * (double)(count - 1);
+    int below = (int)rank;
+    if (below >= count - 1) return sorted[count - 1];
+    return sorted[below] + (sorted[below + 1] - sorted[below]) * (rank - (double)below);
+}
+
+void EndBenchCase(BenchContext* ctx, BenchCase* bench) {
+    int count = bench->sampleCount;
+    if (count == 0) {
+        fprintf(stderr, " no samples\n");
+        free(bench->samples);
+        return;
+    }
+
+    qsort(bench->samples, (size_t)count, sizeof(double), CompareSamples);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += bench->samples[i];
+    double mean = sum / count;
+    double variance = 0.0;
+    for (int i = 0; i < count; i++) variance += (bench->samples[i] - mean) * (bench->samples[i] - mean);
+    double stddev = count > 1 ? sqrt(variance / (count - 1)) : 0.0;
+    double p50 = Percentile(bench->samples, count, 0.50);
+
+    // Times in milliseconds, throughput from the median
+    FILE* out = ctx->output;
+    fprintf(out, "%s\n    {\n", ctx->caseCount > 0 ? "," : "");
+    fprintf(out, "      \"name\": \"%s\",\n", bench->name);
+    fprintf(out, "      \"samples\": %d,\n", count);
+    fprintf(out, "      \"items\": %lld,\n", (long long)bench->items);
+    fprintf(out, "      \"ms\": { \"min\": %.6f, \"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"max\": %.6f, \"mean\": %.6f, \"stddev\": %.6f },\n",
+            bench->samples[0] * 1e3, p50 * 1e3, Percentile(bench->samples, count, 0.90) * 1e3,
+            Percentile(bench->samples, count, 0.99) * 1e3, bench->samples[count - 1] * 1e3, mean * 1e3, stddev * 1e3);
+    fprintf(out, "      \"itemsPerSecond\": %.1f", p50 > 0.0 ? (double)bench->items / p50 : 0.0);
+    if (bench->bytes > 0) fprintf(out, ",\n      \"mbPerSecond\": %.1f", p50 > 0.0 ? (double)bench->bytes / p50 / 1e6 : 0.0);
+    if (bench->counterCount > 0) {
+        fprintf(out, ",\n      \"counters\": {");
+        for (int i = 0; i < bench->counterCount; i++) {
+            fprintf(out, "%s \"%s\": %.6g", i > 0 ? "," : "", bench->counters[i].name, bench->counters[i].value);
+        }
+        fprintf(out, " }");
+    }
+    fprintf(out, "\n    }");
+    fflush(out);
+    ctx->caseCount++;
+
+    fprintf(stderr, " p50 %10.4f ms   p99 %10.4f ms\n", p50 * 1e3, Percentile(bench->samples, count, 0.99) * 1e3);
+    free(bench->samples);
+    bench->samples = NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Entry point
+//----------------------------------------------------------------------------------
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --filter <text>     Run only cases whose name contains text\n"
+        "  --iterations <n>    Timed samples per case (default %d)\n"
+        "  --scale <factor>    Multiply every problem size (default 1.0)\n"
+        "  --output <file>     Write the JSON report to a file instead of stdout\n",
+        program, BENCH_DEFAULT_ITERATIONS);
+}
+
+int main(int argc, char** argv) {
+    BenchContext ctx = { 0 };
+    ctx.iterations = BENCH_DEFAULT_ITERATIONS;
+    ctx.scale = 1.0f;
+    const char* outputPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--filter") == 0 && hasValue) ctx.filter = argv[++i];
+        else if (strcmp(argv[i], "--iterations") == 0 && hasValue) ctx.iterations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0 && hasValue) ctx.scale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && hasValue) outputPath = argv[++i];
+        else {
+            PrintUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (ctx.iterations < 1 || !(ctx.scale > 0.0f)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Core code reports problems through TraceLog; only warnings matter here
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (!CreateTempDir(&ctx)) {
+        fprintf(stderr, "BENCH: Could not create a temporary directory\n");
+        return 1;
+    }
+    ctx.output = outputPath ? fopen(outputPath, "w") : stdout;
+    if (!ctx.output) {
+        fprintf(stderr, "BENCH: Could not open %s\n", outputPath);
+        BenchRemoveTree(ctx.tempDir);
+        return 1;
+    }
+
+    fprintf(ctx.output, "{\n  \"version\": %d,\n  \"timestamp\": %lld,\n  \"iterations\": %d,\n  \"scale\": %.3f,\n  \"cases\": [",
+            BENCH_VERSION, (long long)time(NULL), ctx.iterations, ctx.scale);
+
+    RunTimelineBenchmarks(&ctx);
+    RunProjectBenchmarks(&ctx);
+    RunDirScanBenchmarks(&ctx);
+    RunTextInputBenchmarks(&ctx);
+    RunUiLayoutBenchmarks(&ctx);
+    RunJobBenchmarks(&ctx);
+    RunAssetBenchmarks(&ctx);
+    RunVtfBenchmarks(&ctx);
+    RunVpkBenchmarks(&ctx);
+
+    fprintf(ctx.output, "\n  ]\n}\n");
+    if (ctx.output != stdout) fclose(ctx.output);
+
+    BenchRemoveTree(ctx.tempDir);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Headless benchmark harness.
+//
+// Every case runs a few warmup samples and then the requested number of
+// timed ones. A sample times only the code between BenchStart and
+// BenchStop, so per-sample setup and teardown stay out of the numbers.
+// Results go out as one JSON document with percentiles per case; progress
+// and warnings go to stderr so the JSON can be piped straight into a
+// comparison script.
+//
+// Nothing here opens a window. Suites stick to code that runs without one
+// and keep their files under the context's temporary directory.
+
+#define BENCH_DEFAULT_ITERATIONS 30
+#define BENCH_WARMUP_SAMPLES 2
+#define BENCH_MAX_COUNTERS 8
+
+typedef struct {
+    int iterations;             // Timed samples per case
+    float scale;                // Multiplies every suite's problem size
+    const char* filter;         // Only cases whose name contains this, NULL for all
+    char tempDir[512];          // Created for the run, removed afterwards
+    FILE* output;
+    int caseCount;              // Cases written so far
+} BenchContext;
+
+typedef struct {
+    char name[64];
+    int64_t items;              // Work items per sample, for throughput
+    int64_t bytes;              // Bytes per sample, reported as MB/s when set
+    int warmup;
+    int iterations;
+    int sample;                 // Samples started so far, warmup included
+    double* samples;            // Seconds
+    int sampleCount;
+    double started;
+    struct { const char* name; double value; } counters[BENCH_MAX_COUNTERS];
+    int counterCount;
+} BenchCase;
+
+// Time
+double BenchNow(void);
+
+// Cases. BeginBenchCase returns false for cases the filter skips:
+//
+//     BenchCase bench;
+//     if (BeginBenchCase(ctx, &bench, "timeline.insert", count)) {
+//         while (NextBenchSample(&bench)) {
+//             ... setup ...
+//             BenchStart(&bench);
+//             ... measured work ...
+//             BenchStop(&bench);
+//             ... teardown ...
+//         }
+//         EndBenchCase(ctx, &bench);
+//     }
+bool BeginBenchCase(BenchContext* ctx, BenchCase* bench, const char* name, int64_t items);
+bool NextBenchSample(BenchCase* bench);
+void BenchStart(BenchCase* bench);
+void BenchStop(BenchCase* bench);
+void SetBenchCounter(BenchCase* bench, const char* name, double value);    // Reported next to the timings
+void SetBenchBytes(BenchCase* bench, int64_t bytes);                       // Data processed per sample
+void EndBenchCase(BenchContext* ctx, BenchCase* bench);
+
+// Problem size scaled by --scale, never below one
+int BenchScaled(const BenchContext* ctx, int count);
+
+// Files under the temporary directory
+bool BenchPath(const BenchContext* ctx, char* path, int size, const char* name);
+bool BenchWriteFile(const char* path, const void* data, size_t size);
+void BenchRemoveTree(const char* path);
+bool BenchCreateDirectory(const BenchContext* ctx, const char* name, int fileCount, char* path, int size);   // Asset-like file names
+
+// Deterministic pseudo random numbers, so every run measures the same input
+uint32_t BenchRandom(uint32_t* state);
+float BenchRandomFloat(uint32_t* state, float min, float max);
+
+// Suites
+void RunTimelineBenchmarks(BenchContext* ctx);
+void RunProjectBenchmarks(BenchContext* ctx);
+void RunDirScanBenchmarks(BenchContext* ctx);
+void RunTextInputBenchmarks(BenchContext* ctx);
+void RunUiLayoutBenchmarks(BenchContext* ctx);
+void RunJobBenchmarks(BenchContext* ctx);
+void RunAssetBenchmarks(BenchContext* ctx);
+void RunVtfBenchmarks(BenchContext* ctx);
+void RunVpkBenchmarks(BenchContext* ctx);
+
+#endif // BENCH_H
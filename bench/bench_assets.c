@@ -0,0 +1,144 @@
+#include "bench.h"
+#include "asset_database.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Asset database: importing a fresh set of textures and the materials that
+// use them, refreshing when nothing changed, which should only stat, and
+// refreshing after one texture was edited, which reimports it and the one
+// material using it.
+
+#define ASSETS_BENCH_TEXTURES 400
+#define ASSETS_BENCH_TEXTURE_SIZE 64
+
+// Uncompressed 7.2 VTF with a single mip and no low-res image
+static bool WriteBenchTexture(const char* path, uint32_t seed) {
+    size_t pixels = (size_t)ASSETS_BENCH_TEXTURE_SIZE * ASSETS_BENCH_TEXTURE_SIZE * 4;
+    size_t size = 80 + pixels;
+    unsigned char* data = calloc(1, size);
+    if (!data) return false;
+
+    uint32_t header[] = { 0x00465456u, 7, 2, 80 };
+    memcpy(data, header, sizeof(header));
+    uint16_t width = ASSETS_BENCH_TEXTURE_SIZE, height = ASSETS_BENCH_TEXTURE_SIZE, frames = 1, depth = 1;
+    memcpy(data + 16, &width, 2);
+    memcpy(data + 18, &height, 2);
+    memcpy(data + 24, &frames, 2);
+    int32_t format = 0, lowResFormat = -1;
+    memcpy(data + 52, &format, 4);
+    data[56] = 1;
+    memcpy(data + 57, &lowResFormat, 4);
+    memcpy(data + 63, &depth, 2);
+    for (size_t i = 0; i < pixels; i++) data[80 + i] = (unsigned char)BenchRandom(&seed);
+
+    bool ok = BenchWriteFile(path, data, size);
+    free(data);
+    return ok;
+}
+
+// Textures in pairs, each pair used by one material
+static bool CreateBenchAssets(const BenchContext* ctx, int textures) {
+    char path[1024], text[256];
+    for (int i = 0; i < textures; i++) {
+        snprintf(text, sizeof(text), "asset_texture_%05d.vtf", i);
+        if (!BenchPath(ctx, path, sizeof(path), text) || !WriteBenchTexture(path, (uint32_t)i + 1)) return false;
+    }
+    for (int i = 0; i < textures / 2; i++) {
+        snprintf(text, sizeof(text), "asset_material_%05d.vmt", i);
+        if (!BenchPath(ctx, path, sizeof(path), text)) return false;
+        int length = snprintf(text, sizeof(text), "\"VertexLitGeneric\"\n{\n\t\"$basetexture\" \"asset_texture_%05d\"\n"
+                              "\t\"$bumpmap\" \"asset_texture_%05d\"\n}\n", i * 2, i * 2 + 1);
+        if (!BenchWriteFile(path, text, (size_t)length)) return false;
+    }
+    return true;
+}
+
+static void AddBenchAssets(const BenchContext* ctx, AssetDatabase* db, int textures) {
+    char path[1024], name[64];
+    for (int i = 0; i < textures / 2; i++) {
+        snprintf(name, sizeof(name), "asset_material_%05d.vmt", i);
+        if (BenchPath(ctx, path, sizeof(path), name)) AddAsset(db, path);
+    }
+}
+
+static void SetAssetCounters(BenchCase* bench, const AssetDatabase* db) {
+    AssetDatabaseStats stats = GetAssetDatabaseStats(db);
+    SetBenchCounter(bench, "assets", stats.assets);
+    SetBenchCounter(bench, "hashed", stats.hashed);
+    SetBenchCounter(bench, "scheduled", stats.scheduled);
+    SetBenchCounter(bench, "failed", stats.failed);
+}
+
+void RunAssetBenchmarks(BenchContext* ctx) {
+    int textures = BenchScaled(ctx, ASSETS_BENCH_TEXTURES) & ~1;
+    if (textures < 2) textures = 2;
+    char directory[1024];
+    if (!BenchPath(ctx, directory, sizeof(directory), "asset_database")) return;
+
+    JobSystem* jobs = NULL;
+    AssetDatabase* db = NULL;
+    bool created = false;
+    BenchCase bench;
+
+    if (BeginBenchCase(ctx, &bench, "assets.import", textures + textures / 2)) {
+        created = created || CreateBenchAssets(ctx, textures);
+        if (!jobs) jobs = CreateJobSystem(0);
+        while (created && NextBenchSample(&bench)) {
+            BenchRemoveTree(directory);
+            db = CreateAssetDatabase(directory, jobs);
+            if (!db) break;
+            AddBenchAssets(ctx, db, textures);
+            BenchStart(&bench);
+            RefreshAssets(db);
+            WaitForAssetImports(db);
+            BenchStop(&bench);
+            SetAssetCounters(&bench, db);
+            DestroyAssetDatabase(db);
+            db = NULL;
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    // The rest share one imported database
+    if (BeginBenchCase(ctx, &bench, "assets.refresh_unchanged", textures + textures / 2)) {
+        created = created || CreateBenchAssets(ctx, textures);
+        if (!jobs) jobs = CreateJobSystem(0);
+        if (created && !db && (db = CreateAssetDatabase(directory, jobs))) {
+            AddBenchAssets(ctx, db, textures);
+            RefreshAssets(db);
+            WaitForAssetImports(db);
+        }
+        while (db && NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            RefreshAssets(db);
+            BenchStop(&bench);
+        }
+        if (db) SetAssetCounters(&bench, db);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "assets.reimport_edited", 1)) {
+        created = created || CreateBenchAssets(ctx, textures);
+        if (!jobs) jobs = CreateJobSystem(0);
+        if (created && !db && (db = CreateAssetDatabase(directory, jobs))) {
+            AddBenchAssets(ctx, db, textures);
+            RefreshAssets(db);
+            WaitForAssetImports(db);
+        }
+        char path[1024];
+        bool edited = BenchPath(ctx, path, sizeof(path), "asset_texture_00000.vtf");
+        while (db && edited && NextBenchSample(&bench)) {
+            // New content every sample, same size
+            edited = WriteBenchTexture(path, 0x9e3779b9u + (uint32_t)bench.sample);
+            BenchStart(&bench);
+            RefreshAssets(db);
+            WaitForAssetImports(db);
+            BenchStop(&bench);
+        }
+        if (db) SetAssetCounters(&bench, db);
+        EndBenchCase(ctx, &bench);
+    }
+
+    DestroyAssetDatabase(db);
+    DestroyJobSystem(jobs);
+}
@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "dir_scanner.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #define YieldThread() Sleep(0)
+#else
+    #include <sched.h>
+    #define YieldThread() sched_yield()
+#endif
+
+// Directory scanning: a cold scan on a fresh scanner, how soon the first
+// screenful of entries shows up, and acquiring a listing that is cached
+
+#define DIR_BENCH_FILES 20000
+#define DIR_BENCH_FIRST_ENTRIES 64          // Rows the file browser shows at once
+#define DIR_BENCH_ACQUIRES 1000
+
+static void WaitForEntries(const DirListing* listing, int count) {
+    while (GetDirectoryEntryCount(listing) < count && !IsDirectoryScanComplete(listing)) YieldThread();
+}
+
+static void WaitForScan(const DirListing* listing) {
+    while (!IsDirectoryScanComplete(listing)) YieldThread();
+}
+
+void RunDirScanBenchmarks(BenchContext* ctx) {
+    int files = BenchScaled(ctx, DIR_BENCH_FILES);
+    int acquires = BenchScaled(ctx, DIR_BENCH_ACQUIRES);
+    char path[1024];
+    bool created = false;
+
+    BenchCase bench;
+
+    if (BeginBenchCase(ctx, &bench, "dir_scan.cold", files)) {
+        created = created || BenchCreateDirectory(ctx, "scan", files, path, sizeof(path));
+        int entries = 0;
+        while (created && NextBenchSample(&bench)) {
+            DirScanner* scanner = CreateDirScanner();
+            if (!scanner) break;
+            BenchStart(&bench);
+            DirListing* listing = AcquireDirectory(scanner, path);
+            WaitForScan(listing);
+            BenchStop(&bench);
+            entries = GetDirectoryEntryCount(listing);
+            ReleaseDirectory(scanner, listing);
+            DestroyDirScanner(scanner);
+        }
+        SetBenchCounter(&bench, "entries", entries);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "dir_scan.first_entries", DIR_BENCH_FIRST_ENTRIES)) {
+        created = created || BenchCreateDirectory(ctx, "scan", files, path, sizeof(path));
+        while (created && NextBenchSample(&bench)) {
+            DirScanner* scanner = CreateDirScanner();
+            if (!scanner) break;
+            BenchStart(&bench);
+            DirListing* listing = AcquireDirectory(scanner, path);
+            WaitForEntries(listing, DIR_BENCH_FIRST_ENTRIES);
+            BenchStop(&bench);
+            ReleaseDirectory(scanner, listing);
+            DestroyDirScanner(scanner);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "dir_scan.cached_acquire", acquires)) {
+        created = created || BenchCreateDirectory(ctx, "scan", files, path, sizeof(path));
+        DirScanner* scanner = created ? CreateDirScanner() : NULL;
+        if (scanner) {
+            // Keep one reference so the listing stays cached between acquires
+            DirListing* held = AcquireDirectory(scanner, path);
+            WaitForScan(held);
+            while (NextBenchSample(&bench)) {
+                BenchStart(&bench);
+                for (int i = 0; i < acquires; i++) ReleaseDirectory(scanner, AcquireDirectory(scanner, path));
+                BenchStop(&bench);
+            }
+            ReleaseDirectory(scanner, held);
+            DestroyDirScanner(scanner);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+}
@@ -0,0 +1,75 @@
+#include "bench.h"
+#include "job_system.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+// Job system: a wide fan-out joined by one job that depends on all of it,
+// the shape of a batch import, and a long dependency chain, which measures
+// how quickly a finished job releases the next one.
+
+#define JOBS_BENCH_FAN_OUT 2000
+#define JOBS_BENCH_CHAIN 1000
+#define JOBS_BENCH_WORK 2000                // Hash rounds per job, a few microseconds
+
+typedef struct {
+    atomic_uint checksum;
+} JobsBench;
+
+static void HashJob(void* data) {
+    JobsBench* bench = data;
+    uint32_t state = 2166136261u;
+    for (int i = 0; i < JOBS_BENCH_WORK; i++) state = (state ^ (uint32_t)i) * 16777619u;
+    atomic_fetch_xor_explicit(&bench->checksum, state, memory_order_relaxed);
+}
+
+static void SetJobCounters(BenchCase* bench, JobSystem* jobs, JobSystemStats before) {
+    JobSystemStats after = GetJobSystemStats(jobs);
+    SetBenchCounter(bench, "workers", after.workers);
+    SetBenchCounter(bench, "stolenPerSample", (double)(after.stolen - before.stolen) / (bench->warmup + bench->iterations));
+}
+
+void RunJobBenchmarks(BenchContext* ctx) {
+    int fanOut = BenchScaled(ctx, JOBS_BENCH_FAN_OUT);
+    int chain = BenchScaled(ctx, JOBS_BENCH_CHAIN);
+    if (fanOut > JOB_SYSTEM_MAX_JOBS - 1) fanOut = JOB_SYSTEM_MAX_JOBS - 1;
+
+    JobSystem* jobs = NULL;
+    JobHandle* handles = malloc((size_t)(fanOut > chain ? fanOut : chain) * sizeof(JobHandle));
+    JobsBench state = { 0 };
+    BenchCase bench;
+
+    if (handles && BeginBenchCase(ctx, &bench, "jobs.fan_out", fanOut)) {
+        if (!jobs) jobs = CreateJobSystem(0);
+        JobSystemStats before = GetJobSystemStats(jobs);
+        while (jobs && NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            for (int i = 0; i < fanOut; i++) {
+                handles[i] = ScheduleJob(jobs, (JobDesc){ HashJob, NULL, &state, JOB_PRIORITY_BULK }, NULL, 0);
+            }
+            JobHandle join = ScheduleJob(jobs, (JobDesc){ NULL, NULL, NULL, JOB_PRIORITY_BULK }, handles, fanOut);
+            WaitForJob(jobs, join);
+            BenchStop(&bench);
+        }
+        if (jobs) SetJobCounters(&bench, jobs, before);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (handles && BeginBenchCase(ctx, &bench, "jobs.chain", chain)) {
+        if (!jobs) jobs = CreateJobSystem(0);
+        JobSystemStats before = GetJobSystemStats(jobs);
+        while (jobs && NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            JobHandle previous = JOB_NULL_HANDLE;
+            for (int i = 0; i < chain; i++) {
+                previous = ScheduleJob(jobs, (JobDesc){ HashJob, NULL, &state, JOB_PRIORITY_INTERACTIVE }, &previous, 1);
+            }
+            WaitForJob(jobs, previous);
+            BenchStop(&bench);
+        }
+        if (jobs) SetJobCounters(&bench, jobs, before);
+        EndBenchCase(ctx, &bench);
+    }
+
+    DestroyJobSystem(jobs);
+    free(handles);
+}
@@ -0,0 +1,124 @@
+#include "bench.h"
+#include "app_state.h"
+#include "project_file.h"
+#include "scene.h"
+#include "timeline.h"
+#include <stdlib.h>
+
+// Project files: serializing in memory, saving to disk, and loading back
+// with the same index rebuilds LoadProject does
+
+#define PROJECT_BENCH_ELEMENTS 50000
+#define PROJECT_BENCH_ENTITIES 20000
+#define PROJECT_BENCH_ASSETS 2000
+
+static void FillProject(AppState* app, int elements, int entities, int assets) {
+    uint32_t seed = 4321;
+    snprintf(app->projectName, sizeof(app->projectName), "Benchmark");
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        Track* track = &app->tracks[app->trackCount++];
+        snprintf(track->name, sizeof(track->name), "Track %d", t + 1);
+        track->color = (Color){ 80, (unsigned char)(40 + t * 10), 200, 255 };
+        track->volume = 1.0f;
+    }
+
+    for (int i = 0; i < assets; i++) {
+        Asset* asset = PoolGet(&app->assets, PoolAlloc(&app->assets));
+        if (!asset) return;
+        snprintf(asset->name, sizeof(asset->name), "asset_%05d", i);
+        snprintf(asset->type, sizeof(asset->type), i % 3 ? "texture" : "audio");
+        snprintf(asset->path, sizeof(asset->path), "materials/bench/asset_%05d.vtf", i);
+        asset->id = i;
+    }
+
+    for (int i = 0; i < elements; i++) {
+        TimelineElement* element = PoolGet(&app->elements, PoolAlloc(&app->elements));
+        if (!element) return;
+        snprintf(element->name, sizeof(element->name), "Clip %d", i);
+        element->type = ELEMENT_TYPE_AUDIO;
+        element->id = i;
+        element->color = (Color){ 200, 120, 60, 255 };
+        element->trackIndex = (int)(BenchRandom(&seed) % MAX_TIMELINE_TRACKS);
+        element->startTime = BenchRandomFloat(&seed, 0.0f, 3600.0f);
+        element->duration = BenchRandomFloat(&seed, 0.1f, 8.0f);
+        element->sourceId = (int)(BenchRandom(&seed) % (uint32_t)(assets > 0 ? assets : 1));
+    }
+
+    for (int i = 0; i < entities; i++) {
+        Entity entity = EcsCreateEntity(&app->scene);
+        NameComponent* name = EcsAddComponent(&app->scene, entity, COMPONENT_NAME);
+        TransformComponent* transform = EcsAddComponent(&app->scene, entity, COMPONENT_TRANSFORM);
+        SpriteComponent* sprite = EcsAddComponent(&app->scene, entity, COMPONENT_SPRITE);
+        if (!name || !transform || !sprite) return;
+        snprintf(name->value, sizeof(name->value), "Prop %d", i);
+        transform->position = (Vector2){ BenchRandomFloat(&seed, -8192.0f, 8192.0f), BenchRandomFloat(&seed, -8192.0f, 8192.0f) };
+        transform->rotation = BenchRandomFloat(&seed, 0.0f, 360.0f);
+        sprite->asset = (int32_t)(BenchRandom(&seed) % (uint32_t)(assets > 0 ? assets : 1));
+        sprite->size = (Vector2){ BenchRandomFloat(&seed, 8.0f, 256.0f), BenchRandomFloat(&seed, 8.0f, 256.0f) };
+    }
+
+    RebuildTimelineIndex(app);
+    RebuildSceneBounds(app);
+}
+
+void RunProjectBenchmarks(BenchContext* ctx) {
+    int elements = BenchScaled(ctx, PROJECT_BENCH_ELEMENTS);
+    int entities = BenchScaled(ctx, PROJECT_BENCH_ENTITIES);
+    int assets = BenchScaled(ctx, PROJECT_BENCH_ASSETS);
+    int64_t objects = (int64_t)elements + entities + assets;
+
+    char path[1024];
+    if (!BenchPath(ctx, path, sizeof(path), "project.gbx")) return;
+
+    AppState* app = malloc(sizeof(AppState));
+    if (!app) return;
+    InitApp(app, NULL);
+    FillProject(app, elements, entities, assets);
+
+    BenchCase bench;
+
+    if (BeginBenchCase(ctx, &bench, "project.serialize", objects)) {
+        size_t size = 0;
+        while (NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            unsigned char* data = BuildProjectFile(app, &size);
+            BenchStop(&bench);
+            free(data);
+        }
+        SetBenchCounter(&bench, "bytes", (double)size);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "project.save", objects)) {
+        while (NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            bool saved = WriteProjectFile(app, path);
+            BenchStop(&bench);
+            if (!saved) TraceLog(LOG_WARNING, "BENCH: Could not save %s", path);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    AppState* loaded = malloc(sizeof(AppState));
+    if (loaded && BeginBenchCase(ctx, &bench, "project.load", objects)) {
+        // Saved again in case the save case was filtered out
+        bool saved = WriteProjectFile(app, path);
+        InitApp(loaded, NULL);
+        while (saved && NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            ReadProjectFile(loaded, path);
+            RebuildTimelineIndex(loaded);
+            RebuildSceneBounds(loaded);
+            BenchStop(&bench);
+        }
+        SetBenchCounter(&bench, "elements", (double)loaded->elements.liveCount);
+        SetBenchCounter(&bench, "entities", (double)EcsEntityCount(&loaded->scene));
+        EndBenchCase(ctx, &bench);
+        UnloadApp(loaded);
+    }
+    free(loaded);
+
+    UnloadApp(app);
+    free(app);
+}
@@ -0,0 +1,130 @@
+#include "bench.h"
+#include "app_state.h"
+#include "dir_scanner.h"
+#include "file_filter.h"
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #define YieldThread() Sleep(0)
+#else
+    #include <sched.h>
+    #define YieldThread() sched_yield()
+#endif
+
+// Text input editing: the file browser's filter box, keystroke by keystroke.
+// Every edit refilters the listing the way the browser does each frame, so
+// typing exercises the filter's refinement levels and backspacing or editing
+// in the middle exercises falling back to a cached level.
+
+#define TEXT_BENCH_FILES 20000
+
+static const char* queries[] = { "brick", "rustypipe", "wall_01", "dkflr.vtf", "crate" };
+
+// Same edits UpdateTextInput makes for a typed character and for backspace
+static void TypeCharacter(TextInput* input, char c) {
+    int length = (int)strlen(input->text);
+    if (length >= MAX_INPUT_LEN - 1) return;
+    memmove(input->text + input->cursorPosition + 1, input->text + input->cursorPosition, (size_t)(length - input->cursorPosition + 1));
+    input->text[input->cursorPosition++] = c;
+}
+
+static void Backspace(TextInput* input) {
+    if (input->cursorPosition == 0) return;
+    int length = (int)strlen(input->text);
+    memmove(input->text + input->cursorPosition - 1, input->text + input->cursorPosition, (size_t)(length - input->cursorPosition + 1));
+    input->cursorPosition--;
+}
+
+// Scanned on first use so filtered-out runs don't create the files
+static DirListing* ScanFilterDirectory(BenchContext* ctx, DirScanner** scanner) {
+    char path[1024];
+    if (!BenchCreateDirectory(ctx, "filter", BenchScaled(ctx, TEXT_BENCH_FILES), path, sizeof(path))) return NULL;
+    *scanner = CreateDirScanner();
+    DirListing* listing = AcquireDirectory(*scanner, path);
+    while (!IsDirectoryScanComplete(listing)) YieldThread();
+    return listing;
+}
+
+static void Refilter(FileFilter* filter, const TextInput* input, const DirListing* listing) {
+    SetFileFilterQuery(filter, input->text);
+    UpdateFileFilter(filter, listing);
+}
+
+void RunTextInputBenchmarks(BenchContext* ctx) {
+    const int queryCount = (int)(sizeof(queries) / sizeof(queries[0]));
+    int keystrokes = 0;
+    int middleEdits = 0;
+    for (int q = 0; q < queryCount; q++) {
+        int length = (int)strlen(queries[q]);
+        keystrokes += length * 2;
+        middleEdits += 1 + (length - length / 2) * 2;
+    }
+
+    BenchCase bench;
+    DirScanner* scanner = NULL;
+    DirListing* listing = NULL;
+    FileFilter filter;
+    TextInput input;
+
+    if (BeginBenchCase(ctx, &bench, "text_input.type_and_erase", keystrokes)) {
+        listing = ScanFilterDirectory(ctx, &scanner);
+
+        // Type each query one character at a time, then backspace it away
+        int matches = 0;
+        while (listing && NextBenchSample(&bench)) {
+            InitFileFilter(&filter);
+            memset(&input, 0, sizeof(input));
+            BenchStart(&bench);
+            for (int q = 0; q < queryCount; q++) {
+                for (const char* c = queries[q]; *c; c++) {
+                    TypeCharacter(&input, *c);
+                    Refilter(&filter, &input, listing);
+                }
+                matches += GetFilterMatchCount(&filter);
+                while (input.cursorPosition > 0) {
+                    Backspace(&input);
+                    Refilter(&filter, &input, listing);
+                }
+            }
+            BenchStop(&bench);
+            UnloadFileFilter(&filter);
+        }
+        SetBenchCounter(&bench, "entries", GetDirectoryEntryCount(listing));
+        SetBenchCounter(&bench, "matchesPerQuery", (double)matches / ((bench.warmup + bench.iterations) * queryCount));
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "text_input.edit_middle", middleEdits)) {
+        if (!listing) listing = ScanFilterDirectory(ctx, &scanner);
+
+        // With the query typed, move the caret to the middle and retype the
+        // second half, so every edit changes the query before its end
+        while (listing && NextBenchSample(&bench)) {
+            InitFileFilter(&filter);
+            BenchStart(&bench);
+            for (int q = 0; q < queryCount; q++) {
+                int length = (int)strlen(queries[q]);
+                memset(&input, 0, sizeof(input));
+                for (int i = 0; i < length; i++) TypeCharacter(&input, queries[q][i]);
+                Refilter(&filter, &input, listing);
+
+                input.cursorPosition = length / 2;
+                for (int i = length / 2; i < length; i++) {
+                    TypeCharacter(&input, queries[q][i]);
+                    Refilter(&filter, &input, listing);
+                }
+                for (int i = length / 2; i < length; i++) {
+                    Backspace(&input);
+                    Refilter(&filter, &input, listing);
+                }
+            }
+            BenchStop(&bench);
+            UnloadFileFilter(&filter);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    ReleaseDirectory(scanner, listing);
+    DestroyDirScanner(scanner);
+}
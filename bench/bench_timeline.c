@@ -0,0 +1,154 @@
+#include "bench.h"
+#include "timeline_index.h"
+#include <stdlib.h>
+
+// Timeline index: building it one edit at a time and in bulk, then the
+// queries the timeline view and playback run every frame, also with a clip
+// under the whole project on every track (a music bed), which no query may
+// have to walk past
+
+#define TIMELINE_BENCH_ELEMENTS 100000
+#define TIMELINE_BENCH_TRACKS 64
+#define TIMELINE_BENCH_LENGTH 3600.0f       // Seconds of project
+#define TIMELINE_BENCH_QUERIES 10000
+#define TIMELINE_BENCH_WINDOW 20.0f         // Seconds visible in a query
+
+typedef struct {
+    int track;
+    float start;
+    float end;
+} BenchElement;
+
+static BenchElement* CreateElements(int count, uint32_t seed) {
+    BenchElement* elements = malloc((size_t)count * sizeof(BenchElement));
+    if (!elements) return NULL;
+    for (int i = 0; i < count; i++) {
+        elements[i].track = (int)(BenchRandom(&seed) % TIMELINE_BENCH_TRACKS);
+        elements[i].start = BenchRandomFloat(&seed, 0.0f, TIMELINE_BENCH_LENGTH);
+        elements[i].end = elements[i].start + BenchRandomFloat(&seed, 0.1f, 8.0f);
+    }
+    return elements;
+}
+
+static void BuildIndex(TimelineIndex* index, const BenchElement* elements, int count) {
+    for (int i = 0; i < count; i++) TimelineIndexAppend(index, elements[i].track, i, elements[i].start, elements[i].end);
+    SortTimelineIndex(index);
+}
+
+void RunTimelineBenchmarks(BenchContext* ctx) {
+    int count = BenchScaled(ctx, TIMELINE_BENCH_ELEMENTS);
+    int queries = BenchScaled(ctx, TIMELINE_BENCH_QUERIES);
+    BenchElement* elements = CreateElements(count, 1234);
+    int* results = malloc(4096 * sizeof(int));
+    if (!elements || !results) {
+        free(elements);
+        free(results);
+        return;
+    }
+
+    BenchCase bench;
+    TimelineIndex index;
+
+    if (BeginBenchCase(ctx, &bench, "timeline.insert", count)) {
+        while (NextBenchSample(&bench)) {
+            InitTimelineIndex(&index);
+            BenchStart(&bench);
+            for (int i = 0; i < count; i++) {
+                TimelineIndexInsert(&index, elements[i].track, i, elements[i].start, elements[i].end);
+            }
+            BenchStop(&bench);
+            UnloadTimelineIndex(&index);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "timeline.bulk_load", count)) {
+        while (NextBenchSample(&bench)) {
+            InitTimelineIndex(&index);
+            BenchStart(&bench);
+            BuildIndex(&index, elements, count);
+            BenchStop(&bench);
+            UnloadTimelineIndex(&index);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    InitTimelineIndex(&index);
+    BuildIndex(&index, elements, count);
+
+    if (BeginBenchCase(ctx, &bench, "timeline.query_range", queries)) {
+        int64_t hits = 0;
+        while (NextBenchSample(&bench)) {
+            uint32_t seed = 99;
+            hits = 0;
+            BenchStart(&bench);
+            for (int i = 0; i < queries; i++) {
+                int track = (int)(BenchRandom(&seed) % TIMELINE_BENCH_TRACKS);
+                float from = BenchRandomFloat(&seed, 0.0f, TIMELINE_BENCH_LENGTH);
+                hits += QueryTimelineRange(&index, track, from, from + TIMELINE_BENCH_WINDOW, results, 4096);
+            }
+            BenchStop(&bench);
+        }
+        SetBenchCounter(&bench, "hitsPerQuery", (double)hits / queries);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "timeline.query_point", queries)) {
+        while (NextBenchSample(&bench)) {
+            uint32_t seed = 77;
+            BenchStart(&bench);
+            for (int i = 0; i < queries; i++) {
+                int track = (int)(BenchRandom(&seed) % TIMELINE_BENCH_TRACKS);
+                QueryTimelinePoint(&index, track, BenchRandomFloat(&seed, 0.0f, TIMELINE_BENCH_LENGTH), results, 4096);
+            }
+            BenchStop(&bench);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "timeline.query_underlay", queries)) {
+        TimelineIndex underlaid;
+        InitTimelineIndex(&underlaid);
+        BuildIndex(&underlaid, elements, count);
+        for (int t = 0; t < TIMELINE_BENCH_TRACKS; t++) TimelineIndexInsert(&underlaid, t, count + t, 0.0f, TIMELINE_BENCH_LENGTH);
+
+        int64_t hits = 0;
+        while (NextBenchSample(&bench)) {
+            uint32_t seed = 99;
+            hits = 0;
+            BenchStart(&bench);
+            for (int i = 0; i < queries; i++) {
+                int track = (int)(BenchRandom(&seed) % TIMELINE_BENCH_TRACKS);
+                float from = BenchRandomFloat(&seed, 0.0f, TIMELINE_BENCH_LENGTH);
+                hits += QueryTimelineRange(&underlaid, track, from, from + TIMELINE_BENCH_WINDOW, results, 4096);
+            }
+            BenchStop(&bench);
+        }
+        SetBenchCounter(&bench, "hitsPerQuery", (double)hits / queries);
+        UnloadTimelineIndex(&underlaid);
+        EndBenchCase(ctx, &bench);
+    }
+
+    // Drags onto the next track and back, so every sample starts from the
+    // same index
+    if (BeginBenchCase(ctx, &bench, "timeline.move", queries * 2)) {
+        while (NextBenchSample(&bench)) {
+            uint32_t seed = 55;
+            BenchStart(&bench);
+            for (int i = 0; i < queries; i++) {
+                int element = (int)(BenchRandom(&seed) % (uint32_t)count);
+                const BenchElement* e = &elements[element];
+                float offset = BenchRandomFloat(&seed, -30.0f, 30.0f);
+                int track = (e->track + 1) % TIMELINE_BENCH_TRACKS;
+                TimelineIndexMove(&index, element, e->track, e->start, track, e->start + offset, e->end + offset);
+                TimelineIndexMove(&index, element, track, e->start + offset, e->track, e->start, e->end);
+            }
+            BenchStop(&bench);
+        }
+        EndBenchCase(ctx, &bench);
+    }
+
+    UnloadTimelineIndex(&index);
+    free(elements);
+    free(results);
+}
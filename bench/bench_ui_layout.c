@@ -0,0 +1,147 @@
+#include "bench.h"
+#include "app_state.h"
+#include "draw_list.h"
+#include "scene.h"
+#include "text_cache.h"
+#include "timeline.h"
+#include "ui_components.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// UI layout at scripted window sizes: the editor's own widgets (timeline,
+// inspector property editors, asset grid and toolbar buttons) drawing a
+// project into the draw list, which EndUiDrawList then counts and batches
+// without submitting anything, since there is no window. raylib loads its
+// font with the window, so text is recorded but measures and draws as
+// nothing, and without a thumbnail cache the asset tiles show their type.
+// The scene view draws straight to raylib, so it is left out.
+
+#define LAYOUT_BENCH_FRAMES 100             // Frames per sample
+#define LAYOUT_BENCH_ELEMENTS 20000
+#define LAYOUT_BENCH_ASSETS 600
+#define LAYOUT_BENCH_TOOLBAR_HEIGHT 30      // Same panel layout as the editor
+#define LAYOUT_BENCH_ASSETS_HEIGHT 150
+#define LAYOUT_BENCH_INSPECTOR_WIDTH 260
+#define LAYOUT_BENCH_TIMELINE_HEIGHT 180
+
+static const struct { int width; int height; } sizes[] = {
+    { 1024, 768 }, { 1280, 720 }, { 1920, 1080 }, { 2560, 1080 }, { 3840, 2160 }
+};
+
+static const char* toolbarButtons[] = { "Menu", "Save", "Play" };
+
+static void FillLayoutProject(AppState* app, int elements, int assets) {
+    uint32_t seed = 31337;
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        Track* track = &app->tracks[app->trackCount++];
+        snprintf(track->name, sizeof(track->name), "Track %d", t + 1);
+        track->volume = 1.0f;
+    }
+
+    for (int i = 0; i < assets; i++) {
+        Asset* asset = PoolGet(&app->assets, PoolAlloc(&app->assets));
+        if (!asset) break;
+        snprintf(asset->name, sizeof(asset->name), "asset_%05d", i);
+        snprintf(asset->type, sizeof(asset->type), i % 3 ? "texture" : "audio");
+        snprintf(asset->path, sizeof(asset->path), "materials/bench/asset_%05d.vtf", i);
+        asset->id = i;
+    }
+
+    for (int i = 0; i < elements; i++) {
+        TimelineElement* element = PoolGet(&app->elements, PoolAlloc(&app->elements));
+        if (!element) break;
+        snprintf(element->name, sizeof(element->name), "Clip %d", i);
+        element->type = i % 4 ? ELEMENT_TYPE_AUDIO : ELEMENT_TYPE_OBJECT;
+        element->id = i;
+        element->color = (Color){ 200, 120, 60, 255 };
+        element->trackIndex = (int)(BenchRandom(&seed) % MAX_TIMELINE_TRACKS);
+        element->startTime = BenchRandomFloat(&seed, 0.0f, 3600.0f);
+        element->duration = BenchRandomFloat(&seed, 0.5f, 6.0f);
+        element->sourceId = (int)(BenchRandom(&seed) % (uint32_t)(assets > 0 ? assets : 1));
+    }
+    RebuildTimelineIndex(app);
+
+    // One selected entity with every component, so the inspector is full
+    Entity entity = EcsCreateEntity(&app->scene);
+    for (int type = 0; type < COMPONENT_TYPE_COUNT; type++) EcsAddComponent(&app->scene, entity, type);
+    app->selectedEntity = entity;
+}
+
+static void LayoutPanels(AppState* app, int width, int height) {
+    float w = (float)width, h = (float)height;
+    app->panels[PANEL_ASSETS].bounds = (Rectangle){ 0, h - LAYOUT_BENCH_ASSETS_HEIGHT, w, LAYOUT_BENCH_ASSETS_HEIGHT };
+    app->panels[PANEL_INSPECTOR].bounds = (Rectangle){
+        w - LAYOUT_BENCH_INSPECTOR_WIDTH, LAYOUT_BENCH_TOOLBAR_HEIGHT, LAYOUT_BENCH_INSPECTOR_WIDTH,
+        h - LAYOUT_BENCH_ASSETS_HEIGHT - LAYOUT_BENCH_TIMELINE_HEIGHT - LAYOUT_BENCH_TOOLBAR_HEIGHT
+    };
+}
+
+// One editor frame minus the scene view, in the editor's drawing order
+static void LayoutFrame(AppState* app, int width) {
+    DrawTimeline(app);
+
+    Rectangle inspector = app->panels[PANEL_INSPECTOR].bounds;
+    UiDrawRectangle(inspector, COLOR_PANEL_BG);
+    UiDrawText("Inspector", inspector.x + 8, inspector.y + 3, 16, COLOR_TEXT);
+    Rectangle area = { inspector.x, inspector.y + 24, inspector.width, inspector.height - 24 };
+    float bottom = area.y + area.height;
+    for (int type = 0; type < COMPONENT_TYPE_COUNT && area.height > 0; type++) {
+        DrawPropertyEditor(app, app->selectedEntity, type, area);
+        area.y += (SCENE_COMPONENT_TYPES[type].fieldCount + 1) * PROPERTY_ROW_HEIGHT + 4;
+        area.height = bottom - area.y;
+    }
+
+    Rectangle assets = app->panels[PANEL_ASSETS].bounds;
+    UiDrawRectangle(assets, COLOR_PANEL_BG);
+    UiDrawText("Assets", assets.x + 8, assets.y + 3, 16, COLOR_TEXT);
+    DrawAssetGrid(app, (Rectangle){ assets.x, assets.y + 22, assets.width, assets.height - 22 });
+
+    UiDrawRectangle((Rectangle){ 0, 0, (float)width, LAYOUT_BENCH_TOOLBAR_HEIGHT }, COLOR_PANEL_HEADER);
+    UiDrawText(app->projectName, 10, 6, 18, COLOR_TEXT);
+    for (int i = 0; i < (int)(sizeof(toolbarButtons) / sizeof(toolbarButtons[0])); i++) {
+        Button((Rectangle){ width - 90.0f * (i + 1), 4, 80, 22 }, toolbarButtons[i], false);
+    }
+}
+
+void RunUiLayoutBenchmarks(BenchContext* ctx) {
+    const int sizeCount = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    int frames = BenchScaled(ctx, LAYOUT_BENCH_FRAMES);
+
+    AppState* app = malloc(sizeof(AppState));
+    if (!app) return;
+    InitApp(app, NULL);
+    snprintf(app->projectName, sizeof(app->projectName), "Benchmark");
+    FillLayoutProject(app, BenchScaled(ctx, LAYOUT_BENCH_ELEMENTS), BenchScaled(ctx, LAYOUT_BENCH_ASSETS));
+
+    for (int s = 0; s < sizeCount; s++) {
+        char name[64];
+        snprintf(name, sizeof(name), "ui_layout.%dx%d", sizes[s].width, sizes[s].height);
+
+        BenchCase bench;
+        if (!BeginBenchCase(ctx, &bench, name, frames)) continue;
+
+        LayoutPanels(app, sizes[s].width, sizes[s].height);
+        while (NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            for (int f = 0; f < frames; f++) {
+                app->timeline.scrollX = (float)f * 0.5f;
+                UpdateTextCache();
+                BeginUiDrawList();
+                LayoutFrame(app, sizes[s].width);
+                EndUiDrawList();
+            }
+            BenchStop(&bench);
+        }
+
+        UiDrawStats stats = GetUiDrawStats();
+        SetBenchCounter(&bench, "commands", stats.commands);
+        SetBenchCounter(&bench, "drawCalls", stats.drawCalls);
+        SetBenchCounter(&bench, "vertices", stats.vertices);
+        EndBenchCase(ctx, &bench);
+    }
+
+    UnloadUiDrawList();
+    UnloadTextCache();
+    UnloadApp(app);
+    free(app);
+}
@@ -0,0 +1,178 @@
+#include "bench.h"
+#include "vpk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// VPK packages: mounting a directory with a large tree (parsing it and
+// building the path index), and looking files up by path the way the asset
+// browser and the texture loader would, in a shuffled order with the case
+// and slashes the engine accepts. The package is written once to the
+// temporary directory as a "_dir.vpk" and one "_000.vpk" chunk.
+
+#define VPK_BENCH_FILES 100000
+#define VPK_BENCH_FILES_PER_DIRECTORY 100
+#define VPK_BENCH_LOOKUPS 100000
+#define VPK_BENCH_FILE_SIZE 32              // Bytes of each file in the chunk
+#define VPK_BENCH_PRELOAD_SIZE 16           // Every eighth file keeps this much in the directory too
+#define VPK_BENCH_PATH_SIZE 64
+
+static const char* extensions[] = { "vtf", "vmt", "mdl" };
+
+typedef struct {
+    unsigned char* data;
+    size_t size;
+} VpkWriter;
+
+static void WriteBytes(VpkWriter* writer, const void* data, size_t size) {
+    memcpy(writer->data + writer->size, data, size);
+    writer->size += size;
+}
+
+static void WriteString(VpkWriter* writer, const char* string) {
+    WriteBytes(writer, string, strlen(string) + 1);
+}
+
+static void WriteU16(VpkWriter* writer, uint16_t value) {
+    unsigned char bytes[2] = { (unsigned char)value, (unsigned char)(value >> 8) };
+    WriteBytes(writer, bytes, sizeof(bytes));
+}
+
+static void WriteU32(VpkWriter* writer, uint32_t value) {
+    unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+    WriteBytes(writer, bytes, sizeof(bytes));
+}
+
+static void FilePath(int index, char* path, size_t size) {
+    int directory = index / VPK_BENCH_FILES_PER_DIRECTORY;
+    snprintf(path, size, "materials/bench/set_%04d/file_%06d.%s", directory, index, extensions[directory % 3]);
+}
+
+// Directories take turns between the extensions, so the tree has all three
+// levels: extension -> directory -> file name
+static bool WriteBenchVpk(const BenchContext* ctx, int files, char* dirPath, int size) {
+    char chunkPath[1024];
+    if (!BenchPath(ctx, dirPath, size, "bench_dir.vpk") || !BenchPath(ctx, chunkPath, sizeof(chunkPath), "bench_000.vpk")) return false;
+
+    int directories = (files + VPK_BENCH_FILES_PER_DIRECTORY - 1) / VPK_BENCH_FILES_PER_DIRECTORY;
+    size_t treeCapacity = 64 + (size_t)directories * 32 + (size_t)files * (16 + 18 + VPK_BENCH_PRELOAD_SIZE);
+    VpkWriter tree = { malloc(treeCapacity), 0 };
+    VpkWriter chunk = { malloc((size_t)files * VPK_BENCH_FILE_SIZE + 1), 0 };
+    bool written = false;
+    if (tree.data && chunk.data) {
+        unsigned char contents[VPK_BENCH_FILE_SIZE];
+        for (int e = 0; e < 3; e++) {
+            WriteString(&tree, extensions[e]);
+            for (int d = e; d < directories; d += 3) {
+                char directory[VPK_BENCH_PATH_SIZE];
+                snprintf(directory, sizeof(directory), "materials/bench/set_%04d", d);
+                WriteString(&tree, directory);
+                int last = (d + 1) * VPK_BENCH_FILES_PER_DIRECTORY;
+                for (int i = d * VPK_BENCH_FILES_PER_DIRECTORY; i < last && i < files; i++) {
+                    char name[32];
+                    snprintf(name, sizeof(name), "file_%06d", i);
+                    WriteString(&tree, name);
+                    uint16_t preload = i % 8 == 0 ? VPK_BENCH_PRELOAD_SIZE : 0;
+                    WriteU32(&tree, (uint32_t)i);                       // CRC, not checked by the reader
+                    WriteU16(&tree, preload);
+                    WriteU16(&tree, 0);                                 // Archive _000
+                    WriteU32(&tree, (uint32_t)chunk.size);
+                    WriteU32(&tree, VPK_BENCH_FILE_SIZE);
+                    WriteU16(&tree, 0xFFFF);
+                    memset(contents, (unsigned char)i, sizeof(contents));
+                    WriteBytes(&tree, contents, preload);
+                    WriteBytes(&chunk, contents, sizeof(contents));
+                }
+                WriteString(&tree, "");
+            }
+            WriteString(&tree, "");
+        }
+        WriteString(&tree, "");
+
+        unsigned char headerBytes[28];
+        VpkWriter header = { headerBytes, 0 };
+        WriteU32(&header, VPK_SIGNATURE);
+        WriteU32(&header, 2);
+        WriteU32(&header, (uint32_t)tree.size);
+        WriteU32(&header, 0);                                           // No file data in the directory
+        WriteU32(&header, 0);                                           // No MD5 or signature sections
+        WriteU32(&header, 0);
+        WriteU32(&header, 0);
+
+        FILE* file = fopen(dirPath, "wb");
+        if (file) {
+            written = fwrite(header.data, 1, header.size, file) == header.size &&
+                      fwrite(tree.data, 1, tree.size, file) == tree.size;
+            written = fclose(file) == 0 && written;
+        }
+        written = written && BenchWriteFile(chunkPath, chunk.data, chunk.size);
+    }
+    free(tree.data);
+    free(chunk.data);
+    return written;
+}
+
+// Mixed case and backslashes in every other path, like paths out of a map or a material
+static char* CreateLookupPaths(int files, int lookups) {
+    char* paths = malloc((size_t)lookups * VPK_BENCH_PATH_SIZE);
+    if (!paths) return NULL;
+    uint32_t seed = 0x56504B31u;
+    for (int i = 0; i < lookups; i++) {
+        char* path = paths + (size_t)i * VPK_BENCH_PATH_SIZE;
+        FilePath((int)(BenchRandom(&seed) % (uint32_t)files), path, VPK_BENCH_PATH_SIZE);
+        if (i % 2 == 0) continue;
+        for (char* c = path; *c; c++) {
+            if (*c == '/') *c = '\\';
+            else if (*c >= 'a' && *c <= 'z' && BenchRandom(&seed) % 4 == 0) *c = (char)(*c - ('a' - 'A'));
+        }
+    }
+    return paths;
+}
+
+void RunVpkBenchmarks(BenchContext* ctx) {
+    int files = BenchScaled(ctx, VPK_BENCH_FILES);
+    int lookups = BenchScaled(ctx, VPK_BENCH_LOOKUPS);
+    char dirPath[1024];
+    bool written = false;
+
+    BenchCase bench;
+
+    if (BeginBenchCase(ctx, &bench, "vpk.mount", files)) {
+        written = written || WriteBenchVpk(ctx, files, dirPath, sizeof(dirPath));
+        VpkStats stats = { 0 };
+        while (written && NextBenchSample(&bench)) {
+            BenchStart(&bench);
+            Vpk* vpk = MountVpk(dirPath);
+            BenchStop(&bench);
+            if (!vpk) break;
+            stats = GetVpkStats(vpk);
+            UnmountVpk(vpk);
+        }
+        SetBenchCounter(&bench, "files", stats.files);
+        SetBenchCounter(&bench, "indexBytes", (double)stats.indexBytes);
+        EndBenchCase(ctx, &bench);
+    }
+
+    if (BeginBenchCase(ctx, &bench, "vpk.lookup", lookups)) {
+        written = written || WriteBenchVpk(ctx, files, dirPath, sizeof(dirPath));
+        Vpk* vpk = written ? MountVpk(dirPath) : NULL;
+        char* paths = vpk ? CreateLookupPaths(files, lookups) : NULL;
+        if (paths) {
+            // Every path exists, so found should equal the lookups
+            int found = 0;
+            while (NextBenchSample(&bench)) {
+                found = 0;
+                BenchStart(&bench);
+                for (int i = 0; i < lookups; i++) {
+                    VpkFile file;
+                    if (FindVpkFile(vpk, paths + (size_t)i * VPK_BENCH_PATH_SIZE, &file) && file.size == VPK_BENCH_FILE_SIZE) found++;
+                }
+                BenchStop(&bench);
+            }
+            SetBenchCounter(&bench, "found", found);
+        }
+        free(paths);
+        UnmountVpk(vpk);
+        EndBenchCase(ctx, &bench);
+    }
+}
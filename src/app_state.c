@@ -0,0 +1,168 @@
+#include "app_state.h"
+#include "journal.h"
+#include "scene.h"
+#include "history.h"
+#include "mixer.h"
+#include "disk_stream.h"
+#include "sequencer.h"
+#include "peak_cache.h"
+#include "timeline.h"
+#include "thumbnail_cache.h"
+#include "asset_database.h"
+#include "utils.h"
+
+static bool GrowArray(void** items, int* capacity, int needed, size_t itemSize) {
+    if (needed <= *capacity) return true;
+
+    int newCapacity = *capacity ? *capacity * 2 : 8;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void* grown = realloc(*items, (size_t)newCapacity * itemSize);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+void InitApp(AppState *app, struct JobSystem *jobs) {
+    if (!app) return;
+    memset(app, 0, sizeof(*app));
+
+    app->currentScreen = SCREEN_SPLASH;
+    app->currentTool = TOOL_SELECT;
+
+    InitPool(&app->elements, sizeof(TimelineElement));
+    InitPool(&app->assets, sizeof(Asset));
+    InitPool(&app->patterns, sizeof(Pattern));
+    InitEcsWorld(&app->scene, SCENE_COMPONENT_TYPES, COMPONENT_TYPE_COUNT);
+    InitTimelineIndex(&app->timelineIndex);
+    InitBvh(&app->sceneBounds, SCENE_BOUNDS_MARGIN);
+    app->history = CreateHistory(HISTORY_DEFAULT_LIMIT);
+
+    // Audio, waveforms and thumbnails come up with the window; headless
+    // benchmarks run without them
+    if (IsWindowReady()) {
+        app->peakCache = CreatePeakCache();
+
+        char* cacheDirectory = GetCacheDirectory();
+        char directory[512];
+        if (cacheDirectory) snprintf(directory, sizeof(directory), "%s%sThumbnails", cacheDirectory, DIR_SEPARATOR);
+        app->thumbnails = CreateThumbnailCache(cacheDirectory ? directory : NULL, 0);
+        if (cacheDirectory && jobs) {
+            snprintf(directory, sizeof(directory), "%s%sAssets", cacheDirectory, DIR_SEPARATOR);
+            app->assetDatabase = CreateAssetDatabase(directory, jobs);
+        }
+        free(cacheDirectory);
+
+        if (!IsAudioDeviceReady()) {
+            InitAudioDevice();
+            app->ownsAudioDevice = IsAudioDeviceReady();
+        }
+        app->mixer = CreateMixer(MIXER_DEFAULT_SAMPLE_RATE, MIXER_DEFAULT_BUFFER_FRAMES);
+        if (app->mixer) {
+            app->streamer = CreateDiskStreamer(app->mixer, 0);
+            app->sequencer = CreateSequencer(app->mixer);
+        }
+    }
+
+    app->timeline.zoom = 1.0f;
+    app->timeline.bpm = 120.0f;
+    app->timeline.timeSignatureNumerator = 4.0f;
+    app->timeline.timeSignatureDenominator = 4.0f;
+    app->timeline.snapDivision = 4.0f;
+    app->timeline.showGrid = true;
+    app->timeline.selectedTrack = -1;
+
+    app->sceneZoom = 1.0f;
+}
+
+void UnloadApp(AppState *app) {
+    if (!app) return;
+
+    CloseJournal(app->journal);
+    app->journal = NULL;
+
+    // Waits for its imports, so it goes while the job system is still up
+    DestroyAssetDatabase(app->assetDatabase);
+    app->assetDatabase = NULL;
+
+    // The mixer goes first: once its stream is unloaded no audio callback
+    // can still be rendering from the sources
+    DestroyMixer(app->mixer);
+    DestroySequencer(app->sequencer);
+    DestroyDiskStreamer(app->streamer);
+    app->mixer = NULL;
+    app->sequencer = NULL;
+    app->streamer = NULL;
+    if (app->ownsAudioDevice) CloseAudioDevice();
+    app->ownsAudioDevice = false;
+
+    ClearProjectData(app);
+    free(app->timelinePeaks);
+    app->timelinePeaks = NULL;
+    app->timelinePeakCapacity = 0;
+    DestroyPeakCache(app->peakCache);
+    app->peakCache = NULL;
+    DestroyThumbnailCache(app->thumbnails);
+    app->thumbnails = NULL;
+    free(app->assetOrder);
+    app->assetOrder = NULL;
+    app->assetOrderCount = 0;
+    app->assetOrderCapacity = 0;
+    DestroyHistory(app->history);
+    app->history = NULL;
+    UnloadPool(&app->elements);
+    UnloadPool(&app->assets);
+    UnloadPool(&app->patterns);
+    UnloadEcsWorld(&app->scene);
+    UnloadTimelineIndex(&app->timelineIndex);
+    UnloadBvh(&app->sceneBounds);
+    free(app->sceneProxies);
+    free(app->sceneVisible);
+    app->sceneProxies = NULL;
+    app->sceneVisible = NULL;
+    app->sceneProxyCapacity = 0;
+    app->sceneVisibleCount = 0;
+    app->sceneVisibleCapacity = 0;
+}
+
+void ClearProjectData(AppState *app) {
+    if (!app) return;
+
+    for (uint32_t slot = 0; slot < app->patterns.slotCount; slot++) {
+        Pattern* pattern = PoolAt(&app->patterns, slot);
+        if (pattern) FreePattern(pattern);
+    }
+
+    ClearPool(&app->elements);
+    ClearPool(&app->assets);
+    ClearPool(&app->patterns);
+    ClearEcsWorld(&app->scene);
+    ClearTimelineIndex(&app->timelineIndex);
+    ReleaseTimelinePeaks(app);
+    ClearHistory(app->history);
+    ClearBvh(&app->sceneBounds);
+    for (uint32_t slot = 0; slot < app->sceneProxyCapacity; slot++) app->sceneProxies[slot] = BVH_NULL_PROXY;
+    app->trackCount = 0;
+    app->editVersion++;
+
+    app->selectedElement = POOL_NULL_HANDLE;
+    app->selectedAsset = POOL_NULL_HANDLE;
+    app->selectedPattern = POOL_NULL_HANDLE;
+    app->selectedEntity = ECS_NULL_ENTITY;
+}
+
+int* AddPatternNote(Pattern* pattern, int note) {
+    if (!pattern || !GrowArray((void**)&pattern->notes, &pattern->noteCapacity, pattern->noteCount + 1, sizeof(int))) return NULL;
+    int* slot = &pattern->notes[pattern->noteCount++];
+    *slot = note;
+    return slot;
+}
+
+void FreePattern(Pattern* pattern) {
+    if (!pattern) return;
+    free(pattern->notes);
+    pattern->notes = NULL;
+    pattern->noteCount = 0;
+    pattern->noteCapacity = 0;
+}
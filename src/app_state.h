@@ -2,6 +2,11 @@
 #define APP_STATE_H
 
 #include "raylib.h"
+#include "dir_scanner.h"
+#include "timeline_index.h"
+#include "pool.h"
+#include "ecs.h"
+#include "bvh.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,11 +18,7 @@
 #define WINDOW_WIDTH 1280
 #define WINDOW_HEIGHT 720
 #define MAX_TIMELINE_TRACKS 16
-#define MAX_ASSETS 128
-#define MAX_COMPONENTS 16
 #define MAX_RECENT_PROJECTS 10
-#define MAX_PATTERNS 64
-#define MAX_NOTES 256
 
 // UI Colors
 #define COLOR_BG             (Color){30, 30, 30, 255}      // Dark background
@@ -30,6 +31,9 @@
 #define COLOR_GRID           (Color){50, 50, 50, 128}      // Grid lines
 #define COLOR_TIMELINE_BG    (Color){25, 25, 25, 255}      // Timeline background
 #define COLOR_SELECTION      (Color){100, 150, 230, 100}   // Selection highlight
+#define COLOR_TRACK_BG       (Color){35, 35, 35, 255}      // Track lane
+#define COLOR_TRACK_BORDER   (Color){55, 55, 55, 255}      // Track separator
+#define COLOR_TIMELINE_CURSOR (Color){255, 60, 60, 255}    // Playhead
 
 // Enums
 typedef enum {
@@ -59,7 +63,8 @@ typedef enum {
     ELEMENT_TYPE_AUDIO,
     ELEMENT_TYPE_OBJECT,
     ELEMENT_TYPE_EFFECT,
-    ELEMENT_TYPE_EVENT
+    ELEMENT_TYPE_EVENT,
+    ELEMENT_TYPE_PATTERN
 } ElementType;
 
 // Structures
@@ -84,13 +89,15 @@ typedef struct {
     int trackIndex;
     float startTime;
     float duration;
+    int sourceId;           // Asset.id for audio, Pattern.id for pattern elements, -1 for none
+    float sourceOffset;     // Seconds into the source where the element starts
 } TimelineElement;
 
 typedef struct {
     char name[64];
     char type[32];
     int id;
-    Texture2D thumbnail;
+    char path[256];         // Source file on disk, empty for generated assets
 } Asset;
 
 typedef struct {
@@ -103,8 +110,9 @@ typedef struct {
     char name[64];
     int id;
     bool folded;
-    int notes[MAX_NOTES];
+    int* notes;             // Growable, owned by the pattern
     int noteCount;
+    int noteCapacity;
     Color color;
 } Pattern;
 
@@ -121,6 +129,9 @@ typedef struct {
     float timeSignatureDenominator;
     float snapDivision;
     bool showGrid;
+    bool loopEnabled;
+    float loopStart;
+    float loopEnd;
 } TimelineState;
 
 typedef struct {
@@ -134,30 +145,6 @@ typedef struct {
     float minHeight;
 } Panel;
 
-typedef struct {
-    char name[64];
-    float value;
-    float min;
-    float max;
-    bool isActive;
-    char dataType[32];
-} ComponentProperty;
-
-typedef struct {
-    char name[64];
-    ComponentProperty properties[MAX_COMPONENTS];
-    int propertyCount;
-    bool folded;
-} Component;
-
-typedef struct {
-    char name[64];
-    Component components[MAX_COMPONENTS];
-    int componentCount;
-    bool selected;
-    bool folded;
-} GameObject;
-
 typedef struct {
     Rectangle bounds;
     char text[MAX_INPUT_LEN];
@@ -169,7 +156,8 @@ typedef struct {
 // File browser structure
 typedef struct {
     char currentDirectory[512];
-    FilePathList files;
+    DirScanner* scanner;
+    DirListing* listing;    // Filled in the background, may still be scanning
     int selectedFile;
     Vector2 scrollPosition;
 } FileBrowser;
@@ -183,6 +171,18 @@ typedef struct {
     char projectName[64];
     char projectPath[256];
     bool projectModified;
+    uint32_t editVersion;      // Bumped by every recorded edit, journal replay and ClearProjectData
+    struct Journal* journal;   // Autosave journal, NULL until a project is open
+    uint64_t saveTicket;       // Journal compaction a save is waiting on, 0 if none
+    uint64_t saveRecords;      // Journal records appended when that save was requested
+    struct Mixer* mixer;       // Audio engine, NULL without an audio device
+    bool ownsAudioDevice;      // InitApp opened the device and UnloadApp closes it
+    struct DiskStreamer* streamer;  // Plays audio elements into the mixer, NULL with it
+    struct Sequencer* sequencer;    // Plays pattern elements into the mixer, NULL with it
+    struct ThumbnailCache* thumbnails;  // Asset thumbnails, NULL until the window is open
+    struct PeakCache* peakCache;        // Waveforms of audio assets, NULL until the window is open
+    struct AssetDatabase* assetDatabase;    // Import artifacts, NULL without the window or a job system
+    struct History* history;        // Undo steps for the open project
     
     // UI state
     Panel panels[PANEL_COUNT];
@@ -191,33 +191,43 @@ typedef struct {
     Vector2 dragOffset;
     bool showMixer;
     bool showPatternEditor;
-    int selectedAssetIndex;
+    PoolHandle selectedAsset;
     
     // Timeline data
     TimelineState timeline;
     Track tracks[MAX_TIMELINE_TRACKS];
     int trackCount;
-    TimelineElement elements[MAX_ASSETS];
-    int elementCount;
-    int selectedElementIndex;
+    Pool elements;                  // TimelineElement
+    PoolHandle selectedElement;
+    TimelineIndex timelineIndex;    // Per-track interval index over element slots
+    struct TimelinePeaks* timelinePeaks;    // Waveforms the timeline has shown, sorted by asset id
+    int timelinePeakCount;
+    int timelinePeakCapacity;
     
     // Asset data
-    Asset assets[MAX_ASSETS];
-    int assetCount;
+    Pool assets;                    // Asset
+    uint32_t* assetOrder;           // Live asset slots in grid order, rebuilt when the pool changes
+    uint32_t assetOrderCount;
+    uint32_t assetOrderCapacity;
+    uint32_t assetOrderVersion;     // assets.version the order was built from
     
     // Recent projects
     RecentProject recentProjects[MAX_RECENT_PROJECTS];
     int recentProjectCount;
     
     // Pattern data
-    Pattern patterns[MAX_PATTERNS];
-    int patternCount;
-    int selectedPatternIndex;
+    Pool patterns;                  // Pattern
+    PoolHandle selectedPattern;
     
-    // Game objects
-    GameObject gameObjects[MAX_ASSETS];
-    int gameObjectCount;
-    int selectedGameObjectIndex;
+    // Scene entities, components are declared in scene.h
+    EcsWorld scene;
+    Entity selectedEntity;
+    Bvh sceneBounds;                // World bounds of entities with a transform and a sprite
+    int32_t* sceneProxies;          // Bvh proxy per entity slot, BVH_NULL_PROXY for none
+    uint32_t sceneProxyCapacity;
+    uint32_t* sceneVisible;         // Scratch for the entity slots drawn this frame
+    uint32_t sceneVisibleCount;
+    uint32_t sceneVisibleCapacity;
     
     // Current frame time
     float deltaTime;
@@ -245,7 +255,15 @@ typedef struct {
     float splashTimer;
 } AppState;
 
-// Core initialization function
-void InitApp(AppState *app);
+// Core initialization functions. jobs may be NULL, which leaves out the
+// asset database; it has to outlive the app.
+struct JobSystem;
+void InitApp(AppState *app, struct JobSystem *jobs);
+void UnloadApp(AppState *app);
+void ClearProjectData(AppState *app);
+
+// Growable child storage
+int* AddPatternNote(Pattern* pattern, int note);
+void FreePattern(Pattern* pattern);
 
 #endif // APP_STATE_H
@@ -0,0 +1,990 @@
+#include "asset_database.h"
+#include "mapped_file.h"
+#include "profiler.h"
+#include "vtf.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define strcasecmp _stricmp
+    #define strncasecmp _strnicmp
+#endif
+
+#define ASSET_HASH_BASIS 14695981039346656037ull
+#define ASSET_INITIAL_BUCKETS 256
+#define ASSET_RACY_MARGIN_NS 100000000ll      // File times come from a coarser clock than timespec_get
+
+typedef struct {
+    AssetKind kind;
+    uint32_t version;                   // Bumping it reimports everything of the kind
+    const char* extensions[12];
+} AssetImporter;
+
+static const AssetImporter importers[] = {
+    { ASSET_KIND_TEXTURE, 1, { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".qoi", ".psd", ".hdr", ".vtf" } },
+    { ASSET_KIND_MATERIAL, 2, { ".vmt" } },
+};
+
+// Material parameters that name a texture
+static const char* textureParameters[] = {
+    "$basetexture", "$basetexture2", "$bumpmap", "$bumpmap2", "$normalmap", "$detail", "$envmapmask",
+    "$selfillummask", "$blendmodulatetexture", "$phongexponenttexture", "$lightwarptexture", "$tintmasktexture"
+};
+
+// Saved as is, after the header
+typedef struct {
+    char path[ASSET_MAX_PATH];
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t contentHash;
+    uint64_t artifactKey;               // Key of the artifact on disk
+    uint64_t attemptKey;                // Key of the last import, failed ones included
+    uint32_t kind;
+    uint32_t state;
+    uint32_t dependencyCount;
+    int32_t dependencies[ASSET_MAX_DEPENDENCIES];
+} AssetEntry;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t entrySize;
+    uint32_t count;
+    int64_t refreshTime;                // When the last refresh started
+} AssetDatabaseHeader;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;
+    uint64_t key;
+    uint64_t payloadSize;
+} AssetArtifactHeader;
+
+// Texture payload: this, then width * height RGBA8 pixels
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+} TextureArtifact;
+
+// Material payload: a count, then this per texture parameter
+typedef struct {
+    char parameter[32];
+    char texture[ASSET_MAX_PATH];
+    uint64_t textureKey;                // Key the texture was imported under
+} MaterialArtifactTexture;
+
+// What a refresh found out about one source
+typedef struct {
+    bool skip;                          // Import in flight
+    bool exists;
+    bool hashed;
+    bool artifactOnDisk;                // The current artifact's file is still there
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+    int dependencyCount;
+    char (*dependencies)[ASSET_MAX_PATH];
+} AssetCheck;
+
+// One round of checks: the records as they were when it started, so the
+// main thread can keep adding and updating them meanwhile
+typedef struct {
+    const AssetDatabase* db;
+    AssetEntry* entries;                // Copies of [first, first + count)
+    AssetCheck* checks;
+    int first;
+    int count;
+    int64_t previousRefresh;
+    atomic_int next;
+} AssetCheckBatch;
+
+typedef struct {
+    AssetDatabase* db;
+    int asset;
+    AssetKind kind;
+    uint64_t key;
+    char path[ASSET_MAX_PATH];
+    int dependencyCount;
+    char dependencies[ASSET_MAX_DEPENDENCIES][ASSET_MAX_PATH];
+    uint64_t dependencyKeys[ASSET_MAX_DEPENDENCIES];
+    bool succeeded;
+} AssetImport;
+
+struct AssetDatabase {
+    char directory[512];
+    JobSystem* jobs;
+
+    AssetEntry* entries;
+    JobHandle* imports;                 // Per entry, the import in flight
+    bool* artifactOnDisk;               // Per entry, whether artifactKey's file was there when last checked
+    int count;
+    int capacity;
+
+    int* buckets;                       // Entry index + 1 by path hash, 0 when empty
+    int bucketCount;
+
+    AssetDatabaseStats stats;
+    int64_t refreshTime;                // Start of the last refresh, ns since the Unix epoch
+    AssetCheckBatch* refresh;           // Round of checks in flight, NULL when idle
+    JobHandle refreshJob;               // Its last job, whose callback applies it
+    int64_t refreshStart;
+    bool refreshAgain;                  // Asked for while one was running
+    atomic_uint tmpFiles;
+    bool dirty;
+};
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ".PNG" -> ".png"; false without an extension or with a long one
+static bool GetLowerExtension(const char* path, char* lower, size_t size) {
+    const char* dot = strrchr(path, '.');
+    if (!dot || strchr(dot, '/')) return false;
+    size_t length = strlen(dot);
+    if (length >= size) return false;
+    for (size_t i = 0; i <= length; i++) lower[i] = (char)(dot[i] >= 'A' && dot[i] <= 'Z' ? dot[i] + 32 : dot[i]);
+    return true;
+}
+
+static const AssetImporter* FindImporter(const char* path) {
+    char lower[8];
+    if (!GetLowerExtension(path, lower, sizeof(lower))) return NULL;
+    for (size_t i = 0; i < sizeof(importers) / sizeof(importers[0]); i++) {
+        for (const char* const* extension = importers[i].extensions; *extension; extension++) {
+            if (strcmp(lower, *extension) == 0) return &importers[i];
+        }
+    }
+    return NULL;
+}
+
+static const AssetImporter* GetImporter(AssetKind kind) {
+    for (size_t i = 0; i < sizeof(importers) / sizeof(importers[0]); i++) {
+        if (importers[i].kind == kind) return &importers[i];
+    }
+    return &importers[0];
+}
+
+static void GetArtifactPath(const char* directory, uint64_t key, char* buffer, size_t bufferSize) {
+    snprintf(buffer, bufferSize, "%s/%016llx%s", directory, (unsigned long long)key, ASSET_ARTIFACT_EXTENSION);
+}
+
+static bool ArtifactExists(const AssetDatabase* db, uint64_t key) {
+    char path[560];
+    struct stat st;
+    GetArtifactPath(db->directory, key, path, sizeof(path));
+    return stat(path, &st) == 0;
+}
+
+//----------------------------------------------------------------------------------
+// Materials
+//----------------------------------------------------------------------------------
+
+// Next KeyValues token: a quoted string, a bare word or a brace. Comments are skipped.
+static const char* NextToken(const char* text, const char* end, char* token, size_t size) {
+    for (;;) {
+        while (text < end && (unsigned char)*text <= ' ') text++;
+        if (text + 1 < end && text[0] == '/' && text[1] == '/') {
+            while (text < end && *text != '\n') text++;
+            continue;
+        }
+        break;
+    }
+    if (text >= end) return NULL;
+
+    size_t length = 0;
+    if (*text == '{' || *text == '}') {
+        token[length++] = *text++;
+    } else if (*text == '"') {
+        for (text++; text < end && *text != '"'; text++) {
+            if (length + 1 < size) token[length++] = *text;
+        }
+        if (text < end) text++;
+    } else {
+        for (; text < end && (unsigned char)*text > ' ' && *text != '{' && *text != '}' && *text != '"'; text++) {
+            if (length + 1 < size) token[length++] = *text;
+        }
+    }
+    token[length] = '\0';
+    return text;
+}
+
+static bool IsTextureParameter(const char* key) {
+    for (size_t i = 0; i < sizeof(textureParameters) / sizeof(textureParameters[0]); i++) {
+        if (strcasecmp(key, textureParameters[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Textures are named relative to the "materials" folder the .vmt is in, or
+// to the .vmt's own folder outside of one
+static bool ResolveTexturePath(const char* materialPath, const char* name, char* path, size_t size) {
+    size_t root = 0;
+    for (const char* c = materialPath; *c; c++) {
+        if ((c == materialPath || c[-1] == '/' || c[-1] == '\\') && strncasecmp(c, "materials", 9) == 0 && (c[9] == '/' || c[9] == '\\')) {
+            root = (size_t)(c - materialPath) + 10;
+        }
+    }
+    if (root == 0) {
+        const char* slash = strrchr(materialPath, '/');
+        root = slash ? (size_t)(slash - materialPath) + 1 : 0;
+    }
+
+    char extension[8];
+    bool hasExtension = GetLowerExtension(name, extension, sizeof(extension));
+    int written = snprintf(path, size, "%.*s%s%s", (int)root, materialPath, name, hasExtension ? "" : ".vtf");
+    if (written < 0 || (size_t)written >= size) return false;
+    // Escaped or doubled separators collapse, so every spelling finds the same record
+    char* out = path + root;
+    for (const char* c = path + root; *c; c++) {
+        char ch = *c == '\\' ? '/' : *c;
+        if (ch == '/' && out > path && out[-1] == '/') continue;
+        *out++ = ch;
+    }
+    *out = '\0';
+    return true;
+}
+
+// Texture parameters of a .vmt, resolved to paths; returns how many
+static int ParseMaterial(const char* materialPath, const unsigned char* data, size_t size,
+                         char (*parameters)[32], char (*textures)[ASSET_MAX_PATH], int maxTextures) {
+    const char* text = (const char*)data;
+    const char* end = text + size;
+    char key[64] = "", token[ASSET_MAX_PATH];
+    bool haveKey = false;
+    int count = 0;
+
+    while (count < maxTextures && (text = NextToken(text, end, token, sizeof(token)))) {
+        if (token[0] == '{' || token[0] == '}') {
+            haveKey = false;
+        } else if (!haveKey) {
+            snprintf(key, sizeof(key), "%s", token);
+            haveKey = true;
+        } else {
+            haveKey = false;
+            if (!IsTextureParameter(key) || !token[0]) continue;
+            if (!ResolveTexturePath(materialPath, token, textures[count], ASSET_MAX_PATH)) continue;
+            if (parameters) snprintf(parameters[count], 32, "%s", key);
+            count++;
+        }
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------------
+// Importing (job system workers)
+//----------------------------------------------------------------------------------
+
+static bool WriteArtifact(AssetDatabase* db, uint64_t key, AssetKind kind, const void* head, size_t headSize, const void* body, size_t bodySize) {
+    char path[560], tmpPath[580];
+    GetArtifactPath(db->directory, key, path, sizeof(path));
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%u.tmp", path, atomic_fetch_add(&db->tmpFiles, 1));
+
+    AssetArtifactHeader header = { ASSET_ARTIFACT_MAGIC, ASSET_ARTIFACT_VERSION, (uint16_t)kind, key, headSize + bodySize };
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 && fwrite(head, 1, headSize, out) == headSize &&
+              (bodySize == 0 || fwrite(body, 1, bodySize, out) == bodySize);
+    ok = fclose(out) == 0 && ok;
+    if (ok) {
+#if defined(_WIN32)
+        remove(path);
+#endif
+        ok = rename(tmpPath, path) == 0;
+    }
+    if (!ok) remove(tmpPath);
+    return ok;
+}
+
+static bool ImportTexture(AssetImport* import, const MappedFile* source) {
+    char extension[8];
+    if (source->size > (size_t)INT32_MAX || !GetLowerExtension(import->path, extension, sizeof(extension))) return false;
+
+    // A VTF carries its own mips, so only the one that fits is decoded
+    Image image = strcmp(extension, ".vtf") == 0 ? LoadVtfImage(source->data, source->size, ASSET_TEXTURE_MAX_SIZE)
+                                                 : LoadImageFromMemory(extension, source->data, (int)source->size);
+    if (!image.data || image.width <= 0 || image.height <= 0) {
+        UnloadImage(image);
+        return false;
+    }
+    int longest = image.width > image.height ? image.width : image.height;
+    if (longest > ASSET_TEXTURE_MAX_SIZE) {
+        int width = (int)((long long)image.width * ASSET_TEXTURE_MAX_SIZE / longest);
+        int height = (int)((long long)image.height * ASSET_TEXTURE_MAX_SIZE / longest);
+        ImageResize(&image, width > 0 ? width : 1, height > 0 ? height : 1);
+    }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    TextureArtifact texture = { (uint32_t)image.width, (uint32_t)image.height };
+    bool ok = WriteArtifact(import->db, import->key, ASSET_KIND_TEXTURE, &texture, sizeof(texture),
+                            image.data, (size_t)image.width * image.height * 4);
+    UnloadImage(image);
+    return ok;
+}
+
+static bool ImportMaterial(AssetImport* import, const MappedFile* source) {
+    char parameters[ASSET_MAX_DEPENDENCIES][32];
+    char textures[ASSET_MAX_DEPENDENCIES][ASSET_MAX_PATH];
+    int count = ParseMaterial(import->path, source->data, source->size, parameters, textures, ASSET_MAX_DEPENDENCIES);
+
+    MaterialArtifactTexture entries[ASSET_MAX_DEPENDENCIES];
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < count; i++) {
+        memcpy(entries[i].parameter, parameters[i], sizeof(entries[i].parameter));
+        memcpy(entries[i].texture, textures[i], sizeof(entries[i].texture));
+        for (int d = 0; d < import->dependencyCount; d++) {
+            if (strcmp(import->dependencies[d], textures[i]) == 0) entries[i].textureKey = import->dependencyKeys[d];
+        }
+    }
+    uint32_t header = (uint32_t)count;
+    return WriteArtifact(import->db, import->key, ASSET_KIND_MATERIAL, &header, sizeof(header), entries, count * sizeof(entries[0]));
+}
+
+static void RunImport(void* data) {
+    AssetImport* import = data;
+    PROFILE_SCOPE("ImportAsset");
+    MappedFile source = { 0 };
+    if (!MapFile(import->path, &source)) return;
+    if (import->kind == ASSET_KIND_MATERIAL) import->succeeded = ImportMaterial(import, &source);
+    else import->succeeded = ImportTexture(import, &source);
+    UnmapFile(&source);
+}
+
+// Main thread, from RunJobCallbacks
+static void FinishImport(void* data) {
+    AssetImport* import = data;
+    AssetDatabase* db = import->db;
+    AssetEntry* entry = &db->entries[import->asset];
+    if (import->succeeded) {
+        entry->artifactKey = import->key;
+        entry->state = ASSET_STATE_READY;
+        db->artifactOnDisk[import->asset] = true;
+        db->stats.imported++;
+    } else {
+        entry->state = ASSET_STATE_FAILED;
+        TraceLog(LOG_WARNING, "ASSETS: Failed to import %s", entry->path);
+    }
+    db->imports[import->asset] = JOB_NULL_HANDLE;
+    db->stats.queued--;
+    db->dirty = true;
+    free(import);
+}
+
+//----------------------------------------------------------------------------------
+// Records
+//----------------------------------------------------------------------------------
+
+static uint64_t HashPath(const char* path) {
+    return HashBytes(ASSET_HASH_BASIS, path, strlen(path));
+}
+
+static void InsertBucket(AssetDatabase* db, int asset) {
+    uint32_t mask = (uint32_t)db->bucketCount - 1;
+    uint32_t bucket = (uint32_t)HashPath(db->entries[asset].path) & mask;
+    while (db->buckets[bucket]) bucket = (bucket + 1) & mask;
+    db->buckets[bucket] = asset + 1;
+}
+
+static bool RebuildBuckets(AssetDatabase* db, int bucketCount) {
+    int* buckets = calloc((size_t)bucketCount, sizeof(int));
+    if (!buckets) return false;
+    free(db->buckets);
+    db->buckets = buckets;
+    db->bucketCount = bucketCount;
+    for (int i = 0; i < db->count; i++) InsertBucket(db, i);
+    return true;
+}
+
+static bool ReserveAssets(AssetDatabase* db, int needed) {
+    if (needed <= db->capacity) return true;
+    int capacity = db->capacity ? db->capacity * 2 : 64;
+    while (capacity < needed) capacity *= 2;
+
+    AssetEntry* entries = realloc(db->entries, (size_t)capacity * sizeof(AssetEntry));
+    if (!entries) return false;
+    db->entries = entries;
+    JobHandle* imports = realloc(db->imports, (size_t)capacity * sizeof(JobHandle));
+    if (!imports) return false;
+    db->imports = imports;
+    bool* artifactOnDisk = realloc(db->artifactOnDisk, (size_t)capacity * sizeof(bool));
+    if (!artifactOnDisk) return false;
+    db->artifactOnDisk = artifactOnDisk;
+    db->capacity = capacity;
+    return true;
+}
+
+int FindAsset(const AssetDatabase* db, const char* path) {
+    if (!db || !path || db->bucketCount == 0) return ASSET_NONE;
+    uint32_t mask = (uint32_t)db->bucketCount - 1;
+    for (uint32_t bucket = (uint32_t)HashPath(path) & mask; db->buckets[bucket]; bucket = (bucket + 1) & mask) {
+        int asset = db->buckets[bucket] - 1;
+        if (strcmp(db->entries[asset].path, path) == 0) return asset;
+    }
+    return ASSET_NONE;
+}
+
+int AddAsset(AssetDatabase* db, const char* path) {
+    if (!db || !path || !path[0]) return ASSET_NONE;
+    int existing = FindAsset(db, path);
+    if (existing != ASSET_NONE) return existing;
+
+    const AssetImporter* importer = FindImporter(path);
+    if (!importer || strlen(path) >= ASSET_MAX_PATH) return ASSET_NONE;
+    if (!ReserveAssets(db, db->count + 1)) return ASSET_NONE;
+    if ((db->count + 1) * 2 > db->bucketCount && !RebuildBuckets(db, db->bucketCount ? db->bucketCount * 2 : ASSET_INITIAL_BUCKETS)) {
+        return ASSET_NONE;
+    }
+
+    int asset = db->count++;
+    AssetEntry* entry = &db->entries[asset];
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->path, path);
+    entry->kind = importer->kind;
+    entry->state = ASSET_STATE_NEW;
+    db->imports[asset] = JOB_NULL_HANDLE;
+    db->artifactOnDisk[asset] = false;
+    InsertBucket(db, asset);
+    db->dirty = true;
+    return asset;
+}
+
+void AddProjectAssets(AssetDatabase* db, const AppState* app) {
+    if (!db || !app) return;
+    for (uint32_t slot = 0; slot < app->assets.slotCount; slot++) {
+        const Asset* asset = PoolAt(&app->assets, slot);
+        if (asset && asset->path[0]) AddAsset(db, asset->path);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Refresh
+//----------------------------------------------------------------------------------
+
+// Reads the source only when its size or time moved. A source whose time is
+// not older than the previous refresh is racy: it may have been written again
+// within the same tick after that refresh read it, so it is always read.
+// The artifact is stat'ed here too, so scheduling imports does not have to.
+// Workers, on the batch's copy of the record.
+static void CheckAsset(const AssetCheckBatch* batch, const AssetEntry* entry, AssetCheck* check) {
+    check->artifactOnDisk = entry->artifactKey != 0 && ArtifactExists(batch->db, entry->artifactKey);
+    check->exists = GetFileInfo(entry->path, &check->size, &check->mtime);
+    if (!check->exists) return;
+    bool known = entry->state != ASSET_STATE_NEW && entry->state != ASSET_STATE_MISSING;
+    bool racy = entry->sourceMtime >= batch->previousRefresh - ASSET_RACY_MARGIN_NS;
+    if (known && !racy && check->size == entry->sourceSize && check->mtime == entry->sourceMtime) {
+        check->hash = entry->contentHash;
+        return;
+    }
+
+    MappedFile source = { 0 };
+    if (!MapFile(entry->path, &source) && check->size > 0) {
+        check->exists = false;
+        return;
+    }
+    check->hashed = true;
+    check->hash = HashBytes(ASSET_HASH_BASIS, source.data, source.size);
+
+    if (entry->kind == ASSET_KIND_MATERIAL) {
+        check->dependencies = malloc(ASSET_MAX_DEPENDENCIES * sizeof(*check->dependencies));
+        if (check->dependencies) {
+            check->dependencyCount = ParseMaterial(entry->path, source.data, source.size, NULL, check->dependencies, ASSET_MAX_DEPENDENCIES);
+        }
+    }
+    UnmapFile(&source);
+}
+
+static void RunCheckBatch(AssetCheckBatch* batch) {
+    PROFILE_SCOPE("CheckAssets");
+    for (int i = atomic_fetch_add(&batch->next, 1); i < batch->count; i = atomic_fetch_add(&batch->next, 1)) {
+        if (!batch->checks[i].skip) CheckAsset(batch, &batch->entries[i], &batch->checks[i]);
+    }
+}
+
+static void CheckBatchJob(void* data) {
+    RunCheckBatch(data);
+}
+
+static void FreeCheckBatch(AssetCheckBatch* batch) {
+    if (!batch) return;
+    for (int i = 0; batch->checks && i < batch->count; i++) free(batch->checks[i].dependencies);
+    free(batch->checks);
+    free(batch->entries);
+    free(batch);
+}
+
+static void ApplyCheck(AssetDatabase* db, int asset, AssetCheck* check) {
+    AssetEntry* entry = &db->entries[asset];
+    db->artifactOnDisk[asset] = check->artifactOnDisk;
+    if (!check->exists) {
+        if (entry->state != ASSET_STATE_MISSING) {
+            entry->state = ASSET_STATE_MISSING;
+            db->dirty = true;
+        }
+        return;
+    }
+    if (!check->hashed) {
+        db->stats.unchanged++;
+        return;
+    }
+
+    db->stats.hashed++;
+    db->dirty = true;
+    if (entry->state == ASSET_STATE_MISSING) entry->state = ASSET_STATE_NEW;
+    entry->sourceSize = check->size;
+    entry->sourceMtime = check->mtime;
+    bool changed = check->hash != entry->contentHash || entry->state == ASSET_STATE_NEW;
+    entry->contentHash = check->hash;
+    if (!changed || !check->dependencies) return;
+
+    // Registering a dependency may move the records
+    int dependencies[ASSET_MAX_DEPENDENCIES];
+    int dependencyCount = 0;
+    for (int i = 0; i < check->dependencyCount; i++) {
+        int dependency = AddAsset(db, check->dependencies[i]);
+        if (dependency != ASSET_NONE && dependency != asset) dependencies[dependencyCount++] = dependency;
+    }
+    entry = &db->entries[asset];
+    entry->dependencyCount = (uint32_t)dependencyCount;
+    memcpy(entry->dependencies, dependencies, (size_t)dependencyCount * sizeof(int));
+}
+
+// Content, importer version and every dependency's path and key, so a change
+// anywhere below an asset changes its key. The paths are part of it because
+// they are part of the artifact: the same .vmt in another folder names other
+// textures, even when those have the same content.
+static uint64_t ComputeKey(AssetDatabase* db, int asset, uint64_t* keys, unsigned char* visits) {
+    if (visits[asset] == 2) return keys[asset];
+    AssetEntry* entry = &db->entries[asset];
+    if (visits[asset] == 1) {
+        TraceLog(LOG_WARNING, "ASSETS: Dependency cycle through %s", entry->path);
+        return entry->contentHash;
+    }
+
+    uint64_t key;
+    if (entry->state == ASSET_STATE_QUEUED) {
+        key = entry->attemptKey;
+    } else if (entry->state == ASSET_STATE_MISSING) {
+        key = entry->artifactKey;
+    } else {
+        visits[asset] = 1;
+        uint32_t version = GetImporter((AssetKind)entry->kind)->version;
+        key = HashBytes(ASSET_HASH_BASIS, &entry->contentHash, sizeof(entry->contentHash));
+        key = HashBytes(key, &entry->kind, sizeof(entry->kind));
+        key = HashBytes(key, &version, sizeof(version));
+        for (uint32_t i = 0; i < entry->dependencyCount; i++) {
+            const char* path = db->entries[entry->dependencies[i]].path;
+            uint64_t dependency = ComputeKey(db, entry->dependencies[i], keys, visits);
+            key = HashBytes(key, path, strlen(path) + 1);
+            key = HashBytes(key, &dependency, sizeof(dependency));
+        }
+        if (key == 0) key = 1;          // 0 means no artifact
+    }
+    keys[asset] = key;
+    visits[asset] = 2;
+    return key;
+}
+
+// Dependencies first, so their jobs can be waited on
+static void ScheduleImport(AssetDatabase* db, int asset, const uint64_t* keys, unsigned char* visits) {
+    if (visits[asset] == 3) return;
+    visits[asset] = 3;
+    AssetEntry* entry = &db->entries[asset];
+    JobHandle waits[ASSET_MAX_DEPENDENCIES];
+    for (uint32_t i = 0; i < entry->dependencyCount; i++) {
+        ScheduleImport(db, entry->dependencies[i], keys, visits);
+        waits[i] = db->imports[entry->dependencies[i]];
+    }
+
+    uint64_t key = keys[asset];
+    if (entry->state == ASSET_STATE_QUEUED || entry->state == ASSET_STATE_MISSING) return;
+    if (entry->state == ASSET_STATE_FAILED && entry->attemptKey == key) return;
+    // Up to date only while the artifact is still on disk; one deleted from
+    // the cache is imported again under the same key. The check already
+    // looked for the current artifact, so only a moved key is stat'ed here.
+    bool onDisk = key == entry->artifactKey ? db->artifactOnDisk[asset] : ArtifactExists(db, key);
+    if (onDisk) {
+        db->artifactOnDisk[asset] = true;
+        if (entry->state == ASSET_STATE_READY && entry->artifactKey == key) return;
+        db->dirty = true;
+        entry->artifactKey = key;
+        entry->state = ASSET_STATE_READY;
+        db->stats.reused++;
+        return;
+    }
+
+    AssetImport* import = calloc(1, sizeof(AssetImport));
+    if (!import) return;
+    import->db = db;
+    import->asset = asset;
+    import->kind = (AssetKind)entry->kind;
+    import->key = key;
+    memcpy(import->path, entry->path, sizeof(import->path));
+    for (uint32_t i = 0; i < entry->dependencyCount; i++) {
+        const AssetEntry* dependency = &db->entries[entry->dependencies[i]];
+        memcpy(import->dependencies[i], dependency->path, ASSET_MAX_PATH);
+        import->dependencyKeys[i] = keys[entry->dependencies[i]];
+    }
+    import->dependencyCount = (int)entry->dependencyCount;
+
+    db->dirty = true;
+    entry->state = ASSET_STATE_QUEUED;
+    entry->attemptKey = key;
+    db->stats.queued++;
+    db->stats.scheduled++;
+    db->imports[asset] = ScheduleJob(db->jobs, (JobDesc){ RunImport, FinishImport, import, JOB_PRIORITY_BULK }, waits, (int)entry->dependencyCount);
+}
+
+static void StartCheckRound(AssetDatabase* db, int first);
+
+// Main thread, from RunJobCallbacks once every check of the round is done
+static void FinishCheckRound(void* data) {
+    AssetCheckBatch* batch = data;
+    AssetDatabase* db = (AssetDatabase*)batch->db;
+    for (int i = 0; i < batch->count; i++) {
+        if (!batch->checks[i].skip) ApplyCheck(db, batch->first + i, &batch->checks[i]);
+    }
+    int next = batch->first + batch->count;
+    FreeCheckBatch(batch);
+    db->refresh = NULL;
+    db->refreshJob = JOB_NULL_HANDLE;
+
+    // Materials can register new textures, which are checked in another round
+    if (next < db->count) {
+        StartCheckRound(db, next);
+        if (db->refresh) return;
+    }
+
+    uint64_t* keys = malloc((size_t)db->count * sizeof(uint64_t));
+    unsigned char* visits = calloc((size_t)db->count, 1);
+    if (keys && visits) {
+        for (int i = 0; i < db->count; i++) ComputeKey(db, i, keys, visits);
+        for (int i = 0; i < db->count; i++) ScheduleImport(db, i, keys, visits);
+        db->refreshTime = db->refreshStart;
+    }
+    free(keys);
+    free(visits);
+
+    if (db->refreshAgain) {
+        db->refreshAgain = false;
+        StartAssetRefresh(db);
+    }
+}
+
+// Checks are handed out one at a time, so a few large changed files do
+// not leave the other workers idle. The last job waits for the helpers
+// and applies the round from its callback.
+static void StartCheckRound(AssetDatabase* db, int first) {
+    AssetCheckBatch* batch = calloc(1, sizeof(AssetCheckBatch));
+    int count = db->count - first;
+    if (!batch) return;
+    batch->db = db;
+    batch->first = first;
+    batch->count = count;
+    batch->previousRefresh = db->refreshTime;
+    atomic_init(&batch->next, 0);
+    batch->entries = malloc((size_t)count * sizeof(AssetEntry));
+    batch->checks = calloc((size_t)count, sizeof(AssetCheck));
+    if (!batch->entries || !batch->checks) {
+        FreeCheckBatch(batch);
+        return;
+    }
+    memcpy(batch->entries, &db->entries[first], (size_t)count * sizeof(AssetEntry));
+    for (int i = 0; i < count; i++) batch->checks[i].skip = batch->entries[i].state == ASSET_STATE_QUEUED;
+
+    JobHandle helpers[JOB_SYSTEM_MAX_WORKERS];
+    int helperCount = GetJobWorkerCount(db->jobs);
+    if (helperCount > count - 1) helperCount = count - 1;
+    for (int i = 0; i < helperCount; i++) {
+        helpers[i] = ScheduleJob(db->jobs, (JobDesc){ CheckBatchJob, NULL, batch, JOB_PRIORITY_INTERACTIVE }, NULL, 0);
+    }
+    // Without a job system this finishes the round, and possibly the refresh, right here
+    db->refresh = batch;
+    JobHandle last = ScheduleJob(db->jobs, (JobDesc){ CheckBatchJob, FinishCheckRound, batch, JOB_PRIORITY_INTERACTIVE }, helpers, helperCount);
+    if (db->refresh == batch) db->refreshJob = last;
+}
+
+void StartAssetRefresh(AssetDatabase* db) {
+    if (!db) return;
+    if (db->refresh) {
+        db->refreshAgain = true;
+        return;
+    }
+    PROFILE_SCOPE("StartAssetRefresh");
+    db->stats.unchanged = 0;
+    db->stats.hashed = 0;
+    db->stats.reused = 0;
+    db->stats.scheduled = 0;
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    db->refreshStart = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+    if (db->count > 0) StartCheckRound(db, 0);
+}
+
+static void WaitForAssetRefresh(AssetDatabase* db) {
+    while (db->refresh || db->refreshAgain) {
+        if (!db->refresh) {
+            db->refreshAgain = false;
+            StartAssetRefresh(db);
+            continue;
+        }
+        WaitForJob(db->jobs, db->refreshJob);
+        RunJobCallbacks(db->jobs);
+    }
+}
+
+int RefreshAssets(AssetDatabase* db) {
+    if (!db) return 0;
+    PROFILE_SCOPE("RefreshAssets");
+    WaitForAssetRefresh(db);
+    StartAssetRefresh(db);
+    WaitForAssetRefresh(db);
+    return db->stats.scheduled;
+}
+
+bool IsAssetRefreshPending(const AssetDatabase* db) {
+    return db && (db->refresh || db->refreshAgain);
+}
+
+void WaitForAssetImports(AssetDatabase* db) {
+    if (!db) return;
+    WaitForAssetRefresh(db);
+    while (db->stats.queued > 0) {
+        for (int i = 0; i < db->count; i++) {
+            if (db->entries[i].state == ASSET_STATE_QUEUED) WaitForJob(db->jobs, db->imports[i]);
+        }
+        RunJobCallbacks(db->jobs);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Database
+//----------------------------------------------------------------------------------
+
+static void LoadAssetDatabase(AssetDatabase* db) {
+    char path[560];
+    snprintf(path, sizeof(path), "%s/%s", db->directory, ASSET_DATABASE_FILE);
+    MappedFile file;
+    if (!MapFile(path, &file)) return;
+
+    AssetDatabaseHeader header;
+    bool valid = file.size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, file.data, sizeof(header));
+        valid = header.magic == ASSET_DATABASE_MAGIC && header.version == ASSET_DATABASE_VERSION &&
+                header.entrySize == sizeof(AssetEntry) &&
+                header.count <= (file.size - sizeof(header)) / sizeof(AssetEntry) && ReserveAssets(db, (int)header.count);
+    }
+    if (!valid) {
+        TraceLog(LOG_WARNING, "ASSETS: Ignoring unreadable %s, everything will be checked again", path);
+        UnmapFile(&file);
+        return;
+    }
+
+    memcpy(db->entries, file.data + sizeof(header), header.count * sizeof(AssetEntry));
+    UnmapFile(&file);
+    db->refreshTime = header.refreshTime;
+
+    // Anything out of range is dropped rather than trusted
+    for (uint32_t i = 0; i < header.count; i++) {
+        AssetEntry* entry = &db->entries[db->count];
+        if (entry != &db->entries[i]) *entry = db->entries[i];
+        entry->path[ASSET_MAX_PATH - 1] = '\0';
+        if (!entry->path[0] || entry->kind >= ASSET_KIND_COUNT || entry->state > ASSET_STATE_FAILED) continue;
+        if (entry->state == ASSET_STATE_QUEUED) entry->state = ASSET_STATE_NEW;   // Closed mid-import
+        if (entry->dependencyCount > ASSET_MAX_DEPENDENCIES) entry->dependencyCount = 0;
+        for (uint32_t d = 0; d < entry->dependencyCount; d++) {
+            if (entry->dependencies[d] < 0 || (uint32_t)entry->dependencies[d] >= header.count) entry->dependencyCount = 0;
+        }
+        db->artifactOnDisk[db->count] = false;
+        db->imports[db->count++] = JOB_NULL_HANDLE;
+    }
+    if (db->count < (int)header.count) {
+        // Indices moved; the survivors' dependencies are found again on their next change
+        for (int i = 0; i < db->count; i++) db->entries[i].dependencyCount = 0;
+    }
+
+    int buckets = ASSET_INITIAL_BUCKETS;
+    while (buckets < db->count * 2) buckets *= 2;
+    if (!RebuildBuckets(db, buckets)) db->count = 0;
+}
+
+bool SaveAssetDatabase(AssetDatabase* db) {
+    if (!db) return false;
+    char path[560], tmpPath[580];
+    snprintf(path, sizeof(path), "%s/%s", db->directory, ASSET_DATABASE_FILE);
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    AssetDatabaseHeader header = { ASSET_DATABASE_MAGIC, ASSET_DATABASE_VERSION, 0, sizeof(AssetEntry), (uint32_t)db->count, db->refreshTime };
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) {
+        TraceLog(LOG_WARNING, "ASSETS: Could not write %s", tmpPath);
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(db->entries, sizeof(AssetEntry), (size_t)db->count, out) == (size_t)db->count;
+    ok = fclose(out) == 0 && ok;
+    if (ok) {
+#if defined(_WIN32)
+        remove(path);
+#endif
+        ok = rename(tmpPath, path) == 0;
+    }
+    if (!ok) {
+        remove(tmpPath);
+        TraceLog(LOG_WARNING, "ASSETS: Could not save %s", path);
+        return false;
+    }
+    db->dirty = false;
+    return true;
+}
+
+AssetDatabase* CreateAssetDatabase(const char* directory, JobSystem* jobs) {
+    if (!directory || strlen(directory) >= sizeof(((AssetDatabase*)0)->directory)) return NULL;
+    AssetDatabase* db = calloc(1, sizeof(AssetDatabase));
+    if (!db) return NULL;
+    strcpy(db->directory, directory);
+    mkdir(db->directory, 0777);
+    db->jobs = jobs;
+    atomic_init(&db->tmpFiles, 0);
+    LoadAssetDatabase(db);
+    return db;
+}
+
+void DestroyAssetDatabase(AssetDatabase* db) {
+    if (!db) return;
+    WaitForAssetImports(db);
+    if (db->dirty) SaveAssetDatabase(db);
+    free(db->entries);
+    free(db->imports);
+    free(db->artifactOnDisk);
+    free(db->buckets);
+    free(db);
+}
+
+//----------------------------------------------------------------------------------
+// Queries
+//----------------------------------------------------------------------------------
+
+int GetAssetCount(const AssetDatabase* db) {
+    return db ? db->count : 0;
+}
+
+AssetInfo GetAssetInfo(const AssetDatabase* db, int asset) {
+    AssetInfo info = { 0 };
+    if (!db || asset < 0 || asset >= db->count) return info;
+    const AssetEntry* entry = &db->entries[asset];
+    info.path = entry->path;
+    info.kind = (AssetKind)entry->kind;
+    info.state = (AssetState)entry->state;
+    info.contentHash = entry->contentHash;
+    info.artifactKey = entry->artifactKey;
+    info.dependencyCount = (int)entry->dependencyCount;
+    return info;
+}
+
+int GetAssetDependency(const AssetDatabase* db, int asset, int index) {
+    if (!db || asset < 0 || asset >= db->count) return ASSET_NONE;
+    const AssetEntry* entry = &db->entries[asset];
+    return index >= 0 && (uint32_t)index < entry->dependencyCount ? entry->dependencies[index] : ASSET_NONE;
+}
+
+bool AreAssetImportsPending(const AssetDatabase* db) {
+    return db && (db->stats.queued > 0 || IsAssetRefreshPending(db));
+}
+
+AssetDatabaseStats GetAssetDatabaseStats(const AssetDatabase* db) {
+    AssetDatabaseStats stats = { 0 };
+    if (!db) return stats;
+    stats = db->stats;
+    stats.assets = db->count;
+    stats.failed = 0;
+    for (int i = 0; i < db->count; i++) {
+        if (db->entries[i].state == ASSET_STATE_FAILED) stats.failed++;
+    }
+    return stats;
+}
+
+// Maps the artifact and checks its header; the payload follows it
+static bool MapArtifact(const AssetDatabase* db, int asset, AssetKind kind, MappedFile* file) {
+    if (!db || asset < 0 || asset >= db->count) return false;
+    const AssetEntry* entry = &db->entries[asset];
+    if (entry->kind != kind || entry->artifactKey == 0) return false;
+
+    char path[560];
+    GetArtifactPath(db->directory, entry->artifactKey, path, sizeof(path));
+    if (!MapFile(path, file)) return false;
+    AssetArtifactHeader header;
+    bool valid = file->size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, file->data, sizeof(header));
+        valid = header.magic == ASSET_ARTIFACT_MAGIC && header.version == ASSET_ARTIFACT_VERSION &&
+                header.kind == kind && header.key == entry->artifactKey && header.payloadSize <= file->size - sizeof(header);
+    }
+    if (!valid) UnmapFile(file);
+    return valid;
+}
+
+Image LoadAssetImage(const AssetDatabase* db, int asset) {
+    Image image = { 0 };
+    MappedFile file;
+    if (!MapArtifact(db, asset, ASSET_KIND_TEXTURE, &file)) return image;
+
+    const unsigned char* payload = file.data + sizeof(AssetArtifactHeader);
+    size_t payloadSize = file.size - sizeof(AssetArtifactHeader);
+    TextureArtifact texture;
+    if (payloadSize >= sizeof(texture)) {
+        memcpy(&texture, payload, sizeof(texture));
+        size_t bytes = (size_t)texture.width * texture.height * 4;
+        if (texture.width > 0 && texture.width <= ASSET_TEXTURE_MAX_SIZE && texture.height > 0 &&
+            texture.height <= ASSET_TEXTURE_MAX_SIZE && bytes <= payloadSize - sizeof(texture)) {
+            image.data = MemAlloc((unsigned int)bytes);
+            if (image.data) {
+                memcpy(image.data, payload + sizeof(texture), bytes);
+                image.width = (int)texture.width;
+                image.height = (int)texture.height;
+                image.mipmaps = 1;
+                image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+            }
+        }
+    }
+    UnmapFile(&file);
+    return image;
+}
+
+int GetAssetMaterialTextures(const AssetDatabase* db, int asset, AssetMaterialTexture* textures, int maxTextures) {
+    MappedFile file;
+    if (!textures || maxTextures <= 0 || !MapArtifact(db, asset, ASSET_KIND_MATERIAL, &file)) return 0;
+
+    const unsigned char* payload = file.data + sizeof(AssetArtifactHeader);
+    size_t payloadSize = file.size - sizeof(AssetArtifactHeader);
+    uint32_t count = 0;
+    if (payloadSize >= sizeof(count)) memcpy(&count, payload, sizeof(count));
+    if (count > (payloadSize - sizeof(count)) / sizeof(MaterialArtifactTexture)) count = 0;
+
+    int written = 0;
+    for (uint32_t i = 0; i < count && written < maxTextures; i++) {
+        MaterialArtifactTexture entry;
+        memcpy(&entry, payload + sizeof(count) + i * sizeof(entry), sizeof(entry));
+        entry.parameter[sizeof(entry.parameter) - 1] = '\0';
+        entry.texture[sizeof(entry.texture) - 1] = '\0';
+        memcpy(textures[written].parameter, entry.parameter, sizeof(textures[written].parameter));
+        textures[written].texture = FindAsset(db, entry.texture);
+        written++;
+    }
+    UnmapFile(&file);
+    return written;
+}
@@ -0,0 +1,126 @@
+#ifndef ASSET_DATABASE_H
+#define ASSET_DATABASE_H
+
+#include "raylib.h"
+#include "app_state.h"
+#include "job_system.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Persistent asset database with content-addressed import artifacts.
+//
+// Every source file the project uses is recorded with its size, modification
+// time and content hash, and with the other sources it depends on (a .vmt
+// material on its .vtf textures). Importing a source produces an artifact,
+// a file in the database directory named after its key: a hash of the
+// source content, the importer version and the keys of its dependencies. An
+// edited texture changes its own key and the key of every material using
+// it, and nothing else.
+//
+// A refresh stats every source and only reads the ones whose size or
+// time (in nanoseconds) moved, or whose time is too close to the previous
+// refresh to rule out a same-tick edit since; the same content under a new
+// time is not a change. When the new key already has an artifact on disk
+// (the edit was reverted, or the file is a copy of another) the asset is up
+// to date without importing.
+// The rest are imported on the job system, dependencies first, and their
+// records are updated from RunJobCallbacks. Unchanged assets load straight
+// from their artifacts.
+//
+// The checks themselves run on the job system against a copy of the
+// records, so StartAssetRefresh returns at once and the editor keeps
+// drawing; the imports are scheduled from RunJobCallbacks when the checks
+// are done. Whether each current artifact is still on disk is found out by
+// the checks too, and remembered until the next one.
+//
+// The records are saved as "assets.gbadb" next to the artifacts.
+
+#define ASSET_DATABASE_FILE "assets.gbadb"
+#define ASSET_DATABASE_MAGIC 0x44414247u        // "GBAD"
+#define ASSET_DATABASE_VERSION 2
+#define ASSET_ARTIFACT_EXTENSION ".gbart"
+#define ASSET_ARTIFACT_MAGIC 0x52414247u        // "GBAR"
+#define ASSET_ARTIFACT_VERSION 1
+#define ASSET_MAX_PATH 256
+#define ASSET_MAX_DEPENDENCIES 16
+#define ASSET_TEXTURE_MAX_SIZE 2048             // Longest side kept in texture artifacts
+#define ASSET_NONE -1
+
+typedef struct AssetDatabase AssetDatabase;
+
+typedef enum {
+    ASSET_KIND_TEXTURE,         // Images raylib decodes, and .vtf
+    ASSET_KIND_MATERIAL,        // .vmt, depends on the textures it names
+    ASSET_KIND_COUNT
+} AssetKind;
+
+typedef enum {
+    ASSET_STATE_NEW,            // Not refreshed yet
+    ASSET_STATE_READY,          // The artifact matches the sources
+    ASSET_STATE_QUEUED,         // Import scheduled or running
+    ASSET_STATE_MISSING,        // Source is gone; its last artifact still loads
+    ASSET_STATE_FAILED
+} AssetState;
+
+typedef struct {
+    const char* path;
+    AssetKind kind;
+    AssetState state;
+    uint64_t contentHash;
+    uint64_t artifactKey;       // 0 before the first import
+    int dependencyCount;
+} AssetInfo;
+
+typedef struct {
+    int assets;
+    int queued;                 // Imports in flight
+    int failed;
+    uint64_t imported;          // Since the database was opened
+
+    // Last refresh
+    int unchanged;              // Size and time matched, nothing read
+    int hashed;                 // Read and hashed
+    int reused;                 // Out of date, but an artifact with the new key was on disk
+    int scheduled;
+} AssetDatabaseStats;
+
+typedef struct {
+    char parameter[32];         // "$basetexture"
+    int texture;                // Asset index, ASSET_NONE when the texture is not registered
+} AssetMaterialTexture;
+
+// Lifetime. The directory is created if its parent exists and the saved
+// database in it, if any, is loaded. jobs may be NULL to import on the
+// calling thread. Destroying waits for running imports and saves.
+AssetDatabase* CreateAssetDatabase(const char* directory, JobSystem* jobs);
+void DestroyAssetDatabase(AssetDatabase* db);
+bool SaveAssetDatabase(AssetDatabase* db);
+
+// Sources. AddAsset returns the existing index for a known path, and
+// ASSET_NONE for file types no importer handles.
+int AddAsset(AssetDatabase* db, const char* path);
+int FindAsset(const AssetDatabase* db, const char* path);
+void AddProjectAssets(AssetDatabase* db, const AppState* app);     // Every project asset with a source path
+
+// StartAssetRefresh checks every source on the job system and schedules the
+// imports that are needed once that is done; asked for during a refresh, it
+// runs another one afterwards. RefreshAssets waits for the checks and
+// returns how many imports were scheduled. Main thread.
+void StartAssetRefresh(AssetDatabase* db);
+int RefreshAssets(AssetDatabase* db);
+bool IsAssetRefreshPending(const AssetDatabase* db);
+void WaitForAssetImports(AssetDatabase* db);                        // The refresh too
+
+// Queries
+int GetAssetCount(const AssetDatabase* db);
+AssetInfo GetAssetInfo(const AssetDatabase* db, int asset);
+int GetAssetDependency(const AssetDatabase* db, int asset, int index);
+AssetDatabaseStats GetAssetDatabaseStats(const AssetDatabase* db);
+bool AreAssetImportsPending(const AssetDatabase* db);              // Or a refresh; for RequestBackgroundFrame
+
+// Artifacts. The image is RGBA8 and freed with UnloadImage; both are empty
+// until the asset has been imported once.
+Image LoadAssetImage(const AssetDatabase* db, int asset);
+int GetAssetMaterialTextures(const AssetDatabase* db, int asset, AssetMaterialTexture* textures, int maxTextures);
+
+#endif // ASSET_DATABASE_H
@@ -0,0 +1,364 @@
+#include "atlas.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int x;
+    int y;                      // Top edge of what is placed below this segment
+    int width;
+} SkylineNode;
+
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} AtlasRect;
+
+typedef struct {
+    Texture2D texture;
+    SkylineNode* skyline;       // Left to right, covering the page width
+    int nodeCount;
+    AtlasRect* freeRects;
+    int freeCount;
+    int freeCapacity;
+    int images;
+    uint64_t usedPixels;
+} AtlasPage;
+
+struct Atlas {
+    int pageSize;
+    int maxPages;
+    AtlasPage pages[ATLAS_MAX_PAGES];
+    int pageCount;
+};
+
+static void ResetPage(AtlasPage* page, int pageSize) {
+    page->skyline[0] = (SkylineNode){ 0, 0, pageSize };
+    page->nodeCount = 1;
+    page->freeCount = 0;
+    page->images = 0;
+    page->usedPixels = 0;
+}
+
+static AtlasPage* AddPage(Atlas* atlas) {
+    if (atlas->pageCount >= atlas->maxPages) return NULL;
+    AtlasPage* page = &atlas->pages[atlas->pageCount];
+
+    // A segment is at least a pixel wide, plus one while inserting
+    page->skyline = malloc((size_t)(atlas->pageSize + 1) * sizeof(SkylineNode));
+    if (!page->skyline) return NULL;
+    Image blank = GenImageColor(atlas->pageSize, atlas->pageSize, BLANK);
+    page->texture = LoadTextureFromImage(blank);
+    UnloadImage(blank);
+    if (page->texture.id == 0) {
+        free(page->skyline);
+        page->skyline = NULL;
+        return NULL;
+    }
+    SetTextureFilter(page->texture, TEXTURE_FILTER_BILINEAR);
+    ResetPage(page, atlas->pageSize);
+    atlas->pageCount++;
+    return page;
+}
+
+//----------------------------------------------------------------------------------
+// Packing
+//----------------------------------------------------------------------------------
+
+// Top of an image placed at the start of segment `index`, or -1 if it does not fit
+static int SkylineFit(const AtlasPage* page, int pageSize, int index, int width, int height) {
+    if (page->skyline[index].x + width > pageSize) return -1;
+    int y = 0;
+    for (int i = index, remaining = width; remaining > 0; i++) {
+        if (page->skyline[i].y > y) y = page->skyline[i].y;
+        if (y + height > pageSize) return -1;
+        remaining -= page->skyline[i].width;
+    }
+    return y;
+}
+
+static void RemoveNode(AtlasPage* page, int index) {
+    memmove(&page->skyline[index], &page->skyline[index + 1], (size_t)(page->nodeCount - index - 1) * sizeof(SkylineNode));
+    page->nodeCount--;
+}
+
+static void InsertNode(AtlasPage* page, int index, SkylineNode node) {
+    memmove(&page->skyline[index + 1], &page->skyline[index], (size_t)(page->nodeCount - index) * sizeof(SkylineNode));
+    page->skyline[index] = node;
+    page->nodeCount++;
+}
+
+static void MergeSkyline(AtlasPage* page) {
+    for (int i = 0; i + 1 < page->nodeCount;) {
+        if (page->skyline[i].y == page->skyline[i + 1].y) {
+            page->skyline[i].width += page->skyline[i + 1].width;
+            RemoveNode(page, i + 1);
+        } else {
+            i++;
+        }
+    }
+}
+
+// Bottom-left: the position whose top edge ends lowest, the narrowest segment on ties
+static bool SkylineInsert(AtlasPage* page, int pageSize, int width, int height, AtlasRect* rect) {
+    int best = -1, bestTop = INT_MAX, bestWidth = INT_MAX, bestY = 0;
+    for (int i = 0; i < page->nodeCount; i++) {
+        int y = SkylineFit(page, pageSize, i, width, height);
+        if (y < 0) continue;
+        if (y + height < bestTop || (y + height == bestTop && page->skyline[i].width < bestWidth)) {
+            best = i;
+            bestY = y;
+            bestTop = y + height;
+            bestWidth = page->skyline[i].width;
+        }
+    }
+    if (best < 0) return false;
+    *rect = (AtlasRect){ page->skyline[best].x, bestY, width, height };
+
+    // A new segment on top of the image, cut out of the ones it covers
+    InsertNode(page, best, (SkylineNode){ rect->x, bestTop, width });
+    int end = rect->x + width;
+    for (int i = best + 1; i < page->nodeCount && page->skyline[i].x < end;) {
+        SkylineNode* node = &page->skyline[i];
+        int covered = end - node->x;
+        if (covered < node->width) {
+            node->x += covered;
+            node->width -= covered;
+            break;
+        }
+        RemoveNode(page, i);
+    }
+    MergeSkyline(page);
+    return true;
+}
+
+static void PushFreeRect(AtlasPage* page, AtlasRect rect) {
+    if (rect.width <= 0 || rect.height <= 0) return;
+    if (page->freeCount == page->freeCapacity) {
+        int capacity = page->freeCapacity ? page->freeCapacity * 2 : 16;
+        AtlasRect* rects = realloc(page->freeRects, (size_t)capacity * sizeof(AtlasRect));
+        if (!rects) return;         // The hole is lost until the page empties
+        page->freeRects = rects;
+        page->freeCapacity = capacity;
+    }
+    page->freeRects[page->freeCount++] = rect;
+}
+
+// Segments under a hole, when the hole's bottom edge is the skyline along its
+// whole width
+static bool FindSkylineSpan(const AtlasPage* page, AtlasRect rect, int* first, int* last) {
+    int bottom = rect.y + rect.height, end = rect.x + rect.width;
+    *first = -1;
+    for (int i = 0; i < page->nodeCount && page->skyline[i].x < end; i++) {
+        const SkylineNode* node = &page->skyline[i];
+        if (node->x + node->width <= rect.x) continue;
+        if (node->y != bottom) return false;
+        if (*first < 0) *first = i;
+        *last = i;
+    }
+    return *first >= 0;
+}
+
+// Such a hole goes back above the skyline, so its space is packed again like
+// a fresh page's
+static bool LowerSkyline(AtlasPage* page, AtlasRect rect) {
+    int first, last, end = rect.x + rect.width;
+    if (!FindSkylineSpan(page, rect, &first, &last)) return false;
+
+    // Cut the segments at both edges of the hole, then drop the ones between
+    SkylineNode* node = &page->skyline[first];
+    if (node->x < rect.x) {
+        InsertNode(page, first, (SkylineNode){ node->x, node->y, rect.x - node->x });
+        first++;
+        last++;
+        page->skyline[first].width -= rect.x - page->skyline[first].x;
+        page->skyline[first].x = rect.x;
+    }
+    node = &page->skyline[last];
+    if (node->x + node->width > end) {
+        InsertNode(page, last + 1, (SkylineNode){ end, node->y, node->x + node->width - end });
+        page->skyline[last].width = end - page->skyline[last].x;
+    }
+    for (int i = first; i <= last; i++) page->skyline[i].y = rect.y;
+    MergeSkyline(page);
+    return true;
+}
+
+// Frees a rectangle: holes sharing a whole edge with it are merged into it,
+// and whatever reaches the skyline goes back into it, taking any hole it
+// uncovers along. Without this, space freed one image at a time would stay
+// split into holes too small for anything but images of the same size.
+static void ReleaseRect(AtlasPage* page, AtlasRect rect) {
+    for (;;) {
+        for (int i = 0; i < page->freeCount;) {
+            AtlasRect hole = page->freeRects[i];
+            bool stacked = hole.x == rect.x && hole.width == rect.width &&
+                           (hole.y + hole.height == rect.y || rect.y + rect.height == hole.y);
+            bool sideBySide = hole.y == rect.y && hole.height == rect.height &&
+                              (hole.x + hole.width == rect.x || rect.x + rect.width == hole.x);
+            if (!stacked && !sideBySide) {
+                i++;
+                continue;
+            }
+            if (stacked) {
+                rect.y = hole.y < rect.y ? hole.y : rect.y;
+                rect.height += hole.height;
+            } else {
+                rect.x = hole.x < rect.x ? hole.x : rect.x;
+                rect.width += hole.width;
+            }
+            page->freeRects[i] = page->freeRects[--page->freeCount];
+            i = 0;      // The bigger hole may line up with ones already passed
+        }
+        if (!LowerSkyline(page, rect)) {
+            PushFreeRect(page, rect);
+            return;
+        }
+
+        // The skyline came down; a hole right under it is next
+        int next = -1, first, last;
+        for (int i = 0; i < page->freeCount && next < 0; i++) {
+            if (FindSkylineSpan(page, page->freeRects[i], &first, &last)) next = i;
+        }
+        if (next < 0) return;
+        rect = page->freeRects[next];
+        page->freeRects[next] = page->freeRects[--page->freeCount];
+    }
+}
+
+// Best area fit among the holes; what is left is split along the longer leftover
+static bool FreeRectInsert(AtlasPage* page, int width, int height, AtlasRect* rect) {
+    int best = -1;
+    long long bestArea = LLONG_MAX;
+    for (int i = 0; i < page->freeCount; i++) {
+        const AtlasRect* hole = &page->freeRects[i];
+        long long area = (long long)hole->width * hole->height;
+        if (hole->width >= width && hole->height >= height && area < bestArea) {
+            best = i;
+            bestArea = area;
+        }
+    }
+    if (best < 0) return false;
+
+    AtlasRect hole = page->freeRects[best];
+    page->freeRects[best] = page->freeRects[--page->freeCount];
+    *rect = (AtlasRect){ hole.x, hole.y, width, height };
+
+    int right = hole.width - width;
+    int bottom = hole.height - height;
+    if (right > bottom) {
+        PushFreeRect(page, (AtlasRect){ hole.x + width, hole.y, right, hole.height });
+        PushFreeRect(page, (AtlasRect){ hole.x, hole.y + height, width, bottom });
+    } else {
+        PushFreeRect(page, (AtlasRect){ hole.x + width, hole.y, right, height });
+        PushFreeRect(page, (AtlasRect){ hole.x, hole.y + height, hole.width, bottom });
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Images
+//----------------------------------------------------------------------------------
+
+AtlasRegion AddAtlasImage(Atlas* atlas, Image image) {
+    AtlasRegion region = { 0 };
+    region.page = -1;
+    if (!atlas || !image.data || image.width <= 0 || image.height <= 0) return region;
+
+    int width = image.width + ATLAS_PADDING * 2;
+    int height = image.height + ATLAS_PADDING * 2;
+    if (width > atlas->pageSize || height > atlas->pageSize) return region;
+
+    // Holes first, then the skyline of each page, then a new page
+    AtlasRect rect;
+    AtlasPage* page = NULL;
+    for (int p = 0; p < atlas->pageCount && !page; p++) {
+        if (FreeRectInsert(&atlas->pages[p], width, height, &rect)) page = &atlas->pages[p];
+    }
+    for (int p = 0; p < atlas->pageCount && !page; p++) {
+        if (SkylineInsert(&atlas->pages[p], atlas->pageSize, width, height, &rect)) page = &atlas->pages[p];
+    }
+    if (!page) {
+        page = AddPage(atlas);
+        if (!page || !SkylineInsert(page, atlas->pageSize, width, height, &rect)) return region;
+    }
+
+    // The border is uploaded too, clearing whatever a removed image left there
+    Image rgba = image;
+    if (image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+        rgba = ImageCopy(image);
+        ImageFormat(&rgba, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+    unsigned char* pixels = calloc((size_t)width * height, 4);
+    if (pixels && rgba.data) {
+        for (int y = 0; y < image.height; y++) {
+            memcpy(pixels + ((size_t)(y + ATLAS_PADDING) * width + ATLAS_PADDING) * 4,
+                   (const unsigned char*)rgba.data + (size_t)y * image.width * 4, (size_t)image.width * 4);
+        }
+        UpdateTextureRec(page->texture, (Rectangle){ (float)rect.x, (float)rect.y, (float)width, (float)height }, pixels);
+    }
+    free(pixels);
+    if (rgba.data != image.data) UnloadImage(rgba);
+
+    page->images++;
+    page->usedPixels += (uint64_t)width * height;
+    region.texture = page->texture;
+    region.source = (Rectangle){ (float)(rect.x + ATLAS_PADDING), (float)(rect.y + ATLAS_PADDING), (float)image.width, (float)image.height };
+    region.page = (int)(page - atlas->pages);
+    return region;
+}
+
+AtlasRegion LoadAtlasImage(Atlas* atlas, const char* fileName) {
+    Image image = LoadImage(fileName);
+    AtlasRegion region = AddAtlasImage(atlas, image);
+    UnloadImage(image);
+    return region;
+}
+
+void RemoveAtlasImage(Atlas* atlas, AtlasRegion region) {
+    if (!atlas || region.page < 0 || region.page >= atlas->pageCount || region.texture.id == 0) return;
+    AtlasPage* page = &atlas->pages[region.page];
+
+    AtlasRect rect = {
+        (int)region.source.x - ATLAS_PADDING, (int)region.source.y - ATLAS_PADDING,
+        (int)region.source.width + ATLAS_PADDING * 2, (int)region.source.height + ATLAS_PADDING * 2
+    };
+    page->images--;
+    page->usedPixels -= (uint64_t)rect.width * rect.height;
+    if (page->images == 0) ResetPage(page, atlas->pageSize);
+    else ReleaseRect(page, rect);
+}
+
+AtlasStats GetAtlasStats(const Atlas* atlas) {
+    AtlasStats stats = { 0 };
+    if (!atlas) return stats;
+    stats.pages = atlas->pageCount;
+    for (int p = 0; p < atlas->pageCount; p++) {
+        const AtlasPage* page = &atlas->pages[p];
+        stats.images += page->images;
+        stats.usedPixels += page->usedPixels;
+        stats.freeRects += page->freeCount;
+    }
+    stats.capacityPixels = (uint64_t)atlas->pageCount * atlas->pageSize * atlas->pageSize;
+    return stats;
+}
+
+Atlas* CreateAtlas(int pageSize, int maxPages) {
+    Atlas* atlas = calloc(1, sizeof(Atlas));
+    if (!atlas) return NULL;
+    atlas->pageSize = pageSize > 0 ? pageSize : ATLAS_DEFAULT_PAGE_SIZE;
+    atlas->maxPages = maxPages > 0 && maxPages < ATLAS_MAX_PAGES ? maxPages : ATLAS_MAX_PAGES;
+    return atlas;
+}
+
+void DestroyAtlas(Atlas* atlas) {
+    if (!atlas) return;
+    for (int p = 0; p < atlas->pageCount; p++) {
+        UnloadTexture(atlas->pages[p].texture);
+        free(atlas->pages[p].skyline);
+        free(atlas->pages[p].freeRects);
+    }
+    free(atlas);
+}
@@ -0,0 +1,57 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Texture atlas for small UI images (icons, thumbnails).
+//
+// Images are packed into a few large page textures instead of getting one
+// texture each, so a toolbar or an asset grid is a run of quads on the same
+// texture and the draw list submits it as one batch.
+//
+// Each page is packed with a skyline: the top edge of everything placed so
+// far is kept as a list of horizontal segments, and a new image goes where
+// its top ends up lowest. Removing an image leaves a hole that later images
+// of the same size or smaller reuse, split guillotine-style. Holes sharing a
+// whole edge merge, and one that reaches the skyline goes back into it; a
+// page whose images are all gone starts over empty. Every image carries a transparent
+// border of ATLAS_PADDING pixels, so filtering never picks up a neighbour.
+
+#define ATLAS_DEFAULT_PAGE_SIZE 1024
+#define ATLAS_PADDING 1
+#define ATLAS_MAX_PAGES 16
+
+typedef struct Atlas Atlas;
+
+// Where an image lives. Valid until it is removed or the atlas destroyed;
+// texture.id is 0 when there is no image.
+typedef struct {
+    Texture2D texture;          // The page
+    Rectangle source;           // Pixels of the image within the page
+    int page;
+} AtlasRegion;
+
+typedef struct {
+    int pages;
+    int images;
+    uint64_t usedPixels;        // Images and their padding
+    uint64_t capacityPixels;    // Of the pages created so far
+    int freeRects;              // Holes left by removed images
+} AtlasStats;
+
+// Lifetime; pages are created as they are needed, up to maxPages. Needs the
+// window open, like any texture.
+Atlas* CreateAtlas(int pageSize, int maxPages);
+void DestroyAtlas(Atlas* atlas);
+
+// Copies the image into a page. Returns an empty region when it is larger
+// than a page or every page is full.
+AtlasRegion AddAtlasImage(Atlas* atlas, Image image);
+AtlasRegion LoadAtlasImage(Atlas* atlas, const char* fileName);
+void RemoveAtlasImage(Atlas* atlas, AtlasRegion region);
+
+AtlasStats GetAtlasStats(const Atlas* atlas);
+
+#endif // ATLAS_H
@@ -0,0 +1,334 @@
+#include "bsp.h"
+#include "mapped_file.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BSP_LUMP_ENTRY_SIZE 16
+#define BSP_HEADER_SIZE (8 + BSP_LUMP_COUNT * BSP_LUMP_ENTRY_SIZE + 4)
+#define BSP_LEAF_V0_SIZE 56             // Version 0 leaves, with 24 bytes of ambient lighting
+#define BSP_LEAF_V0_PREFIX 30           // Bytes shared with BspLeaf, up to the lighting
+
+_Static_assert(sizeof(BspPlane) == 20, "BspPlane layout changed");
+_Static_assert(sizeof(BspNode) == 32, "BspNode layout changed");
+_Static_assert(sizeof(BspLeaf) == 32, "BspLeaf layout changed");
+_Static_assert(sizeof(BspFace) == 56, "BspFace layout changed");
+
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t version;
+    uint32_t uncompressedSize;          // Nonzero when the lump is LZMA compressed
+} BspLumpEntry;
+
+typedef struct {
+    bool loaded;
+    const void* records;                // Into the mapping, or owned
+    int count;
+    void* owned;
+} BspLumpView;
+
+typedef struct {
+    int cluster;                        // -1 for a free slot
+    uint64_t lastUsed;
+} BspPvsSlot;
+
+struct Bsp {
+    MappedFile file;
+    int version;
+    BspLumpEntry lumps[BSP_LUMP_COUNT];
+    BspLumpView views[BSP_LUMP_COUNT];
+    int lumpsLoaded;
+    size_t bytesCopied;
+
+    // Visibility, set up on first use
+    bool visLoaded;
+    const unsigned char* vis;
+    size_t visSize;
+    int clusters;
+    int rowBytes;
+    unsigned char* rows;                // BSP_PVS_CACHE_SIZE rows, then one with every bit set
+    BspPvsSlot slots[BSP_PVS_CACHE_SIZE];
+    uint64_t pvsClock;
+    uint64_t pvsDecoded;
+    uint64_t pvsHits;
+};
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//----------------------------------------------------------------------------------
+// Lumps
+//----------------------------------------------------------------------------------
+
+// Left 4 Dead 2 moved the version to the front of each entry. Entries of
+// either order must lie past the header, which tells them apart.
+static bool ReadLumpDirectory(Bsp* bsp, bool versionFirst) {
+    const unsigned char* p = bsp->file.data + 8;
+    size_t size = bsp->file.size;
+    for (int i = 0; i < BSP_LUMP_COUNT; i++, p += BSP_LUMP_ENTRY_SIZE) {
+        uint32_t a = ReadU32(p), b = ReadU32(p + 4), c = ReadU32(p + 8), d = ReadU32(p + 12);
+        BspLumpEntry entry = versionFirst ? (BspLumpEntry){ b, c, a, d } : (BspLumpEntry){ a, b, c, d };
+        if (entry.length > 0 && (entry.offset < BSP_HEADER_SIZE || entry.offset > size || entry.length > size - entry.offset)) {
+            return false;
+        }
+        bsp->lumps[i] = entry;
+    }
+    return true;
+}
+
+bool GetBspLump(const Bsp* bsp, int lump, const unsigned char** data, size_t* size) {
+    if (!bsp || lump < 0 || lump >= BSP_LUMP_COUNT) return false;
+    const BspLumpEntry* entry = &bsp->lumps[lump];
+    if (entry->length == 0 || entry->uncompressedSize != 0) return false;
+    if (data) *data = bsp->file.data + entry->offset;
+    if (size) *size = entry->length;
+    return true;
+}
+
+// Records point into the mapping when the lump is aligned for them
+static const void* LoadLumpRecords(Bsp* bsp, int lump, size_t recordSize, size_t alignment, int* count) {
+    BspLumpView* view = &bsp->views[lump];
+    if (!view->loaded) {
+        view->loaded = true;
+        bsp->lumpsLoaded++;
+        const unsigned char* data;
+        size_t size;
+        if (GetBspLump(bsp, lump, &data, &size) && size % recordSize == 0 && size / recordSize <= INT_MAX) {
+            if ((uintptr_t)data % alignment == 0) {
+                view->records = data;
+                view->count = (int)(size / recordSize);
+            } else if ((view->owned = malloc(size)) != NULL) {
+                memcpy(view->owned, data, size);
+                view->records = view->owned;
+                view->count = (int)(size / recordSize);
+                bsp->bytesCopied += size;
+            }
+        } else if (bsp->lumps[lump].uncompressedSize != 0) {
+            TraceLog(LOG_WARNING, "BSP: Lump %d is compressed, which is not supported", lump);
+        } else if (bsp->lumps[lump].length != 0) {
+            TraceLog(LOG_WARNING, "BSP: Lump %d is not a whole number of records", lump);
+        }
+    }
+    if (count) *count = view->count;
+    return view->records;
+}
+
+const char* GetBspEntities(Bsp* bsp, size_t* length) {
+    if (length) *length = 0;
+    const unsigned char* data;
+    size_t size;
+    if (!GetBspLump(bsp, BSP_LUMP_ENTITIES, &data, &size)) return NULL;
+    const unsigned char* end = memchr(data, 0, size);
+    if (length) *length = end ? (size_t)(end - data) : size;
+    return (const char*)data;
+}
+
+const BspPlane* GetBspPlanes(Bsp* bsp, int* count) {
+    if (count) *count = 0;
+    if (!bsp) return NULL;
+    return LoadLumpRecords(bsp, BSP_LUMP_PLANES, sizeof(BspPlane), _Alignof(BspPlane), count);
+}
+
+const BspNode* GetBspNodes(Bsp* bsp, int* count) {
+    if (count) *count = 0;
+    if (!bsp) return NULL;
+    return LoadLumpRecords(bsp, BSP_LUMP_NODES, sizeof(BspNode), _Alignof(BspNode), count);
+}
+
+const BspFace* GetBspFaces(Bsp* bsp, int* count) {
+    if (count) *count = 0;
+    if (!bsp) return NULL;
+    return LoadLumpRecords(bsp, BSP_LUMP_FACES, sizeof(BspFace), _Alignof(BspFace), count);
+}
+
+// Version 0 leaves are reshaped once, dropping the ambient lighting
+const BspLeaf* GetBspLeaves(Bsp* bsp, int* count) {
+    if (count) *count = 0;
+    if (!bsp) return NULL;
+    if (bsp->lumps[BSP_LUMP_LEAFS].version != 0) {
+        return LoadLumpRecords(bsp, BSP_LUMP_LEAFS, sizeof(BspLeaf), _Alignof(BspLeaf), count);
+    }
+
+    BspLumpView* view = &bsp->views[BSP_LUMP_LEAFS];
+    if (!view->loaded) {
+        view->loaded = true;
+        bsp->lumpsLoaded++;
+        const unsigned char* data;
+        size_t size;
+        if (GetBspLump(bsp, BSP_LUMP_LEAFS, &data, &size) && size % BSP_LEAF_V0_SIZE == 0 && size / BSP_LEAF_V0_SIZE <= INT_MAX) {
+            size_t leafCount = size / BSP_LEAF_V0_SIZE;
+            BspLeaf* leaves = calloc(leafCount, sizeof(BspLeaf));
+            if (leaves) {
+                for (size_t i = 0; i < leafCount; i++) memcpy(&leaves[i], data + i * BSP_LEAF_V0_SIZE, BSP_LEAF_V0_PREFIX);
+                view->owned = leaves;
+                view->records = leaves;
+                view->count = (int)leafCount;
+                bsp->bytesCopied += leafCount * sizeof(BspLeaf);
+            }
+        } else if (bsp->lumps[BSP_LUMP_LEAFS].length != 0) {
+            TraceLog(LOG_WARNING, "BSP: Leaf lump is compressed or malformed");
+        }
+    }
+    if (count) *count = view->count;
+    return view->records;
+}
+
+int FindBspLeaf(Bsp* bsp, Vector3 point) {
+    int nodeCount, planeCount, leafCount;
+    const BspNode* nodes = GetBspNodes(bsp, &nodeCount);
+    const BspPlane* planes = GetBspPlanes(bsp, &planeCount);
+    GetBspLeaves(bsp, &leafCount);
+    if (!nodes || !planes) return -1;
+
+    // A well-formed tree reaches a leaf in fewer steps than there are nodes
+    int index = 0;
+    for (int steps = 0; index >= 0 && steps < nodeCount; steps++) {
+        const BspNode* node = &nodes[index];
+        if (node->plane < 0 || node->plane >= planeCount) return -1;
+        const BspPlane* plane = &planes[node->plane];
+        float distance = plane->normal.x * point.x + plane->normal.y * point.y + plane->normal.z * point.z - plane->distance;
+        index = node->children[distance >= 0.0f ? 0 : 1];
+        if (index >= nodeCount) return -1;
+    }
+    if (index >= 0) return -1;
+    int leaf = -1 - index;
+    return leaf < leafCount ? leaf : -1;
+}
+
+//----------------------------------------------------------------------------------
+// Visibility
+//----------------------------------------------------------------------------------
+
+// The lump is a cluster count, a PVS and PAS offset per cluster, then the
+// compressed rows
+static bool LoadVisibility(Bsp* bsp) {
+    if (bsp->visLoaded) return bsp->rows != NULL;
+    bsp->visLoaded = true;
+
+    const unsigned char* data;
+    size_t size;
+    if (!GetBspLump(bsp, BSP_LUMP_VISIBILITY, &data, &size) || size < 4) return false;
+    uint32_t clusters = ReadU32(data);
+    if (clusters == 0 || clusters > (size - 4) / 8) {
+        TraceLog(LOG_WARNING, "BSP: Visibility lump is malformed, treating everything as visible");
+        return false;
+    }
+
+    int rowBytes = (int)((clusters + 7) / 8);
+    bsp->rows = malloc((size_t)(BSP_PVS_CACHE_SIZE + 1) * rowBytes);
+    if (!bsp->rows) return false;
+    memset(bsp->rows + (size_t)BSP_PVS_CACHE_SIZE * rowBytes, 0xFF, (size_t)rowBytes);
+    for (int i = 0; i < BSP_PVS_CACHE_SIZE; i++) bsp->slots[i] = (BspPvsSlot){ -1, 0 };
+    bsp->vis = data;
+    bsp->visSize = size;
+    bsp->clusters = (int)clusters;
+    bsp->rowBytes = rowBytes;
+    return true;
+}
+
+// A zero byte is followed by how many zero bytes it stands for; anything
+// else is literal. A truncated row errs toward drawing too much.
+static void DecompressPvs(const Bsp* bsp, int cluster, unsigned char* row) {
+    uint32_t offset = ReadU32(bsp->vis + 4 + (size_t)cluster * 8);
+    int out = 0;
+    if (offset < bsp->visSize) {
+        const unsigned char* in = bsp->vis + offset;
+        const unsigned char* end = bsp->vis + bsp->visSize;
+        while (out < bsp->rowBytes && in < end) {
+            if (*in) {
+                row[out++] = *in++;
+                continue;
+            }
+            if (end - in < 2) break;
+            int skip = in[1];
+            in += 2;
+            if (skip > bsp->rowBytes - out) skip = bsp->rowBytes - out;
+            memset(row + out, 0, (size_t)skip);
+            out += skip;
+        }
+    }
+    if (out < bsp->rowBytes) memset(row + out, 0xFF, (size_t)(bsp->rowBytes - out));
+}
+
+int GetBspClusterCount(Bsp* bsp) {
+    return bsp && LoadVisibility(bsp) ? bsp->clusters : 0;
+}
+
+const unsigned char* GetBspPvs(Bsp* bsp, int cluster) {
+    if (!bsp || !LoadVisibility(bsp)) return NULL;
+    if (cluster < 0 || cluster >= bsp->clusters) return bsp->rows + (size_t)BSP_PVS_CACHE_SIZE * bsp->rowBytes;
+
+    // Least recently used row makes room; free slots have never been used
+    bsp->pvsClock++;
+    int victim = 0;
+    for (int i = 0; i < BSP_PVS_CACHE_SIZE; i++) {
+        if (bsp->slots[i].cluster == cluster) {
+            bsp->slots[i].lastUsed = bsp->pvsClock;
+            bsp->pvsHits++;
+            return bsp->rows + (size_t)i * bsp->rowBytes;
+        }
+        if (bsp->slots[i].lastUsed < bsp->slots[victim].lastUsed) victim = i;
+    }
+    unsigned char* row = bsp->rows + (size_t)victim * bsp->rowBytes;
+    DecompressPvs(bsp, cluster, row);
+    bsp->slots[victim] = (BspPvsSlot){ cluster, bsp->pvsClock };
+    bsp->pvsDecoded++;
+    return row;
+}
+
+bool IsBspClusterVisible(Bsp* bsp, int fromCluster, int toCluster) {
+    const unsigned char* row = GetBspPvs(bsp, fromCluster);
+    if (!row) return true;
+    if (toCluster < 0 || toCluster >= bsp->clusters) return false;
+    return (row[toCluster >> 3] & (1 << (toCluster & 7))) != 0;
+}
+
+BspStats GetBspStats(Bsp* bsp) {
+    BspStats stats = { 0 };
+    if (!bsp) return stats;
+    stats.version = bsp->version;
+    stats.lumpsLoaded = bsp->lumpsLoaded;
+    stats.bytesCopied = bsp->bytesCopied;
+    stats.clusters = bsp->clusters;
+    stats.pvsDecoded = bsp->pvsDecoded;
+    stats.pvsHits = bsp->pvsHits;
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lifetime
+//----------------------------------------------------------------------------------
+
+Bsp* OpenBsp(const char* path) {
+    Bsp* bsp = calloc(1, sizeof(Bsp));
+    if (!bsp) return NULL;
+    if (!MapFile(path, &bsp->file)) {
+        TraceLog(LOG_WARNING, "BSP: Could not open %s", path ? path : "(null)");
+        free(bsp);
+        return NULL;
+    }
+
+    const unsigned char* data = bsp->file.data;
+    bool valid = bsp->file.size >= BSP_HEADER_SIZE && ReadU32(data) == BSP_IDENT;
+    if (valid) {
+        bsp->version = (int)ReadU32(data + 4);
+        valid = bsp->version >= BSP_MIN_VERSION && bsp->version <= BSP_MAX_VERSION &&
+                (ReadLumpDirectory(bsp, false) || (bsp->version == 21 && ReadLumpDirectory(bsp, true)));
+    }
+    if (!valid) {
+        TraceLog(LOG_WARNING, "BSP: %s is not a supported map", path);
+        CloseBsp(bsp);
+        return NULL;
+    }
+    return bsp;
+}
+
+void CloseBsp(Bsp* bsp) {
+    if (!bsp) return;
+    for (int i = 0; i < BSP_LUMP_COUNT; i++) free(bsp->views[i].owned);
+    free(bsp->rows);
+    UnmapFile(&bsp->file);
+    free(bsp);
+}
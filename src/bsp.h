@@ -0,0 +1,143 @@
+#ifndef BSP_H
+#define BSP_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Source engine map (.bsp) reader, versions 19 to 21.
+//
+// Opening maps the file and reads the lump directory, nothing else. A lump
+// is checked the first time it is asked for and handed out as records that
+// point straight into the mapping, so the cost of a map is the pages of the
+// lumps actually used. Only records that need reshaping are copied: a leaf
+// lump at version 0 (whatever the map version) carries ambient lighting
+// that is dropped, and a lump at an unaligned offset is copied once to an
+// aligned buffer.
+//
+// Visibility is stored run-length encoded per cluster. GetBspPvs expands a
+// cluster's row on demand and keeps the last BSP_PVS_CACHE_SIZE rows, which
+// covers the handful of clusters a camera moves between.
+//
+// A Bsp is not thread-safe; lumps and the cache fill in on first use.
+
+#define BSP_IDENT 0x50534256u           // "VBSP"
+#define BSP_MIN_VERSION 19
+#define BSP_MAX_VERSION 21
+#define BSP_LUMP_COUNT 64
+#define BSP_PVS_CACHE_SIZE 32
+
+typedef enum {
+    BSP_LUMP_ENTITIES = 0,
+    BSP_LUMP_PLANES = 1,
+    BSP_LUMP_TEXDATA = 2,
+    BSP_LUMP_VERTEXES = 3,
+    BSP_LUMP_VISIBILITY = 4,
+    BSP_LUMP_NODES = 5,
+    BSP_LUMP_TEXINFO = 6,
+    BSP_LUMP_FACES = 7,
+    BSP_LUMP_LIGHTING = 8,
+    BSP_LUMP_LEAFS = 10,
+    BSP_LUMP_EDGES = 12,
+    BSP_LUMP_SURFEDGES = 13,
+    BSP_LUMP_MODELS = 14,
+    BSP_LUMP_LEAFFACES = 16,
+    BSP_LUMP_BRUSHES = 18,
+    BSP_LUMP_GAME = 35,
+    BSP_LUMP_PAKFILE = 40
+} BspLump;
+
+// Records as stored in the file
+
+typedef struct {
+    Vector3 normal;
+    float distance;
+    int32_t type;
+} BspPlane;
+
+typedef struct {
+    int32_t plane;
+    int32_t children[2];                // Negative: leaf -1 - child
+    int16_t mins[3];
+    int16_t maxs[3];
+    uint16_t firstFace;
+    uint16_t faceCount;
+    int16_t area;
+    int16_t padding;
+} BspNode;
+
+typedef struct {
+    int32_t contents;
+    int16_t cluster;                    // -1 outside the map
+    int16_t areaFlags;                  // Area in the low 9 bits, flags above
+    int16_t mins[3];
+    int16_t maxs[3];
+    uint16_t firstLeafFace;
+    uint16_t leafFaceCount;
+    uint16_t firstLeafBrush;
+    uint16_t leafBrushCount;
+    int16_t leafWaterData;
+    int16_t padding;
+} BspLeaf;
+
+typedef struct {
+    uint16_t plane;
+    uint8_t side;
+    uint8_t onNode;
+    int32_t firstEdge;
+    int16_t edgeCount;
+    int16_t texInfo;
+    int16_t dispInfo;
+    int16_t surfaceFogVolume;
+    uint8_t styles[4];
+    int32_t lightOffset;
+    float area;
+    int32_t lightmapMins[2];
+    int32_t lightmapSize[2];
+    int32_t originalFace;
+    uint16_t primitiveCount;
+    uint16_t firstPrimitive;
+    uint32_t smoothingGroups;
+} BspFace;
+
+typedef struct Bsp Bsp;
+
+typedef struct {
+    int version;
+    int lumpsLoaded;                    // Typed lumps checked so far
+    size_t bytesCopied;                 // Reshaped or realigned records
+    int clusters;
+    uint64_t pvsDecoded;                // Rows expanded
+    uint64_t pvsHits;                   // Rows served from the cache
+} BspStats;
+
+// Lifetime. Returns NULL if the file is missing or not a supported map.
+Bsp* OpenBsp(const char* path);
+void CloseBsp(Bsp* bsp);
+
+// Raw bytes of any lump. False if it is empty, out of range or compressed.
+bool GetBspLump(const Bsp* bsp, int lump, const unsigned char** data, size_t* size);
+
+// Typed lumps, loaded on first use. NULL with count 0 when the lump is
+// missing or malformed. Pointers stay valid until the map is closed.
+const char* GetBspEntities(Bsp* bsp, size_t* length);
+const BspPlane* GetBspPlanes(Bsp* bsp, int* count);
+const BspNode* GetBspNodes(Bsp* bsp, int* count);
+const BspLeaf* GetBspLeaves(Bsp* bsp, int* count);
+const BspFace* GetBspFaces(Bsp* bsp, int* count);
+
+// Leaf containing a point, walking the node tree from the world's root
+int FindBspLeaf(Bsp* bsp, Vector3 point);
+
+// Potentially visible set of a cluster: one bit per cluster, (clusters + 7) / 8
+// bytes, valid until the next call. NULL when the map has no visibility,
+// which means everything is visible; cluster -1 (outside the world) gets a
+// row with every bit set.
+int GetBspClusterCount(Bsp* bsp);
+const unsigned char* GetBspPvs(Bsp* bsp, int cluster);
+bool IsBspClusterVisible(Bsp* bsp, int fromCluster, int toCluster);
+
+BspStats GetBspStats(Bsp* bsp);
+
+#endif // BSP_H
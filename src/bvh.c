@@ -0,0 +1,530 @@
+#include "bvh.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NULL_NODE -1
+#define UNLINKED_NODE -2        // Parent of an appended leaf until BvhRebuild
+#define MAX_SAH_DEPTH 64        // Deeper splits fall back to the median
+#define WALK_STACK_SIZE 128
+
+typedef struct {
+    int32_t node;
+    Vector2 centroid;
+} BuildItem;
+
+//----------------------------------------------------------------------------------
+// Boxes
+//----------------------------------------------------------------------------------
+static Rectangle UnionBox(Rectangle a, Rectangle b) {
+    float x0 = fminf(a.x, b.x), y0 = fminf(a.y, b.y);
+    float x1 = fmaxf(a.x + a.width, b.x + b.width), y1 = fmaxf(a.y + a.height, b.y + b.height);
+    return (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static float Perimeter(Rectangle box) {
+    return 2.0f * (box.width + box.height);
+}
+
+static bool ContainsBox(Rectangle outer, Rectangle inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+}
+
+static bool OverlapsBox(Rectangle a, Rectangle b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Slab test of the segment from + d * [0, maxFraction]
+static bool SegmentHitsBox(Vector2 from, Vector2 d, float maxFraction, Rectangle box) {
+    float lo = 0.0f, hi = maxFraction;
+    float origin[2] = { from.x, from.y }, dir[2] = { d.x, d.y };
+    float mins[2] = { box.x, box.y }, maxs[2] = { box.x + box.width, box.y + box.height };
+
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabsf(dir[axis]) < 1e-12f) {
+            if (origin[axis] < mins[axis] || origin[axis] > maxs[axis]) return false;
+            continue;
+        }
+        float inv = 1.0f / dir[axis];
+        float t0 = (mins[axis] - origin[axis]) * inv;
+        float t1 = (maxs[axis] - origin[axis]) * inv;
+        if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+        lo = fmaxf(lo, t0);
+        hi = fminf(hi, t1);
+        if (lo > hi) return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Nodes
+//----------------------------------------------------------------------------------
+static bool ReserveNodes(Bvh* bvh, int32_t extra) {
+    if (bvh->nodeCount + extra <= bvh->nodeCapacity) return true;
+
+    int32_t capacity = bvh->nodeCapacity ? bvh->nodeCapacity * 2 : 64;
+    while (capacity < bvh->nodeCount + extra) capacity *= 2;
+
+    BvhNode* nodes = realloc(bvh->nodes, (size_t)capacity * sizeof(BvhNode));
+    if (!nodes) return false;
+    bvh->nodes = nodes;
+    bvh->nodeCapacity = capacity;
+    return true;
+}
+
+// Capacity must have been reserved
+static int32_t AllocNode(Bvh* bvh) {
+    int32_t id;
+    if (bvh->freeList != NULL_NODE) {
+        id = bvh->freeList;
+        bvh->freeList = bvh->nodes[id].parent;
+    } else {
+        id = bvh->nodeCount++;
+    }
+
+    BvhNode* node = &bvh->nodes[id];
+    memset(node, 0, sizeof(*node));
+    node->parent = NULL_NODE;
+    node->children[0] = node->children[1] = NULL_NODE;
+    return id;
+}
+
+static void FreeNode(Bvh* bvh, int32_t id) {
+    bvh->nodes[id].height = -1;
+    bvh->nodes[id].parent = bvh->freeList;
+    bvh->freeList = id;
+}
+
+static bool IsProxy(const Bvh* bvh, int32_t proxy) {
+    return proxy >= 0 && proxy < bvh->nodeCount && bvh->nodes[proxy].height == 0;
+}
+
+static void Refit(Bvh* bvh, int32_t id) {
+    BvhNode* node = &bvh->nodes[id];
+    const BvhNode* a = &bvh->nodes[node->children[0]];
+    const BvhNode* b = &bvh->nodes[node->children[1]];
+    node->box = UnionBox(a->box, b->box);
+    node->height = 1 + (a->height > b->height ? a->height : b->height);
+}
+
+static void ReplaceChild(Bvh* bvh, int32_t parent, int32_t oldChild, int32_t newChild) {
+    if (parent == NULL_NODE) {
+        bvh->root = newChild;
+        return;
+    }
+    BvhNode* node = &bvh->nodes[parent];
+    if (node->children[0] == oldChild) node->children[0] = newChild;
+    else node->children[1] = newChild;
+}
+
+// Lifts the taller grandchild of a above it when the two subtrees of a differ
+// in height by more than one. Returns the node now in a's place.
+static int32_t Balance(Bvh* bvh, int32_t ia) {
+    BvhNode* a = &bvh->nodes[ia];
+    if (a->height < 2) return ia;
+
+    int balance = bvh->nodes[a->children[1]].height - bvh->nodes[a->children[0]].height;
+    if (balance >= -1 && balance <= 1) return ia;
+
+    // Side of a that is too tall, and the other one
+    int up = balance > 1 ? 1 : 0;
+    int32_t ic = a->children[up];
+    BvhNode* c = &bvh->nodes[ic];
+    int32_t if0 = c->children[0], ig = c->children[1];
+    if (bvh->nodes[if0].height < bvh->nodes[ig].height) { int32_t t = if0; if0 = ig; ig = t; }
+
+    // c takes a's place with a as one child and its taller child as the
+    // other; a keeps its short side and adopts c's shorter child
+    c->parent = a->parent;
+    ReplaceChild(bvh, a->parent, ia, ic);
+    c->children[0] = ia;
+    c->children[1] = if0;
+    a->parent = ic;
+    a->children[up] = ig;
+    bvh->nodes[ig].parent = ia;
+
+    Refit(bvh, ia);
+    Refit(bvh, ic);
+    return ic;
+}
+
+static void RefitAncestors(Bvh* bvh, int32_t id) {
+    while (id != NULL_NODE) {
+        id = Balance(bvh, id);
+        Refit(bvh, id);
+        id = bvh->nodes[id].parent;
+    }
+}
+
+// The leaf's sibling is the node where pairing up costs the least new
+// perimeter, counting what the pairing adds to every ancestor above it
+static void InsertLeaf(Bvh* bvh, int32_t leaf) {
+    if (bvh->root == NULL_NODE) {
+        bvh->root = leaf;
+        bvh->nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    Rectangle box = bvh->nodes[leaf].box;
+    int32_t index = bvh->root;
+    while (bvh->nodes[index].height > 0) {
+        const BvhNode* node = &bvh->nodes[index];
+        float combined = Perimeter(UnionBox(node->box, box));
+        float pairCost = 2.0f * combined;
+        float inherited = 2.0f * (combined - Perimeter(node->box));
+
+        float childCost[2];
+        for (int i = 0; i < 2; i++) {
+            const BvhNode* child = &bvh->nodes[node->children[i]];
+            float grown = Perimeter(UnionBox(child->box, box));
+            childCost[i] = (child->height == 0 ? grown : grown - Perimeter(child->box)) + inherited;
+        }
+
+        if (pairCost < childCost[0] && pairCost < childCost[1]) break;
+        index = node->children[childCost[0] < childCost[1] ? 0 : 1];
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = bvh->nodes[sibling].parent;
+    int32_t newParent = AllocNode(bvh);
+    BvhNode* parent = &bvh->nodes[newParent];
+    parent->parent = oldParent;
+    parent->children[0] = sibling;
+    parent->children[1] = leaf;
+    ReplaceChild(bvh, oldParent, sibling, newParent);
+    bvh->nodes[sibling].parent = newParent;
+    bvh->nodes[leaf].parent = newParent;
+
+    RefitAncestors(bvh, newParent);
+}
+
+static void RemoveLeaf(Bvh* bvh, int32_t leaf) {
+    if (leaf == bvh->root) {
+        bvh->root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = bvh->nodes[leaf].parent;
+    int32_t grandParent = bvh->nodes[parent].parent;
+    const BvhNode* p = &bvh->nodes[parent];
+    int32_t sibling = p->children[0] == leaf ? p->children[1] : p->children[0];
+
+    ReplaceChild(bvh, grandParent, parent, sibling);
+    bvh->nodes[sibling].parent = grandParent;
+    FreeNode(bvh, parent);
+    RefitAncestors(bvh, grandParent);
+}
+
+static Rectangle FattenBox(const Bvh* bvh, Rectangle box) {
+    return (Rectangle){ box.x - bvh->margin, box.y - bvh->margin,
+                        box.width + 2.0f * bvh->margin, box.height + 2.0f * bvh->margin };
+}
+
+//----------------------------------------------------------------------------------
+// Tree lifetime
+//----------------------------------------------------------------------------------
+void InitBvh(Bvh* bvh, float margin) {
+    if (!bvh) return;
+    memset(bvh, 0, sizeof(*bvh));
+    bvh->root = NULL_NODE;
+    bvh->freeList = NULL_NODE;
+    bvh->margin = margin > 0.0f ? margin : 0.0f;
+}
+
+void UnloadBvh(Bvh* bvh) {
+    if (!bvh) return;
+    free(bvh->nodes);
+    InitBvh(bvh, bvh->margin);
+}
+
+void ClearBvh(Bvh* bvh) {
+    if (!bvh) return;
+    bvh->nodeCount = 0;
+    bvh->root = NULL_NODE;
+    bvh->freeList = NULL_NODE;
+    bvh->proxyCount = 0;
+    bvh->unlinkedCount = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Proxies
+//----------------------------------------------------------------------------------
+static int32_t CreateLeaf(Bvh* bvh, Rectangle box, uint32_t data) {
+    int32_t leaf = AllocNode(bvh);
+    bvh->nodes[leaf].box = FattenBox(bvh, box);
+    bvh->nodes[leaf].data = data;
+    bvh->proxyCount++;
+    return leaf;
+}
+
+int32_t BvhInsert(Bvh* bvh, Rectangle box, uint32_t data) {
+    if (!bvh || !ReserveNodes(bvh, 2)) return BVH_NULL_PROXY;
+    int32_t leaf = CreateLeaf(bvh, box, data);
+    InsertLeaf(bvh, leaf);
+    return leaf;
+}
+
+int32_t BvhAppend(Bvh* bvh, Rectangle box, uint32_t data) {
+    if (!bvh || !ReserveNodes(bvh, 1)) return BVH_NULL_PROXY;
+    int32_t leaf = CreateLeaf(bvh, box, data);
+    bvh->nodes[leaf].parent = UNLINKED_NODE;
+    bvh->unlinkedCount++;
+    return leaf;
+}
+
+void BvhRemove(Bvh* bvh, int32_t proxy) {
+    if (!bvh || !IsProxy(bvh, proxy)) return;
+    if (bvh->nodes[proxy].parent == UNLINKED_NODE) bvh->unlinkedCount--;
+    else RemoveLeaf(bvh, proxy);
+    FreeNode(bvh, proxy);
+    bvh->proxyCount--;
+}
+
+bool BvhMove(Bvh* bvh, int32_t proxy, Rectangle box) {
+    if (!bvh || !IsProxy(bvh, proxy)) return false;
+
+    BvhNode* leaf = &bvh->nodes[proxy];
+    if (ContainsBox(leaf->box, box)) return false;
+
+    leaf->box = FattenBox(bvh, box);
+    if (leaf->parent == UNLINKED_NODE) return false;
+
+    // Removing frees the node the insert takes back, so no allocation happens
+    RemoveLeaf(bvh, proxy);
+    InsertLeaf(bvh, proxy);
+    return true;
+}
+
+uint32_t BvhGetData(const Bvh* bvh, int32_t proxy) {
+    return bvh && IsProxy(bvh, proxy) ? bvh->nodes[proxy].data : 0;
+}
+
+Rectangle BvhGetFatBox(const Bvh* bvh, int32_t proxy) {
+    return bvh && IsProxy(bvh, proxy) ? bvh->nodes[proxy].box : (Rectangle){ 0 };
+}
+
+//----------------------------------------------------------------------------------
+// Rebuild
+//----------------------------------------------------------------------------------
+static int CompareCentroidX(const void* a, const void* b) {
+    float d = ((const BuildItem*)a)->centroid.x - ((const BuildItem*)b)->centroid.x;
+    return (d > 0.0f) - (d < 0.0f);
+}
+
+static int CompareCentroidY(const void* a, const void* b) {
+    float d = ((const BuildItem*)a)->centroid.y - ((const BuildItem*)b)->centroid.y;
+    return (d > 0.0f) - (d < 0.0f);
+}
+
+// Binned split of items along the longer centroid axis; returns the size of
+// the left half
+static int SplitItems(const Bvh* bvh, BuildItem* items, int count, int depth) {
+    float minX = items[0].centroid.x, maxX = minX, minY = items[0].centroid.y, maxY = minY;
+    for (int i = 1; i < count; i++) {
+        minX = fminf(minX, items[i].centroid.x);
+        maxX = fmaxf(maxX, items[i].centroid.x);
+        minY = fminf(minY, items[i].centroid.y);
+        maxY = fmaxf(maxY, items[i].centroid.y);
+    }
+    bool alongX = maxX - minX >= maxY - minY;
+    float lo = alongX ? minX : minY;
+    float extent = alongX ? maxX - minX : maxY - minY;
+
+    // All centroids on one spot: any split is as good as another
+    if (extent <= 0.0f) return count / 2;
+
+    // Badly clustered input can keep peeling a few items off per level;
+    // past a depth the median keeps the tree shallow instead
+    if (depth >= MAX_SAH_DEPTH) {
+        qsort(items, (size_t)count, sizeof(BuildItem), alongX ? CompareCentroidX : CompareCentroidY);
+        return count / 2;
+    }
+
+    Rectangle binBoxes[BVH_SAH_BINS];
+    int binCounts[BVH_SAH_BINS] = { 0 };
+    float scale = (float)BVH_SAH_BINS / extent;
+
+    for (int i = 0; i < count; i++) {
+        float c = alongX ? items[i].centroid.x : items[i].centroid.y;
+        int bin = (int)((c - lo) * scale);
+        if (bin >= BVH_SAH_BINS) bin = BVH_SAH_BINS - 1;
+        Rectangle box = bvh->nodes[items[i].node].box;
+        binBoxes[bin] = binCounts[bin]++ ? UnionBox(binBoxes[bin], box) : box;
+    }
+
+    // Cost of splitting after bin i: items times perimeter on each side
+    float leftCost[BVH_SAH_BINS - 1];
+    Rectangle acc = { 0 };
+    int accCount = 0;
+    for (int i = 0; i < BVH_SAH_BINS - 1; i++) {
+        if (binCounts[i]) acc = accCount ? UnionBox(acc, binBoxes[i]) : binBoxes[i];
+        accCount += binCounts[i];
+        leftCost[i] = accCount ? accCount * Perimeter(acc) : INFINITY;
+    }
+
+    int best = 0;
+    float bestCost = INFINITY;
+    accCount = 0;
+    for (int i = BVH_SAH_BINS - 1; i > 0; i--) {
+        if (binCounts[i]) acc = accCount ? UnionBox(acc, binBoxes[i]) : binBoxes[i];
+        accCount += binCounts[i];
+        float cost = leftCost[i - 1] + (accCount ? accCount * Perimeter(acc) : INFINITY);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = i - 1;
+        }
+    }
+
+    // Partition in place around the chosen bin boundary
+    int left = 0;
+    for (int i = 0; i < count; i++) {
+        float c = alongX ? items[i].centroid.x : items[i].centroid.y;
+        int bin = (int)((c - lo) * scale);
+        if (bin >= BVH_SAH_BINS) bin = BVH_SAH_BINS - 1;
+        if (bin <= best) {
+            BuildItem t = items[left];
+            items[left++] = items[i];
+            items[i] = t;
+        }
+    }
+    return left > 0 && left < count ? left : count / 2;
+}
+
+static int32_t BuildNode(Bvh* bvh, BuildItem* items, int count, int depth) {
+    if (count == 1) return items[0].node;
+
+    int left = SplitItems(bvh, items, count, depth);
+    int32_t a = BuildNode(bvh, items, left, depth + 1);
+    int32_t b = BuildNode(bvh, items + left, count - left, depth + 1);
+
+    int32_t id = AllocNode(bvh);
+    bvh->nodes[id].children[0] = a;
+    bvh->nodes[id].children[1] = b;
+    bvh->nodes[a].parent = id;
+    bvh->nodes[b].parent = id;
+    Refit(bvh, id);
+    return id;
+}
+
+void BvhRebuild(Bvh* bvh) {
+    if (!bvh || bvh->proxyCount == 0) return;
+
+    // Everything that can fail happens before the old tree is taken apart
+    BuildItem* items = malloc((size_t)bvh->proxyCount * sizeof(BuildItem));
+    if (!items || !ReserveNodes(bvh, bvh->proxyCount)) {
+        TraceLog(LOG_WARNING, "BVH: Out of memory rebuilding %d proxies", bvh->proxyCount);
+        free(items);
+        return;
+    }
+
+    int count = 0;
+    for (int32_t i = 0; i < bvh->nodeCount; i++) {
+        BvhNode* node = &bvh->nodes[i];
+        if (node->height == 0) {
+            Rectangle box = node->box;
+            items[count++] = (BuildItem){ i, { box.x + box.width * 0.5f, box.y + box.height * 0.5f } };
+        } else if (node->height > 0) {
+            FreeNode(bvh, i);
+        }
+    }
+
+    bvh->root = BuildNode(bvh, items, count, 0);
+    bvh->nodes[bvh->root].parent = NULL_NODE;
+    bvh->unlinkedCount = 0;
+    free(items);
+}
+
+//----------------------------------------------------------------------------------
+// Queries
+//----------------------------------------------------------------------------------
+
+// A depth-first walk keeps at most one pending sibling per level, so the
+// stack never needs more than the tree height plus one entries
+static int32_t* BeginWalk(const Bvh* bvh, int32_t* local) {
+    int32_t needed = bvh->nodes[bvh->root].height + 2;
+    if (needed <= WALK_STACK_SIZE) return local;
+
+    int32_t* stack = malloc((size_t)needed * sizeof(int32_t));
+    if (!stack) TraceLog(LOG_WARNING, "BVH: Out of memory walking a tree of height %d", needed - 2);
+    return stack;
+}
+
+static void EndWalk(int32_t* stack, int32_t* local) {
+    if (stack != local) free(stack);
+}
+
+void BvhQueryRect(const Bvh* bvh, Rectangle rect, BvhQueryCallback callback, void* user) {
+    if (!bvh || !callback || bvh->root == NULL_NODE) return;
+
+    int32_t local[WALK_STACK_SIZE];
+    int32_t* stack = BeginWalk(bvh, local);
+    if (!stack) return;
+
+    int top = 0;
+    stack[top++] = bvh->root;
+    while (top > 0) {
+        const BvhNode* node = &bvh->nodes[stack[--top]];
+        if (!OverlapsBox(node->box, rect)) continue;
+
+        if (node->height == 0) {
+            if (!callback(user, (int32_t)(node - bvh->nodes), node->data)) break;
+        } else {
+            stack[top++] = node->children[0];
+            stack[top++] = node->children[1];
+        }
+    }
+    EndWalk(stack, local);
+}
+
+void BvhQueryPoint(const Bvh* bvh, Vector2 point, BvhQueryCallback callback, void* user) {
+    BvhQueryRect(bvh, (Rectangle){ point.x, point.y, 0.0f, 0.0f }, callback, user);
+}
+
+void BvhRaycast(const Bvh* bvh, Vector2 from, Vector2 to, BvhRaycastCallback callback, void* user) {
+    if (!bvh || !callback || bvh->root == NULL_NODE) return;
+
+    int32_t local[WALK_STACK_SIZE];
+    int32_t* stack = BeginWalk(bvh, local);
+    if (!stack) return;
+
+    Vector2 d = { to.x - from.x, to.y - from.y };
+    float maxFraction = 1.0f;
+    int top = 0;
+    stack[top++] = bvh->root;
+    while (top > 0) {
+        const BvhNode* node = &bvh->nodes[stack[--top]];
+        if (!SegmentHitsBox(from, d, maxFraction, node->box)) continue;
+
+        if (node->height == 0) {
+            float value = callback(user, (int32_t)(node - bvh->nodes), node->data, from, to, maxFraction);
+            if (value == 0.0f) break;
+            if (value > 0.0f && value < maxFraction) maxFraction = value;
+        } else {
+            stack[top++] = node->children[0];
+            stack[top++] = node->children[1];
+        }
+    }
+    EndWalk(stack, local);
+}
+
+BvhStats GetBvhStats(const Bvh* bvh) {
+    BvhStats stats = { 0 };
+    if (!bvh) return stats;
+
+    float internalPerimeter = 0.0f;
+    for (int32_t i = 0; i < bvh->nodeCount; i++) {
+        const BvhNode* node = &bvh->nodes[i];
+        if (node->height < 0) continue;
+        stats.nodes++;
+        if (node->height > 0) internalPerimeter += Perimeter(node->box);
+    }
+
+    stats.proxies = bvh->proxyCount;
+    if (bvh->root != NULL_NODE) {
+        float rootPerimeter = Perimeter(bvh->nodes[bvh->root].box);
+        stats.height = bvh->nodes[bvh->root].height;
+        stats.perimeterRatio = rootPerimeter > 0.0f ? internalPerimeter / rootPerimeter : 0.0f;
+    }
+    return stats;
+}
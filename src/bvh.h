@@ -0,0 +1,81 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Dynamic bounding volume hierarchy over 2D boxes.
+//
+// Every proxy is a leaf holding its box grown by a margin. A move that stays
+// inside that fat box changes nothing; one that leaves it takes the leaf out
+// and inserts it again, refitting the ancestors on both paths. Insertion
+// walks down towards the sibling that grows the tree's total perimeter the
+// least and rotates unbalanced nodes on the way back up, so the tree stays
+// logarithmic under arbitrary edits.
+//
+// Bulk loads append unlinked leaves and link them in one top-down build that
+// splits by the binned surface area heuristic (perimeter in 2D), which gives
+// a tighter tree than inserting one by one.
+//
+// Proxy ids are node indices. They stay valid until the proxy is removed or
+// the tree is cleared, including across BvhRebuild.
+
+#define BVH_NULL_PROXY -1
+#define BVH_SAH_BINS 16
+
+typedef struct {
+    Rectangle box;          // Fat box for leaves, union of the children otherwise
+    int32_t parent;         // Next free node while on the free list
+    int32_t children[2];    // -1 for leaves
+    int32_t height;         // 0 for leaves, -1 while free
+    uint32_t data;
+} BvhNode;
+
+typedef struct {
+    BvhNode* nodes;
+    int32_t nodeCount;      // Nodes handed out so far
+    int32_t nodeCapacity;
+    int32_t root;
+    int32_t freeList;
+    int32_t proxyCount;
+    int32_t unlinkedCount;  // Appended leaves waiting for BvhRebuild
+    float margin;
+} Bvh;
+
+typedef struct {
+    int proxies;
+    int nodes;
+    int height;
+    float perimeterRatio;   // Summed perimeter of internal nodes over the root's, lower is tighter
+} BvhStats;
+
+// Return false to stop the query
+typedef bool (*BvhQueryCallback)(void* user, int32_t proxy, uint32_t data);
+// Return the fraction to clip the ray to: 0 stops, the hit's fraction keeps
+// only closer ones, maxFraction carries on unchanged, a negative value
+// ignores the proxy
+typedef float (*BvhRaycastCallback)(void* user, int32_t proxy, uint32_t data, Vector2 from, Vector2 to, float maxFraction);
+
+// Tree lifetime
+void InitBvh(Bvh* bvh, float margin);
+void UnloadBvh(Bvh* bvh);
+void ClearBvh(Bvh* bvh);
+
+// Proxies
+int32_t BvhInsert(Bvh* bvh, Rectangle box, uint32_t data);
+void BvhRemove(Bvh* bvh, int32_t proxy);
+bool BvhMove(Bvh* bvh, int32_t proxy, Rectangle box);     // True if the leaf was reinserted
+int32_t BvhAppend(Bvh* bvh, Rectangle box, uint32_t data);  // Bulk load, call BvhRebuild after
+void BvhRebuild(Bvh* bvh);
+uint32_t BvhGetData(const Bvh* bvh, int32_t proxy);
+Rectangle BvhGetFatBox(const Bvh* bvh, int32_t proxy);
+
+// Queries report proxies whose fat box overlaps; callers test the exact shape
+void BvhQueryRect(const Bvh* bvh, Rectangle rect, BvhQueryCallback callback, void* user);
+void BvhQueryPoint(const Bvh* bvh, Vector2 point, BvhQueryCallback callback, void* user);
+void BvhRaycast(const Bvh* bvh, Vector2 from, Vector2 to, BvhRaycastCallback callback, void* user);
+
+BvhStats GetBvhStats(const Bvh* bvh);
+
+#endif // BVH_H
@@ -0,0 +1,421 @@
+#include "dir_scanner.h"
+#include "profiler.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    // Only changes to the set of names; writes to a file inside the directory
+    // (a log, a render) must not force a rescan on every write
+    #define DIR_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | \
+                            IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+#endif
+
+#define NAME_BLOCK_SIZE (64 * 1024)
+#define WATCH_POLL_INTERVAL_MS 100
+
+typedef struct NameBlock {
+    struct NameBlock* next;
+    size_t used;
+    char data[NAME_BLOCK_SIZE];
+} NameBlock;
+
+struct DirListing {
+    char path[512];
+    atomic_int count;
+    atomic_bool complete;
+    atomic_bool stale;
+    atomic_bool cancel;
+    DirEntry* chunks[DIR_MAX_CHUNKS];
+    NameBlock* names;           // Written by the scanner thread only
+
+    // Guarded by the scanner lock
+    int refCount;
+    bool cached;
+    int watch;
+    int64_t dirMtime;
+    uint64_t lastUsed;
+    DirListing* nextJob;
+};
+
+struct DirScanner {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+
+    DirListing* cache[DIR_CACHE_SIZE];
+    int cacheCount;
+    uint64_t useCounter;
+
+    DirListing* queueHead;
+    DirListing* queueTail;
+
+    int inotifyFd;
+};
+
+static int64_t GetDirectoryMtime(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (int64_t)st.st_mtime : -1;
+}
+
+static void FreeListing(DirScanner* scanner, DirListing* listing) {
+#if defined(__linux__)
+    // Watch descriptors are shared by every listing of the same directory,
+    // including a replacement still queued or scanning: inotify hands it the
+    // same descriptor, but it only stores it once its scan is done
+    if (scanner->inotifyFd >= 0 && listing->watch >= 0) {
+        bool shared = false;
+        for (int i = 0; i < scanner->cacheCount && !shared; i++) {
+            const DirListing* other = scanner->cache[i];
+            if (other == listing) continue;
+            shared = other->watch == listing->watch || (other->watch < 0 && strcmp(other->path, listing->path) == 0);
+        }
+        if (!shared) inotify_rm_watch(scanner->inotifyFd, listing->watch);
+    }
+#else
+    (void)scanner;
+#endif
+
+    for (int i = 0; i < DIR_MAX_CHUNKS && listing->chunks[i]; i++) free(listing->chunks[i]);
+    while (listing->names) {
+        NameBlock* next = listing->names->next;
+        free(listing->names);
+        listing->names = next;
+    }
+    free(listing);
+}
+
+// Drop a listing from the cache; it is freed once nobody references it
+static void UncacheListing(DirScanner* scanner, int cacheIndex) {
+    DirListing* listing = scanner->cache[cacheIndex];
+    scanner->cache[cacheIndex] = scanner->cache[--scanner->cacheCount];
+    listing->cached = false;
+    atomic_store(&listing->cancel, true);
+    if (listing->refCount == 0) FreeListing(scanner, listing);
+}
+
+static bool AppendEntry(DirListing* listing, const char* name, bool isDir, uint64_t size, int64_t mtime) {
+    int index = atomic_load_explicit(&listing->count, memory_order_relaxed);
+    int chunk = index / DIR_CHUNK_ENTRIES;
+    if (chunk >= DIR_MAX_CHUNKS) return false;
+
+    if (!listing->chunks[chunk]) {
+        listing->chunks[chunk] = calloc(DIR_CHUNK_ENTRIES, sizeof(DirEntry));
+        if (!listing->chunks[chunk]) return false;
+    }
+
+    size_t length = strlen(name);
+    if (!listing->names || listing->names->used + length + 1 > NAME_BLOCK_SIZE) {
+        NameBlock* block = malloc(sizeof(NameBlock));
+        if (!block) return false;
+        block->next = listing->names;
+        block->used = 0;
+        listing->names = block;
+    }
+    char* stored = listing->names->data + listing->names->used;
+    memcpy(stored, name, length + 1);
+    listing->names->used += length + 1;
+
+    DirEntry* entry = &listing->chunks[chunk][index % DIR_CHUNK_ENTRIES];
+    entry->name = stored;
+    entry->nameLength = (int)length;
+    entry->isDir = isDir;
+    entry->size = size;
+    entry->mtime = mtime;
+
+    // Publish: the entry is fully written before readers can see it
+    atomic_store_explicit(&listing->count, index + 1, memory_order_release);
+    return true;
+}
+
+static void ScanDirectory(DirListing* listing) {
+#if defined(_WIN32)
+    char pattern[520];
+    snprintf(pattern, sizeof(pattern), "%s\\*", listing->path);
+
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(pattern, &data);
+    if (find == INVALID_HANDLE_VALUE) return;
+
+    do {
+        if (atomic_load_explicit(&listing->cancel, memory_order_relaxed)) break;
+        if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) continue;
+
+        uint64_t size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        uint64_t ticks = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        int64_t mtime = (int64_t)(ticks / 10000000ULL) - 11644473600LL;   // FILETIME to Unix time
+        bool isDir = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if (!AppendEntry(listing, data.cFileName, isDir, size, mtime)) break;
+    } while (FindNextFileA(find, &data));
+
+    FindClose(find);
+#else
+    DIR* dir = opendir(listing->path);
+    if (!dir) return;
+    int dirFd = dirfd(dir);
+
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (atomic_load_explicit(&listing->cancel, memory_order_relaxed)) break;
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+
+        // Follow symlinks so linked directories can be entered
+        struct stat st;
+        bool isDir = false;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        if (fstatat(dirFd, ent->d_name, &st, 0) == 0) {
+            isDir = S_ISDIR(st.st_mode);
+            size = (uint64_t)st.st_size;
+            mtime = (int64_t)st.st_mtime;
+        } else {
+            isDir = ent->d_type == DT_DIR;
+        }
+        if (!AppendEntry(listing, ent->d_name, isDir, size, mtime)) break;
+    }
+
+    closedir(dir);
+#endif
+}
+
+static void DrainWatchEvents(DirScanner* scanner) {
+#if defined(__linux__)
+    if (scanner->inotifyFd < 0) return;
+
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t length = read(scanner->inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        pthread_mutex_lock(&scanner->lock);
+        for (char* p = buffer; p < buffer + length;) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            for (int i = 0; i < scanner->cacheCount; i++) {
+                if (scanner->cache[i]->watch == event->wd) atomic_store(&scanner->cache[i]->stale, true);
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+        pthread_mutex_unlock(&scanner->lock);
+    }
+#else
+    (void)scanner;
+#endif
+}
+
+static void* DirScannerThread(void* arg) {
+    DirScanner* scanner = arg;
+    SetProfilerThreadName("Dir scanner");
+
+    for (;;) {
+        pthread_mutex_lock(&scanner->lock);
+        if (!scanner->stopping && !scanner->queueHead) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += WATCH_POLL_INTERVAL_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&scanner->wake, &scanner->lock, &deadline);
+        }
+        if (scanner->stopping) {
+            pthread_mutex_unlock(&scanner->lock);
+            break;
+        }
+
+        DirListing* job = scanner->queueHead;
+        if (job) {
+            scanner->queueHead = job->nextJob;
+            if (!scanner->queueHead) scanner->queueTail = NULL;
+        }
+        pthread_mutex_unlock(&scanner->lock);
+
+        if (job) {
+#if defined(__linux__)
+            // Watch before scanning so changes made during the scan are not missed
+            int watch = -1;
+            if (scanner->inotifyFd >= 0 && !atomic_load(&job->cancel)) {
+                watch = inotify_add_watch(scanner->inotifyFd, job->path, DIR_WATCH_MASK);
+            }
+#endif
+            PROFILE_BEGIN(scan, "ScanDirectory");
+            if (!atomic_load(&job->cancel)) ScanDirectory(job);
+            PROFILE_END(scan);
+            atomic_store_explicit(&job->complete, true, memory_order_release);
+
+            pthread_mutex_lock(&scanner->lock);
+#if defined(__linux__)
+            job->watch = watch;
+#endif
+            // Drop the reference taken when the job was queued
+            if (--job->refCount == 0 && !job->cached) FreeListing(scanner, job);
+            pthread_mutex_unlock(&scanner->lock);
+        }
+
+        DrainWatchEvents(scanner);
+    }
+    return NULL;
+}
+
+DirScanner* CreateDirScanner(void) {
+    DirScanner* scanner = calloc(1, sizeof(DirScanner));
+    if (!scanner) return NULL;
+
+#if defined(__linux__)
+    scanner->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#else
+    scanner->inotifyFd = -1;
+#endif
+
+    pthread_mutex_init(&scanner->lock, NULL);
+    pthread_cond_init(&scanner->wake, NULL);
+    if (pthread_create(&scanner->thread, NULL, DirScannerThread, scanner) != 0) {
+        pthread_cond_destroy(&scanner->wake);
+        pthread_mutex_destroy(&scanner->lock);
+#if defined(__linux__)
+        if (scanner->inotifyFd >= 0) close(scanner->inotifyFd);
+#endif
+        free(scanner);
+        return NULL;
+    }
+    return scanner;
+}
+
+void DestroyDirScanner(DirScanner* scanner) {
+    if (!scanner) return;
+
+    pthread_mutex_lock(&scanner->lock);
+    scanner->stopping = true;
+    for (int i = 0; i < scanner->cacheCount; i++) atomic_store(&scanner->cache[i]->cancel, true);
+    pthread_cond_signal(&scanner->wake);
+    pthread_mutex_unlock(&scanner->lock);
+    pthread_join(scanner->thread, NULL);
+
+    // Queued jobs still hold their scan reference; the ones already evicted
+    // from the cache are only kept alive by it
+    DirListing* job = scanner->queueHead;
+    while (job) {
+        DirListing* next = job->nextJob;
+        if (--job->refCount == 0 && !job->cached) FreeListing(scanner, job);
+        job = next;
+    }
+    scanner->queueHead = NULL;
+    scanner->queueTail = NULL;
+    while (scanner->cacheCount > 0) {
+        scanner->cache[0]->refCount = 0;
+        UncacheListing(scanner, 0);
+    }
+
+#if defined(__linux__)
+    if (scanner->inotifyFd >= 0) close(scanner->inotifyFd);
+#endif
+    pthread_cond_destroy(&scanner->wake);
+    pthread_mutex_destroy(&scanner->lock);
+    free(scanner);
+}
+
+DirListing* AcquireDirectory(DirScanner* scanner, const char* path) {
+    if (!scanner || !path) return NULL;
+
+    // Without inotify the directory's own mtime is the only staleness signal
+    int64_t dirMtime = scanner->inotifyFd < 0 ? GetDirectoryMtime(path) : 0;
+
+    pthread_mutex_lock(&scanner->lock);
+    for (int i = 0; i < scanner->cacheCount; i++) {
+        DirListing* cached = scanner->cache[i];
+        if (strcmp(cached->path, path) != 0) continue;
+
+        if (!atomic_load(&cached->stale) && cached->dirMtime == dirMtime) {
+            cached->refCount++;
+            cached->lastUsed = ++scanner->useCounter;
+            pthread_mutex_unlock(&scanner->lock);
+            return cached;
+        }
+        UncacheListing(scanner, i);
+        break;
+    }
+
+    // Make room by evicting the least recently used listing
+    if (scanner->cacheCount == DIR_CACHE_SIZE) {
+        int oldest = 0;
+        for (int i = 1; i < scanner->cacheCount; i++) {
+            if (scanner->cache[i]->lastUsed < scanner->cache[oldest]->lastUsed) oldest = i;
+        }
+        UncacheListing(scanner, oldest);
+    }
+
+    DirListing* listing = calloc(1, sizeof(DirListing));
+    if (!listing) {
+        pthread_mutex_unlock(&scanner->lock);
+        return NULL;
+    }
+    strncpy(listing->path, path, sizeof(listing->path) - 1);
+    listing->watch = -1;
+    listing->dirMtime = dirMtime;
+    listing->cached = true;
+    listing->refCount = 2;      // The caller and the queued scan
+    listing->lastUsed = ++scanner->useCounter;
+    scanner->cache[scanner->cacheCount++] = listing;
+
+    if (scanner->queueTail) scanner->queueTail->nextJob = listing;
+    else scanner->queueHead = listing;
+    scanner->queueTail = listing;
+    pthread_cond_signal(&scanner->wake);
+    pthread_mutex_unlock(&scanner->lock);
+
+    return listing;
+}
+
+void ReleaseDirectory(DirScanner* scanner, DirListing* listing) {
+    if (!scanner || !listing) return;
+
+    pthread_mutex_lock(&scanner->lock);
+    if (--listing->refCount == 0 && !listing->cached) FreeListing(scanner, listing);
+    pthread_mutex_unlock(&scanner->lock);
+}
+
+const char* GetListingPath(const DirListing* listing) {
+    return listing ? listing->path : "";
+}
+
+int GetDirectoryEntryCount(const DirListing* listing) {
+    return listing ? atomic_load_explicit(&listing->count, memory_order_acquire) : 0;
+}
+
+const DirEntry* GetDirectoryEntry(const DirListing* listing, int index) {
+    if (!listing || index < 0 || index >= GetDirectoryEntryCount(listing)) return NULL;
+    return &listing->chunks[index / DIR_CHUNK_ENTRIES][index % DIR_CHUNK_ENTRIES];
+}
+
+bool IsDirectoryScanComplete(const DirListing* listing) {
+    return !listing || atomic_load_explicit(&listing->complete, memory_order_acquire);
+}
+
+bool IsDirectoryStale(const DirListing* listing) {
+    return listing && atomic_load(&listing->stale);
+}
+
+bool StatDirectoryEntry(const DirListing* listing, int index, uint64_t* size, int64_t* mtime) {
+    const DirEntry* entry = GetDirectoryEntry(listing, index);
+    if (!entry) return false;
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", listing->path, entry->name);
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    if (size) *size = (uint64_t)st.st_size;
+    if (mtime) *mtime = (int64_t)st.st_mtime;
+    return true;
+}
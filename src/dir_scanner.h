@@ -0,0 +1,53 @@
+#ifndef DIR_SCANNER_H
+#define DIR_SCANNER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Background directory scanner with a per-directory entry cache.
+//
+// A listing is filled by the scanner thread while the UI reads it: entries
+// are stored in fixed chunks that never move, and the entry count is
+// published after each entry is complete, so the UI can draw
+// [0, GetDirectoryEntryCount()) at any time without locking.
+// On Linux cached listings are invalidated through inotify; elsewhere the
+// directory's own mtime is checked when a listing is acquired. Either way
+// only names appearing, disappearing or moving invalidate a listing, so a
+// file being written inside the directory does not cause rescans. Sizes
+// and times are as of the scan; StatDirectoryEntry reads them again.
+
+#define DIR_CHUNK_ENTRIES 1024
+#define DIR_MAX_CHUNKS 1024          // Up to ~1M entries per directory
+#define DIR_CACHE_SIZE 8
+
+typedef struct {
+    const char* name;
+    int nameLength;
+    bool isDir;
+    uint64_t size;          // As of the scan
+    int64_t mtime;
+} DirEntry;
+
+typedef struct DirListing DirListing;
+typedef struct DirScanner DirScanner;
+
+// Scanner lifetime
+DirScanner* CreateDirScanner(void);
+void DestroyDirScanner(DirScanner* scanner);
+
+// Listings are reference counted; acquire starts a scan if the directory is
+// not cached or its cached listing went stale
+DirListing* AcquireDirectory(DirScanner* scanner, const char* path);
+void ReleaseDirectory(DirScanner* scanner, DirListing* listing);
+
+// Listing queries (safe while the scan is still running)
+const char* GetListingPath(const DirListing* listing);
+int GetDirectoryEntryCount(const DirListing* listing);
+const DirEntry* GetDirectoryEntry(const DirListing* listing, int index);
+bool IsDirectoryScanComplete(const DirListing* listing);
+bool IsDirectoryStale(const DirListing* listing);
+
+// Current size and modification time of an entry, read from disk
+bool StatDirectoryEntry(const DirListing* listing, int index, uint64_t* size, int64_t* mtime);
+
+#endif // DIR_SCANNER_H
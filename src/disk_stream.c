@@ -0,0 +1,561 @@
+#include "disk_stream.h"
+#include "mapped_file.h"
+#include "wav_file.h"
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DISK_STREAM_IDLE_WAIT_MS 10
+#define DISK_STREAM_MAX_WANTED (MAX_TIMELINE_TRACKS * DISK_STREAM_TRACK_STREAMS)
+
+typedef enum {
+    STREAM_FREE,
+    STREAM_LIVE,
+    STREAM_RETIRED              // Off the audio path, freed once no render can still see it
+} DiskStreamState;
+
+typedef struct {
+    atomic_int state;
+
+    // Set by the UI thread before the stream goes live, read-only while it is
+    int element;                // Element slot
+    int sourceId;
+    float sourceOffset;
+    uint64_t clipStart;         // Timeline frames
+    uint64_t clipEnd;
+    uint64_t startFrame;        // Timeline frame at ring position 0
+    char path[256];
+    float* ring;                // Interleaved stereo
+    uint32_t ringFrames;        // Power of two
+    size_t bytes;
+
+    // I/O thread; the UI only touches them once the stream is retired and idle
+    bool opened;
+    MappedFile map;
+    WavData wav;
+    atomic_bool failed;
+
+    atomic_uint_least64_t filled;       // Frames past startFrame written by the I/O thread
+    atomic_uint_least64_t consumed;     // Frames past startFrame read by the audio thread
+
+    // UI thread
+    uint64_t retiredAt;         // Voice render count when retired
+    bool wanted;
+} DiskStream;
+
+typedef struct {
+    DiskStreamer* streamer;
+    DiskStream streams[DISK_STREAM_TRACK_STREAMS];
+    atomic_uint_least64_t renders;      // Odd while the audio thread is inside a render
+} DiskVoice;
+
+struct DiskStreamer {
+    Mixer* mixer;
+    int sampleRate;
+    size_t budget;
+    DiskVoice voices[MAX_TIMELINE_TRACKS];
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+    DiskStream* reading;        // Being filled by the I/O thread outside the lock
+
+    // Written by the audio thread
+    atomic_uint_least64_t underruns;
+
+    // Written by the I/O thread
+    atomic_uint_least64_t framesRead;
+
+    // UI thread
+    size_t bytes;
+    uint64_t skipped;
+};
+
+typedef struct {
+    int element;
+    int track;
+    uint64_t start;             // Timeline frame the stream has to begin at
+} WantedStream;
+
+static uint64_t SecondsToFrames(const DiskStreamer* streamer, float seconds) {
+    return seconds > 0.0f ? (uint64_t)((double)seconds * streamer->sampleRate + 0.5) : 0;
+}
+
+static uint64_t MinU64(uint64_t a, uint64_t b) {
+    return a < b ? a : b;
+}
+
+static uint64_t MaxU64(uint64_t a, uint64_t b) {
+    return a > b ? a : b;
+}
+
+//----------------------------------------------------------------------------------
+// Audio thread
+//----------------------------------------------------------------------------------
+
+// Where a stream would be read for a segment starting at `frame`, or false if
+// it cannot serve it: it starts later, or has already played past it
+static bool StreamReadPosition(DiskStream* stream, uint64_t frame, uint64_t* rel) {
+    uint64_t from = MaxU64(frame, stream->clipStart);
+    if (stream->startFrame > from) return false;
+    *rel = from - stream->startFrame;
+    return *rel >= atomic_load_explicit(&stream->consumed, memory_order_relaxed);
+}
+
+// With several streams of one clip live (the playing one and a pre-seek), the
+// one that continues where it stopped wins, then the one starting latest
+static bool IsPreferredStream(DiskVoice* voice, DiskStream* stream, uint64_t frame) {
+    uint64_t rel;
+    if (!StreamReadPosition(stream, frame, &rel)) return false;
+    bool continues = rel == atomic_load_explicit(&stream->consumed, memory_order_relaxed);
+
+    for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+        DiskStream* other = &voice->streams[i];
+        if (other == stream || atomic_load(&other->state) != STREAM_LIVE) continue;
+        if (other->element != stream->element) continue;
+
+        uint64_t otherRel;
+        if (!StreamReadPosition(other, frame, &otherRel)) continue;
+        bool otherContinues = otherRel == atomic_load_explicit(&other->consumed, memory_order_relaxed);
+        if (otherContinues != continues) {
+            if (otherContinues) return false;
+            continue;
+        }
+        if (other->startFrame > stream->startFrame || (other->startFrame == stream->startFrame && other < stream)) return false;
+    }
+    return true;
+}
+
+// Sums the streams overlapping [frame, frame + count) and returns how many
+// frames were complete before the first missing one
+static int RenderSegment(DiskVoice* voice, uint64_t frame, float* left, float* right, int count) {
+    memset(left, 0, (size_t)count * sizeof(float));
+    memset(right, 0, (size_t)count * sizeof(float));
+
+    // Choose before reading, reading moves the streams on
+    bool chosen[DISK_STREAM_TRACK_STREAMS];
+    for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+        DiskStream* stream = &voice->streams[i];
+        chosen[i] = atomic_load(&stream->state) == STREAM_LIVE &&
+                    stream->clipEnd > frame && stream->clipStart < frame + (uint64_t)count &&
+                    !atomic_load_explicit(&stream->failed, memory_order_relaxed) &&
+                    IsPreferredStream(voice, stream, frame);
+    }
+
+    int complete = count;
+    for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+        if (!chosen[i]) continue;
+        DiskStream* stream = &voice->streams[i];
+
+        uint64_t from = MaxU64(frame, stream->clipStart);
+        uint64_t to = MinU64(frame + (uint64_t)count, stream->clipEnd);
+        uint64_t rel = from - stream->startFrame;
+        uint64_t filled = atomic_load_explicit(&stream->filled, memory_order_acquire);
+        uint64_t have = filled > rel ? MinU64(filled - rel, to - from) : 0;
+
+        const float* ring = stream->ring;
+        uint32_t mask = stream->ringFrames - 1;
+        int offset = (int)(from - frame);
+        for (uint64_t f = 0; f < have; f++) {
+            const float* in = ring + ((rel + f) & mask) * 2;
+            left[offset + f] += in[0];
+            right[offset + f] += in[1];
+        }
+
+        // Frames skipped over by a late start are dropped, never rewound into
+        if (filled >= rel) atomic_store_explicit(&stream->consumed, rel + have, memory_order_release);
+        if (have < to - from) {
+            atomic_fetch_add_explicit(&voice->streamer->underruns, 1, memory_order_relaxed);
+            if (offset + (int)have < complete) complete = offset + (int)have;
+        }
+    }
+    return complete;
+}
+
+static int RenderDiskVoice(void* user, uint64_t frame, float* left, float* right, int frames) {
+    DiskVoice* voice = user;
+
+    // Sequentially consistent, so a retiring UI thread either sees this render
+    // in progress or the render sees the stream retired
+    atomic_fetch_add(&voice->renders, 1);
+    int produced = RenderSegment(voice, frame, left, right, frames);
+    atomic_fetch_add(&voice->renders, 1);
+    return produced;
+}
+
+//----------------------------------------------------------------------------------
+// I/O thread
+//----------------------------------------------------------------------------------
+
+// Decodes the next run of frames into the ring, resampling linearly when the
+// file rate differs from the mixer's
+static void FillStream(DiskStreamer* streamer, DiskStream* stream) {
+    if (!stream->opened) {
+        stream->opened = true;
+        if (!MapFile(stream->path, &stream->map) || !ParseWav(stream->map.data, stream->map.size, &stream->wav)) {
+            TraceLog(LOG_WARNING, "STREAM: Cannot stream %s", stream->path);
+            UnmapFile(&stream->map);
+            atomic_store(&stream->failed, true);
+            return;
+        }
+    }
+
+    const WavData* wav = &stream->wav;
+    uint64_t filled = atomic_load_explicit(&stream->filled, memory_order_relaxed);
+    uint64_t consumed = atomic_load_explicit(&stream->consumed, memory_order_acquire);
+    uint64_t count = MinU64(stream->ringFrames - (filled - consumed), stream->clipEnd - stream->startFrame - filled);
+    count = MinU64(count, DISK_STREAM_READ_FRAMES);
+
+    double step = (double)wav->sampleRate / streamer->sampleRate;
+    double origin = (double)stream->sourceOffset * wav->sampleRate + (double)(stream->startFrame - stream->clipStart) * step;
+    uint32_t mask = stream->ringFrames - 1;
+    for (uint64_t i = 0; i < count; i++) {
+        double source = origin + (double)(filled + i) * step;
+        float left = 0.0f, right = 0.0f;
+        if (source >= 0.0 && source < (double)wav->frames) {
+            uint64_t index = (uint64_t)source;
+            float frac = (float)(source - (double)index);
+            ReadWavFrame(wav, index, &left, &right);
+            if (frac > 0.0f && index + 1 < wav->frames) {
+                float nextLeft, nextRight;
+                ReadWavFrame(wav, index + 1, &nextLeft, &nextRight);
+                left += (nextLeft - left) * frac;
+                right += (nextRight - right) * frac;
+            }
+        }
+        float* out = stream->ring + ((filled + i) & mask) * 2;
+        out[0] = left;
+        out[1] = right;
+    }
+
+    atomic_store_explicit(&stream->filled, filled + count, memory_order_release);
+    atomic_fetch_add_explicit(&streamer->framesRead, count, memory_order_relaxed);
+}
+
+// The live stream with the least audio buffered that has room for a
+// worthwhile read. Caller holds the lock.
+static DiskStream* PickStreamToFill(DiskStreamer* streamer) {
+    DiskStream* best = NULL;
+    uint64_t bestBuffered = UINT64_MAX;
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+            DiskStream* stream = &streamer->voices[t].streams[i];
+            if (atomic_load_explicit(&stream->state, memory_order_relaxed) != STREAM_LIVE) continue;
+            if (atomic_load_explicit(&stream->failed, memory_order_relaxed)) continue;
+
+            uint64_t remaining = stream->clipEnd - stream->startFrame - atomic_load_explicit(&stream->filled, memory_order_relaxed);
+            if (remaining == 0) continue;
+            uint64_t buffered = atomic_load_explicit(&stream->filled, memory_order_relaxed) -
+                                atomic_load_explicit(&stream->consumed, memory_order_acquire);
+            uint64_t space = stream->ringFrames - buffered;
+            uint64_t batch = MinU64(MinU64(DISK_STREAM_READ_FRAMES, stream->ringFrames / 2), remaining);
+            if (space < batch) continue;
+
+            if (buffered < bestBuffered) {
+                best = stream;
+                bestBuffered = buffered;
+            }
+        }
+    }
+    return best;
+}
+
+static void* DiskStreamThread(void* arg) {
+    DiskStreamer* streamer = arg;
+
+    pthread_mutex_lock(&streamer->lock);
+    while (!streamer->stopping) {
+        DiskStream* stream = PickStreamToFill(streamer);
+        if (!stream) {
+            // The audio thread cannot signal, so draining rings are found by polling
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += DISK_STREAM_IDLE_WAIT_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&streamer->wake, &streamer->lock, &deadline);
+            continue;
+        }
+
+        streamer->reading = stream;
+        pthread_mutex_unlock(&streamer->lock);
+        FillStream(streamer, stream);
+        pthread_mutex_lock(&streamer->lock);
+        streamer->reading = NULL;
+    }
+    pthread_mutex_unlock(&streamer->lock);
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// UI thread
+//----------------------------------------------------------------------------------
+
+static void FreeStream(DiskStreamer* streamer, DiskStream* stream) {
+    UnmapFile(&stream->map);
+    free(stream->ring);
+    streamer->bytes -= stream->bytes;
+    stream->ring = NULL;
+    stream->bytes = 0;
+    stream->opened = false;
+    atomic_store(&stream->failed, false);
+    atomic_store(&stream->state, STREAM_FREE);
+}
+
+static void RetireStream(DiskVoice* voice, DiskStream* stream) {
+    atomic_store(&stream->state, STREAM_RETIRED);
+    stream->retiredAt = atomic_load(&voice->renders);
+}
+
+// Frees retired streams once neither the audio nor the I/O thread can be using them
+static void ReclaimStreams(DiskStreamer* streamer) {
+    pthread_mutex_lock(&streamer->lock);
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        DiskVoice* voice = &streamer->voices[t];
+        uint64_t renders = atomic_load(&voice->renders);
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+            DiskStream* stream = &voice->streams[i];
+            if (atomic_load_explicit(&stream->state, memory_order_relaxed) != STREAM_RETIRED) continue;
+            if (stream == streamer->reading) continue;
+            if ((stream->retiredAt & 1) && renders == stream->retiredAt) continue;
+            FreeStream(streamer, stream);
+        }
+    }
+    pthread_mutex_unlock(&streamer->lock);
+}
+
+static const char* FindAssetPath(const AppState* app, int assetId) {
+    for (uint32_t slot = 0; slot < app->assets.slotCount; slot++) {
+        const Asset* asset = PoolAt(&app->assets, slot);
+        if (asset && asset->id == assetId) return asset->path[0] ? asset->path : NULL;
+    }
+    return NULL;
+}
+
+// Audio elements on every track overlapping [from, to), each wanted from
+// max(its start, from)
+static int CollectWanted(const DiskStreamer* streamer, const AppState* app, float from, float to,
+                         WantedStream* wanted, int count) {
+    int hits[DISK_STREAM_TRACK_STREAMS];
+    for (int t = 0; t < app->trackCount && t < MAX_TIMELINE_TRACKS; t++) {
+        int found = QueryTimelineRange(&app->timelineIndex, t, from, to, hits, DISK_STREAM_TRACK_STREAMS);
+        if (found > DISK_STREAM_TRACK_STREAMS) found = DISK_STREAM_TRACK_STREAMS;
+
+        for (int i = 0; i < found && count < DISK_STREAM_MAX_WANTED; i++) {
+            const TimelineElement* element = PoolAt(&app->elements, (uint32_t)hits[i]);
+            if (!element || element->type != ELEMENT_TYPE_AUDIO || element->sourceId < 0) continue;
+            uint64_t clipStart = SecondsToFrames(streamer, element->startTime);
+            uint64_t clipEnd = SecondsToFrames(streamer, element->startTime + element->duration);
+            uint64_t start = MaxU64(clipStart, SecondsToFrames(streamer, from));
+            if (start >= clipEnd) continue;
+
+            bool duplicate = false;
+            for (int w = 0; w < count && !duplicate; w++) duplicate = wanted[w].element == hits[i] && wanted[w].start == start;
+            if (!duplicate) wanted[count++] = (WantedStream){ hits[i], t, start };
+        }
+    }
+    return count;
+}
+
+// A live stream serves a wanted start if it belongs to the same clip layout
+// and is (about) where the wanted start is. Right after a seek the audio
+// thread has not moved yet, so nothing past the start will do.
+static bool StreamServes(const DiskStreamer* streamer, DiskStream* stream, const TimelineElement* element,
+                         uint64_t start, bool seeking) {
+    if (stream->sourceId != element->sourceId || stream->sourceOffset != element->sourceOffset) return false;
+    if (stream->clipStart != SecondsToFrames(streamer, element->startTime)) return false;
+    if (stream->clipEnd != SecondsToFrames(streamer, element->startTime + element->duration)) return false;
+    if (stream->startFrame > start) return false;
+
+    // The audio thread may have read ahead of the position the UI last saw
+    uint64_t slack = seeking ? 0 : (uint64_t)streamer->sampleRate / 10;
+    uint64_t at = stream->startFrame + atomic_load_explicit(&stream->consumed, memory_order_acquire);
+    return at <= start + slack && at + slack >= start;
+}
+
+static uint32_t RingFramesFor(const DiskStreamer* streamer, int streams) {
+    size_t share = streamer->budget / (size_t)(streams > 0 ? streams : 1) / (2 * sizeof(float));
+    uint32_t limit = (uint32_t)(DISK_STREAM_MAX_RING_SECONDS * streamer->sampleRate);
+    uint32_t frames = DISK_STREAM_MIN_RING_FRAMES;
+    while ((size_t)frames * 2 <= share && frames * 2 <= limit) frames *= 2;
+    return frames;
+}
+
+static void OpenStream(DiskStreamer* streamer, const AppState* app, const WantedStream* want, uint32_t ringFrames) {
+    const TimelineElement* element = PoolAt(&app->elements, (uint32_t)want->element);
+    const char* path = FindAssetPath(app, element->sourceId);
+    if (!path) return;
+
+    // Shrink the ring rather than skip the clip when the budget is tight
+    while (ringFrames > DISK_STREAM_MIN_RING_FRAMES && streamer->bytes + ringFrames * 2 * sizeof(float) > streamer->budget) {
+        ringFrames /= 2;
+    }
+    size_t bytes = (size_t)ringFrames * 2 * sizeof(float);
+
+    DiskVoice* voice = &streamer->voices[want->track];
+    DiskStream* stream = NULL;
+    for (int i = 0; i < DISK_STREAM_TRACK_STREAMS && !stream; i++) {
+        if (atomic_load_explicit(&voice->streams[i].state, memory_order_relaxed) == STREAM_FREE) stream = &voice->streams[i];
+    }
+    float* ring = stream && streamer->bytes + bytes <= streamer->budget ? malloc(bytes) : NULL;
+    if (!ring) {
+        streamer->skipped++;
+        return;
+    }
+
+    pthread_mutex_lock(&streamer->lock);
+    stream->element = want->element;
+    stream->sourceId = element->sourceId;
+    stream->sourceOffset = element->sourceOffset;
+    stream->clipStart = SecondsToFrames(streamer, element->startTime);
+    stream->clipEnd = SecondsToFrames(streamer, element->startTime + element->duration);
+    stream->startFrame = want->start;
+    strncpy(stream->path, path, sizeof(stream->path) - 1);
+    stream->path[sizeof(stream->path) - 1] = '\0';
+    stream->ring = ring;
+    stream->ringFrames = ringFrames;
+    stream->bytes = bytes;
+    stream->wanted = true;
+    atomic_store_explicit(&stream->filled, 0, memory_order_relaxed);
+    atomic_store_explicit(&stream->consumed, 0, memory_order_relaxed);
+    atomic_store(&stream->state, STREAM_LIVE);
+    streamer->bytes += bytes;
+    pthread_cond_signal(&streamer->wake);
+    pthread_mutex_unlock(&streamer->lock);
+}
+
+DiskStreamer* CreateDiskStreamer(Mixer* mixer, size_t budgetBytes) {
+    if (!mixer) return NULL;
+
+    DiskStreamer* streamer = calloc(1, sizeof(DiskStreamer));
+    if (!streamer) return NULL;
+    streamer->mixer = mixer;
+    streamer->sampleRate = GetMixerSampleRate(mixer);
+    streamer->budget = budgetBytes > 0 ? budgetBytes : DISK_STREAM_DEFAULT_BUDGET;
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) streamer->voices[t].streamer = streamer;
+
+    pthread_mutex_init(&streamer->lock, NULL);
+    pthread_cond_init(&streamer->wake, NULL);
+    if (pthread_create(&streamer->thread, NULL, DiskStreamThread, streamer) != 0) {
+        TraceLog(LOG_WARNING, "STREAM: Failed to start the I/O thread");
+        pthread_cond_destroy(&streamer->wake);
+        pthread_mutex_destroy(&streamer->lock);
+        free(streamer);
+        return NULL;
+    }
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SetMixerTrackSource(mixer, t, DISK_STREAM_MIXER_SLOT, RenderDiskVoice, &streamer->voices[t]);
+    }
+    TraceLog(LOG_INFO, "STREAM: %zu KB ring budget", streamer->budget >> 10);
+    return streamer;
+}
+
+void DestroyDiskStreamer(DiskStreamer* streamer) {
+    if (!streamer) return;
+
+    pthread_mutex_lock(&streamer->lock);
+    streamer->stopping = true;
+    pthread_cond_signal(&streamer->wake);
+    pthread_mutex_unlock(&streamer->lock);
+    pthread_join(streamer->thread, NULL);
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+            DiskStream* stream = &streamer->voices[t].streams[i];
+            if (atomic_load(&stream->state) != STREAM_FREE) FreeStream(streamer, stream);
+        }
+    }
+    pthread_cond_destroy(&streamer->wake);
+    pthread_mutex_destroy(&streamer->lock);
+    free(streamer);
+}
+
+void UpdateDiskStreamer(DiskStreamer* streamer, const AppState* app) {
+    if (!streamer || !app) return;
+
+    ReclaimStreams(streamer);
+
+    // Right after a seek the audio thread has not moved yet, so streams have
+    // to start exactly at the new position
+    uint64_t position = GetMixerPosition(streamer->mixer);
+    bool seeking = IsMixerSeeking(streamer->mixer);
+
+    uint64_t loopStart = 0, loopEnd = 0;
+    if (app->timeline.loopEnabled && app->timeline.loopEnd > app->timeline.loopStart) {
+        loopStart = SecondsToFrames(streamer, app->timeline.loopStart);
+        loopEnd = SecondsToFrames(streamer, app->timeline.loopEnd);
+    }
+
+    // Clips in the prefetch window; a window crossing the loop end continues
+    // from the loop start so the wrap finds its streams already filled
+    WantedStream wanted[DISK_STREAM_MAX_WANTED];
+    float now = (float)((double)position / streamer->sampleRate);
+    float windowEnd = now + DISK_STREAM_PREFETCH_SECONDS;
+    int wantedCount = 0;
+    if (loopEnd > loopStart && position < loopEnd && windowEnd > app->timeline.loopEnd) {
+        wantedCount = CollectWanted(streamer, app, now, app->timeline.loopEnd, wanted, wantedCount);
+        float wrapped = fminf(app->timeline.loopStart + (windowEnd - app->timeline.loopEnd), app->timeline.loopEnd);
+        wantedCount = CollectWanted(streamer, app, app->timeline.loopStart, wrapped, wanted, wantedCount);
+    } else {
+        wantedCount = CollectWanted(streamer, app, now, windowEnd, wanted, wantedCount);
+    }
+
+    // Keep streams that serve a wanted start, retire the rest
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) streamer->voices[t].streams[i].wanted = false;
+    }
+    bool served[DISK_STREAM_MAX_WANTED] = { false };
+    for (int w = 0; w < wantedCount; w++) {
+        const TimelineElement* element = PoolAt(&app->elements, (uint32_t)wanted[w].element);
+        DiskVoice* voice = &streamer->voices[wanted[w].track];
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS && !served[w]; i++) {
+            DiskStream* stream = &voice->streams[i];
+            if (atomic_load_explicit(&stream->state, memory_order_relaxed) != STREAM_LIVE || stream->element != wanted[w].element) continue;
+            if (!StreamServes(streamer, stream, element, wanted[w].start, seeking)) continue;
+            stream->wanted = true;
+            served[w] = true;
+        }
+    }
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        DiskVoice* voice = &streamer->voices[t];
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+            DiskStream* stream = &voice->streams[i];
+            if (atomic_load_explicit(&stream->state, memory_order_relaxed) == STREAM_LIVE && !stream->wanted) {
+                RetireStream(voice, stream);
+            }
+        }
+    }
+
+    // Open the missing ones nearest first, so a tight budget goes to the
+    // clips that play soonest
+    uint32_t ringFrames = RingFramesFor(streamer, wantedCount);
+    for (;;) {
+        int next = -1;
+        for (int w = 0; w < wantedCount; w++) {
+            if (!served[w] && (next < 0 || wanted[w].start < wanted[next].start)) next = w;
+        }
+        if (next < 0) break;
+        served[next] = true;
+        OpenStream(streamer, app, &wanted[next], ringFrames);
+    }
+}
+
+DiskStreamStats GetDiskStreamStats(DiskStreamer* streamer) {
+    DiskStreamStats stats = { 0 };
+    if (!streamer) return stats;
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        for (int i = 0; i < DISK_STREAM_TRACK_STREAMS; i++) {
+            if (atomic_load_explicit(&streamer->voices[t].streams[i].state, memory_order_relaxed) == STREAM_LIVE) stats.streams++;
+        }
+    }
+    stats.bytes = streamer->bytes;
+    stats.budget = streamer->budget;
+    stats.skipped = streamer->skipped;
+    stats.underruns = atomic_load_explicit(&streamer->underruns, memory_order_relaxed);
+    stats.framesRead = atomic_load_explicit(&streamer->framesRead, memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,56 @@
+#ifndef DISK_STREAM_H
+#define DISK_STREAM_H
+
+#include "app_state.h"
+#include "mixer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Disk streaming playback of audio elements.
+//
+// Clips are never loaded whole. Every audio element that is playing, or
+// starts within DISK_STREAM_PREFETCH_SECONDS of the playhead, gets a stream:
+// a ring of decoded stereo frames that an I/O thread keeps topped up from the
+// source file while the mixer drains it on the audio thread. Each track is
+// one mixer source summing the streams of its clips, following the mixer's
+// transport.
+//
+// A stream starts at a fixed timeline frame and only moves forward, so a jump
+// is served by a stream opened at the new position. While stopped, streams
+// wait at the playhead and fill before play is pressed; while looping, the
+// clips at the loop start are opened before the wrap comes round. Ring sizes
+// are carved out of one byte budget, so memory follows the number of clips
+// near the playhead rather than the length of the session.
+//
+// Only WAV is streamed; compressed formats would have to be decoded whole.
+
+#define DISK_STREAM_MIXER_SLOT 0
+#define DISK_STREAM_DEFAULT_BUDGET (64u << 20)
+#define DISK_STREAM_PREFETCH_SECONDS 2.0f
+#define DISK_STREAM_TRACK_STREAMS 8         // Clips in the window plus pre-seeks, per track
+#define DISK_STREAM_MIN_RING_FRAMES 8192
+#define DISK_STREAM_MAX_RING_SECONDS 4.0f
+#define DISK_STREAM_READ_FRAMES 16384       // Frames decoded per I/O pass
+
+typedef struct DiskStreamer DiskStreamer;
+
+typedef struct {
+    int streams;                // Live streams
+    size_t bytes;               // Ring memory, including retired rings not yet freed
+    size_t budget;
+    uint64_t underruns;         // Blocks where a stream was not filled far enough
+    uint64_t framesRead;        // Frames decoded by the I/O thread
+    uint64_t skipped;           // Streams not opened because the budget or the track's slots ran out
+} DiskStreamStats;
+
+// Lifetime. Registers itself as a source of every timeline track. The audio
+// thread may hold streams until the mixer is gone, so destroy the mixer first.
+DiskStreamer* CreateDiskStreamer(Mixer* mixer, size_t budgetBytes);   // 0 for the default budget
+void DestroyDiskStreamer(DiskStreamer* streamer);
+
+// UI thread, once per frame after SyncMixerTransport
+void UpdateDiskStreamer(DiskStreamer* streamer, const AppState* app);
+
+DiskStreamStats GetDiskStreamStats(DiskStreamer* streamer);
+
+#endif // DISK_STREAM_H
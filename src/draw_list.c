@@ -0,0 +1,273 @@
+#include "draw_list.h"
+#include "text_cache.h"
+#include "profiler.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define UI_CIRCLE_VERTICES 72   // DrawCircleV: 36 segments drawn as 18 quads
+
+typedef enum {
+    UI_PRIM_RECT,
+    UI_PRIM_RECT_LINES,
+    UI_PRIM_CIRCLE,
+    UI_PRIM_TEXTURE,
+    UI_PRIM_TEXT,
+    UI_PRIM_LINE
+} UiPrimitive;
+
+typedef enum {
+    UI_MODE_QUADS,
+    UI_MODE_LINES
+} UiBatchMode;
+
+typedef struct {
+    uint32_t layer;
+    uint8_t primitive;
+    uint8_t mode;               // UiBatchMode
+    unsigned int textureId;     // Batch key, not necessarily the texture drawn
+    Rectangle rect;             // Line: x,y = start, width,height = end; circle: x,y = center, width = radius
+    Rectangle source;
+    Texture2D texture;
+    Color color;
+    float size;                 // Line thickness or font size
+    uint32_t textOffset;
+} UiDrawCommand;
+
+typedef struct {
+    bool clip;
+    Rectangle area;
+} UiLayer;
+
+static struct {
+    bool recording;
+    UiDrawCommand* commands;
+    int count;
+    int capacity;
+    char* text;
+    uint32_t textSize;
+    uint32_t textCapacity;
+    UiLayer* layers;
+    int layerCount;
+    int layerCapacity;
+    UiDrawStats stats;
+} drawList;
+
+static bool Grow(void** items, int* capacity, int needed, size_t itemSize) {
+    if (needed <= *capacity) return true;
+    int newCapacity = *capacity ? *capacity * 2 : 256;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* grown = realloc(*items, (size_t)newCapacity * itemSize);
+    if (!grown) return false;
+    *items = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static bool PushLayer(bool clip, Rectangle area) {
+    if (!Grow((void**)&drawList.layers, &drawList.layerCapacity, drawList.layerCount + 1, sizeof(UiLayer))) return false;
+    drawList.layers[drawList.layerCount++] = (UiLayer){ clip, area };
+    return true;
+}
+
+static UiDrawCommand* PushCommand(UiPrimitive primitive, UiBatchMode mode, unsigned int textureId) {
+    if (!Grow((void**)&drawList.commands, &drawList.capacity, drawList.count + 1, sizeof(UiDrawCommand))) return NULL;
+    UiDrawCommand* command = &drawList.commands[drawList.count++];
+    memset(command, 0, sizeof(*command));
+    command->layer = (uint32_t)(drawList.layerCount - 1);
+    command->primitive = (uint8_t)primitive;
+    command->mode = (uint8_t)mode;
+    command->textureId = textureId;
+    return command;
+}
+
+static int CommandVertices(const UiDrawCommand* command) {
+    switch (command->primitive) {
+        case UI_PRIM_RECT:       return 4;
+        case UI_PRIM_RECT_LINES: return 16;
+        case UI_PRIM_CIRCLE:     return UI_CIRCLE_VERTICES;
+        case UI_PRIM_TEXTURE:    return 4;
+        case UI_PRIM_LINE:       return 2;
+        case UI_PRIM_TEXT:       return GetTextLayout(drawList.text + command->textOffset, command->size).quadCount * 4;
+        default:                 return 0;
+    }
+}
+
+static void ExecuteCommand(const UiDrawCommand* command) {
+    switch (command->primitive) {
+        case UI_PRIM_RECT:
+            DrawRectangleRec(command->rect, command->color);
+            break;
+        case UI_PRIM_RECT_LINES:
+            DrawRectangleLinesEx(command->rect, command->size, command->color);
+            break;
+        case UI_PRIM_CIRCLE:
+            DrawCircleV((Vector2){ command->rect.x, command->rect.y }, command->rect.width, command->color);
+            break;
+        case UI_PRIM_TEXTURE:
+            DrawTexturePro(command->texture, command->source, command->rect, (Vector2){ 0, 0 }, 0.0f, command->color);
+            break;
+        case UI_PRIM_TEXT:
+            DrawTextCached(drawList.text + command->textOffset, (Vector2){ command->rect.x, command->rect.y },
+                           command->size, command->color);
+            break;
+        case UI_PRIM_LINE:
+            DrawLineV((Vector2){ command->rect.x, command->rect.y },
+                      (Vector2){ command->rect.width, command->rect.height }, command->color);
+            break;
+    }
+}
+
+// Batches raylib will flush: a new one on every change of batch mode,
+// texture or scissor region between neighbouring commands
+static int CountBatches(void) {
+    int batches = 0;
+    uint32_t layer = UINT32_MAX;
+    int mode = -1;
+    unsigned int textureId = 0;
+
+    for (int i = 0; i < drawList.count; i++) {
+        const UiDrawCommand* command = &drawList.commands[i];
+        bool clipChanged = layer != UINT32_MAX && command->layer != layer &&
+                           (drawList.layers[layer].clip || drawList.layers[command->layer].clip);
+        if (clipChanged || command->mode != mode || command->textureId != textureId) batches++;
+        layer = command->layer;
+        mode = command->mode;
+        textureId = command->textureId;
+    }
+    return batches;
+}
+
+void BeginUiDrawList(void) {
+    drawList.recording = true;
+    drawList.count = 0;
+    drawList.textSize = 0;
+    drawList.layerCount = 0;
+    PushLayer(false, (Rectangle){ 0 });
+}
+
+void EndUiDrawList(void) {
+    if (!drawList.recording) return;
+    PROFILE_SCOPE("EndUiDrawList");
+    drawList.recording = false;
+
+    UiDrawStats stats = { 0 };
+    stats.commands = drawList.count;
+    stats.drawCalls = CountBatches();
+
+    // Without a window (headless benchmarks) the list is counted but
+    // nothing is submitted
+    bool submit = IsWindowReady();
+    uint32_t layer = UINT32_MAX;
+    bool clipping = false;
+    for (int i = 0; i < drawList.count; i++) {
+        const UiDrawCommand* command = &drawList.commands[i];
+        stats.vertices += CommandVertices(command);
+        if (!submit) continue;
+        if (command->layer != layer) {
+            layer = command->layer;
+            const UiLayer* info = &drawList.layers[layer];
+            if (clipping) EndScissorMode();
+            clipping = info->clip;
+            if (clipping) {
+                BeginScissorMode((int)info->area.x, (int)info->area.y, (int)info->area.width, (int)info->area.height);
+            }
+        }
+        ExecuteCommand(command);
+    }
+    if (clipping) EndScissorMode();
+
+    drawList.stats = stats;
+}
+
+void UnloadUiDrawList(void) {
+    free(drawList.commands);
+    free(drawList.text);
+    free(drawList.layers);
+    memset(&drawList, 0, sizeof(drawList));
+}
+
+UiDrawStats GetUiDrawStats(void) {
+    return drawList.stats;
+}
+
+void UiNextLayer(void) {
+    if (drawList.recording) PushLayer(false, (Rectangle){ 0 });
+}
+
+void UiBeginScissor(Rectangle area) {
+    if (drawList.recording) PushLayer(true, area);
+    else BeginScissorMode((int)area.x, (int)area.y, (int)area.width, (int)area.height);
+}
+
+void UiEndScissor(void) {
+    if (drawList.recording) PushLayer(false, (Rectangle){ 0 });
+    else EndScissorMode();
+}
+
+void UiDrawRectangle(Rectangle rect, Color color) {
+    if (!drawList.recording) { DrawRectangleRec(rect, color); return; }
+    UiDrawCommand* command = PushCommand(UI_PRIM_RECT, UI_MODE_QUADS, GetShapesTexture().id);
+    if (!command) return;
+    command->rect = rect;
+    command->color = color;
+}
+
+void UiDrawRectangleLines(Rectangle rect, float thickness, Color color) {
+    if (!drawList.recording) { DrawRectangleLinesEx(rect, thickness, color); return; }
+    UiDrawCommand* command = PushCommand(UI_PRIM_RECT_LINES, UI_MODE_QUADS, GetShapesTexture().id);
+    if (!command) return;
+    command->rect = rect;
+    command->size = thickness;
+    command->color = color;
+}
+
+void UiDrawLine(Vector2 start, Vector2 end, Color color) {
+    if (!drawList.recording) { DrawLineV(start, end, color); return; }
+    UiDrawCommand* command = PushCommand(UI_PRIM_LINE, UI_MODE_LINES, 0);
+    if (!command) return;
+    command->rect = (Rectangle){ start.x, start.y, end.x, end.y };
+    command->color = color;
+}
+
+void UiDrawCircle(Vector2 center, float radius, Color color) {
+    if (!drawList.recording) { DrawCircleV(center, radius, color); return; }
+    UiDrawCommand* command = PushCommand(UI_PRIM_CIRCLE, UI_MODE_QUADS, GetShapesTexture().id);
+    if (!command) return;
+    command->rect = (Rectangle){ center.x, center.y, radius, 0 };
+    command->color = color;
+}
+
+void UiDrawTexture(Texture2D texture, Rectangle source, Rectangle dest, Color tint) {
+    if (!drawList.recording) { DrawTexturePro(texture, source, dest, (Vector2){ 0, 0 }, 0.0f, tint); return; }
+    UiDrawCommand* command = PushCommand(UI_PRIM_TEXTURE, UI_MODE_QUADS, texture.id);
+    if (!command) return;
+    command->texture = texture;
+    command->source = source;
+    command->rect = dest;
+    command->color = tint;
+}
+
+void UiDrawText(const char* text, float x, float y, int fontSize, Color color) {
+    if (!text || !text[0]) return;
+    if (!drawList.recording) { DrawTextCached(text, (Vector2){ x, y }, (float)fontSize, color); return; }
+
+    // Callers often pass TextFormat's rotating buffers, so the string is copied
+    uint32_t length = (uint32_t)strlen(text) + 1;
+    if (drawList.textSize + length > drawList.textCapacity) {
+        uint32_t capacity = drawList.textCapacity ? drawList.textCapacity : 4096;
+        while (capacity < drawList.textSize + length) capacity *= 2;
+        char* grown = realloc(drawList.text, capacity);
+        if (!grown) return;
+        drawList.text = grown;
+        drawList.textCapacity = capacity;
+    }
+
+    UiDrawCommand* command = PushCommand(UI_PRIM_TEXT, UI_MODE_QUADS, GetTextAtlasTexture((float)fontSize).id);
+    if (!command) return;
+    memcpy(drawList.text + drawList.textSize, text, length);
+    command->textOffset = drawList.textSize;
+    drawList.textSize += length;
+    command->rect = (Rectangle){ x, y, 0, 0 };
+    command->size = (float)fontSize;
+    command->color = color;
+}
@@ -0,0 +1,47 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Retained draw list for the UI.
+//
+// Between BeginUiDrawList and EndUiDrawList the UiDraw* functions record
+// commands instead of drawing. At the end the commands are submitted in the
+// order they were recorded, so later calls always draw over earlier ones.
+// Neighbouring commands that share a batch mode and texture reach raylib's
+// batcher back to back and cost one draw call; a widget batches best by
+// drawing its fills before its text rather than alternating them. Outside
+// a list the same calls draw immediately.
+//
+// Layers group the commands of an overlay (popups, panels on top of other
+// panels) and carry scissor regions; drawing order is the recording order
+// either way.
+
+typedef struct {
+    int commands;           // Commands recorded
+    int drawCalls;          // Batches submitted
+    int vertices;
+} UiDrawStats;
+
+// Frame
+void BeginUiDrawList(void);
+void EndUiDrawList(void);
+void UnloadUiDrawList(void);
+UiDrawStats GetUiDrawStats(void);      // Last submitted list
+
+// Layers and clipping; a scissor region is always a layer of its own
+void UiNextLayer(void);
+void UiBeginScissor(Rectangle area);
+void UiEndScissor(void);
+
+// Primitives
+void UiDrawRectangle(Rectangle rect, Color color);
+void UiDrawRectangleLines(Rectangle rect, float thickness, Color color);
+void UiDrawLine(Vector2 start, Vector2 end, Color color);
+void UiDrawCircle(Vector2 center, float radius, Color color);
+void UiDrawTexture(Texture2D texture, Rectangle source, Rectangle dest, Color tint);
+void UiDrawText(const char* text, float x, float y, int fontSize, Color color);
+
+#endif // DRAW_LIST_H
@@ -0,0 +1,287 @@
+#include "ecs.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#if defined(_WIN32)
+    #define strcasecmp _stricmp
+#endif
+
+// Where an entity's components live
+typedef struct {
+    uint32_t archetype;
+    uint32_t row;
+} EcsLocation;
+
+static void InitArchetype(EcsArchetype* archetype, EcsMask mask) {
+    memset(archetype, 0, sizeof(*archetype));
+    archetype->mask = mask;
+    for (int t = 0; t < ECS_MAX_COMPONENT_TYPES; t++) {
+        archetype->addEdge[t] = -1;
+        archetype->removeEdge[t] = -1;
+    }
+}
+
+static void FreeArchetype(EcsArchetype* archetype) {
+    free(archetype->entities);
+    for (int t = 0; t < ECS_MAX_COMPONENT_TYPES; t++) free(archetype->columns[t]);
+}
+
+static int FindArchetype(EcsWorld* world, EcsMask mask) {
+    for (int a = 0; a < world->archetypeCount; a++) {
+        if (world->archetypes[a].mask == mask) return a;
+    }
+
+    if (world->archetypeCount == world->archetypeCapacity) {
+        int capacity = world->archetypeCapacity ? world->archetypeCapacity * 2 : 16;
+        EcsArchetype* archetypes = realloc(world->archetypes, (size_t)capacity * sizeof(EcsArchetype));
+        if (!archetypes) return -1;
+        world->archetypes = archetypes;
+        world->archetypeCapacity = capacity;
+    }
+    InitArchetype(&world->archetypes[world->archetypeCount], mask);
+    return world->archetypeCount++;
+}
+
+// Archetype for mask with one type added or removed, cached on the edge
+static int NeighbourArchetype(EcsWorld* world, int from, int type, bool add) {
+    int* edge = add ? &world->archetypes[from].addEdge[type] : &world->archetypes[from].removeEdge[type];
+    if (*edge >= 0) return *edge;
+
+    EcsMask mask = world->archetypes[from].mask;
+    mask = add ? (mask | ECS_MASK(type)) : (mask & ~ECS_MASK(type));
+    int to = FindArchetype(world, mask);   // May move the archetype array
+    if (to >= 0) {
+        edge = add ? &world->archetypes[from].addEdge[type] : &world->archetypes[from].removeEdge[type];
+        *edge = to;
+    }
+    return to;
+}
+
+static bool ReserveRows(const EcsWorld* world, EcsArchetype* archetype, uint32_t needed) {
+    if (needed <= archetype->capacity) return true;
+
+    uint32_t capacity = archetype->capacity ? archetype->capacity * 2 : 64;
+    while (capacity < needed) capacity *= 2;
+
+    Entity* entities = realloc(archetype->entities, capacity * sizeof(Entity));
+    if (!entities) return false;
+    archetype->entities = entities;
+
+    for (int t = 0; t < world->typeCount; t++) {
+        if (!(archetype->mask & ECS_MASK(t))) continue;
+        unsigned char* column = realloc(archetype->columns[t], (size_t)capacity * world->types[t].size);
+        if (!column) return false;
+        archetype->columns[t] = column;
+    }
+    archetype->capacity = capacity;
+    return true;
+}
+
+static void* ColumnRow(const EcsWorld* world, const EcsArchetype* archetype, int type, uint32_t row) {
+    return archetype->columns[type] + (size_t)row * world->types[type].size;
+}
+
+// Append an uninitialized row; returns the row index or UINT32_MAX
+static uint32_t PushRow(EcsWorld* world, int archetypeIndex, Entity entity) {
+    EcsArchetype* archetype = &world->archetypes[archetypeIndex];
+    if (!ReserveRows(world, archetype, archetype->count + 1)) return UINT32_MAX;
+    archetype->entities[archetype->count] = entity;
+    return archetype->count++;
+}
+
+// Swap-remove a row, patching the location of the entity moved into it
+static void RemoveRow(EcsWorld* world, int archetypeIndex, uint32_t row) {
+    EcsArchetype* archetype = &world->archetypes[archetypeIndex];
+    uint32_t last = --archetype->count;
+    if (row == last) return;
+
+    Entity moved = archetype->entities[last];
+    archetype->entities[row] = moved;
+    for (int t = 0; t < world->typeCount; t++) {
+        if (!(archetype->mask & ECS_MASK(t))) continue;
+        memcpy(ColumnRow(world, archetype, t, row), ColumnRow(world, archetype, t, last), world->types[t].size);
+    }
+
+    EcsLocation* location = PoolGet(&world->entities, moved);
+    if (location) location->row = row;
+}
+
+void InitEcsWorld(EcsWorld* world, const EcsComponentInfo* types, int typeCount) {
+    memset(world, 0, sizeof(*world));
+    world->types = types;
+    world->typeCount = typeCount < ECS_MAX_COMPONENT_TYPES ? typeCount : ECS_MAX_COMPONENT_TYPES;
+    InitPool(&world->entities, sizeof(EcsLocation));
+    FindArchetype(world, 0);
+}
+
+void UnloadEcsWorld(EcsWorld* world) {
+    for (int a = 0; a < world->archetypeCount; a++) FreeArchetype(&world->archetypes[a]);
+    free(world->archetypes);
+    UnloadPool(&world->entities);
+    world->archetypes = NULL;
+    world->archetypeCount = 0;
+    world->archetypeCapacity = 0;
+}
+
+void ClearEcsWorld(EcsWorld* world) {
+    // Archetypes and their storage are kept for the next scene
+    for (int a = 0; a < world->archetypeCount; a++) world->archetypes[a].count = 0;
+    ClearPool(&world->entities);
+}
+
+static Entity PlaceEntity(EcsWorld* world, Entity entity) {
+    EcsLocation* location = PoolGet(&world->entities, entity);
+    if (!location) return ECS_NULL_ENTITY;
+
+    if (world->archetypeCount == 0 && FindArchetype(world, 0) != 0) {
+        PoolFree(&world->entities, entity);
+        return ECS_NULL_ENTITY;
+    }
+
+    uint32_t row = PushRow(world, 0, entity);
+    if (row == UINT32_MAX) {
+        PoolFree(&world->entities, entity);
+        return ECS_NULL_ENTITY;
+    }
+    location->archetype = 0;
+    location->row = row;
+    return entity;
+}
+
+Entity EcsCreateEntity(EcsWorld* world) {
+    return PlaceEntity(world, PoolAlloc(&world->entities));
+}
+
+Entity EcsCreateEntityAt(EcsWorld* world, uint32_t slot) {
+    return PlaceEntity(world, PoolAllocAt(&world->entities, slot));
+}
+
+void EcsDestroyEntity(EcsWorld* world, Entity entity) {
+    EcsLocation* location = PoolGet(&world->entities, entity);
+    if (!location) return;
+    RemoveRow(world, (int)location->archetype, location->row);
+    PoolFree(&world->entities, entity);
+}
+
+bool EcsIsAlive(const EcsWorld* world, Entity entity) {
+    return PoolGet(&world->entities, entity) != NULL;
+}
+
+Entity EcsEntityAt(const EcsWorld* world, uint32_t slot) {
+    return PoolHandleAt(&world->entities, slot);
+}
+
+EcsMask EcsGetMask(const EcsWorld* world, Entity entity) {
+    const EcsLocation* location = PoolGet(&world->entities, entity);
+    return location ? world->archetypes[location->archetype].mask : 0;
+}
+
+uint32_t EcsEntityCount(const EcsWorld* world) {
+    return world->entities.liveCount;
+}
+
+// Move an entity's row to another archetype, carrying over shared columns
+static bool MoveEntity(EcsWorld* world, Entity entity, EcsLocation* location, int to) {
+    int from = (int)location->archetype;
+    uint32_t row = PushRow(world, to, entity);
+    if (row == UINT32_MAX) return false;
+
+    const EcsArchetype* source = &world->archetypes[from];
+    const EcsArchetype* target = &world->archetypes[to];
+    EcsMask shared = source->mask & target->mask;
+    for (int t = 0; t < world->typeCount; t++) {
+        if (!(shared & ECS_MASK(t))) continue;
+        memcpy(ColumnRow(world, target, t, row), ColumnRow(world, source, t, location->row), world->types[t].size);
+    }
+
+    RemoveRow(world, from, location->row);
+    location->archetype = (uint32_t)to;
+    location->row = row;
+    return true;
+}
+
+void* EcsAddComponent(EcsWorld* world, Entity entity, int type) {
+    if (type < 0 || type >= world->typeCount) return NULL;
+    EcsLocation* location = PoolGet(&world->entities, entity);
+    if (!location) return NULL;
+
+    if (!(world->archetypes[location->archetype].mask & ECS_MASK(type))) {
+        int to = NeighbourArchetype(world, (int)location->archetype, type, true);
+        if (to < 0 || !MoveEntity(world, entity, location, to)) return NULL;
+        void* component = ColumnRow(world, &world->archetypes[to], type, location->row);
+        EcsResetComponent(world, type, component);
+        return component;
+    }
+    return ColumnRow(world, &world->archetypes[location->archetype], type, location->row);
+}
+
+void EcsRemoveComponent(EcsWorld* world, Entity entity, int type) {
+    if (type < 0 || type >= world->typeCount) return;
+    EcsLocation* location = PoolGet(&world->entities, entity);
+    if (!location || !(world->archetypes[location->archetype].mask & ECS_MASK(type))) return;
+
+    int to = NeighbourArchetype(world, (int)location->archetype, type, false);
+    if (to >= 0) MoveEntity(world, entity, location, to);
+}
+
+void* EcsGetComponent(const EcsWorld* world, Entity entity, int type) {
+    if (type < 0 || type >= world->typeCount) return NULL;
+    const EcsLocation* location = PoolGet(&world->entities, entity);
+    if (!location) return NULL;
+
+    const EcsArchetype* archetype = &world->archetypes[location->archetype];
+    if (!(archetype->mask & ECS_MASK(type))) return NULL;
+    return ColumnRow(world, archetype, type, location->row);
+}
+
+void EcsResetComponent(const EcsWorld* world, int type, void* component) {
+    const EcsComponentInfo* info = &world->types[type];
+    if (info->defaults) memcpy(component, info->defaults, info->size);
+    else memset(component, 0, info->size);
+}
+
+int EcsFindComponentType(const EcsWorld* world, const char* name) {
+    for (int t = 0; name && t < world->typeCount; t++) {
+        if (strcasecmp(world->types[t].name, name) == 0) return t;
+    }
+    return -1;
+}
+
+const EcsField* EcsFindField(const EcsComponentInfo* info, const char* name) {
+    for (int f = 0; name && f < info->fieldCount; f++) {
+        if (strcasecmp(info->fields[f].name, name) == 0) return &info->fields[f];
+    }
+    return NULL;
+}
+
+EcsQuery EcsQueryBegin(const EcsWorld* world, EcsMask include, EcsMask exclude) {
+    EcsQuery query = { 0 };
+    query.world = world;
+    query.include = include;
+    query.exclude = exclude;
+    query.archetype = -1;
+    return query;
+}
+
+bool EcsQueryNext(EcsQuery* query) {
+    const EcsWorld* world = query->world;
+    while (++query->archetype < world->archetypeCount) {
+        const EcsArchetype* archetype = &world->archetypes[query->archetype];
+        if (archetype->count == 0) continue;
+        if ((archetype->mask & query->include) != query->include || (archetype->mask & query->exclude)) continue;
+
+        query->count = archetype->count;
+        query->entities = archetype->entities;
+        return true;
+    }
+    query->count = 0;
+    query->entities = NULL;
+    return false;
+}
+
+void* EcsQueryColumn(const EcsQuery* query, int type) {
+    if (query->archetype < 0 || query->archetype >= query->world->archetypeCount) return NULL;
+    if (type < 0 || type >= ECS_MAX_COMPONENT_TYPES) return NULL;
+    return query->world->archetypes[query->archetype].columns[type];
+}
@@ -0,0 +1,117 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include "pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Archetype entity/component store.
+//
+// Entities with the same set of component types share an archetype, which
+// keeps one tightly packed column per component type. A system that needs
+// transforms and sprites walks only the archetypes containing both, and
+// inside each one sweeps two contiguous arrays.
+//
+// Entity ids are pool handles: the pool item records where the entity's row
+// currently lives, and a destroyed entity's id stops resolving.
+
+#define ECS_MAX_COMPONENT_TYPES 32
+#define ECS_MAX_FIELDS 8
+
+typedef PoolHandle Entity;
+typedef uint32_t EcsMask;
+
+#define ECS_NULL_ENTITY POOL_NULL_HANDLE
+#define ECS_MASK(type) ((EcsMask)1u << (type))
+
+typedef enum {
+    ECS_FIELD_FLOAT,
+    ECS_FIELD_INT,
+    ECS_FIELD_BOOL,
+    ECS_FIELD_COLOR,
+    ECS_FIELD_STRING        // char[size], shown but not edited as a value
+} EcsFieldType;
+
+// Editable field of a component type; names and ranges are stored once per
+// type instead of once per instance
+typedef struct {
+    const char* name;
+    EcsFieldType type;
+    uint32_t offset;
+    uint32_t size;
+    float min;
+    float max;
+} EcsField;
+
+typedef struct {
+    const char* name;
+    uint32_t fourcc;            // Stable id, used as the project file section id
+    uint32_t size;
+    const void* defaults;       // Initial value for new components, NULL for zero
+    EcsField fields[ECS_MAX_FIELDS];
+    int fieldCount;
+} EcsComponentInfo;
+
+typedef struct {
+    EcsMask mask;
+    Entity* entities;
+    unsigned char* columns[ECS_MAX_COMPONENT_TYPES];   // NULL for types not in the mask
+    uint32_t count;
+    uint32_t capacity;
+    int addEdge[ECS_MAX_COMPONENT_TYPES];       // Archetype reached by adding a type, -1 if not cached
+    int removeEdge[ECS_MAX_COMPONENT_TYPES];
+} EcsArchetype;
+
+typedef struct {
+    const EcsComponentInfo* types;
+    int typeCount;
+    EcsArchetype* archetypes;   // Index 0 is the empty archetype
+    int archetypeCount;
+    int archetypeCapacity;
+    Pool entities;              // EcsLocation per entity
+} EcsWorld;
+
+typedef struct {
+    const EcsWorld* world;
+    EcsMask include;
+    EcsMask exclude;
+    int archetype;
+
+    // Current batch, valid after EcsQueryNext returns true
+    uint32_t count;
+    const Entity* entities;
+} EcsQuery;
+
+// World lifetime
+void InitEcsWorld(EcsWorld* world, const EcsComponentInfo* types, int typeCount);
+void UnloadEcsWorld(EcsWorld* world);
+void ClearEcsWorld(EcsWorld* world);
+
+// Entities
+Entity EcsCreateEntity(EcsWorld* world);
+Entity EcsCreateEntityAt(EcsWorld* world, uint32_t slot);
+void EcsDestroyEntity(EcsWorld* world, Entity entity);
+bool EcsIsAlive(const EcsWorld* world, Entity entity);
+Entity EcsEntityAt(const EcsWorld* world, uint32_t slot);
+EcsMask EcsGetMask(const EcsWorld* world, Entity entity);
+uint32_t EcsEntityCount(const EcsWorld* world);
+
+// Components
+void* EcsAddComponent(EcsWorld* world, Entity entity, int type);     // Returns the existing one if present
+void EcsRemoveComponent(EcsWorld* world, Entity entity, int type);
+void* EcsGetComponent(const EcsWorld* world, Entity entity, int type);
+void EcsResetComponent(const EcsWorld* world, int type, void* component);
+int EcsFindComponentType(const EcsWorld* world, const char* name);
+const EcsField* EcsFindField(const EcsComponentInfo* info, const char* name);
+
+// Iteration over every entity that has all of include and none of exclude:
+//   for (EcsQuery q = EcsQueryBegin(world, mask, 0); EcsQueryNext(&q);) {
+//       TransformComponent* transforms = EcsQueryColumn(&q, COMPONENT_TRANSFORM);
+//       for (uint32_t i = 0; i < q.count; i++) ...
+//   }
+EcsQuery EcsQueryBegin(const EcsWorld* world, EcsMask include, EcsMask exclude);
+bool EcsQueryNext(EcsQuery* query);
+void* EcsQueryColumn(const EcsQuery* query, int type);
+
+#endif // ECS_H
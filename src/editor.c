@@ -0,0 +1,178 @@
+#include "editor.h"
+#include "app_state.h"
+#include "timeline.h"
+#include "ui_components.h"
+#include "text_cache.h"
+#include "history.h"
+#include "journal.h"
+#include "scene.h"
+#include "utils.h"
+#include "thumbnail_cache.h"
+#include "asset_database.h"
+#include "profiler.h"
+
+#define EDITOR_TOOLBAR_HEIGHT 30
+#define EDITOR_ASSETS_HEIGHT 150
+#define EDITOR_INSPECTOR_WIDTH 260
+#define EDITOR_TIMELINE_HEIGHT 180     // Matches the timeline's own height
+
+struct Editor {
+    AppState app;
+    JobSystem* jobs;
+    bool focused;               // Last frame, to refresh assets when the window comes back
+};
+
+Editor* CreateEditor(JobSystem* jobs) {
+    Editor* editor = calloc(1, sizeof(Editor));
+    if (!editor) return NULL;
+
+    editor->jobs = jobs;
+    InitApp(&editor->app, jobs);
+    editor->focused = true;
+    editor->app.currentScreen = SCREEN_EDITOR;
+    return editor;
+}
+
+void DestroyEditor(Editor* editor) {
+    if (!editor) return;
+    UnloadApp(&editor->app);
+    free(editor);
+}
+
+bool OpenEditorProject(Editor* editor, const char* projectDir) {
+    if (!editor || !projectDir || !projectDir[0]) return false;
+    AppState* app = &editor->app;
+
+    ClearProjectData(app);
+    LoadProject(app, projectDir);
+
+    const char* name = strrchr(projectDir, '/');
+#if defined(_WIN32)
+    const char* backslash = strrchr(projectDir, '\\');
+    if (backslash && (!name || backslash > name)) name = backslash;
+#endif
+    snprintf(app->projectName, sizeof(app->projectName), "%s", name ? name + 1 : projectDir);
+
+    // A fresh project gets one track to put things on; it is not an edit to undo
+    if (app->trackCount == 0) {
+        CreateTrack(app, "Track 1", COLOR_ACCENT);
+        ClearHistory(app->history);
+    }
+
+    // Sources may have been edited since the artifacts were made
+    AddProjectAssets(app->assetDatabase, app);
+    StartAssetRefresh(app->assetDatabase);
+    return true;
+}
+
+// Panel rectangles follow the window size
+static void LayoutEditor(AppState* app) {
+    float w = (float)GetScreenWidth();
+    float h = (float)GetScreenHeight();
+
+    app->panels[PANEL_ASSETS].bounds = (Rectangle){ 0, h - EDITOR_ASSETS_HEIGHT, w, EDITOR_ASSETS_HEIGHT };
+    app->panels[PANEL_ASSETS].visible = true;
+    app->panels[PANEL_INSPECTOR].bounds = (Rectangle){
+        w - EDITOR_INSPECTOR_WIDTH, EDITOR_TOOLBAR_HEIGHT, EDITOR_INSPECTOR_WIDTH,
+        h - EDITOR_ASSETS_HEIGHT - EDITOR_TIMELINE_HEIGHT - EDITOR_TOOLBAR_HEIGHT
+    };
+    app->panels[PANEL_INSPECTOR].visible = true;
+}
+
+static Rectangle GetSceneView(const AppState* app) {
+    Rectangle inspector = app->panels[PANEL_INSPECTOR].bounds;
+    return (Rectangle){ 0, EDITOR_TOOLBAR_HEIGHT, inspector.x, inspector.height };
+}
+
+static void DrawPanelFrame(const Panel* panel, const char* title) {
+    UiDrawRectangle(panel->bounds, COLOR_PANEL_BG);
+    UiDrawRectangle((Rectangle){ panel->bounds.x, panel->bounds.y, panel->bounds.width, 22 }, COLOR_PANEL_HEADER);
+    UiDrawText(title, panel->bounds.x + 8, panel->bounds.y + 3, 16, COLOR_TEXT);
+}
+
+// Returns false when the Menu button was pressed
+static bool DrawToolbar(AppState* app) {
+    int w = GetScreenWidth();
+    UiDrawRectangle((Rectangle){ 0, 0, w, EDITOR_TOOLBAR_HEIGHT }, COLOR_PANEL_HEADER);
+    UiDrawText(TextFormat("%s%s", app->projectName, app->projectModified ? " *" : ""), 10, 6, 18, COLOR_TEXT);
+
+    bool stay = !Button((Rectangle){ w - 90, 4, 80, 22 }, "Menu", false);
+    if (Button((Rectangle){ w - 180, 4, 80, 22 }, app->saveTicket ? "Saving..." : "Save", false)) SaveProject(app);
+    if (Button((Rectangle){ w - 270, 4, 80, 22 }, app->isPlaying ? "Stop" : "Play", app->isPlaying)) {
+        app->isPlaying = !app->isPlaying;
+    }
+
+    const char* undo = GetUndoLabel(app->history);
+    if (undo) {
+        float x = w - 280 - MeasureTextCached(TextFormat("Undo: %s", undo), 14).x;
+        UiDrawText(TextFormat("Undo: %s", undo), x, 8, 14, COLOR_TEXT_DIM);
+    }
+    return stay;
+}
+
+bool UpdateEditor(Editor* editor, FrameScheduler* scheduler) {
+    if (!editor) return false;
+    PROFILE_SCOPE("UpdateEditor");
+    AppState* app = &editor->app;
+
+    app->deltaTime = GetFrameTime();
+    app->prevMousePosition = app->mousePosition;
+    app->mousePosition = GetMousePosition();
+    LayoutEditor(app);
+
+    // Coming back from another program, which may have edited sources
+    bool focused = IsWindowFocused();
+    if (focused && !editor->focused) StartAssetRefresh(app->assetDatabase);
+    editor->focused = focused;
+
+    // The last frame's draw list has been submitted, so thumbnails it asked
+    // for can be uploaded now
+    UpdateThumbnailCache(app->thumbnails);
+
+    bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    if (control && IsKeyPressed(KEY_S)) SaveProject(app);
+    if (IsKeyPressed(KEY_SPACE)) app->isPlaying = !app->isPlaying;
+
+    // The scene view draws straight away, underneath the recorded UI
+    Rectangle sceneView = GetSceneView(app);
+    DrawScene(app, sceneView);
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(app->mousePosition, sceneView)) {
+        app->selectedEntity = PickSceneEntity(app, SceneScreenToWorld(app, sceneView, app->mousePosition));
+    }
+
+    UpdateTimeline(app);
+    DrawTimeline(app);
+
+    const Panel* inspector = &app->panels[PANEL_INSPECTOR];
+    DrawPanelFrame(inspector, "Inspector");
+    if (EcsIsAlive(&app->scene, app->selectedEntity)) {
+        Rectangle area = { inspector->bounds.x, inspector->bounds.y + 24, inspector->bounds.width, inspector->bounds.height - 24 };
+        float bottom = area.y + area.height;
+        for (int type = 0; type < COMPONENT_TYPE_COUNT && area.height > 0; type++) {
+            if (!EcsGetComponent(&app->scene, app->selectedEntity, type)) continue;
+            DrawPropertyEditor(app, app->selectedEntity, type, area);
+            area.y += (SCENE_COMPONENT_TYPES[type].fieldCount + 1) * PROPERTY_ROW_HEIGHT + 4;
+            area.height = bottom - area.y;
+        }
+    }
+    const Panel* assets = &app->panels[PANEL_ASSETS];
+    DrawPanelFrame(assets, "Assets");
+    DrawAssetGrid(app, (Rectangle){ assets->bounds.x, assets->bounds.y + 22, assets->bounds.width, assets->bounds.height - 22 });
+
+    bool stay = DrawToolbar(app);
+
+    // End of the frame: this frame's edits become one undo step (or join
+    // the last one), then the journal gets to confirm saves and compact
+    UpdateHistory(app);
+    UpdateJournal(app);
+
+    if (app->isPlaying) RequestFrame(scheduler);
+    if (app->saveTicket || AreTimelinePeaksPending(app) || IsThumbnailWorkPending(app->thumbnails) ||
+        AreAssetImportsPending(app->assetDatabase)) {
+        RequestBackgroundFrame(scheduler);
+    }
+
+    // Leaving stops playback; unsaved edits stay in the journal
+    if (!stay) app->isPlaying = false;
+    return stay;
+}
@@ -0,0 +1,28 @@
+#ifndef EDITOR_H
+#define EDITOR_H
+
+#include "job_system.h"
+#include "frame_scheduler.h"
+#include <stdbool.h>
+
+// The project editor screen.
+//
+// Owns the AppState of the open project and runs one editor frame at a
+// time from the menu's main loop, between BeginUiDrawList and
+// EndUiDrawList: input, the panels and timeline, then the end-of-frame
+// bookkeeping (closing the undo step, confirming saves and compacting the
+// journal). Kept behind a handle so the menu does not see AppState.
+
+typedef struct Editor Editor;
+
+// Editor lifetime; destroy before the job system
+Editor* CreateEditor(JobSystem* jobs);
+void DestroyEditor(Editor* editor);
+
+// Load a project folder, replacing whatever was open
+bool OpenEditorProject(Editor* editor, const char* projectDir);
+
+// One frame; returns false once the user asked to leave the editor
+bool UpdateEditor(Editor* editor, FrameScheduler* scheduler);
+
+#endif // EDITOR_H
@@ -0,0 +1,124 @@
+#include "file_filter.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool FuzzyMatch(const char* query, const char* text) {
+    while (*query && *text) {
+        if (tolower((unsigned char)*query) == tolower((unsigned char)*text)) query++;
+        text++;
+    }
+    return *query == '\0';
+}
+
+// Every name matching `query` also matches `base` when base is a subsequence of query
+static bool RefinesQuery(const char* base, const char* query) {
+    while (*base && *query) {
+        if (tolower((unsigned char)*base) == tolower((unsigned char)*query)) base++;
+        query++;
+    }
+    return *base == '\0';
+}
+
+static bool PushMatch(FilterLevel* level, int index) {
+    if (level->matchCount == level->matchCapacity) {
+        int capacity = level->matchCapacity ? level->matchCapacity * 2 : 256;
+        int* matches = realloc(level->matches, capacity * sizeof(int));
+        if (!matches) return false;
+        level->matches = matches;
+        level->matchCapacity = capacity;
+    }
+    level->matches[level->matchCount++] = index;
+    return true;
+}
+
+static void ClearLevels(FileFilter* filter, int keep) {
+    for (int i = keep; i < filter->levelCount; i++) {
+        free(filter->levels[i].matches);
+        memset(&filter->levels[i], 0, sizeof(FilterLevel));
+    }
+    filter->levelCount = keep;
+}
+
+// Test entries published since the level was last brought up to date
+static void CatchUpLevel(const FileFilter* filter, FilterLevel* level) {
+    int count = GetDirectoryEntryCount(filter->listing);
+    for (int i = level->scannedCount; i < count; i++) {
+        const DirEntry* entry = GetDirectoryEntry(filter->listing, i);
+        if (FuzzyMatch(level->query, entry->name) && !PushMatch(level, i)) return;
+    }
+    level->scannedCount = count;
+}
+
+void InitFileFilter(FileFilter* filter) {
+    memset(filter, 0, sizeof(*filter));
+}
+
+void UnloadFileFilter(FileFilter* filter) {
+    ClearLevels(filter, 0);
+    filter->listing = NULL;
+}
+
+void SetFileFilterQuery(FileFilter* filter, const char* query) {
+    if (!query) query = "";
+
+    // Drop levels that the new query does not refine
+    int keep = filter->levelCount;
+    while (keep > 0 && !RefinesQuery(filter->levels[keep - 1].query, query)) keep--;
+    ClearLevels(filter, keep);
+
+    if (query[0] == '\0') return;
+    if (keep > 0 && strcmp(filter->levels[keep - 1].query, query) == 0) {
+        CatchUpLevel(filter, &filter->levels[keep - 1]);
+        return;
+    }
+
+    // Keep the deepest levels when the history is full
+    if (filter->levelCount == FILTER_MAX_LEVELS) {
+        free(filter->levels[0].matches);
+        memmove(&filter->levels[0], &filter->levels[1], (FILTER_MAX_LEVELS - 1) * sizeof(FilterLevel));
+        memset(&filter->levels[FILTER_MAX_LEVELS - 1], 0, sizeof(FilterLevel));
+        filter->levelCount--;
+    }
+
+    FilterLevel* level = &filter->levels[filter->levelCount++];
+    strncpy(level->query, query, FILTER_MAX_QUERY - 1);
+    level->query[FILTER_MAX_QUERY - 1] = '\0';
+
+    if (filter->levelCount > 1) {
+        // Refine the previous result set
+        FilterLevel* base = &filter->levels[filter->levelCount - 2];
+        CatchUpLevel(filter, base);
+        for (int i = 0; i < base->matchCount; i++) {
+            const DirEntry* entry = GetDirectoryEntry(filter->listing, base->matches[i]);
+            if (FuzzyMatch(level->query, entry->name) && !PushMatch(level, base->matches[i])) break;
+        }
+        level->scannedCount = base->scannedCount;
+    } else {
+        CatchUpLevel(filter, level);
+    }
+}
+
+void UpdateFileFilter(FileFilter* filter, const DirListing* listing) {
+    if (filter->listing != listing) {
+        // A new listing invalidates every level; rebuild the current query
+        char query[FILTER_MAX_QUERY] = "";
+        if (filter->levelCount > 0) strcpy(query, filter->levels[filter->levelCount - 1].query);
+        ClearLevels(filter, 0);
+        filter->listing = listing;
+        SetFileFilterQuery(filter, query);
+        return;
+    }
+
+    if (filter->levelCount > 0) CatchUpLevel(filter, &filter->levels[filter->levelCount - 1]);
+}
+
+int GetFilterMatchCount(const FileFilter* filter) {
+    if (filter->levelCount == 0) return GetDirectoryEntryCount(filter->listing);
+    return filter->levels[filter->levelCount - 1].matchCount;
+}
+
+int GetFilterMatch(const FileFilter* filter, int index) {
+    if (filter->levelCount == 0) return index;
+    return filter->levels[filter->levelCount - 1].matches[index];
+}
@@ -0,0 +1,41 @@
+#ifndef FILE_FILTER_H
+#define FILE_FILTER_H
+
+#include "dir_scanner.h"
+
+// Incremental fuzzy filter over a directory listing.
+//
+// A query matches a name when its characters appear in the name in order
+// (case-insensitive). Typing another character can only shrink the result
+// set, so each level refines the level below it instead of rescanning the
+// whole directory; deleting characters pops back to a cached level. Entries
+// that arrive while the directory is still being scanned are tested as they
+// are published.
+
+#define FILTER_MAX_QUERY 128
+#define FILTER_MAX_LEVELS 16
+
+typedef struct {
+    char query[FILTER_MAX_QUERY];
+    int* matches;           // Listing indices, in listing order
+    int matchCount;
+    int matchCapacity;
+    int scannedCount;       // Listing entries already tested at this level
+} FilterLevel;
+
+typedef struct {
+    const DirListing* listing;
+    FilterLevel levels[FILTER_MAX_LEVELS];
+    int levelCount;         // Zero means no query: every entry matches
+} FileFilter;
+
+// Filter functions
+void InitFileFilter(FileFilter* filter);
+void UnloadFileFilter(FileFilter* filter);
+void SetFileFilterQuery(FileFilter* filter, const char* query);
+void UpdateFileFilter(FileFilter* filter, const DirListing* listing);
+int GetFilterMatchCount(const FileFilter* filter);
+int GetFilterMatch(const FileFilter* filter, int index);
+bool FuzzyMatch(const char* query, const char* text);
+
+#endif // FILE_FILTER_H
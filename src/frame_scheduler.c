@@ -0,0 +1,116 @@
+#include "frame_scheduler.h"
+#include <string.h>
+
+#define FRAME_GRACE_SECONDS 0.5f    // Hover effects and key repeat settle within this
+
+// Keys held without new events (a held arrow key) still count as interaction
+static bool HasInput(FrameScheduler* scheduler) {
+    Vector2 mouse = GetMousePosition();
+    bool moved = mouse.x != scheduler->lastMouse.x || mouse.y != scheduler->lastMouse.y;
+    scheduler->lastMouse = mouse;
+    if (moved || GetMouseWheelMove() != 0.0f || IsWindowResized()) return true;
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++) {
+        if (IsMouseButtonDown(button)) return true;
+    }
+    for (int key = KEY_SPACE; key <= KEY_KB_MENU; key++) {
+        if (IsKeyDown(key)) return true;
+    }
+    return false;
+}
+
+static void ApplyMode(const FrameScheduler* scheduler) {
+    switch (scheduler->mode) {
+        case FRAME_MODE_ACTIVE:
+            DisableEventWaiting();
+            SetTargetFPS(scheduler->activeFps);
+            break;
+        case FRAME_MODE_BACKGROUND:
+            DisableEventWaiting();
+            SetTargetFPS(scheduler->backgroundFps);
+            break;
+        case FRAME_MODE_IDLE:
+            // The frame after a wake is input driven and runs at full rate
+            EnableEventWaiting();
+            SetTargetFPS(scheduler->activeFps);
+            break;
+    }
+}
+
+void InitFrameScheduler(FrameScheduler* scheduler, int activeFps, int backgroundFps) {
+    if (!scheduler) return;
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->activeFps = activeFps > 0 ? activeFps : 60;
+    scheduler->backgroundFps = backgroundFps > 0 ? backgroundFps : 10;
+    scheduler->graceFrames = (int)(scheduler->activeFps * FRAME_GRACE_SECONDS);
+    if (scheduler->graceFrames < 2) scheduler->graceFrames = 2;
+    scheduler->mode = FRAME_MODE_ACTIVE;
+    scheduler->activeFramesLeft = scheduler->graceFrames;
+    scheduler->lastMouse = GetMousePosition();
+    ApplyMode(scheduler);
+}
+
+void BeginScheduledFrame(FrameScheduler* scheduler) {
+    if (!scheduler) return;
+
+    // Time since the last frame started, including any sleep or wait, is charged to its mode
+    double now = GetTime();
+    if (scheduler->stats.frames > 0) {
+        double elapsed = now - scheduler->frameStart;
+        scheduler->stats.lastFrameTime = elapsed;
+        switch (scheduler->mode) {
+            case FRAME_MODE_ACTIVE:     scheduler->stats.activeTime += elapsed; break;
+            case FRAME_MODE_BACKGROUND: scheduler->stats.backgroundTime += elapsed; break;
+            case FRAME_MODE_IDLE:       scheduler->stats.idleTime += elapsed; break;
+        }
+    }
+    scheduler->frameStart = now;
+
+    scheduler->stats.frames++;
+    switch (scheduler->mode) {
+        case FRAME_MODE_ACTIVE:     scheduler->stats.activeFrames++; break;
+        case FRAME_MODE_BACKGROUND: scheduler->stats.backgroundFrames++; break;
+        case FRAME_MODE_IDLE:       scheduler->stats.idleFrames++; break;
+    }
+
+    // Returning from an idle wait means an event arrived
+    bool input = HasInput(scheduler);
+    if (input || scheduler->mode == FRAME_MODE_IDLE) scheduler->activeFramesLeft = scheduler->graceFrames;
+    scheduler->backgroundRequested = false;
+}
+
+void ScheduleNextFrame(FrameScheduler* scheduler) {
+    if (!scheduler) return;
+
+    FrameMode previous = scheduler->mode;
+    if (scheduler->activeFramesLeft > 0) {
+        scheduler->mode = FRAME_MODE_ACTIVE;
+        scheduler->activeFramesLeft--;
+    } else if (scheduler->backgroundRequested) {
+        scheduler->mode = FRAME_MODE_BACKGROUND;
+    } else {
+        scheduler->mode = FRAME_MODE_IDLE;
+    }
+    if (scheduler->mode != previous) ApplyMode(scheduler);
+}
+
+void RequestFrame(FrameScheduler* scheduler) {
+    if (scheduler && scheduler->activeFramesLeft < 1) scheduler->activeFramesLeft = 1;
+}
+
+void RequestBackgroundFrame(FrameScheduler* scheduler) {
+    if (scheduler) scheduler->backgroundRequested = true;
+}
+
+FrameStats GetFrameStats(const FrameScheduler* scheduler) {
+    return scheduler ? scheduler->stats : (FrameStats){ 0 };
+}
+
+const char* GetFrameModeName(FrameMode mode) {
+    switch (mode) {
+        case FRAME_MODE_ACTIVE:     return "active";
+        case FRAME_MODE_BACKGROUND: return "background";
+        case FRAME_MODE_IDLE:       return "idle";
+        default:                    return "unknown";
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Decides how fast the main loop runs.
+//
+// While the user is interacting, something is animating or playback is
+// running, frames go out at the full rate. While background work is in
+// flight (a directory scan, thumbnails) the loop polls at a low rate so the
+// result shows up without spinning. Otherwise EndDrawing blocks in raylib's
+// event waiting until the next input event, and an idle editor costs nothing.
+//
+// Usage per frame:
+//   BeginScheduledFrame(&scheduler);
+//   BeginDrawing(); ... RequestFrame() / RequestBackgroundFrame() as needed ...
+//   ScheduleNextFrame(&scheduler);
+//   EndDrawing();                      // sleeps or waits as scheduled
+
+typedef enum {
+    FRAME_MODE_ACTIVE,          // Full rate
+    FRAME_MODE_BACKGROUND,      // Low rate until background work finishes
+    FRAME_MODE_IDLE             // Wait for input
+} FrameMode;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t activeFrames;
+    uint64_t backgroundFrames;
+    uint64_t idleFrames;        // Frames drawn after waking from an idle wait
+    double activeTime;          // Seconds spent in frames of each mode, waits included
+    double backgroundTime;
+    double idleTime;
+    double lastFrameTime;
+} FrameStats;
+
+typedef struct {
+    int activeFps;
+    int backgroundFps;
+    int graceFrames;            // Full-rate frames kept after the last input or request
+    FrameMode mode;             // Mode the current frame was scheduled with
+    int activeFramesLeft;
+    bool backgroundRequested;
+    double frameStart;
+    Vector2 lastMouse;
+    FrameStats stats;
+} FrameScheduler;
+
+void InitFrameScheduler(FrameScheduler* scheduler, int activeFps, int backgroundFps);
+void BeginScheduledFrame(FrameScheduler* scheduler);
+void ScheduleNextFrame(FrameScheduler* scheduler);
+
+// Requests made while building a frame apply to the ones after it
+void RequestFrame(FrameScheduler* scheduler);               // Animation, playback, anything visible changing
+void RequestBackgroundFrame(FrameScheduler* scheduler);     // Work in flight whose result must show up
+
+FrameStats GetFrameStats(const FrameScheduler* scheduler);
+const char* GetFrameModeName(FrameMode mode);
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,599 @@
+#include "history.h"
+#include "scene.h"
+
+#define HISTORY_LABEL_SIZE 32
+#define HISTORY_RUN_GAP 16      // Equal bytes between two differing runs that are kept rather than split
+
+// One changed object. The images follow the header: old then new when the
+// object was alive on both sides, otherwise only the alive side's bytes.
+typedef struct {
+    uint8_t kind;
+    uint8_t wasAlive;
+    uint8_t isAlive;
+    uint8_t reserved;
+    uint32_t slot;
+    uint32_t sub;
+    uint32_t offset;
+    uint32_t size;              // Bytes per image
+} HistoryChange;
+
+typedef struct {
+    char label[HISTORY_LABEL_SIZE];
+    unsigned char* data;        // HistoryChange records back to back
+    size_t size;
+    int changeCount;
+} HistoryStep;
+
+// Object state at its first capture in the open step
+typedef struct {
+    JournalObjectKind kind;
+    uint32_t slot;
+    uint32_t sub;
+    bool alive;
+    size_t offset;              // Into History.before
+    size_t size;
+} HistoryCaptureRecord;
+
+typedef struct {
+    unsigned char* bytes;
+    size_t size;
+    bool alive;
+    bool valid;
+} ObjectView;
+
+struct History {
+    // Ring of steps; [0, cursor) can be undone, [cursor, count) redone
+    HistoryStep* steps;
+    int capacity;
+    int first;
+    int count;
+    int cursor;
+    size_t bytes;
+    size_t limit;
+    uint64_t dropped;
+
+    // Open step
+    char label[HISTORY_LABEL_SIZE];
+    uint64_t mergeKey;
+    double lastMergeTime;
+    bool failed;                // A capture could not be stored
+    HistoryCaptureRecord* captures;
+    int captureCount;
+    int captureCapacity;
+    int32_t* lookup;            // Open addressing, capture index + 1, 0 for empty
+    uint32_t lookupCapacity;
+    unsigned char* before;
+    size_t beforeSize;
+    size_t beforeCapacity;
+    unsigned char* scratch;     // Record being built for the step
+    size_t scratchSize;
+    size_t scratchCapacity;
+};
+
+static bool GrowBuffer(unsigned char** data, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) return true;
+
+    size_t newCapacity = *capacity ? *capacity * 2 : 4096;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    unsigned char* grown = realloc(*data, newCapacity);
+    if (!grown) return false;
+    *data = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Objects
+//----------------------------------------------------------------------------------
+static ObjectView ViewObject(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub) {
+    ObjectView view = { 0 };
+
+    // Entities have no bytes of their own, only their components do
+    if (kind == JOURNAL_OBJECT_ENTITY) {
+        view.valid = true;
+        view.alive = EcsIsAlive(&app->scene, EcsEntityAt(&app->scene, slot));
+        return view;
+    }
+
+    view.bytes = GetJournalTarget(app, kind, slot, sub, &view.size);
+    view.valid = view.size > 0;
+    view.alive = view.bytes != NULL;
+    if (kind == JOURNAL_OBJECT_TRACK) view.alive = slot < (uint32_t)app->trackCount;
+    return view;
+}
+
+// Copies bytes [offset, offset + size) into the object, leaving its protected
+// range alone, and journals what was written
+static void WriteObject(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                        size_t offset, const unsigned char* image, size_t size) {
+    size_t objectSize = 0, protectedStart = 0, protectedEnd = 0;
+    unsigned char* object = GetJournalTarget(app, kind, slot, sub, &objectSize);
+    if (!object || offset > objectSize || size > objectSize - offset) return;
+    GetJournalProtectedRange(kind, &protectedStart, &protectedEnd);
+
+    // The parts before and after the protected range, either may be empty
+    size_t end = offset + size;
+    size_t parts[2][2] = {
+        { offset, protectedStart < end ? protectedStart : end },
+        { protectedEnd > offset ? protectedEnd : offset, end }
+    };
+    for (int i = 0; i < 2; i++) {
+        size_t from = parts[i][0], to = parts[i][1];
+        if (to <= from) continue;
+        memcpy(object + from, image + (from - offset), to - from);
+        RecordProjectChange(app, kind, slot, sub, from, object + from, to - from);
+    }
+}
+
+static void SetPoolObject(AppState* app, Pool* pool, JournalObjectKind kind, uint32_t slot, bool alive) {
+    void* object = PoolAt(pool, slot);
+    if (alive && !object) {
+        PoolAllocAt(pool, slot);
+        RecordProjectAlloc(app, kind, slot);
+    } else if (!alive && object) {
+        if (kind == JOURNAL_OBJECT_PATTERN) FreePattern(object);
+        PoolFree(pool, PoolHandleAt(pool, slot));
+        RecordProjectFree(app, kind, slot);
+    }
+}
+
+// Brings an object to the given state, keeping the derived indexes in step
+static void SetObject(AppState* app, const HistoryChange* change, bool alive, const unsigned char* image) {
+    JournalObjectKind kind = (JournalObjectKind)change->kind;
+    uint32_t slot = change->slot;
+
+    switch (kind) {
+        case JOURNAL_OBJECT_ENTITY: {
+            bool wasAlive = EcsIsAlive(&app->scene, EcsEntityAt(&app->scene, slot));
+            if (alive && !wasAlive) {
+                EcsCreateEntityAt(&app->scene, slot);
+                RecordProjectAlloc(app, kind, slot);
+            } else if (!alive && wasAlive) {
+                Entity entity = EcsEntityAt(&app->scene, slot);
+                EcsDestroyEntity(&app->scene, entity);
+                RecordProjectFree(app, kind, slot);
+                UpdateSceneBounds(app, entity);
+            }
+            return;
+        }
+        case JOURNAL_OBJECT_COMPONENT: {
+            Entity entity = EcsEntityAt(&app->scene, slot);
+            bool present = EcsGetComponent(&app->scene, entity, (int)change->sub) != NULL;
+            if (alive && !present) {
+                if (!EcsAddComponent(&app->scene, entity, (int)change->sub)) return;
+                JournalRecord(app->journal, JOURNAL_RECORD_ALLOC, kind, slot, change->sub, 0, NULL, 0);
+            } else if (!alive && present) {
+                EcsRemoveComponent(&app->scene, entity, (int)change->sub);
+                JournalRecord(app->journal, JOURNAL_RECORD_FREE, kind, slot, change->sub, 0, NULL, 0);
+            }
+            if (alive) WriteObject(app, kind, slot, change->sub, change->offset, image, change->size);
+            UpdateSceneBounds(app, entity);
+            app->projectModified = true;
+            return;
+        }
+        case JOURNAL_OBJECT_ELEMENT: {
+            // Out of the index under its old times, back in under the new ones
+            const TimelineElement* element = PoolAt(&app->elements, slot);
+            if (element) TimelineIndexRemove(&app->timelineIndex, element->trackIndex, (int)slot, element->startTime);
+            SetPoolObject(app, &app->elements, kind, slot, alive);
+            if (!alive) return;
+
+            WriteObject(app, kind, slot, 0, change->offset, image, change->size);
+            element = PoolAt(&app->elements, slot);
+            if (element) {
+                TimelineIndexInsert(&app->timelineIndex, element->trackIndex, (int)slot, element->startTime,
+                                    element->startTime + element->duration);
+            }
+            return;
+        }
+        case JOURNAL_OBJECT_ASSET:
+        case JOURNAL_OBJECT_PATTERN:
+            SetPoolObject(app, kind == JOURNAL_OBJECT_ASSET ? &app->assets : &app->patterns, kind, slot, alive);
+            if (alive) WriteObject(app, kind, slot, 0, change->offset, image, change->size);
+            return;
+        case JOURNAL_OBJECT_TRACK:
+            // Tracks are only ever appended, so a track's life is the count
+            if (alive != (slot < (uint32_t)app->trackCount)) {
+                app->trackCount = alive ? (int)slot + 1 : (int)slot;
+                RecordProjectResize(app, kind, 0, 0, app->trackCount);
+            }
+            if (alive) WriteObject(app, kind, slot, 0, change->offset, image, change->size);
+            return;
+        default:
+            WriteObject(app, kind, slot, change->sub, change->offset, image, change->size);
+            return;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Steps
+//----------------------------------------------------------------------------------
+static HistoryStep* StepAt(History* history, int index) {
+    return &history->steps[(history->first + index) % history->capacity];
+}
+
+static void FreeStep(History* history, HistoryStep* step) {
+    history->bytes -= sizeof(HistoryStep) + step->size;
+    free(step->data);
+    memset(step, 0, sizeof(*step));
+}
+
+static void ResetOpenStep(History* history) {
+    history->label[0] = '\0';
+    history->mergeKey = 0;
+    history->failed = false;
+    if (history->captureCount > 0) memset(history->lookup, 0, history->lookupCapacity * sizeof(int32_t));
+    history->captureCount = 0;
+    history->beforeSize = 0;
+}
+
+static bool AppendChange(History* history, const HistoryChange* change, const unsigned char* a, const unsigned char* b) {
+    size_t images = (a ? change->size : 0) + (b ? change->size : 0);
+    if (!GrowBuffer(&history->scratch, &history->scratchCapacity, history->scratchSize + sizeof(*change) + images)) return false;
+
+    unsigned char* out = history->scratch + history->scratchSize;
+    memcpy(out, change, sizeof(*change));
+    out += sizeof(*change);
+    if (a) memcpy(out, a, change->size), out += change->size;
+    if (b) memcpy(out, b, change->size);
+    history->scratchSize += sizeof(*change) + images;
+    return true;
+}
+
+// Differing byte runs of one object, the protected range counted as equal
+static bool DiffObject(History* history, const HistoryCaptureRecord* capture, const unsigned char* now, int* changeCount) {
+    const unsigned char* old = history->before + capture->offset;
+    size_t protectedStart = 0, protectedEnd = 0;
+    GetJournalProtectedRange(capture->kind, &protectedStart, &protectedEnd);
+
+    size_t i = 0;
+    while (i < capture->size) {
+        if (old[i] == now[i] || (i >= protectedStart && i < protectedEnd)) {
+            i++;
+            continue;
+        }
+
+        // Extend the run over short equal gaps, a header costs more than them
+        size_t start = i, end = i + 1, equal = 0;
+        for (size_t j = end; j < capture->size && equal < HISTORY_RUN_GAP; j++) {
+            bool same = old[j] == now[j] || (j >= protectedStart && j < protectedEnd);
+            if (same) {
+                equal++;
+            } else {
+                equal = 0;
+                end = j + 1;
+            }
+        }
+
+        HistoryChange change = { (uint8_t)capture->kind, 1, 1, 0, capture->slot, capture->sub, (uint32_t)start, (uint32_t)(end - start) };
+        if (!AppendChange(history, &change, old + start, now + start)) return false;
+        (*changeCount)++;
+        i = end;
+    }
+    return true;
+}
+
+static void PushStep(History* history, HistoryStep* step) {
+    // A new edit ends the redo branch
+    while (history->count > history->cursor) {
+        FreeStep(history, StepAt(history, history->count - 1));
+        history->count--;
+    }
+
+    if (history->count == history->capacity) {
+        int capacity = history->capacity ? history->capacity * 2 : 64;
+        HistoryStep* steps = malloc((size_t)capacity * sizeof(HistoryStep));
+        if (!steps) {
+            TraceLog(LOG_WARNING, "HISTORY: Out of memory, dropping step \"%s\"", step->label);
+            free(step->data);
+            return;
+        }
+        for (int i = 0; i < history->count; i++) steps[i] = *StepAt(history, i);
+        free(history->steps);
+        history->steps = steps;
+        history->capacity = capacity;
+        history->first = 0;
+    }
+
+    *StepAt(history, history->count++) = *step;
+    history->cursor = history->count;
+    history->bytes += sizeof(HistoryStep) + step->size;
+
+    while (history->bytes > history->limit && history->count > 1) {
+        FreeStep(history, StepAt(history, 0));
+        history->first = (history->first + 1) % history->capacity;
+        history->count--;
+        history->cursor--;
+        history->dropped++;
+    }
+}
+
+static void CloseStep(AppState* app) {
+    History* history = app->history;
+    if (history->captureCount == 0) {
+        ResetOpenStep(history);
+        return;
+    }
+
+    // Undoing across an edit that was not recorded would mix states
+    if (history->failed) {
+        TraceLog(LOG_WARNING, "HISTORY: Out of memory recording \"%s\", undo history cleared", history->label);
+        ClearHistory(history);
+        return;
+    }
+
+    HistoryStep step = { 0 };
+    history->scratchSize = 0;
+    bool stored = true;
+    for (int i = 0; i < history->captureCount && stored; i++) {
+        const HistoryCaptureRecord* capture = &history->captures[i];
+        ObjectView now = ViewObject(app, capture->kind, capture->slot, capture->sub);
+        if (!capture->alive && !now.alive) continue;
+
+        if (capture->alive && now.alive) {
+            stored = DiffObject(history, capture, now.bytes, &step.changeCount);
+        } else {
+            HistoryChange change = { (uint8_t)capture->kind, capture->alive, now.alive, 0, capture->slot, capture->sub,
+                                     0, (uint32_t)capture->size };
+            const unsigned char* image = capture->alive ? history->before + capture->offset : now.bytes;
+            stored = AppendChange(history, &change, capture->size ? image : NULL, NULL);
+            step.changeCount++;
+        }
+    }
+
+    if (!stored || (history->scratchSize > 0 && !(step.data = malloc(history->scratchSize)))) {
+        TraceLog(LOG_WARNING, "HISTORY: Out of memory recording \"%s\", undo history cleared", history->label);
+        ClearHistory(history);
+        return;
+    }
+
+    if (step.changeCount > 0) {
+        memcpy(step.data, history->scratch, history->scratchSize);
+        step.size = history->scratchSize;
+        snprintf(step.label, sizeof(step.label), "%s", history->label[0] ? history->label : "Edit");
+        PushStep(history, &step);
+    }
+    ResetOpenStep(history);
+}
+
+// Applies a step's changes backwards for undo, forwards for redo
+static void ApplyStep(AppState* app, const HistoryStep* step, bool undo) {
+    const unsigned char** changes = malloc((size_t)step->changeCount * sizeof(*changes));
+    if (!changes) return;
+
+    size_t pos = 0;
+    for (int i = 0; i < step->changeCount; i++) {
+        const HistoryChange* change = (const HistoryChange*)(step->data + pos);
+        changes[i] = step->data + pos;
+        pos += sizeof(*change) + (size_t)change->size * (change->wasAlive && change->isAlive ? 2 : (change->wasAlive || change->isAlive ? 1 : 0));
+    }
+
+    for (int n = 0; n < step->changeCount; n++) {
+        HistoryChange change;
+        const unsigned char* record = changes[undo ? step->changeCount - 1 - n : n];
+        memcpy(&change, record, sizeof(change));
+
+        const unsigned char* images = record + sizeof(change);
+        bool alive = undo ? change.wasAlive : change.isAlive;
+        const unsigned char* image = images;
+        if (change.wasAlive && change.isAlive && !undo) image += change.size;
+        SetObject(app, &change, alive, image);
+    }
+    free(changes);
+}
+
+//----------------------------------------------------------------------------------
+// History lifetime
+//----------------------------------------------------------------------------------
+History* CreateHistory(size_t memoryLimit) {
+    History* history = calloc(1, sizeof(History));
+    if (!history) return NULL;
+    history->limit = memoryLimit ? memoryLimit : HISTORY_DEFAULT_LIMIT;
+    return history;
+}
+
+void DestroyHistory(History* history) {
+    if (!history) return;
+    ClearHistory(history);
+    free(history->steps);
+    free(history->captures);
+    free(history->lookup);
+    free(history->before);
+    free(history->scratch);
+    free(history);
+}
+
+void ClearHistory(History* history) {
+    if (!history) return;
+    for (int i = 0; i < history->count; i++) FreeStep(history, StepAt(history, i));
+    history->first = 0;
+    history->count = 0;
+    history->cursor = 0;
+    ResetOpenStep(history);
+}
+
+//----------------------------------------------------------------------------------
+// Recording
+//----------------------------------------------------------------------------------
+uint64_t HistoryMergeKey(JournalObjectKind kind, uint32_t slot, uint32_t sub, uint32_t field) {
+    const uint32_t values[4] = { (uint32_t)kind + 1, slot, sub, field };
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(values); i++) {
+        hash ^= ((const unsigned char*)values)[i];
+        hash *= 1099511628211ull;
+    }
+    return hash ? hash : 1;
+}
+
+void HistoryLabel(AppState* app, const char* label, uint64_t mergeKey) {
+    if (!app || !app->history) return;
+    History* history = app->history;
+
+    if (history->captureCount > 0 && mergeKey != history->mergeKey) CloseStep(app);
+    if (!history->label[0] && label) {
+        strncpy(history->label, label, sizeof(history->label) - 1);
+        history->label[sizeof(history->label) - 1] = '\0';
+    }
+    history->mergeKey = mergeKey;
+    history->lastMergeTime = GetTime();
+}
+
+static uint32_t CaptureHash(JournalObjectKind kind, uint32_t slot, uint32_t sub) {
+    uint32_t hash = ((uint32_t)kind * 0x9E3779B1u) ^ (slot * 0x85EBCA77u) ^ (sub * 0xC2B2AE3Du);
+    return hash ^ (hash >> 15);
+}
+
+// Index of an object's capture in the open step, or the empty lookup slot for it
+static uint32_t FindCapture(const History* history, JournalObjectKind kind, uint32_t slot, uint32_t sub, int* index) {
+    uint32_t mask = history->lookupCapacity - 1;
+    for (uint32_t i = CaptureHash(kind, slot, sub) & mask;; i = (i + 1) & mask) {
+        int32_t entry = history->lookup[i];
+        if (entry == 0) {
+            *index = -1;
+            return i;
+        }
+        const HistoryCaptureRecord* capture = &history->captures[entry - 1];
+        if (capture->kind == kind && capture->slot == slot && capture->sub == sub) {
+            *index = entry - 1;
+            return i;
+        }
+    }
+}
+
+static bool GrowLookup(History* history) {
+    uint32_t capacity = history->lookupCapacity ? history->lookupCapacity * 2 : 64;
+    int32_t* lookup = calloc(capacity, sizeof(int32_t));
+    if (!lookup) return false;
+
+    free(history->lookup);
+    history->lookup = lookup;
+    history->lookupCapacity = capacity;
+    for (int i = 0; i < history->captureCount; i++) {
+        const HistoryCaptureRecord* capture = &history->captures[i];
+        int existing;
+        history->lookup[FindCapture(history, capture->kind, capture->slot, capture->sub, &existing)] = i + 1;
+    }
+    return true;
+}
+
+static void Capture(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub, bool created) {
+    if (!app || !app->history) return;
+    History* history = app->history;
+
+    // Keep the lookup at most half full
+    if ((uint32_t)(history->captureCount + 1) * 2 > history->lookupCapacity && !GrowLookup(history)) {
+        history->failed = true;
+        return;
+    }
+
+    int existing;
+    uint32_t lookupSlot = FindCapture(history, kind, slot, sub, &existing);
+    if (existing >= 0) return;
+
+    ObjectView view = ViewObject(app, kind, slot, sub);
+    if (!view.valid) return;
+    bool alive = view.alive && !created;
+
+    if (history->captureCount == history->captureCapacity) {
+        int capacity = history->captureCapacity ? history->captureCapacity * 2 : 64;
+        HistoryCaptureRecord* captures = realloc(history->captures, (size_t)capacity * sizeof(HistoryCaptureRecord));
+        if (!captures) {
+            history->failed = true;
+            return;
+        }
+        history->captures = captures;
+        history->captureCapacity = capacity;
+    }
+    if (alive && !GrowBuffer(&history->before, &history->beforeCapacity, history->beforeSize + view.size)) {
+        history->failed = true;
+        return;
+    }
+
+    HistoryCaptureRecord* capture = &history->captures[history->captureCount];
+    capture->kind = kind;
+    capture->slot = slot;
+    capture->sub = sub;
+    capture->alive = alive;
+    capture->offset = history->beforeSize;
+    capture->size = view.size;
+    if (alive && view.size) {
+        memcpy(history->before + history->beforeSize, view.bytes, view.size);
+        history->beforeSize += view.size;
+    }
+    history->lookup[lookupSlot] = ++history->captureCount;
+}
+
+void HistoryCapture(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub) {
+    Capture(app, kind, slot, sub, false);
+}
+
+void HistoryCaptureCreated(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub) {
+    Capture(app, kind, slot, sub, true);
+}
+
+void UpdateHistory(AppState* app) {
+    if (!app || !app->history) return;
+    History* history = app->history;
+
+    if (history->captureCount == 0) {
+        ResetOpenStep(history);
+    } else if (history->mergeKey == 0 || GetTime() - history->lastMergeTime > HISTORY_MERGE_WINDOW) {
+        CloseStep(app);
+    }
+
+    bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    bool shift = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+    if (control && IsKeyPressed(KEY_Z)) {
+        if (shift) RedoHistory(app);
+        else UndoHistory(app);
+    } else if (control && IsKeyPressed(KEY_Y)) {
+        RedoHistory(app);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Undo and redo
+//----------------------------------------------------------------------------------
+bool UndoHistory(AppState* app) {
+    if (!app || !app->history) return false;
+    History* history = app->history;
+
+    CloseStep(app);
+    if (history->cursor == 0) return false;
+    ApplyStep(app, StepAt(history, history->cursor - 1), true);
+    history->cursor--;
+    return true;
+}
+
+bool RedoHistory(AppState* app) {
+    if (!app || !app->history) return false;
+    History* history = app->history;
+
+    CloseStep(app);
+    if (history->cursor == history->count) return false;
+    ApplyStep(app, StepAt(history, history->cursor), false);
+    history->cursor++;
+    return true;
+}
+
+const char* GetUndoLabel(const History* history) {
+    if (!history || history->cursor == 0) return NULL;
+    return history->steps[(history->first + history->cursor - 1) % history->capacity].label;
+}
+
+const char* GetRedoLabel(const History* history) {
+    if (!history || history->cursor == history->count) return NULL;
+    return history->steps[(history->first + history->cursor) % history->capacity].label;
+}
+
+HistoryStats GetHistoryStats(const History* history) {
+    HistoryStats stats = { 0 };
+    if (!history) return stats;
+    stats.undoSteps = history->cursor;
+    stats.redoSteps = history->count - history->cursor;
+    stats.bytes = history->bytes;
+    stats.limit = history->limit;
+    stats.dropped = history->dropped;
+    return stats;
+}
@@ -0,0 +1,62 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "app_state.h"
+#include "journal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Undo/redo history built from per-object deltas.
+//
+// Editing code calls HistoryCapture before it changes an object (the same
+// kind/slot/sub addressing the journal uses). The first capture of an object
+// in a step copies its bytes; when the step closes, each copy is compared
+// with the object as it is now and only the byte runs that differ are kept,
+// old and new value side by side. Objects that came alive or died keep one
+// image. A slider drag or an element move therefore costs a few dozen bytes
+// however large the project is, and undo rewrites just those bytes.
+//
+// A step closes at the end of the frame. Edits labelled with the same merge
+// key less than HISTORY_MERGE_WINDOW seconds apart stay in one step, so a
+// continuous drag undoes in one go. Steps past the memory limit are dropped
+// oldest first; the latest step is always kept.
+//
+// Undo and redo go through the journal like any other edit and keep the
+// timeline index and scene bounds in step. Pattern notes are not covered.
+
+#define HISTORY_DEFAULT_LIMIT (4u << 20)    // Bytes
+#define HISTORY_MERGE_WINDOW 0.5            // Seconds
+
+typedef struct History History;
+
+typedef struct {
+    int undoSteps;
+    int redoSteps;
+    size_t bytes;                   // Held by all steps
+    size_t limit;
+    uint64_t dropped;               // Steps dropped to stay under the limit
+} HistoryStats;
+
+// History lifetime
+History* CreateHistory(size_t memoryLimit);
+void DestroyHistory(History* history);
+void ClearHistory(History* history);
+
+// Recording. Label a step before capturing; a non-zero merge key lets
+// following edits with the same key join it.
+void HistoryLabel(AppState* app, const char* label, uint64_t mergeKey);
+void HistoryCapture(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub);
+void HistoryCaptureCreated(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub);   // Object just came alive
+uint64_t HistoryMergeKey(JournalObjectKind kind, uint32_t slot, uint32_t sub, uint32_t field);
+
+// Once per frame: closes the open step and handles Ctrl+Z, Ctrl+Y and Ctrl+Shift+Z
+void UpdateHistory(AppState* app);
+
+bool UndoHistory(AppState* app);
+bool RedoHistory(AppState* app);
+const char* GetUndoLabel(const History* history);     // NULL when there is nothing to undo
+const char* GetRedoLabel(const History* history);
+HistoryStats GetHistoryStats(const History* history);
+
+#endif // HISTORY_H
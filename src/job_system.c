@@ -0,0 +1,502 @@
+#include "job_system.h"
+#include "spsc_queue.h"
+#include "profiler.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#define JOB_NONE UINT32_MAX
+
+typedef struct {
+    JobDesc desc;
+    atomic_uint generation;     // Odd while the job is scheduled or waiting for its callback
+    atomic_int waiting;         // Unfinished dependencies, plus one until ScheduleJob is done
+    atomic_bool finished;
+    uint32_t successors;        // Edge list of jobs waiting on this one, under graphLock
+    uint32_t next;              // Free list or callback list
+} Job;
+
+typedef struct {
+    uint32_t job;
+    uint32_t next;
+} JobEdge;
+
+// Chase-Lev deque of job indices. The owner pushes and pops at the bottom,
+// thieves take from the top. Sized for every job at once, so it never fills.
+typedef struct {
+    char padTop[SPSC_CACHE_LINE];
+    atomic_long top;
+    char padBottom[SPSC_CACHE_LINE - sizeof(atomic_long)];
+    atomic_long bottom;
+    char padEnd[SPSC_CACHE_LINE - sizeof(atomic_long)];
+    atomic_uint* items;
+} JobDeque;
+
+// Shared queue for jobs scheduled from outside the pool
+typedef struct {
+    uint32_t* items;
+    uint32_t head;
+    uint32_t count;
+} JobQueue;
+
+typedef struct {
+    JobSystem* system;
+    int index;
+    pthread_t thread;
+    JobDeque deques[JOB_PRIORITY_COUNT];
+    uint32_t seed;              // Picks where to start stealing
+} JobWorker;
+
+struct JobSystem {
+    Job* jobs;
+    JobWorker workers[JOB_SYSTEM_MAX_WORKERS];
+    int workerCount;
+    pthread_t owner;
+
+    pthread_mutex_t queueLock;
+    JobQueue queues[JOB_PRIORITY_COUNT];
+    atomic_int queued;          // Runnable jobs not taken yet; briefly negative while a push is counted
+
+    pthread_mutex_t graphLock;  // Edges and finishing
+    JobEdge* edges;
+    uint32_t freeEdges;
+
+    pthread_mutex_t freeLock;
+    uint32_t freeJobs;
+
+    pthread_mutex_t callbackLock;
+    uint32_t callbacks;         // Newest first
+
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wake;
+    atomic_int sleepers;
+    bool stopping;
+
+    atomic_int pending;
+    atomic_int pendingCallbacks;
+    atomic_ullong executed;
+    atomic_ullong stolen;
+};
+
+static _Thread_local JobWorker* localWorker;
+
+//----------------------------------------------------------------------------------
+// Deques
+//----------------------------------------------------------------------------------
+
+static void PushDeque(JobDeque* deque, uint32_t job) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    atomic_store_explicit(&deque->items[bottom & (JOB_SYSTEM_MAX_JOBS - 1)], job, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+}
+
+static uint32_t PopDeque(JobDeque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_seq_cst);
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return JOB_NONE;
+    }
+
+    uint32_t job = atomic_load_explicit(&deque->items[bottom & (JOB_SYSTEM_MAX_JOBS - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        // Last item: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) job = JOB_NONE;
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static uint32_t StealDeque(JobDeque* deque) {
+    long top = atomic_load_explicit(&deque->top, memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_seq_cst);
+    if (top >= bottom) return JOB_NONE;
+
+    uint32_t job = atomic_load_explicit(&deque->items[top & (JOB_SYSTEM_MAX_JOBS - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) return JOB_NONE;
+    return job;
+}
+
+//----------------------------------------------------------------------------------
+// Scheduling
+//----------------------------------------------------------------------------------
+
+static Job* GetJob(const JobSystem* system, uint32_t index) {
+    return &system->jobs[index];
+}
+
+static void WakeWorker(JobSystem* system) {
+    if (atomic_load(&system->sleepers) == 0) return;
+    pthread_mutex_lock(&system->sleepLock);
+    pthread_cond_signal(&system->wake);
+    pthread_mutex_unlock(&system->sleepLock);
+}
+
+// Workers keep what they unblock; anyone else goes through the shared queue
+static void EnqueueJob(JobSystem* system, uint32_t index) {
+    JobPriority priority = GetJob(system, index)->desc.priority;
+    if (localWorker && localWorker->system == system) {
+        PushDeque(&localWorker->deques[priority], index);
+    } else {
+        pthread_mutex_lock(&system->queueLock);
+        JobQueue* queue = &system->queues[priority];
+        queue->items[(queue->head + queue->count) & (JOB_SYSTEM_MAX_JOBS - 1)] = index;
+        queue->count++;
+        pthread_mutex_unlock(&system->queueLock);
+    }
+    atomic_fetch_add(&system->queued, 1);
+    WakeWorker(system);
+}
+
+static uint32_t PopSharedQueue(JobSystem* system, JobPriority priority) {
+    JobQueue* queue = &system->queues[priority];
+    uint32_t job = JOB_NONE;
+    pthread_mutex_lock(&system->queueLock);
+    if (queue->count > 0) {
+        job = queue->items[queue->head];
+        queue->head = (queue->head + 1) & (JOB_SYSTEM_MAX_JOBS - 1);
+        queue->count--;
+    }
+    pthread_mutex_unlock(&system->queueLock);
+    return job;
+}
+
+// Own deque, then the shared queue, then the other workers, all
+// interactive jobs before any bulk one. worker is NULL off the pool.
+static uint32_t FindJob(JobSystem* system, JobWorker* worker) {
+    uint32_t start = 0;
+    if (worker) {
+        worker->seed ^= worker->seed << 13;
+        worker->seed ^= worker->seed >> 17;
+        worker->seed ^= worker->seed << 5;
+        start = worker->seed;
+    }
+
+    for (int priority = 0; priority < JOB_PRIORITY_COUNT; priority++) {
+        uint32_t job = worker ? PopDeque(&worker->deques[priority]) : JOB_NONE;
+        if (job == JOB_NONE) job = PopSharedQueue(system, priority);
+        for (int i = 0; job == JOB_NONE && i < system->workerCount; i++) {
+            JobWorker* victim = &system->workers[(start + (uint32_t)i) % (uint32_t)system->workerCount];
+            if (victim == worker) continue;
+            job = StealDeque(&victim->deques[priority]);
+            if (job != JOB_NONE) atomic_fetch_add_explicit(&system->stolen, 1, memory_order_relaxed);
+        }
+        if (job != JOB_NONE) {
+            atomic_fetch_sub(&system->queued, 1);
+            return job;
+        }
+    }
+    return JOB_NONE;
+}
+
+static void RetireJob(JobSystem* system, uint32_t index) {
+    Job* job = GetJob(system, index);
+    atomic_fetch_add(&job->generation, 1);
+    pthread_mutex_lock(&system->freeLock);
+    job->next = system->freeJobs;
+    system->freeJobs = index;
+    pthread_mutex_unlock(&system->freeLock);
+}
+
+static void RunJob(JobSystem* system, uint32_t index) {
+    Job* job = GetJob(system, index);
+    PROFILE_BEGIN(run, "Job");
+    if (job->desc.run) job->desc.run(job->desc.data);
+    PROFILE_END(run);
+    atomic_fetch_add_explicit(&system->executed, 1, memory_order_relaxed);
+
+    // Release the jobs that were waiting on this one
+    pthread_mutex_lock(&system->graphLock);
+    atomic_store(&job->finished, true);
+    uint32_t edge = job->successors;
+    job->successors = JOB_NONE;
+    while (edge != JOB_NONE) {
+        JobEdge* current = &system->edges[edge];
+        uint32_t next = current->next;
+        if (atomic_fetch_sub(&GetJob(system, current->job)->waiting, 1) == 1) EnqueueJob(system, current->job);
+        current->next = system->freeEdges;
+        system->freeEdges = edge;
+        edge = next;
+    }
+    pthread_mutex_unlock(&system->graphLock);
+
+    // Counted as a callback before it stops counting as pending, so
+    // DestroyJobSystem never sees neither
+    if (job->desc.complete) {
+        pthread_mutex_lock(&system->callbackLock);
+        job->next = system->callbacks;
+        system->callbacks = index;
+        atomic_fetch_add(&system->pendingCallbacks, 1);
+        pthread_mutex_unlock(&system->callbackLock);
+        atomic_fetch_sub(&system->pending, 1);
+    } else {
+        atomic_fetch_sub(&system->pending, 1);
+        RetireJob(system, index);
+    }
+}
+
+// Helps out while every slot is taken; the main thread also frees the
+// slots held by finished jobs' callbacks
+static uint32_t AcquireJob(JobSystem* system) {
+    for (;;) {
+        pthread_mutex_lock(&system->freeLock);
+        uint32_t index = system->freeJobs;
+        if (index != JOB_NONE) system->freeJobs = GetJob(system, index)->next;
+        pthread_mutex_unlock(&system->freeLock);
+        if (index != JOB_NONE) return index;
+
+        if (pthread_equal(pthread_self(), system->owner) && RunJobCallbacks(system) > 0) continue;
+        JobWorker* worker = localWorker && localWorker->system == system ? localWorker : NULL;
+        uint32_t job = FindJob(system, worker);
+        if (job != JOB_NONE) RunJob(system, job);
+        else sched_yield();
+    }
+}
+
+JobHandle ScheduleJob(JobSystem* system, JobDesc desc, const JobHandle* dependencies, int dependencyCount) {
+    if (!system) {
+        if (desc.run) desc.run(desc.data);
+        if (desc.complete) desc.complete(desc.data);
+        return JOB_NULL_HANDLE;
+    }
+    if (desc.priority < 0 || desc.priority >= JOB_PRIORITY_COUNT) desc.priority = JOB_PRIORITY_BULK;
+
+    uint32_t index = AcquireJob(system);
+    Job* job = GetJob(system, index);
+    job->desc = desc;
+    job->successors = JOB_NONE;
+    atomic_store(&job->waiting, 1);
+    atomic_store(&job->finished, false);
+    JobHandle handle = { index, atomic_fetch_add(&job->generation, 1) + 1 };
+    atomic_fetch_add(&system->pending, 1);
+
+    pthread_mutex_lock(&system->graphLock);
+    for (int i = 0; i < dependencyCount; i++) {
+        JobHandle dependency = dependencies[i];
+        if (dependency.generation == 0 || dependency.index >= JOB_SYSTEM_MAX_JOBS) continue;
+        Job* other = GetJob(system, dependency.index);
+        if (atomic_load(&other->generation) != dependency.generation || atomic_load(&other->finished)) continue;
+
+        // Out of edges: wait the dependency out instead of recording it
+        if (system->freeEdges == JOB_NONE) {
+            pthread_mutex_unlock(&system->graphLock);
+            WaitForJob(system, dependency);
+            pthread_mutex_lock(&system->graphLock);
+            continue;
+        }
+        uint32_t edge = system->freeEdges;
+        system->freeEdges = system->edges[edge].next;
+        system->edges[edge] = (JobEdge){ index, other->successors };
+        other->successors = edge;
+        atomic_fetch_add(&job->waiting, 1);
+    }
+    pthread_mutex_unlock(&system->graphLock);
+
+    if (atomic_fetch_sub(&job->waiting, 1) == 1) EnqueueJob(system, index);
+    return handle;
+}
+
+bool IsJobComplete(const JobSystem* system, JobHandle handle) {
+    if (!system || handle.generation == 0 || handle.index >= JOB_SYSTEM_MAX_JOBS) return true;
+    Job* job = GetJob(system, handle.index);
+    if (atomic_load(&job->generation) != handle.generation) return true;
+    bool finished = atomic_load(&job->finished);
+
+    // Retired and scheduled again between the two loads
+    return finished || atomic_load(&job->generation) != handle.generation;
+}
+
+void WaitForJob(JobSystem* system, JobHandle handle) {
+    JobWorker* worker = localWorker && localWorker->system == system ? localWorker : NULL;
+    while (!IsJobComplete(system, handle)) {
+        uint32_t job = FindJob(system, worker);
+        if (job != JOB_NONE) RunJob(system, job);
+        else sched_yield();
+    }
+}
+
+int RunJobCallbacks(JobSystem* system) {
+    if (!system) return 0;
+    pthread_mutex_lock(&system->callbackLock);
+    uint32_t list = system->callbacks;
+    system->callbacks = JOB_NONE;
+    pthread_mutex_unlock(&system->callbackLock);
+
+    // Oldest first
+    uint32_t ordered = JOB_NONE;
+    while (list != JOB_NONE) {
+        uint32_t next = GetJob(system, list)->next;
+        GetJob(system, list)->next = ordered;
+        ordered = list;
+        list = next;
+    }
+
+    int count = 0;
+    while (ordered != JOB_NONE) {
+        Job* job = GetJob(system, ordered);
+        uint32_t next = job->next;
+        job->desc.complete(job->desc.data);
+        atomic_fetch_sub(&system->pendingCallbacks, 1);
+        RetireJob(system, ordered);
+        ordered = next;
+        count++;
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------------
+// Workers
+//----------------------------------------------------------------------------------
+
+static void* JobWorkerThread(void* arg) {
+    JobWorker* worker = arg;
+    JobSystem* system = worker->system;
+    localWorker = worker;
+
+    char name[32];
+    snprintf(name, sizeof(name), "Jobs %d", worker->index);
+    SetProfilerThreadName(name);
+
+    for (;;) {
+        uint32_t job = FindJob(system, worker);
+        if (job != JOB_NONE) {
+            RunJob(system, job);
+            continue;
+        }
+
+        // Counted as a sleeper before checking, so a push either sees us or we see it
+        pthread_mutex_lock(&system->sleepLock);
+        atomic_fetch_add(&system->sleepers, 1);
+        while (!system->stopping && atomic_load(&system->queued) <= 0) pthread_cond_wait(&system->wake, &system->sleepLock);
+        atomic_fetch_sub(&system->sleepers, 1);
+        bool stopping = system->stopping;
+        pthread_mutex_unlock(&system->sleepLock);
+        if (stopping && atomic_load(&system->queued) <= 0) break;
+    }
+    return NULL;
+}
+
+static int GetCoreCount(void) {
+#if defined(_WIN32)
+    return pthread_num_processors_np();
+#else
+    return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+static void StopWorkers(JobSystem* system, int started) {
+    pthread_mutex_lock(&system->sleepLock);
+    system->stopping = true;
+    pthread_cond_broadcast(&system->wake);
+    pthread_mutex_unlock(&system->sleepLock);
+    for (int i = 0; i < started; i++) pthread_join(system->workers[i].thread, NULL);
+}
+
+static void FreeJobSystem(JobSystem* system) {
+    for (int i = 0; i < JOB_SYSTEM_MAX_WORKERS; i++) {
+        for (int p = 0; p < JOB_PRIORITY_COUNT; p++) free(system->workers[i].deques[p].items);
+    }
+    for (int p = 0; p < JOB_PRIORITY_COUNT; p++) free(system->queues[p].items);
+    pthread_cond_destroy(&system->wake);
+    pthread_mutex_destroy(&system->sleepLock);
+    pthread_mutex_destroy(&system->callbackLock);
+    pthread_mutex_destroy(&system->freeLock);
+    pthread_mutex_destroy(&system->graphLock);
+    pthread_mutex_destroy(&system->queueLock);
+    free(system->edges);
+    free(system->jobs);
+    free(system);
+}
+
+JobSystem* CreateJobSystem(int workerCount) {
+    if (workerCount <= 0) workerCount = GetCoreCount() - 1;
+    if (workerCount < 1) workerCount = 1;
+    if (workerCount > JOB_SYSTEM_MAX_WORKERS) workerCount = JOB_SYSTEM_MAX_WORKERS;
+
+    JobSystem* system = calloc(1, sizeof(JobSystem));
+    if (!system) return NULL;
+    system->owner = pthread_self();
+    pthread_mutex_init(&system->queueLock, NULL);
+    pthread_mutex_init(&system->graphLock, NULL);
+    pthread_mutex_init(&system->freeLock, NULL);
+    pthread_mutex_init(&system->callbackLock, NULL);
+    pthread_mutex_init(&system->sleepLock, NULL);
+    pthread_cond_init(&system->wake, NULL);
+    system->callbacks = JOB_NONE;
+
+    bool allocated = true;
+    system->jobs = calloc(JOB_SYSTEM_MAX_JOBS, sizeof(Job));
+    system->edges = malloc(JOB_SYSTEM_MAX_EDGES * sizeof(JobEdge));
+    allocated = system->jobs && system->edges;
+    for (int p = 0; p < JOB_PRIORITY_COUNT; p++) {
+        system->queues[p].items = malloc(JOB_SYSTEM_MAX_JOBS * sizeof(uint32_t));
+        allocated = allocated && system->queues[p].items;
+        for (int i = 0; i < workerCount; i++) {
+            system->workers[i].deques[p].items = calloc(JOB_SYSTEM_MAX_JOBS, sizeof(atomic_uint));
+            allocated = allocated && system->workers[i].deques[p].items;
+        }
+    }
+    if (!allocated) {
+        FreeJobSystem(system);
+        return NULL;
+    }
+
+    // Generations start at zero, so no real handle is ever zeroed
+    for (uint32_t i = 0; i < JOB_SYSTEM_MAX_JOBS; i++) system->jobs[i].next = i + 1 < JOB_SYSTEM_MAX_JOBS ? i + 1 : JOB_NONE;
+    system->freeJobs = 0;
+    for (uint32_t i = 0; i < JOB_SYSTEM_MAX_EDGES; i++) system->edges[i].next = i + 1 < JOB_SYSTEM_MAX_EDGES ? i + 1 : JOB_NONE;
+    system->freeEdges = 0;
+
+    // Workers steal from each other from the start, so they are all set up first
+    system->workerCount = workerCount;
+    for (int i = 0; i < workerCount; i++) {
+        JobWorker* worker = &system->workers[i];
+        worker->system = system;
+        worker->index = i;
+        worker->seed = 2654435761u * (uint32_t)(i + 1);
+    }
+    for (int i = 0; i < workerCount; i++) {
+        if (pthread_create(&system->workers[i].thread, NULL, JobWorkerThread, &system->workers[i]) == 0) continue;
+        StopWorkers(system, i);
+        FreeJobSystem(system);
+        return NULL;
+    }
+    return system;
+}
+
+void DestroyJobSystem(JobSystem* system) {
+    if (!system) return;
+
+    // Callbacks may schedule more work, so drain until both are empty
+    while (atomic_load(&system->pending) > 0 || atomic_load(&system->pendingCallbacks) > 0) {
+        uint32_t job = FindJob(system, NULL);
+        if (job != JOB_NONE) RunJob(system, job);
+        else if (RunJobCallbacks(system) == 0) sched_yield();
+    }
+
+    StopWorkers(system, system->workerCount);
+    FreeJobSystem(system);
+}
+
+int GetJobWorkerCount(const JobSystem* system) {
+    return system ? system->workerCount : 0;
+}
+
+JobSystemStats GetJobSystemStats(const JobSystem* system) {
+    JobSystemStats stats = { 0 };
+    if (!system) return stats;
+    stats.workers = system->workerCount;
+    stats.pending = atomic_load((atomic_int*)&system->pending);
+    stats.callbacks = atomic_load((atomic_int*)&system->pendingCallbacks);
+    stats.executed = atomic_load((atomic_ullong*)&system->executed);
+    stats.stolen = atomic_load((atomic_ullong*)&system->stolen);
+    return stats;
+}
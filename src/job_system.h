@@ -0,0 +1,78 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Work-stealing thread pool for editor background work.
+//
+// Every worker owns a deque per priority. Jobs it schedules or unblocks go
+// on its own end and it takes them back newest first, while idle workers
+// steal the oldest from the other end. Jobs scheduled from other threads go
+// to a shared queue. Interactive jobs are always taken before bulk ones.
+//
+// A job can depend on other jobs and only becomes runnable once they have
+// all finished. Its completion callback runs afterwards on the main thread,
+// from RunJobCallbacks, so it can touch UI and app state without locking.
+//
+// Handles are generational like pool handles: once a job has finished and
+// its callback has run, the slot is reused and stale handles read as
+// complete. A zeroed handle is always complete.
+//
+//     JobHandle decode = ScheduleJob(jobs, (JobDesc){ DecodeTexture, NULL, texture, JOB_PRIORITY_BULK }, NULL, 0);
+//     ScheduleJob(jobs, (JobDesc){ BuildAtlas, AtlasReady, atlas, JOB_PRIORITY_BULK }, &decode, 1);
+
+#define JOB_SYSTEM_MAX_WORKERS 32
+#define JOB_SYSTEM_MAX_JOBS 4096                        // Scheduled and not yet retired
+#define JOB_SYSTEM_MAX_EDGES (JOB_SYSTEM_MAX_JOBS * 4)  // Dependencies on unfinished jobs
+
+typedef struct JobSystem JobSystem;
+
+typedef enum {
+    JOB_PRIORITY_INTERACTIVE,   // Someone is waiting on it: a click, the next frame
+    JOB_PRIORITY_BULK,          // Imports, caches, prefetching
+    JOB_PRIORITY_COUNT
+} JobPriority;
+
+typedef void (*JobFunction)(void* data);
+
+typedef struct {
+    JobFunction run;            // On a worker, or on a thread waiting in WaitForJob
+    JobFunction complete;       // On the main thread once run returned; may be NULL
+    void* data;
+    JobPriority priority;
+} JobDesc;
+
+typedef struct {
+    uint32_t index;
+    uint32_t generation;
+} JobHandle;
+
+#define JOB_NULL_HANDLE ((JobHandle){ 0, 0 })
+
+typedef struct {
+    int workers;
+    int pending;                // Scheduled, not finished
+    int callbacks;              // Finished, callback not run yet
+    uint64_t executed;
+    uint64_t stolen;            // Taken from another worker's deque
+} JobSystemStats;
+
+// The creating thread is the main thread: RunJobCallbacks and DestroyJobSystem
+// belong to it. DestroyJobSystem finishes every scheduled job and runs the
+// callbacks first.
+JobSystem* CreateJobSystem(int workerCount);    // 0 for one per core besides the main thread
+void DestroyJobSystem(JobSystem* jobs);
+
+// Dependencies that already finished are ignored. Safe from any thread,
+// including from inside a job. Without a job system the job and its
+// callback run right away on the calling thread.
+JobHandle ScheduleJob(JobSystem* jobs, JobDesc desc, const JobHandle* dependencies, int dependencyCount);
+bool IsJobComplete(const JobSystem* jobs, JobHandle job);   // Run has returned; the callback may be pending
+void WaitForJob(JobSystem* jobs, JobHandle job);            // Runs other jobs while it waits
+
+int RunJobCallbacks(JobSystem* jobs);           // Main thread, once per frame; returns how many ran
+int GetJobWorkerCount(const JobSystem* jobs);
+JobSystemStats GetJobSystemStats(const JobSystem* jobs);
+
+#endif // JOB_SYSTEM_H
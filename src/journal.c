@@ -0,0 +1,644 @@
+#include "journal.h"
+#include "project_file.h"
+#include "mapped_file.h"
+#include "profiler.h"
+#include "scene.h"
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#if defined(_WIN32)
+    #include <io.h>
+    #define open _open
+    #define write _write
+    #define close _close
+    #define fsync _commit
+    #define ftruncate _chsize
+    #define JOURNAL_OPEN_FLAGS (_O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY)
+#else
+    #include <unistd.h>
+    #define JOURNAL_OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t layoutHash;
+    uint32_t reserved2;
+} JournalFileHeader;
+
+typedef struct {
+    uint32_t checksum;      // Covers everything after this field, payload included
+    uint32_t size;          // Payload bytes
+    uint8_t type;
+    uint8_t kind;
+    uint16_t reserved;
+    uint32_t slot;
+    uint32_t sub;
+    uint32_t offset;
+} JournalRecordHeader;
+
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} JournalBuffer;
+
+struct Journal {
+    char path[512];
+    char projectFilePath[512];
+    int fd;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+
+    // Guarded by lock
+    JournalBuffer pending;
+    unsigned char* snapshot;
+    size_t snapshotSize;
+    size_t snapshotCut;     // Bytes of pending already contained in the snapshot
+    uint64_t snapshotTicket;
+    uint64_t nextTicket;
+    uint64_t writtenTicket; // Newest compaction whose project file was renamed into place
+    uint64_t failedTicket;  // Newest compaction that could not be written
+    JournalStats stats;
+
+    // Owned by the writer thread
+    JournalBuffer writing;
+
+    double lastCompactionTime;
+    double lastEditTime;    // When UpdateJournal last saw AppState.editVersion move
+    uint32_t editVersion;
+};
+
+// Records store raw in-memory object bytes, so a journal written by a build
+// with different struct layouts must not be replayed
+static uint32_t LayoutHash(void) {
+    const uint32_t sizes[] = {
+        JOURNAL_FILE_VERSION,
+        sizeof(Track), sizeof(TimelineElement), sizeof(Pattern),
+        sizeof(Asset), sizeof(TimelineState)
+    };
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        hash = (hash ^ sizes[i]) * 16777619u;
+    }
+    for (int t = 0; t < COMPONENT_TYPE_COUNT; t++) {
+        hash = (hash ^ SCENE_COMPONENT_TYPES[t].size) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t Checksum(const void* data, size_t size, uint32_t hash) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+static uint32_t RecordChecksum(const JournalRecordHeader* header, const void* payload) {
+    uint32_t hash = Checksum((const unsigned char*)header + sizeof(header->checksum),
+                             sizeof(*header) - sizeof(header->checksum), 2166136261u);
+    return Checksum(payload, header->size, hash);
+}
+
+static bool ReserveBuffer(JournalBuffer* buffer, size_t extra) {
+    if (buffer->size + extra <= buffer->capacity) return true;
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->size + extra) capacity *= 2;
+
+    unsigned char* data = realloc(buffer->data, capacity);
+    if (!data) return false;
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+static bool WriteAll(int fd, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    while (size > 0) {
+        long written = (long)write(fd, bytes, (unsigned int)size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static bool ResetJournalFile(Journal* journal) {
+    JournalFileHeader header = { JOURNAL_FILE_MAGIC, JOURNAL_FILE_VERSION, 0, LayoutHash(), 0 };
+    return ftruncate(journal->fd, 0) == 0 && WriteAll(journal->fd, &header, sizeof(header));
+}
+
+// Bytes at the start of a journal file that replay would accept: 0 if the
+// header does not match this build, otherwise up to the first torn record
+static size_t ValidJournalSize(const MappedFile* file, int* recordCount) {
+    const JournalFileHeader* header = (const JournalFileHeader*)file->data;
+    if (recordCount) *recordCount = 0;
+    if (file->size < sizeof(JournalFileHeader) || header->magic != JOURNAL_FILE_MAGIC ||
+        header->version != JOURNAL_FILE_VERSION || header->layoutHash != LayoutHash()) {
+        return 0;
+    }
+
+    size_t pos = sizeof(JournalFileHeader);
+    while (pos + sizeof(JournalRecordHeader) <= file->size) {
+        JournalRecordHeader record;
+        memcpy(&record, file->data + pos, sizeof(record));
+        if (record.size > file->size - pos - sizeof(record)) break;
+        if (record.checksum != RecordChecksum(&record, file->data + pos + sizeof(record))) break;
+        pos += sizeof(record) + record.size;
+        if (recordCount) (*recordCount)++;
+    }
+    return pos;
+}
+
+static void* JournalWriterThread(void* arg) {
+    Journal* journal = arg;
+
+    pthread_mutex_lock(&journal->lock);
+    for (;;) {
+        while (!journal->stopping && journal->pending.size == 0 && !journal->snapshot) {
+            pthread_cond_wait(&journal->wake, &journal->lock);
+        }
+
+        // Give further edits a moment to join this batch, so one fsync covers them all
+        if (!journal->stopping && !journal->snapshot) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += JOURNAL_FLUSH_INTERVAL_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&journal->wake, &journal->lock, &deadline);
+        }
+
+        JournalBuffer batch = journal->pending;
+        journal->pending = journal->writing;
+        journal->pending.size = 0;
+        journal->writing = batch;
+
+        unsigned char* snapshot = journal->snapshot;
+        size_t snapshotSize = journal->snapshotSize;
+        size_t cut = journal->snapshotCut;
+        uint64_t ticket = journal->snapshotTicket;
+        journal->snapshot = NULL;
+        bool stopping = journal->stopping;
+        pthread_mutex_unlock(&journal->lock);
+
+        // Disk work happens without the lock held, so appends never wait on I/O
+        size_t start = 0;
+        bool written = false, compacted = false;
+        if (snapshot) {
+            written = WriteProjectFileData(journal->projectFilePath, snapshot, snapshotSize);
+            if (written && ResetJournalFile(journal)) {
+                start = cut;
+                compacted = true;
+            }
+            free(snapshot);
+        }
+
+        bool ok = true;
+        if (batch.size > start) {
+            ok = WriteAll(journal->fd, batch.data + start, batch.size - start) && fsync(journal->fd) == 0;
+        }
+        if (!ok) TraceLog(LOG_WARNING, "JOURNAL: Failed to write %s", journal->path);
+
+        pthread_mutex_lock(&journal->lock);
+        if (compacted) {
+            journal->stats.compactions++;
+            journal->stats.fileSize = sizeof(JournalFileHeader);
+        }
+        if (written) journal->writtenTicket = ticket;
+        else if (snapshot) journal->failedTicket = ticket;
+        if (ok && batch.size > start) {
+            journal->stats.flushes++;
+            journal->stats.fileSize += batch.size - start;
+        }
+        journal->writing.size = 0;
+
+        if (stopping && journal->pending.size == 0 && !journal->snapshot) break;
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return NULL;
+}
+
+Journal* OpenJournal(const char* projectDir) {
+    if (!projectDir) return NULL;
+
+    Journal* journal = calloc(1, sizeof(Journal));
+    if (!journal) return NULL;
+
+    snprintf(journal->path, sizeof(journal->path), "%s/%s", projectDir, JOURNAL_FILE_NAME);
+    snprintf(journal->projectFilePath, sizeof(journal->projectFilePath), "%s/%s", projectDir, PROJECT_FILE_NAME);
+
+    journal->fd = open(journal->path, JOURNAL_OPEN_FLAGS, 0644);
+    if (journal->fd < 0) {
+        TraceLog(LOG_WARNING, "JOURNAL: Failed to open %s", journal->path);
+        free(journal);
+        return NULL;
+    }
+
+    // Whatever was in the journal has already been replayed by the caller,
+    // who compacts it right away. Until then new records go after the last
+    // one replay accepted: anything past a torn record, or behind a header
+    // from another build, would never be read back
+    MappedFile existing = { 0 };
+    size_t validSize = MapFile(journal->path, &existing) ? ValidJournalSize(&existing, NULL) : 0;
+    size_t existingSize = existing.size;
+    UnmapFile(&existing);
+
+    bool ok = validSize > 0 ? (validSize == existingSize || ftruncate(journal->fd, (long)validSize) == 0)
+                            : ResetJournalFile(journal);
+    if (!ok) {
+        TraceLog(LOG_WARNING, "JOURNAL: Failed to initialize %s", journal->path);
+        close(journal->fd);
+        free(journal);
+        return NULL;
+    }
+
+    journal->stats.fileSize = validSize > 0 ? validSize : sizeof(JournalFileHeader);
+    journal->lastCompactionTime = GetTime();
+    pthread_mutex_init(&journal->lock, NULL);
+    pthread_cond_init(&journal->wake, NULL);
+
+    if (pthread_create(&journal->thread, NULL, JournalWriterThread, journal) != 0) {
+        TraceLog(LOG_WARNING, "JOURNAL: Failed to start writer thread");
+        pthread_cond_destroy(&journal->wake);
+        pthread_mutex_destroy(&journal->lock);
+        close(journal->fd);
+        free(journal);
+        return NULL;
+    }
+
+    return journal;
+}
+
+void CloseJournal(Journal* journal) {
+    if (!journal) return;
+
+    pthread_mutex_lock(&journal->lock);
+    journal->stopping = true;
+    pthread_cond_signal(&journal->wake);
+    pthread_mutex_unlock(&journal->lock);
+    pthread_join(journal->thread, NULL);
+
+    pthread_cond_destroy(&journal->wake);
+    pthread_mutex_destroy(&journal->lock);
+    close(journal->fd);
+    free(journal->pending.data);
+    free(journal->writing.data);
+    free(journal->snapshot);
+    free(journal);
+}
+
+static void AppendRecord(Journal* journal, JournalRecordType type, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                         size_t offset, const void* data, size_t size) {
+    if (!journal) return;
+
+    JournalRecordHeader header = { 0, (uint32_t)size, (uint8_t)type, (uint8_t)kind, 0, slot, sub, (uint32_t)offset };
+    header.checksum = RecordChecksum(&header, data);
+
+    pthread_mutex_lock(&journal->lock);
+    if (ReserveBuffer(&journal->pending, sizeof(header) + size)) {
+        memcpy(journal->pending.data + journal->pending.size, &header, sizeof(header));
+        if (size > 0) memcpy(journal->pending.data + journal->pending.size + sizeof(header), data, size);
+        journal->pending.size += sizeof(header) + size;
+        journal->stats.recordsAppended++;
+        journal->stats.bytesAppended += sizeof(header) + size;
+        pthread_cond_signal(&journal->wake);
+    }
+    pthread_mutex_unlock(&journal->lock);
+}
+
+void JournalRecord(Journal* journal, JournalRecordType type, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                   size_t offset, const void* data, size_t size) {
+    AppendRecord(journal, type, kind, slot, sub, offset, data, size);
+}
+
+static Pool* JournalPool(AppState* app, JournalObjectKind kind) {
+    switch (kind) {
+        case JOURNAL_OBJECT_ELEMENT:     return &app->elements;
+        case JOURNAL_OBJECT_PATTERN:     return &app->patterns;
+        case JOURNAL_OBJECT_ASSET:       return &app->assets;
+        default:                         return NULL;
+    }
+}
+
+// Resolve a journal target to its object inside app
+unsigned char* GetJournalTarget(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub, size_t* objectSize) {
+    switch (kind) {
+        case JOURNAL_OBJECT_TRACK:
+            if (slot >= MAX_TIMELINE_TRACKS) return NULL;
+            *objectSize = sizeof(Track);
+            return (unsigned char*)&app->tracks[slot];
+        case JOURNAL_OBJECT_ELEMENT:
+            *objectSize = sizeof(TimelineElement);
+            return PoolAt(&app->elements, slot);
+        case JOURNAL_OBJECT_PATTERN:
+            *objectSize = sizeof(Pattern);
+            return PoolAt(&app->patterns, slot);
+        case JOURNAL_OBJECT_ASSET:
+            *objectSize = sizeof(Asset);
+            return PoolAt(&app->assets, slot);
+        case JOURNAL_OBJECT_TIMELINE:
+            *objectSize = sizeof(TimelineState);
+            return (unsigned char*)&app->timeline;
+        case JOURNAL_OBJECT_COMPONENT:
+            if (sub >= COMPONENT_TYPE_COUNT) return NULL;
+            *objectSize = SCENE_COMPONENT_TYPES[sub].size;
+            return EcsGetComponent(&app->scene, EcsEntityAt(&app->scene, slot), (int)sub);
+        default:
+            return NULL;
+    }
+}
+
+// Bytes of an object that only make sense in this process (heap pointers)
+// and are never journaled; children go through their own records
+void GetJournalProtectedRange(JournalObjectKind kind, size_t* start, size_t* end) {
+    switch (kind) {
+        case JOURNAL_OBJECT_PATTERN:
+            *start = offsetof(Pattern, notes);
+            *end = offsetof(Pattern, noteCapacity) + sizeof(int);
+            break;
+        default:
+            *start = *end = 0;
+            break;
+    }
+}
+
+static void ReleaseChildren(JournalObjectKind kind, void* object) {
+    if (kind == JOURNAL_OBJECT_PATTERN) FreePattern(object);
+}
+
+// Entities and components live in the ECS rather than a pool
+static void ApplySceneRecord(AppState* app, const JournalRecordHeader* record) {
+    Entity entity = EcsEntityAt(&app->scene, record->slot);
+
+    if (record->kind == JOURNAL_OBJECT_ENTITY) {
+        // Recreating an alive entity empties it, matching the state the
+        // following records were made against
+        EcsDestroyEntity(&app->scene, entity);
+        if (record->type == JOURNAL_RECORD_ALLOC) EcsCreateEntityAt(&app->scene, record->slot);
+    } else if (record->kind == JOURNAL_OBJECT_COMPONENT && record->sub < COMPONENT_TYPE_COUNT) {
+        if (record->type == JOURNAL_RECORD_ALLOC) {
+            void* component = EcsAddComponent(&app->scene, entity, (int)record->sub);
+            if (component) EcsResetComponent(&app->scene, (int)record->sub, component);
+        } else {
+            EcsRemoveComponent(&app->scene, entity, (int)record->sub);
+        }
+    }
+}
+
+static void ApplyRecord(AppState* app, const JournalRecordHeader* record, const unsigned char* payload) {
+    JournalObjectKind kind = (JournalObjectKind)record->kind;
+
+    switch (record->type) {
+        case JOURNAL_RECORD_FIELD: {
+            size_t objectSize = 0, protectedStart = 0, protectedEnd = 0;
+            unsigned char* object = GetJournalTarget(app, kind, record->slot, record->sub, &objectSize);
+            if (!object || record->offset > objectSize || record->size > objectSize - record->offset) return;
+            GetJournalProtectedRange(kind, &protectedStart, &protectedEnd);
+            if (record->offset < protectedEnd && record->offset + record->size > protectedStart) return;
+            memcpy(object + record->offset, payload, record->size);
+            break;
+        }
+        case JOURNAL_RECORD_ALLOC: {
+            if (kind == JOURNAL_OBJECT_ENTITY || kind == JOURNAL_OBJECT_COMPONENT) {
+                ApplySceneRecord(app, record);
+                return;
+            }
+
+            // The slot may already be alive when the project file was written
+            // after this record; start it over so the following fields apply
+            // to the same zeroed object as when they were recorded
+            Pool* pool = JournalPool(app, kind);
+            if (!pool) return;
+            void* object = PoolAt(pool, record->slot);
+            if (object) {
+                ReleaseChildren(kind, object);
+                memset(object, 0, pool->itemSize);
+            } else {
+                PoolAllocAt(pool, record->slot);
+            }
+            break;
+        }
+        case JOURNAL_RECORD_FREE: {
+            if (kind == JOURNAL_OBJECT_ENTITY || kind == JOURNAL_OBJECT_COMPONENT) {
+                ApplySceneRecord(app, record);
+                return;
+            }
+
+            Pool* pool = JournalPool(app, kind);
+            void* object = pool ? PoolAt(pool, record->slot) : NULL;
+            if (!object) return;
+            ReleaseChildren(kind, object);
+            PoolFree(pool, PoolHandleAt(pool, record->slot));
+            break;
+        }
+        case JOURNAL_RECORD_RESIZE: {
+            int32_t count;
+            if (record->size != sizeof(count)) return;
+            memcpy(&count, payload, sizeof(count));
+            if (count < 0) return;
+
+            if (kind == JOURNAL_OBJECT_TRACK && count <= MAX_TIMELINE_TRACKS) app->trackCount = count;
+            break;
+        }
+        case JOURNAL_RECORD_NOTES: {
+            Pattern* pattern = PoolAt(&app->patterns, record->slot);
+            if (!pattern || kind != JOURNAL_OBJECT_PATTERN || record->size % sizeof(int32_t) != 0) return;
+            pattern->noteCount = 0;
+            for (size_t i = 0; i < record->size / sizeof(int32_t); i++) {
+                int32_t note;
+                memcpy(&note, payload + i * sizeof(note), sizeof(note));
+                if (!AddPatternNote(pattern, note)) break;
+            }
+            break;
+        }
+    }
+}
+
+void RecordProjectChange(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                         size_t offset, const void* data, size_t size) {
+    if (!app) return;
+    JournalRecord(app->journal, JOURNAL_RECORD_FIELD, kind, slot, sub, offset, data, size);
+    app->projectModified = true;
+    app->editVersion++;
+}
+
+void RecordProjectObject(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub) {
+    if (!app) return;
+    size_t objectSize = 0, protectedStart = 0, protectedEnd = 0;
+    const unsigned char* object = GetJournalTarget(app, kind, slot, sub, &objectSize);
+    if (!object) return;
+
+    // Everything but the protected range, which replay would reject anyway
+    GetJournalProtectedRange(kind, &protectedStart, &protectedEnd);
+    if (protectedStart > 0) RecordProjectChange(app, kind, slot, sub, 0, object, protectedStart);
+    if (protectedEnd < objectSize) {
+        RecordProjectChange(app, kind, slot, sub, protectedEnd, object + protectedEnd, objectSize - protectedEnd);
+    }
+}
+
+void RecordProjectAlloc(AppState* app, JournalObjectKind kind, uint32_t slot) {
+    if (!app) return;
+    JournalRecord(app->journal, JOURNAL_RECORD_ALLOC, kind, slot, 0, 0, NULL, 0);
+    app->projectModified = true;
+    app->editVersion++;
+}
+
+void RecordProjectFree(AppState* app, JournalObjectKind kind, uint32_t slot) {
+    if (!app) return;
+    JournalRecord(app->journal, JOURNAL_RECORD_FREE, kind, slot, 0, 0, NULL, 0);
+    app->projectModified = true;
+    app->editVersion++;
+}
+
+void RecordProjectResize(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub, int count) {
+    if (!app) return;
+    int32_t value = count;
+    JournalRecord(app->journal, JOURNAL_RECORD_RESIZE, kind, slot, sub, 0, &value, sizeof(value));
+    app->projectModified = true;
+    app->editVersion++;
+}
+
+void RecordPatternNotes(AppState* app, uint32_t slot) {
+    if (!app) return;
+    const Pattern* pattern = PoolAt(&app->patterns, slot);
+    if (!pattern) return;
+    JournalRecord(app->journal, JOURNAL_RECORD_NOTES, JOURNAL_OBJECT_PATTERN, slot, 0, 0,
+                  pattern->notes, (size_t)pattern->noteCount * sizeof(int32_t));
+    app->projectModified = true;
+    app->editVersion++;
+}
+
+uint64_t CompactJournal(Journal* journal, const AppState* app) {
+    if (!journal || !app) return 0;
+
+    // Serializing is a memory copy of the project; the disk write happens on
+    // the writer thread
+    size_t size = 0;
+    unsigned char* snapshot = BuildProjectFile(app, &size);
+    if (!snapshot) {
+        TraceLog(LOG_WARNING, "JOURNAL: Failed to serialize project for compaction");
+        return 0;
+    }
+
+    // A snapshot the writer has not picked up yet is superseded by this one
+    pthread_mutex_lock(&journal->lock);
+    free(journal->snapshot);
+    journal->snapshot = snapshot;
+    journal->snapshotSize = size;
+    journal->snapshotCut = journal->pending.size;
+    uint64_t ticket = ++journal->nextTicket;
+    journal->snapshotTicket = ticket;
+    pthread_cond_signal(&journal->wake);
+    pthread_mutex_unlock(&journal->lock);
+
+    journal->lastCompactionTime = GetTime();
+    return ticket;
+}
+
+JournalCompactionState GetJournalCompaction(const Journal* journal, uint64_t ticket) {
+    if (!journal || ticket == 0) return JOURNAL_COMPACTION_FAILED;
+
+    // A newer snapshot contains everything an older one did
+    pthread_mutex_lock((pthread_mutex_t*)&journal->lock);
+    JournalCompactionState state = JOURNAL_COMPACTION_PENDING;
+    if (journal->writtenTicket >= ticket) state = JOURNAL_COMPACTION_DONE;
+    else if (journal->failedTicket >= ticket) state = JOURNAL_COMPACTION_FAILED;
+    pthread_mutex_unlock((pthread_mutex_t*)&journal->lock);
+    return state;
+}
+
+bool SaveProjectJournal(AppState* app) {
+    if (!app || !app->journal) return false;
+    app->saveTicket = CompactJournal(app->journal, app);
+    app->saveRecords = GetJournalStats(app->journal).recordsAppended;
+    return app->saveTicket != 0;
+}
+
+void UpdateJournal(AppState* app) {
+    if (!app || !app->journal) return;
+    Journal* journal = app->journal;
+
+    // The project only counts as saved once the writer has renamed the new
+    // file into place, and only if nothing was edited since the snapshot
+    if (app->saveTicket != 0) {
+        JournalCompactionState state = GetJournalCompaction(journal, app->saveTicket);
+        if (state != JOURNAL_COMPACTION_PENDING) {
+            if (state == JOURNAL_COMPACTION_DONE &&
+                GetJournalStats(journal).recordsAppended == app->saveRecords) {
+                app->projectModified = false;
+            }
+            app->saveTicket = 0;
+        }
+    }
+
+    double now = GetTime();
+    if (app->editVersion != journal->editVersion) {
+        journal->editVersion = app->editVersion;
+        journal->lastEditTime = now;
+    }
+
+    if (!app->projectModified || app->saveTicket != 0) return;
+    JournalStats stats = GetJournalStats(journal);
+    bool due = stats.fileSize >= JOURNAL_COMPACT_BYTES || now - journal->lastCompactionTime >= JOURNAL_COMPACT_INTERVAL;
+    bool quiet = now - journal->lastEditTime >= JOURNAL_COMPACT_QUIET;
+    if ((due && quiet) || stats.fileSize >= JOURNAL_COMPACT_FORCE_BYTES) {
+        PROFILE_SCOPE("CompactJournal");
+        CompactJournal(journal, app);
+    }
+}
+
+int ReplayJournal(AppState* app, const char* projectDir) {
+    if (!app || !projectDir) return 0;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", projectDir, JOURNAL_FILE_NAME);
+
+    MappedFile file;
+    if (!MapFile(path, &file)) return 0;
+
+    int recordCount = 0;
+    size_t validSize = ValidJournalSize(&file, &recordCount);
+    if (validSize == 0) {
+        TraceLog(LOG_WARNING, "JOURNAL: Ignoring incompatible journal %s", path);
+        UnmapFile(&file);
+        return 0;
+    }
+
+    // A torn or corrupt record marks the end of what reached the disk
+    int applied = 0;
+    size_t pos = sizeof(JournalFileHeader);
+    while (applied < recordCount) {
+        JournalRecordHeader record;
+        memcpy(&record, file.data + pos, sizeof(record));
+        ApplyRecord(app, &record, file.data + pos + sizeof(record));
+        pos += sizeof(record) + record.size;
+        applied++;
+    }
+    UnmapFile(&file);
+
+    if (applied > 0) {
+        TraceLog(LOG_INFO, "JOURNAL: Recovered %d unsaved edits from %s", applied, path);
+        app->projectModified = true;
+        app->editVersion++;
+    }
+    return applied;
+}
+
+JournalStats GetJournalStats(const Journal* journal) {
+    JournalStats stats = { 0 };
+    if (!journal) return stats;
+
+    pthread_mutex_lock((pthread_mutex_t*)&journal->lock);
+    stats = journal->stats;
+    pthread_mutex_unlock((pthread_mutex_t*)&journal->lock);
+    return stats;
+}
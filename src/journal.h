@@ -0,0 +1,113 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "app_state.h"
+#include <stdint.h>
+
+// Append-only autosave journal.
+//
+// Every edit is appended as a small delta record (which object, which bytes,
+// their new value) to an in-memory buffer; a background thread writes the
+// buffer to disk and fsyncs once per batch. Records hold absolute values, so
+// replaying them over a project file that already contains some of them is
+// harmless. Compaction serializes the project in memory on the caller's
+// thread and lets the background thread write it and truncate the journal;
+// the caller polls its ticket to learn whether the project file made it.
+//
+// Serializing stalls the UI thread for a copy of the whole project, about
+// 5 ms for the 70k objects of the project benchmark (project.serialize), and
+// only a consistent copy would let a worker do it, which costs the same. So
+// compactions that are merely due wait for a quiet point, JOURNAL_COMPACT_QUIET
+// seconds without an edit, and only a journal that keeps growing through
+// JOURNAL_COMPACT_FORCE_BYTES of continuous editing is compacted mid-edit.
+// Saving compacts right away.
+
+#define JOURNAL_FILE_NAME "project.gbjournal"
+#define JOURNAL_FILE_MAGIC 0x4C4A4247u   // "GBJL"
+#define JOURNAL_FILE_VERSION 3
+
+#define JOURNAL_FLUSH_INTERVAL_MS 100
+#define JOURNAL_COMPACT_BYTES (4 * 1024 * 1024)
+#define JOURNAL_COMPACT_INTERVAL 300.0   // seconds
+#define JOURNAL_COMPACT_QUIET 2.0        // Seconds without an edit before a due compaction runs
+#define JOURNAL_COMPACT_FORCE_BYTES (4 * JOURNAL_COMPACT_BYTES)
+
+// Objects are addressed by pool slot (array index for tracks, entity slot
+// for scene components)
+typedef enum {
+    JOURNAL_OBJECT_TRACK,
+    JOURNAL_OBJECT_ELEMENT,
+    JOURNAL_OBJECT_PATTERN,
+    JOURNAL_OBJECT_ENTITY,
+    JOURNAL_OBJECT_ASSET,
+    JOURNAL_OBJECT_TIMELINE,    // AppState.timeline, slot is ignored
+    JOURNAL_OBJECT_COMPONENT,   // sub = SceneComponentType
+    JOURNAL_OBJECT_COUNT
+} JournalObjectKind;
+
+typedef enum {
+    JOURNAL_RECORD_FIELD,       // Overwrite bytes [offset, offset + size) of one object
+    JOURNAL_RECORD_ALLOC,       // A pool slot came alive zeroed, or a component was added with defaults
+    JOURNAL_RECORD_FREE,        // A pool slot was freed, or a component removed
+    JOURNAL_RECORD_RESIZE,      // Set the number of tracks
+    JOURNAL_RECORD_NOTES        // Replace a pattern's notes
+} JournalRecordType;
+
+typedef struct Journal Journal;
+
+typedef enum {
+    JOURNAL_COMPACTION_PENDING,
+    JOURNAL_COMPACTION_DONE,        // The project file was renamed into place
+    JOURNAL_COMPACTION_FAILED
+} JournalCompactionState;
+
+typedef struct {
+    uint64_t recordsAppended;
+    uint64_t bytesAppended;
+    uint64_t flushes;
+    uint64_t compactions;
+    uint64_t fileSize;
+} JournalStats;
+
+// Journal lifetime
+Journal* OpenJournal(const char* projectDir);
+void CloseJournal(Journal* journal);
+
+// Recording (cheap, never touches the disk)
+void JournalRecord(Journal* journal, JournalRecordType type, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                   size_t offset, const void* data, size_t size);
+
+// Record one field of an object, e.g.
+//   JOURNAL_FIELD(app, JOURNAL_OBJECT_TRACK, i, &app->tracks[i], volume);
+#define JOURNAL_FIELD(app, kind, slot, object, field) \
+    JOURNAL_SUBFIELD(app, kind, slot, 0, object, field)
+#define JOURNAL_SUBFIELD(app, kind, slot, sub, object, field) \
+    RecordProjectChange((app), (kind), (slot), (sub), \
+                        (size_t)((const char*)&(object)->field - (const char*)(object)), \
+                        &(object)->field, sizeof((object)->field))
+
+// Record a change and flag the project as modified
+void RecordProjectChange(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub,
+                         size_t offset, const void* data, size_t size);
+void RecordProjectObject(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub);
+void RecordProjectAlloc(AppState* app, JournalObjectKind kind, uint32_t slot);
+void RecordProjectFree(AppState* app, JournalObjectKind kind, uint32_t slot);
+void RecordProjectResize(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub, int count);
+void RecordPatternNotes(AppState* app, uint32_t slot);
+
+// Object a record addresses, NULL if it is not alive; objectSize is set
+// either way as long as the kind and slot are valid. The protected range holds heap pointers that
+// are never journaled (empty for most kinds).
+unsigned char* GetJournalTarget(AppState* app, JournalObjectKind kind, uint32_t slot, uint32_t sub, size_t* objectSize);
+void GetJournalProtectedRange(JournalObjectKind kind, size_t* start, size_t* end);
+
+// Compaction and recovery. CompactJournal returns a ticket, 0 if the
+// project could not be serialized.
+uint64_t CompactJournal(Journal* journal, const AppState* app);
+JournalCompactionState GetJournalCompaction(const Journal* journal, uint64_t ticket);
+bool SaveProjectJournal(AppState* app);     // Compacts; projectModified clears once the write is confirmed
+void UpdateJournal(AppState* app);          // Once per frame: confirms saves, compacts when due
+int ReplayJournal(AppState* app, const char* projectDir);
+JournalStats GetJournalStats(const Journal* journal);
+
+#endif // JOURNAL_H
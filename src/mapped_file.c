@@ -0,0 +1,98 @@
+#include "mapped_file.h"
+#include <string.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool MapFile(const char* path, MappedFile* file) {
+    if (!file) return false;
+    memset(file, 0, sizeof(*file));
+    if (!path) return false;
+
+#if defined(_WIN32)
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || size.QuadPart == 0) {
+        CloseHandle(fh);
+        return false;
+    }
+
+    HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mh) {
+        CloseHandle(fh);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mh);
+        CloseHandle(fh);
+        return false;
+    }
+
+    file->data = view;
+    file->size = (size_t)size.QuadPart;
+    file->fileHandle = fh;
+    file->mappingHandle = mh;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+    if (view == MAP_FAILED) return false;
+
+    file->data = view;
+    file->size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void UnmapFile(MappedFile* file) {
+    if (!file || !file->data) return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->mappingHandle);
+    CloseHandle(file->fileHandle);
+#else
+    munmap((void*)file->data, file->size);
+#endif
+    memset(file, 0, sizeof(*file));
+}
+
+bool GetFileInfo(const char* path, uint64_t* size, int64_t* mtime) {
+    if (!path) return false;
+
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return false;
+    uint64_t ticks = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    *size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    *mtime = ((int64_t)ticks - 116444736000000000LL) * 100;     // 100ns FILETIME ticks since 1601
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (uint64_t)st.st_size;
+#if defined(__APPLE__)
+    *mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    *mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+    return true;
+}
@@ -0,0 +1,26 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Read-only memory mapping of a whole file
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+} MappedFile;
+
+// Map a file read-only. Returns false (and leaves *file zeroed) on failure.
+bool MapFile(const char* path, MappedFile* file);
+void UnmapFile(MappedFile* file);
+
+// Size and modification time of a file, the time in nanoseconds since the
+// Unix epoch. Returns false when the file can't be stat'ed.
+bool GetFileInfo(const char* path, uint64_t* size, int64_t* mtime);
+
+#endif // MAPPED_FILE_H
@@ -1,4 +1,13 @@
 #include "raylib.h"
+#include "dir_scanner.h"
+#include "file_filter.h"
+#include "draw_list.h"
+#include "text_cache.h"
+#include "frame_scheduler.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "editor.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,7 +35,7 @@
 #define WINDOW_HEIGHT 600
 #define MAX_DIRECTORY_FILES 1024
 
-typedef enum { SCREEN_MAIN_MENU, SCREEN_NEW_PROJECT, SCREEN_FILE_BROWSER } AppScreen;
+typedef enum { SCREEN_MAIN_MENU, SCREEN_NEW_PROJECT, SCREEN_FILE_BROWSER, SCREEN_EDITOR } AppScreen;
 
 typedef struct {
     const char *text;
@@ -46,12 +55,16 @@ typedef struct {
 // Simple file browser structure
 typedef struct {
     char currentDirectory[512];
-    FilePathList files;
-    int selectedFile;
+    DirScanner *scanner;
+    DirListing *listing;    // Filled in the background, may still be scanning
+    DirListing *refresh;    // Rescan of a stale listing, swapped in once complete
+    TextInput filterInput;
+    FileFilter filter;
+    int selectedFile;       // Listing index, not row
     Vector2 scrollPosition;
 } FileBrowser;
 
-char *GetDefaultProjectPath(void) {
+static char *GetDefaultProjectPath(void) {
 #if defined(_WIN32)
     return strdup(DEFAULT_PROJECT_PATH);
 #else
@@ -63,42 +76,124 @@ char *GetDefaultProjectPath(void) {
 #endif
 }
 
-void EnsureDirectoryExists(const char *path) {
+static void EnsureDirectoryExists(const char *path) {
     mkdir(path, 0777);
 }
 
+// Project folders are created on a worker; the editor opens once they exist,
+// unless the user left the New Project screen (or quit) in the meantime
+typedef struct ProjectCreation {
+    char parent[512];
+    char path[512];
+    AppScreen *screen;
+    struct ProjectCreation **pending;   // Cleared when the callback ran
+    bool cancelled;
+    Editor *editor;
+} ProjectCreation;
+
+static void CreateProjectJob(void *data) {
+    ProjectCreation *creation = data;
+    EnsureDirectoryExists(creation->parent);
+    EnsureDirectoryExists(creation->path);
+}
+
+static void ProjectCreated(void *data) {
+    ProjectCreation *creation = data;
+    TraceLog(LOG_INFO, "Created project at: %s", creation->path);
+    if (!creation->cancelled) {
+        *creation->screen = OpenEditorProject(creation->editor, creation->path) ? SCREEN_EDITOR : SCREEN_MAIN_MENU;
+    }
+    *creation->pending = NULL;
+    free(creation);
+}
+
+static void CancelProjectCreation(ProjectCreation *pending) {
+    if (pending) pending->cancelled = true;
+}
+
 // Initialize file browser with a starting directory
-FileBrowser InitFileBrowser(const char *directory) {
+static FileBrowser InitFileBrowser(DirScanner *scanner, const char *directory) {
     FileBrowser browser;
     
     strncpy(browser.currentDirectory, directory, 511);
     browser.currentDirectory[511] = '\0';
-    browser.files = LoadDirectoryFiles(browser.currentDirectory);
+    browser.scanner = scanner;
+    browser.listing = AcquireDirectory(scanner, browser.currentDirectory);
+    browser.refresh = NULL;
+    browser.filterInput = (TextInput){ .text = "", .cursorPosition = 0, .editMode = true };
+    InitFileFilter(&browser.filter);
     browser.selectedFile = -1;
     browser.scrollPosition = (Vector2){0};
     
     return browser;
 }
 
+// Switch the browser to another directory (scanned in the background)
+static void ChangeFileBrowserDirectory(FileBrowser *browser, const char *directory) {
+    if (directory != browser->currentDirectory) {
+        strncpy(browser->currentDirectory, directory, 511);
+        browser->currentDirectory[511] = '\0';
+    }
+    ReleaseDirectory(browser->scanner, browser->refresh);
+    browser->refresh = NULL;
+    ReleaseDirectory(browser->scanner, browser->listing);
+    browser->listing = AcquireDirectory(browser->scanner, browser->currentDirectory);
+    browser->filterInput.text[0] = '\0';
+    browser->filterInput.cursorPosition = 0;
+    browser->selectedFile = -1;
+    browser->scrollPosition.y = 0;
+}
+
+// Rescan a listing that went stale. The old one stays on screen until the
+// new scan is complete, then the selection is carried over by name; the
+// scroll position is kept as is.
+static void RefreshFileBrowser(FileBrowser *browser) {
+    if (!browser->refresh) {
+        if (IsDirectoryStale(browser->listing)) {
+            browser->refresh = AcquireDirectory(browser->scanner, browser->currentDirectory);
+        }
+        return;
+    }
+    if (!IsDirectoryScanComplete(browser->refresh)) return;
+
+    const DirEntry *selected = GetDirectoryEntry(browser->listing, browser->selectedFile);
+    int remapped = -1;
+    if (selected) {
+        int count = GetDirectoryEntryCount(browser->refresh);
+        for (int i = 0; i < count && remapped < 0; i++) {
+            const DirEntry *entry = GetDirectoryEntry(browser->refresh, i);
+            if (entry->nameLength == selected->nameLength && strcmp(entry->name, selected->name) == 0) remapped = i;
+        }
+    }
+    ReleaseDirectory(browser->scanner, browser->listing);
+    browser->listing = browser->refresh;
+    browser->refresh = NULL;
+    browser->selectedFile = remapped;
+}
+
 // Unload file browser resources
-void UnloadFileBrowser(FileBrowser *browser) {
-    UnloadDirectoryFiles(browser->files);
+static void UnloadFileBrowser(FileBrowser *browser) {
+    ReleaseDirectory(browser->scanner, browser->refresh);
+    browser->refresh = NULL;
+    ReleaseDirectory(browser->scanner, browser->listing);
+    browser->listing = NULL;
+    UnloadFileFilter(&browser->filter);
 }
 
 // Custom GUI functions
-bool Button(Rectangle bounds, const char *text) {
+static bool Button(Rectangle bounds, const char *text) {
     Vector2 mousePoint = GetMousePosition();
     bool mouseHover = CheckCollisionPointRec(mousePoint, bounds);
     bool pressed = false;
     
     // Draw button
     Color buttonColor = mouseHover ? (Color){81, 113, 144, 255} : (Color){59, 91, 118, 255};
-    DrawRectangleRec(bounds, buttonColor);
-    DrawRectangleLinesEx(bounds, 1, mouseHover ? WHITE : LIGHTGRAY);
+    UiDrawRectangle(bounds, buttonColor);
+    UiDrawRectangleLines(bounds, 1, mouseHover ? WHITE : LIGHTGRAY);
     
     // Draw text centered
-    int textWidth = MeasureText(text, 20);
-    DrawText(text, bounds.x + (bounds.width - textWidth)/2, bounds.y + (bounds.height - 20)/2, 20, WHITE);
+    float textWidth = MeasureTextCached(text, 20).x;
+    UiDrawText(text, bounds.x + (bounds.width - textWidth)/2, bounds.y + (bounds.height - 20)/2, 20, WHITE);
     
     // Check click
     if (mouseHover && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) pressed = true;
@@ -106,7 +201,7 @@ bool Button(Rectangle bounds, const char *text) {
     return pressed;
 }
 
-void UpdateTextInput(TextInput *input) {
+static void UpdateTextInput(TextInput *input) {
     Vector2 mousePoint = GetMousePosition();
     bool mouseHover = CheckCollisionPointRec(mousePoint, input->bounds);
     
@@ -155,17 +250,17 @@ void UpdateTextInput(TextInput *input) {
     
     // Draw text input
     Color backgroundColor = input->editMode ? (Color){70, 70, 70, 255} : (Color){60, 60, 60, 255};
-    DrawRectangleRec(input->bounds, backgroundColor);
-    DrawRectangleLinesEx(input->bounds, 1, input->editMode ? WHITE : GRAY);
+    UiDrawRectangle(input->bounds, backgroundColor);
+    UiDrawRectangleLines(input->bounds, 1, input->editMode ? WHITE : GRAY);
     
     // Draw text with padding
-    DrawText(input->text, input->bounds.x + 5, input->bounds.y + (input->bounds.height - 20)/2, 20, WHITE);
+    UiDrawText(input->text, input->bounds.x + 5, input->bounds.y + (input->bounds.height - 20)/2, 20, WHITE);
     
     // Draw cursor when in edit mode
     if (input->editMode) {
         // Calculate cursor position
-        int cursorX = input->bounds.x + 5 + MeasureText(TextSubtext(input->text, 0, input->cursorPosition), 20);
-        DrawRectangle(cursorX, input->bounds.y + 5, 2, input->bounds.height - 10, WHITE);
+        float cursorX = input->bounds.x + 5 + GetTextCaretPosition(input->text, input->cursorPosition, 20).x;
+        UiDrawRectangle((Rectangle){ cursorX, input->bounds.y + 5, 2, input->bounds.height - 10 }, WHITE);
     }
 }
 
@@ -173,7 +268,11 @@ int main(void) {
     // Allow window resizing
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "GearBox");
-    SetTargetFPS(60);
+    FrameScheduler scheduler;
+    InitFrameScheduler(&scheduler, 60, 10);
+    InitTextCache("resources/fonts/ui.ttf");
+    InitProfiler();
+    JobSystem *jobs = CreateJobSystem(0);
 
     // Terraria‑style subtitle
     const char *randomSubtitles[] = {
@@ -217,12 +316,22 @@ int main(void) {
     free(defaultPath);
     
     // File browser
+    DirScanner *dirScanner = CreateDirScanner();
     FileBrowser fileBrowser;
     bool fileBrowserInitialized = false;
+    bool browsingForProject = false;    // Open Project rather than picking a destination
+    Editor *editor = CreateEditor(jobs);
+    bool showDrawStats = false;
+    ProjectCreation *pendingCreation = NULL;
 
     while (!WindowShouldClose()) {
+        BeginScheduledFrame(&scheduler);
+        BeginProfilerFrame();
         BeginDrawing();
         ClearBackground(BLACK);
+        UpdateTextCache();
+        RunJobCallbacks(jobs);
+        BeginUiDrawList();
 
         if (screen == SCREEN_MAIN_MENU) {
             Vector2 m = GetMousePosition();
@@ -235,16 +344,19 @@ int main(void) {
                 items[i].isHovered = hov;
                 float tgt = (hov||seli)?HIGHLIGHTED_FONT_SIZE:BASE_FONT_SIZE;
                 items[i].fontSize += (tgt - items[i].fontSize)*0.2f;
+                // Snap once the easing is invisible so the menu can go idle
+                if (fabsf(tgt - items[i].fontSize) < 0.1f) items[i].fontSize = tgt;
+                else RequestFrame(&scheduler);
                 if (hov) sel = i;
             }
 
-            DrawText("GearBox :3", 50,30,30,RAYWHITE);
+            UiDrawText("GearBox :3", 50,30,30,RAYWHITE);
             for (int i=0; i<NUM_ITEMS; i++) {
-                DrawText(items[i].text,
-                         items[i].bounds.x,
-                         items[i].bounds.y,
-                         (int)items[i].fontSize,
-                         (i==sel)?RED:RAYWHITE);
+                UiDrawText(items[i].text,
+                           items[i].bounds.x,
+                           items[i].bounds.y,
+                           (int)items[i].fontSize,
+                           (i==sel)?RED:RAYWHITE);
             }
 
             if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
@@ -252,50 +364,83 @@ int main(void) {
                 screen = SCREEN_NEW_PROJECT;
             }
             
+            // Open Project browses for a project folder
+            if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
+                CheckCollisionPointRec(GetMousePosition(), items[1].bounds)) {
+                if (fileBrowserInitialized) {
+                    UnloadFileBrowser(&fileBrowser);
+                }
+                char *projectsPath = GetDefaultProjectPath();
+                fileBrowser = InitFileBrowser(dirScanner, projectsPath);
+                free(projectsPath);
+                fileBrowserInitialized = true;
+                browsingForProject = true;
+                screen = SCREEN_FILE_BROWSER;
+            }
+            
             // Exit when clicking Exit
             if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
                 CheckCollisionPointRec(GetMousePosition(), items[4].bounds)) {
+                if (fileBrowserInitialized) {
+                    UnloadFileBrowser(&fileBrowser);
+                }
+                EndUiDrawList();
+                EndDrawing();
+                // Callbacks still queued run while the editor and job system shut down
+                CancelProjectCreation(pendingCreation);
+                DestroyEditor(editor);
+                DestroyJobSystem(jobs);
+                DestroyDirScanner(dirScanner);
+                UnloadProfiler();
+                UnloadUiDrawList();
+                UnloadTextCache();
                 CloseWindow();
                 return 0;
             }
 
             int h = GetScreenHeight();
-            DrawText("© Blockiro LLC and GearBox contributors, under the MPL 2.0",
-                     50, h-45, 15, GRAY);
-            DrawText("Not affiliated or endorsed with Valve corporation.",
-                     50, h-25, 15, GRAY);
+            UiDrawText("© Blockiro LLC and GearBox contributors, under the MPL 2.0",
+                       50, h-45, 15, GRAY);
+            UiDrawText("Not affiliated or endorsed with Valve corporation.",
+                       50, h-25, 15, GRAY);
 
         } else if (screen == SCREEN_NEW_PROJECT) {
-            DrawText("New Project", 50,30,30,RAYWHITE);
+            UiDrawText("New Project", 50,30,30,RAYWHITE);
 
             int y0 = 100;
-            DrawText("Project Name", 50, y0, 20, GRAY);
+            UiDrawText("Project Name", 50, y0, 20, GRAY);
             UpdateTextInput(&projectNameInput);
 
-            DrawText("Project Destination", 50, y0+70, 20, GRAY);
+            UiDrawText("Project Destination", 50, y0+70, 20, GRAY);
             UpdateTextInput(&projectPathInput);
             
             if (Button((Rectangle){460, y0+95, 100, 30}, "Browse")) {
                 if (fileBrowserInitialized) {
                     UnloadFileBrowser(&fileBrowser);
                 }
-                fileBrowser = InitFileBrowser(projectPathInput.text);
+                fileBrowser = InitFileBrowser(dirScanner, projectPathInput.text);
                 fileBrowserInitialized = true;
+                browsingForProject = false;
+                CancelProjectCreation(pendingCreation);
                 screen = SCREEN_FILE_BROWSER;
             }
 
             int h = GetScreenHeight();
-            if (Button((Rectangle){50, h-60, 150, 30}, "Create Project")) {
-                if (strlen(projectNameInput.text) > 0) {
-                    char fullPath[512];
-                    snprintf(fullPath, 512, "%s%s%s", projectPathInput.text, DIR_SEPARATOR, projectNameInput.text);
-                    EnsureDirectoryExists(projectPathInput.text);
-                    EnsureDirectoryExists(fullPath);
-                    TraceLog(LOG_INFO, "Created project at: %s", fullPath);
-                    screen = SCREEN_MAIN_MENU;
+            if (Button((Rectangle){50, h-60, 150, 30}, pendingCreation ? "Creating..." : "Create Project") && !pendingCreation) {
+                ProjectCreation *creation = strlen(projectNameInput.text) > 0 ? malloc(sizeof(ProjectCreation)) : NULL;
+                if (creation) {
+                    snprintf(creation->parent, sizeof(creation->parent), "%s", projectPathInput.text);
+                    snprintf(creation->path, sizeof(creation->path), "%s%s%s", projectPathInput.text, DIR_SEPARATOR, projectNameInput.text);
+                    creation->screen = &screen;
+                    creation->pending = &pendingCreation;
+                    creation->cancelled = false;
+                    creation->editor = editor;
+                    pendingCreation = creation;
+                    ScheduleJob(jobs, (JobDesc){ CreateProjectJob, ProjectCreated, creation, JOB_PRIORITY_INTERACTIVE }, NULL, 0);
                 }
             }
             if (Button((Rectangle){220, h-60, 150, 30}, "Back")) {
+                CancelProjectCreation(pendingCreation);
                 screen = SCREEN_MAIN_MENU;
             }
         } else if (screen == SCREEN_FILE_BROWSER) {
@@ -303,16 +448,16 @@ int main(void) {
             int h = GetScreenHeight();
             
             // Draw a darker semi-transparent overlay
-            DrawRectangle(0, 0, w, h, (Color){0, 0, 0, 200});
+            UiDrawRectangle((Rectangle){ 0, 0, w, h }, (Color){0, 0, 0, 200});
             
             // Draw file browser panel
             Rectangle panel = (Rectangle){w/2 - 300, h/2 - 200, 600, 400};
-            DrawRectangleRec(panel, (Color){40, 40, 40, 255});
-            DrawRectangleLinesEx(panel, 2, RAYWHITE);
+            UiDrawRectangle(panel, (Color){40, 40, 40, 255});
+            UiDrawRectangleLines(panel, 2, RAYWHITE);
             
             // Draw current directory
-            DrawText("Select Directory", panel.x + 10, panel.y + 10, 20, RAYWHITE);
-            DrawText(fileBrowser.currentDirectory, panel.x + 10, panel.y + 40, 16, LIGHTGRAY);
+            UiDrawText(browsingForProject ? "Open Project" : "Select Directory", panel.x + 10, panel.y + 10, 20, RAYWHITE);
+            UiDrawText(fileBrowser.currentDirectory, panel.x + 10, panel.y + 40, 16, LIGHTGRAY);
             
             // Parent directory button
             if (Button((Rectangle){panel.x + panel.width - 100, panel.y + 10, 90, 30}, "Parent Dir")) {
@@ -324,20 +469,34 @@ int main(void) {
                     if (strlen(fileBrowser.currentDirectory) == 0) {
                         strcpy(fileBrowser.currentDirectory, "/");
                     }
-                    UnloadDirectoryFiles(fileBrowser.files);
-                    fileBrowser.files = LoadDirectoryFiles(fileBrowser.currentDirectory);
-                    fileBrowser.selectedFile = -1;
+                    ChangeFileBrowserDirectory(&fileBrowser, fileBrowser.currentDirectory);
                 }
             }
             
+            // Pick up changes to the directory without losing the scroll position
+            RefreshFileBrowser(&fileBrowser);
+            if (fileBrowser.refresh) RequestBackgroundFrame(&scheduler);
+            
+            // Type-to-filter box; each keystroke refines the previous matches
+            fileBrowser.filterInput.bounds = (Rectangle){panel.x + 10, panel.y + 65, panel.width - 20, 28};
+            fileBrowser.filterInput.editMode = true;     // The filter box always takes typing
+            UpdateTextInput(&fileBrowser.filterInput);
+            if (fileBrowser.filterInput.text[0] == '\0') {
+                UiDrawText("Type to filter...", panel.x + 15, panel.y + 71, 16, GRAY);
+            }
+            PROFILE_BEGIN(filter, "FileBrowser.Filter");
+            UpdateFileFilter(&fileBrowser.filter, fileBrowser.listing);
+            SetFileFilterQuery(&fileBrowser.filter, fileBrowser.filterInput.text);
+            PROFILE_END(filter);
+            
             // Draw file list
-            Rectangle listView = (Rectangle){panel.x + 10, panel.y + 70, panel.width - 20, panel.height - 120};
-            DrawRectangleRec(listView, (Color){20, 20, 20, 255});
+            Rectangle listView = (Rectangle){panel.x + 10, panel.y + 100, panel.width - 20, panel.height - 150};
+            UiDrawRectangle(listView, (Color){20, 20, 20, 255});
             
             // Calculate visible items and scroll
             int itemHeight = 25;
             int visibleItems = (int)(listView.height / itemHeight);
-            int totalItems = fileBrowser.files.count;
+            int totalItems = GetFilterMatchCount(&fileBrowser.filter);
             
             // Handle scrolling
             float scrollMax = (totalItems - visibleItems) * itemHeight;
@@ -348,15 +507,21 @@ int main(void) {
             if (fileBrowser.scrollPosition.y < 0) fileBrowser.scrollPosition.y = 0;
             if (fileBrowser.scrollPosition.y > scrollMax) fileBrowser.scrollPosition.y = scrollMax;
             
+            // Only the rows inside the view are touched, however long the list is
+            int firstVisible = (int)(fileBrowser.scrollPosition.y / itemHeight);
+            int lastVisible = firstVisible + visibleItems + 1;
+            if (lastVisible > totalItems) lastVisible = totalItems;
+            float dirPrefixWidth = MeasureTextCached("[DIR] ", 16).x;
+            
             // Draw files
-            for (int i = 0; i < fileBrowser.files.count; i++) {
-                float itemY = listView.y + i * itemHeight - fileBrowser.scrollPosition.y;
-                
-                // Skip items outside of view
-                if (itemY + itemHeight < listView.y || itemY > listView.y + listView.height) continue;
+            PROFILE_BEGIN(rows, "FileBrowser.Rows");
+            for (int row = firstVisible; row < lastVisible; row++) {
+                int i = GetFilterMatch(&fileBrowser.filter, row);
+                float itemY = listView.y + row * itemHeight - fileBrowser.scrollPosition.y;
                 
-                const char *filename = GetFileName(fileBrowser.files.paths[i]);
-                bool isDir = DirectoryExists(fileBrowser.files.paths[i]);
+                const DirEntry *entry = GetDirectoryEntry(fileBrowser.listing, i);
+                const char *filename = entry->name;
+                bool isDir = entry->isDir;
                 Color itemColor = isDir ? SKYBLUE : RAYWHITE;
                 
                 Rectangle itemRect = (Rectangle){listView.x, itemY, listView.width, itemHeight};
@@ -364,19 +529,17 @@ int main(void) {
                 
                 // Draw selection highlight
                 if (isSelected) {
-                    DrawRectangleRec(itemRect, (Color){60, 60, 60, 255});
+                    UiDrawRectangle(itemRect, (Color){60, 60, 60, 255});
                 }
                 
                 // Draw filename
-                char displayName[256];
                 if (isDir) {
-                    snprintf(displayName, 256, "[DIR] %s", filename);
+                    UiDrawText("[DIR]", itemRect.x + 5, itemRect.y + 5, 16, itemColor);
+                    UiDrawText(filename, itemRect.x + 5 + dirPrefixWidth, itemRect.y + 5, 16, itemColor);
                 } else {
-                    snprintf(displayName, 256, "%s", filename);
+                    UiDrawText(filename, itemRect.x + 5, itemRect.y + 5, 16, itemColor);
                 }
                 
-                DrawText(displayName, itemRect.x + 5, itemRect.y + 5, 16, itemColor);
-                
                 // Handle item selection
                 if (CheckCollisionPointRec(GetMousePosition(), itemRect)) {
                     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
@@ -389,54 +552,114 @@ int main(void) {
                             // Enter directory
                             char newPath[512];
                             snprintf(newPath, 512, "%s/%s", fileBrowser.currentDirectory, filename);
-                            strcpy(fileBrowser.currentDirectory, newPath);
-                            UnloadDirectoryFiles(fileBrowser.files);
-                            fileBrowser.files = LoadDirectoryFiles(fileBrowser.currentDirectory);
-                            fileBrowser.selectedFile = -1;
-                            fileBrowser.scrollPosition.y = 0;
+                            ChangeFileBrowserDirectory(&fileBrowser, newPath);
+                            lastClickTime = 0;
+                            break;
                         }
                         lastClickTime = currentTime;
                     }
                 }
             }
+            PROFILE_END(rows);
+            
+            // Entries keep streaming in while the scan runs
+            if (!IsDirectoryScanComplete(fileBrowser.listing)) {
+                RequestBackgroundFrame(&scheduler);
+                UiDrawText(TextFormat("Scanning... %d items", totalItems), panel.x + 10, panel.y + panel.height - 35, 16, GRAY);
+            }
             
             // Draw scrollbar if needed
             if (totalItems > visibleItems) {
                 float scrollbarHeight = listView.height * (visibleItems / (float)totalItems);
                 float scrollbarY = listView.y + (fileBrowser.scrollPosition.y / scrollMax) * (listView.height - scrollbarHeight);
-                DrawRectangle(listView.x + listView.width - 10, scrollbarY, 8, scrollbarHeight, GRAY);
+                UiDrawRectangle((Rectangle){ listView.x + listView.width - 10, scrollbarY, 8, scrollbarHeight }, GRAY);
             }
             
             // OK and Cancel buttons
             if (Button((Rectangle){panel.x + panel.width - 220, panel.y + panel.height - 40, 100, 30}, "Select")) {
                 // If directory is selected or we're in directory mode
-                if (fileBrowser.selectedFile >= 0 && DirectoryExists(fileBrowser.files.paths[fileBrowser.selectedFile])) {
+                const DirEntry *selected = GetDirectoryEntry(fileBrowser.listing, fileBrowser.selectedFile);
+                char chosen[512];
+                if (selected && selected->isDir) {
                     // Use the selected directory
-                    strcpy(projectPathInput.text, fileBrowser.files.paths[fileBrowser.selectedFile]);
+                    snprintf(chosen, sizeof(chosen), "%s/%s", fileBrowser.currentDirectory, selected->name);
                 } else {
                     // Use current directory
-                    strcpy(projectPathInput.text, fileBrowser.currentDirectory);
+                    snprintf(chosen, sizeof(chosen), "%s", fileBrowser.currentDirectory);
                 }
                 
                 UnloadFileBrowser(&fileBrowser);
                 fileBrowserInitialized = false;
-                screen = SCREEN_NEW_PROJECT;
+                if (browsingForProject) {
+                    screen = OpenEditorProject(editor, chosen) ? SCREEN_EDITOR : SCREEN_MAIN_MENU;
+                } else {
+                    snprintf(projectPathInput.text, MAX_INPUT_LEN, "%s", chosen);
+                    screen = SCREEN_NEW_PROJECT;
+                }
             }
             
             if (Button((Rectangle){panel.x + panel.width - 110, panel.y + panel.height - 40, 100, 30}, "Cancel")) {
                 UnloadFileBrowser(&fileBrowser);
                 fileBrowserInitialized = false;
-                screen = SCREEN_NEW_PROJECT;
+                screen = browsingForProject ? SCREEN_MAIN_MENU : SCREEN_NEW_PROJECT;
             }
+        } else if (screen == SCREEN_EDITOR) {
+            if (!UpdateEditor(editor, &scheduler)) screen = SCREEN_MAIN_MENU;
+        }
+
+        // F4 toggles the profiler panel, F5 writes what it captured as a Chrome trace
+        if (IsKeyPressed(KEY_F4)) SetProfilerEnabled(!IsProfilerEnabled());
+        if (IsKeyPressed(KEY_F5)) ExportProfilerTrace("gearbox_trace.json");
+        if (IsProfilerEnabled()) {
+            UiNextLayer();
+            int w = GetScreenWidth();
+            int h = GetScreenHeight();
+            DrawProfilerPanel((Rectangle){ w - 520, h - 340, 510, 300 });
+            // The graph keeps moving at the background rate; a full-rate
+            // loop would mostly be measuring the overlay itself
+            RequestBackgroundFrame(&scheduler);
+        }
+
+        EndUiDrawList();
+
+        // F3 shows what the UI cost this frame; drawn directly so it does not count itself
+        if (IsKeyPressed(KEY_F3)) showDrawStats = !showDrawStats;
+        if (showDrawStats) {
+            UiDrawStats stats = GetUiDrawStats();
+            DrawText(TextFormat("UI: %d commands, %d draw calls, %d vertices",
+                                stats.commands, stats.drawCalls, stats.vertices),
+                     10, GetScreenHeight() - 20, 10, LIME);
+            FrameStats frames = GetFrameStats(&scheduler);
+            DrawText(TextFormat("Frames: %llu active, %llu background, %llu idle; %.1fs idle of %.1fs (%s)",
+                                (unsigned long long)frames.activeFrames, (unsigned long long)frames.backgroundFrames,
+                                (unsigned long long)frames.idleFrames, frames.idleTime,
+                                frames.activeTime + frames.backgroundTime + frames.idleTime, GetFrameModeName(scheduler.mode)),
+                     10, GetScreenHeight() - 34, 10, LIME);
         }
 
+        // Keep frames coming until finished jobs have reported back; requests
+        // must come before ScheduleNextFrame, which picks the next mode from them
+        JobSystemStats jobStats = GetJobSystemStats(jobs);
+        if (jobStats.pending > 0 || jobStats.callbacks > 0) RequestBackgroundFrame(&scheduler);
+        ScheduleNextFrame(&scheduler);
+
+        PROFILE_BEGIN(present, "EndDrawing");
         EndDrawing();
+        PROFILE_END(present);
+        EndProfilerFrame();
     }
 
     // Clean up resources
     if (fileBrowserInitialized) {
         UnloadFileBrowser(&fileBrowser);
     }
+    CancelProjectCreation(pendingCreation);
+    DestroyEditor(editor);
+    DestroyJobSystem(jobs);
+    DestroyDirScanner(dirScanner);
+    UnloadProfiler();
+    UnloadUiDrawList();
+    UnloadTextCache();
     
     CloseWindow();
     return 0;
@@ -0,0 +1,553 @@
+#include "mixer.h"
+#include "spsc_queue.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define MIXER_NEON
+#endif
+
+#define MIXER_COMMAND_CAPACITY 1024
+#define MIXER_LOAD_SMOOTHING 0.05f
+
+typedef enum {
+    MIXER_CMD_TRACK,            // Full parameter set of one track
+    MIXER_CMD_SOURCE,
+    MIXER_CMD_MASTER,
+    MIXER_CMD_TRANSPORT,
+    MIXER_CMD_SEEK,
+    MIXER_CMD_LOOP
+} MixerCommandType;
+
+typedef struct {
+    uint8_t type;
+    uint8_t track;
+    uint8_t active;
+    uint8_t muted;
+    uint8_t solo;
+    uint8_t playing;
+    uint8_t slot;
+    float volume;
+    float pan;
+    uint64_t frame;             // Seek target or loop start
+    uint64_t frameEnd;          // Loop end
+    MixerRenderFunc render;
+    void* user;
+} MixerCommand;
+
+// Parameters as last sent by the UI thread
+typedef struct {
+    bool sent;
+    bool active;
+    bool muted;
+    bool solo;
+    float volume;
+    float pan;
+} MixerTrackParams;
+
+// Audio thread only
+typedef struct {
+    bool active;
+    bool muted;
+    bool solo;
+    float volume;
+    float panLeft;              // Pan law applied once per change, not per block
+    float panRight;
+    float gainLeft;             // Gain reached at the end of the last block
+    float gainRight;
+    MixerRenderFunc render[MIXER_TRACK_SOURCES];
+    void* user[MIXER_TRACK_SOURCES];
+} MixerTrack;
+
+struct Mixer {
+    AudioStream stream;
+    int sampleRate;
+    int bufferFrames;
+    SpscQueue commands;
+
+    // UI thread
+    MixerTrackParams sent[MIXER_MAX_TRACKS];
+    bool sentPlaying;
+    float sentPlayhead;
+    uint64_t sentLoopStart;
+    uint64_t sentLoopEnd;
+    uint64_t seekFrame;
+    unsigned int seeksSent;
+    uint64_t droppedCommands;
+
+    // Audio thread
+    MixerTrack tracks[MIXER_MAX_TRACKS];
+    bool playing;
+    uint64_t position;          // Timeline frame of the next block
+    uint64_t loopStart;         // Equal to loopEnd when looping is off
+    uint64_t loopEnd;
+    unsigned int seeksApplied;
+    float masterGain;
+    double lastCallback;
+    float sourceLeft[MIXER_BLOCK_FRAMES];
+    float sourceRight[MIXER_BLOCK_FRAMES];
+    float extraLeft[MIXER_BLOCK_FRAMES];
+    float extraRight[MIXER_BLOCK_FRAMES];
+    float mixLeft[MIXER_BLOCK_FRAMES];
+    float mixRight[MIXER_BLOCK_FRAMES];
+
+    // Written by the audio thread, read by the UI thread
+    atomic_uint_least64_t callbacks;
+    atomic_uint_least64_t framesMixed;
+    atomic_uint_least64_t underruns;
+    atomic_uint_least64_t lateCallbacks;
+    atomic_uint_least64_t overloads;
+    atomic_uint load;           // Float bits
+    atomic_uint peakLoad;
+    atomic_uint trackPeaks[MIXER_MAX_TRACKS];
+    atomic_uint masterPeak[2];
+    atomic_uint_least64_t publishedPosition;
+    atomic_uint publishedSeeks;
+};
+
+static _Atomic(Mixer*) activeMixer = NULL;
+
+static unsigned int FloatBits(float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float BitsFloat(unsigned int bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Meters only ever rise on the audio thread; the reader swaps in zero
+static void RaisePeak(atomic_uint* peak, float value) {
+    if (value > BitsFloat(atomic_load_explicit(peak, memory_order_relaxed))) {
+        atomic_store_explicit(peak, FloatBits(value), memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Kernels
+//----------------------------------------------------------------------------------
+
+void MixerAddRamped(float* dst, const float* src, int count, float gain, float gainStep) {
+    int i = 0;
+#if defined(MIXER_SSE2)
+    __m128 g = _mm_setr_ps(gain, gain + gainStep, gain + 2.0f * gainStep, gain + 3.0f * gainStep);
+    __m128 step = _mm_set1_ps(4.0f * gainStep);
+    for (; i + 4 <= count; i += 4) {
+        __m128 d = _mm_loadu_ps(dst + i);
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+        _mm_storeu_ps(dst + i, d);
+        g = _mm_add_ps(g, step);
+    }
+#elif defined(MIXER_NEON)
+    float start[4] = { gain, gain + gainStep, gain + 2.0f * gainStep, gain + 3.0f * gainStep };
+    float32x4_t g = vld1q_f32(start);
+    float32x4_t step = vdupq_n_f32(4.0f * gainStep);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+        g = vaddq_f32(g, step);
+    }
+#endif
+    for (; i < count; i++) dst[i] += src[i] * (gain + gainStep * (float)i);
+}
+
+void MixerInterleave(float* out, const float* left, const float* right, int frames) {
+    int i = 0;
+#if defined(MIXER_SSE2)
+    __m128 lo = _mm_set1_ps(-1.0f);
+    __m128 hi = _mm_set1_ps(1.0f);
+    for (; i + 4 <= frames; i += 4) {
+        __m128 l = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(left + i), lo), hi);
+        __m128 r = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(right + i), lo), hi);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(MIXER_NEON)
+    float32x4_t lo = vdupq_n_f32(-1.0f);
+    float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr;
+        lr.val[0] = vminq_f32(vmaxq_f32(vld1q_f32(left + i), lo), hi);
+        lr.val[1] = vminq_f32(vmaxq_f32(vld1q_f32(right + i), lo), hi);
+        vst2q_f32(out + 2 * i, lr);
+    }
+#endif
+    for (; i < frames; i++) {
+        out[2 * i] = left[i] < -1.0f ? -1.0f : (left[i] > 1.0f ? 1.0f : left[i]);
+        out[2 * i + 1] = right[i] < -1.0f ? -1.0f : (right[i] > 1.0f ? 1.0f : right[i]);
+    }
+}
+
+float MixerPeak(const float* samples, int count, float peak) {
+    int i = 0;
+#if defined(MIXER_SSE2)
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 m = _mm_set1_ps(peak);
+    for (; i + 4 <= count; i += 4) m = _mm_max_ps(m, _mm_and_ps(_mm_loadu_ps(samples + i), absMask));
+    float lanes[4];
+    _mm_storeu_ps(lanes, m);
+    for (int l = 0; l < 4; l++) if (lanes[l] > peak) peak = lanes[l];
+#elif defined(MIXER_NEON)
+    float32x4_t m = vdupq_n_f32(peak);
+    for (; i + 4 <= count; i += 4) m = vmaxq_f32(m, vabsq_f32(vld1q_f32(samples + i)));
+    float lanes[4];
+    vst1q_f32(lanes, m);
+    for (int l = 0; l < 4; l++) if (lanes[l] > peak) peak = lanes[l];
+#endif
+    for (; i < count; i++) {
+        float value = fabsf(samples[i]);
+        if (value > peak) peak = value;
+    }
+    return peak;
+}
+
+//----------------------------------------------------------------------------------
+// Audio thread
+//----------------------------------------------------------------------------------
+
+static void ApplyCommand(Mixer* mixer, const MixerCommand* command) {
+    MixerTrack* track = command->track < MIXER_MAX_TRACKS ? &mixer->tracks[command->track] : NULL;
+
+    switch (command->type) {
+        case MIXER_CMD_TRACK: {
+            if (!track) break;
+            track->active = command->active;
+            track->muted = command->muted;
+            track->solo = command->solo;
+            track->volume = command->volume;
+            // Constant power, normalized so the center position is unity gain
+            float angle = (fminf(fmaxf(command->pan, -1.0f), 1.0f) + 1.0f) * (PI / 4.0f);
+            track->panLeft = cosf(angle) * 1.41421356f;
+            track->panRight = sinf(angle) * 1.41421356f;
+            break;
+        }
+        case MIXER_CMD_SOURCE:
+            if (!track || command->slot >= MIXER_TRACK_SOURCES) break;
+            track->render[command->slot] = command->render;
+            track->user[command->slot] = command->user;
+            break;
+        case MIXER_CMD_MASTER:
+            mixer->masterGain = command->volume;
+            break;
+        case MIXER_CMD_TRANSPORT:
+            mixer->playing = command->playing;
+            break;
+        case MIXER_CMD_SEEK:
+            mixer->position = command->frame;
+            mixer->seeksApplied++;
+            break;
+        case MIXER_CMD_LOOP:
+            mixer->loopStart = command->frame;
+            mixer->loopEnd = command->frameEnd;
+            break;
+    }
+}
+
+static void MixBlock(Mixer* mixer, float* out, int frames) {
+    memset(mixer->mixLeft, 0, (size_t)frames * sizeof(float));
+    memset(mixer->mixRight, 0, (size_t)frames * sizeof(float));
+
+    bool anySolo = false;
+    for (int t = 0; t < MIXER_MAX_TRACKS; t++) {
+        if (mixer->tracks[t].active && mixer->tracks[t].solo) anySolo = true;
+    }
+
+    for (int t = 0; mixer->playing && t < MIXER_MAX_TRACKS; t++) {
+        MixerTrack* track = &mixer->tracks[t];
+        if (!track->active) continue;
+
+        bool audible = !track->muted && (!anySolo || track->solo);
+        float gain = audible ? track->volume * mixer->masterGain : 0.0f;
+        float targetLeft = gain * track->panLeft;
+        float targetRight = gain * track->panRight;
+
+        // Silent tracks still render so their sources stay in time
+        int sources = 0;
+        for (int s = 0; s < MIXER_TRACK_SOURCES; s++) {
+            if (!track->render[s]) continue;
+            float* left = sources ? mixer->extraLeft : mixer->sourceLeft;
+            float* right = sources ? mixer->extraRight : mixer->sourceRight;
+            int produced = track->render[s](track->user[s], mixer->position, left, right, frames);
+            if (produced < 0) produced = 0;
+            if (produced < frames) {
+                atomic_fetch_add_explicit(&mixer->underruns, 1, memory_order_relaxed);
+                memset(left + produced, 0, (size_t)(frames - produced) * sizeof(float));
+                memset(right + produced, 0, (size_t)(frames - produced) * sizeof(float));
+            }
+            if (sources++) {
+                MixerAddRamped(mixer->sourceLeft, left, frames, 1.0f, 0.0f);
+                MixerAddRamped(mixer->sourceRight, right, frames, 1.0f, 0.0f);
+            }
+        }
+        if (!sources) continue;
+
+        if (track->gainLeft != 0.0f || track->gainRight != 0.0f || targetLeft != 0.0f || targetRight != 0.0f) {
+            MixerAddRamped(mixer->mixLeft, mixer->sourceLeft, frames, track->gainLeft, (targetLeft - track->gainLeft) / frames);
+            MixerAddRamped(mixer->mixRight, mixer->sourceRight, frames, track->gainRight, (targetRight - track->gainRight) / frames);
+            float peak = fmaxf(MixerPeak(mixer->sourceLeft, frames, 0.0f) * fmaxf(track->gainLeft, targetLeft),
+                               MixerPeak(mixer->sourceRight, frames, 0.0f) * fmaxf(track->gainRight, targetRight));
+            RaisePeak(&mixer->trackPeaks[t], peak);
+        }
+        track->gainLeft = targetLeft;
+        track->gainRight = targetRight;
+    }
+
+    RaisePeak(&mixer->masterPeak[0], MixerPeak(mixer->mixLeft, frames, 0.0f));
+    RaisePeak(&mixer->masterPeak[1], MixerPeak(mixer->mixRight, frames, 0.0f));
+    MixerInterleave(out, mixer->mixLeft, mixer->mixRight, frames);
+}
+
+static void MixerCallback(void* buffer, unsigned int frames) {
+    Mixer* mixer = atomic_load_explicit(&activeMixer, memory_order_acquire);
+    float* out = buffer;
+    if (!mixer) {
+        memset(out, 0, (size_t)frames * 2 * sizeof(float));
+        return;
+    }
+
+    double start = GetTime();
+    double period = (double)frames / mixer->sampleRate;
+    if (atomic_load_explicit(&mixer->callbacks, memory_order_relaxed) > 0 && start - mixer->lastCallback > 2.0 * period) {
+        atomic_fetch_add_explicit(&mixer->lateCallbacks, 1, memory_order_relaxed);
+    }
+    mixer->lastCallback = start;
+
+    MixerCommand command;
+    while (SpscPop(&mixer->commands, &command)) ApplyCommand(mixer, &command);
+
+    // Blocks end at the loop end, so the wrap lands on the exact frame
+    for (unsigned int offset = 0; offset < frames;) {
+        unsigned int chunk = frames - offset < MIXER_BLOCK_FRAMES ? frames - offset : MIXER_BLOCK_FRAMES;
+        bool looping = mixer->loopEnd > mixer->loopStart && mixer->position < mixer->loopEnd;
+        if (mixer->playing && looping && mixer->loopEnd - mixer->position < chunk) {
+            chunk = (unsigned int)(mixer->loopEnd - mixer->position);
+        }
+        MixBlock(mixer, out + offset * 2, (int)chunk);
+        offset += chunk;
+
+        if (mixer->playing) {
+            mixer->position += chunk;
+            if (looping && mixer->position == mixer->loopEnd) mixer->position = mixer->loopStart;
+        }
+    }
+    atomic_store_explicit(&mixer->publishedPosition, mixer->position, memory_order_relaxed);
+    atomic_store_explicit(&mixer->publishedSeeks, mixer->seeksApplied, memory_order_release);
+
+    float load = (float)((GetTime() - start) / period);
+    float smoothed = BitsFloat(atomic_load_explicit(&mixer->load, memory_order_relaxed));
+    smoothed += (load - smoothed) * MIXER_LOAD_SMOOTHING;
+    atomic_store_explicit(&mixer->load, FloatBits(smoothed), memory_order_relaxed);
+    RaisePeak(&mixer->peakLoad, load);
+    if (load > 1.0f) atomic_fetch_add_explicit(&mixer->overloads, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&mixer->framesMixed, frames, memory_order_relaxed);
+    atomic_fetch_add_explicit(&mixer->callbacks, 1, memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------
+// UI thread
+//----------------------------------------------------------------------------------
+
+static bool PushCommand(Mixer* mixer, const MixerCommand* command) {
+    if (SpscPush(&mixer->commands, command)) return true;
+    mixer->droppedCommands++;
+    return false;
+}
+
+Mixer* CreateMixer(int sampleRate, int bufferFrames) {
+    if (!IsAudioDeviceReady()) {
+        TraceLog(LOG_WARNING, "MIXER: Audio device is not initialized");
+        return NULL;
+    }
+    if (atomic_load(&activeMixer)) {
+        TraceLog(LOG_WARNING, "MIXER: Only one mixer can run at a time");
+        return NULL;
+    }
+
+    Mixer* mixer = calloc(1, sizeof(Mixer));
+    if (!mixer) return NULL;
+    if (!InitSpscQueue(&mixer->commands, sizeof(MixerCommand), MIXER_COMMAND_CAPACITY)) {
+        free(mixer);
+        return NULL;
+    }
+    mixer->sampleRate = sampleRate > 0 ? sampleRate : MIXER_DEFAULT_SAMPLE_RATE;
+    mixer->bufferFrames = bufferFrames > 0 ? bufferFrames : MIXER_DEFAULT_BUFFER_FRAMES;
+    mixer->masterGain = 1.0f;
+    for (int t = 0; t < MIXER_MAX_TRACKS; t++) {
+        mixer->tracks[t].panLeft = 1.0f;
+        mixer->tracks[t].panRight = 1.0f;
+    }
+
+    SetAudioStreamBufferSizeDefault(mixer->bufferFrames);
+    mixer->stream = LoadAudioStream((unsigned int)mixer->sampleRate, 32, 2);
+    SetAudioStreamBufferSizeDefault(0);
+    if (!mixer->stream.buffer) {
+        TraceLog(LOG_WARNING, "MIXER: Failed to open a %d Hz stream", mixer->sampleRate);
+        UnloadSpscQueue(&mixer->commands);
+        free(mixer);
+        return NULL;
+    }
+
+    atomic_store_explicit(&activeMixer, mixer, memory_order_release);
+    SetAudioStreamCallback(mixer->stream, MixerCallback);
+    PlayAudioStream(mixer->stream);
+    TraceLog(LOG_INFO, "MIXER: %d Hz, %d frame buffers", mixer->sampleRate, mixer->bufferFrames);
+    return mixer;
+}
+
+void DestroyMixer(Mixer* mixer) {
+    if (!mixer) return;
+
+    // Unloading the stream takes the device lock the callback runs under,
+    // so the callback is done with the mixer once this returns
+    StopAudioStream(mixer->stream);
+    UnloadAudioStream(mixer->stream);
+    atomic_store_explicit(&activeMixer, NULL, memory_order_release);
+
+    UnloadSpscQueue(&mixer->commands);
+    free(mixer);
+}
+
+void SyncMixerTracks(Mixer* mixer, const Track* tracks, int trackCount) {
+    if (!mixer) return;
+
+    for (int t = 0; t < MIXER_MAX_TRACKS; t++) {
+        MixerTrackParams want = { true, false, false, false, 0.0f, 0.0f };
+        if (tracks && t < trackCount) {
+            want.active = true;
+            want.muted = tracks[t].muted;
+            want.solo = tracks[t].solo;
+            want.volume = tracks[t].volume;
+            want.pan = tracks[t].pan;
+        }
+
+        MixerTrackParams* sent = &mixer->sent[t];
+        if (sent->sent && sent->active == want.active && sent->muted == want.muted && sent->solo == want.solo &&
+            sent->volume == want.volume && sent->pan == want.pan) continue;
+
+        MixerCommand command = { 0 };
+        command.type = MIXER_CMD_TRACK;
+        command.track = (uint8_t)t;
+        command.active = want.active;
+        command.muted = want.muted;
+        command.solo = want.solo;
+        command.volume = want.volume;
+        command.pan = want.pan;
+        if (PushCommand(mixer, &command)) *sent = want;
+    }
+}
+
+void SetMixerTrackSource(Mixer* mixer, int track, int slot, MixerRenderFunc render, void* user) {
+    if (!mixer || track < 0 || track >= MIXER_MAX_TRACKS || slot < 0 || slot >= MIXER_TRACK_SOURCES) return;
+    MixerCommand command = { 0 };
+    command.type = MIXER_CMD_SOURCE;
+    command.track = (uint8_t)track;
+    command.slot = (uint8_t)slot;
+    command.render = render;
+    command.user = user;
+    PushCommand(mixer, &command);
+}
+
+void SetMixerMasterGain(Mixer* mixer, float gain) {
+    if (!mixer) return;
+    MixerCommand command = { 0 };
+    command.type = MIXER_CMD_MASTER;
+    command.volume = gain;
+    PushCommand(mixer, &command);
+}
+
+int GetMixerSampleRate(const Mixer* mixer) {
+    return mixer ? mixer->sampleRate : 0;
+}
+
+static uint64_t SecondsToFrames(const Mixer* mixer, float seconds) {
+    return seconds > 0.0f ? (uint64_t)((double)seconds * mixer->sampleRate + 0.5) : 0;
+}
+
+float SyncMixerTransport(Mixer* mixer, float playhead, bool playing, const TimelineState* timeline) {
+    if (!mixer) return playhead;
+
+    uint64_t loopStart = 0, loopEnd = 0;
+    if (timeline && timeline->loopEnabled && timeline->loopEnd > timeline->loopStart) {
+        loopStart = SecondsToFrames(mixer, timeline->loopStart);
+        loopEnd = SecondsToFrames(mixer, timeline->loopEnd);
+    }
+    if (loopStart != mixer->sentLoopStart || loopEnd != mixer->sentLoopEnd) {
+        MixerCommand command = { 0 };
+        command.type = MIXER_CMD_LOOP;
+        command.frame = loopStart;
+        command.frameEnd = loopEnd;
+        if (PushCommand(mixer, &command)) {
+            mixer->sentLoopStart = loopStart;
+            mixer->sentLoopEnd = loopEnd;
+        }
+    }
+
+    // Starting always seeks, so play begins exactly at the playhead rather
+    // than wherever the audio stopped; the seek is queued ahead of the start
+    bool following = playing && mixer->sentPlaying && playhead == mixer->sentPlayhead;
+    if (!following && (playhead != mixer->sentPlayhead || playing != mixer->sentPlaying)) {
+        MixerCommand command = { 0 };
+        command.type = MIXER_CMD_SEEK;
+        command.frame = SecondsToFrames(mixer, playhead);
+        if (!PushCommand(mixer, &command)) return playhead;
+        mixer->seekFrame = command.frame;
+        mixer->seeksSent++;
+    }
+    if (playing != mixer->sentPlaying) {
+        MixerCommand command = { 0 };
+        command.type = MIXER_CMD_TRANSPORT;
+        command.playing = playing;
+        if (PushCommand(mixer, &command)) mixer->sentPlaying = playing;
+    }
+
+    if (following) playhead = (float)((double)GetMixerPosition(mixer) / mixer->sampleRate);
+    mixer->sentPlayhead = playhead;
+    return playhead;
+}
+
+uint64_t GetMixerPosition(Mixer* mixer) {
+    if (!mixer) return 0;
+    if (IsMixerSeeking(mixer)) return mixer->seekFrame;
+    return atomic_load_explicit(&mixer->publishedPosition, memory_order_relaxed);
+}
+
+bool IsMixerSeeking(Mixer* mixer) {
+    return mixer && atomic_load_explicit(&mixer->publishedSeeks, memory_order_acquire) != mixer->seeksSent;
+}
+
+MixerStats GetMixerStats(Mixer* mixer) {
+    MixerStats stats = { 0 };
+    if (!mixer) return stats;
+
+    stats.callbacks = atomic_load_explicit(&mixer->callbacks, memory_order_relaxed);
+    stats.framesMixed = atomic_load_explicit(&mixer->framesMixed, memory_order_relaxed);
+    stats.underruns = atomic_load_explicit(&mixer->underruns, memory_order_relaxed);
+    stats.lateCallbacks = atomic_load_explicit(&mixer->lateCallbacks, memory_order_relaxed);
+    stats.overloads = atomic_load_explicit(&mixer->overloads, memory_order_relaxed);
+    stats.droppedCommands = mixer->droppedCommands;
+    stats.load = BitsFloat(atomic_load_explicit(&mixer->load, memory_order_relaxed));
+    stats.peakLoad = BitsFloat(atomic_load_explicit(&mixer->peakLoad, memory_order_relaxed));
+    for (int t = 0; t < MIXER_MAX_TRACKS; t++) {
+        stats.trackPeaks[t] = BitsFloat(atomic_exchange_explicit(&mixer->trackPeaks[t], 0, memory_order_relaxed));
+    }
+    stats.masterPeak[0] = BitsFloat(atomic_exchange_explicit(&mixer->masterPeak[0], 0, memory_order_relaxed));
+    stats.masterPeak[1] = BitsFloat(atomic_exchange_explicit(&mixer->masterPeak[1], 0, memory_order_relaxed));
+    return stats;
+}
+
+void ResetMixerStats(Mixer* mixer) {
+    if (!mixer) return;
+    atomic_store(&mixer->underruns, 0);
+    atomic_store(&mixer->lateCallbacks, 0);
+    atomic_store(&mixer->overloads, 0);
+    atomic_store(&mixer->peakLoad, 0);
+    mixer->droppedCommands = 0;
+}
@@ -0,0 +1,78 @@
+#ifndef MIXER_H
+#define MIXER_H
+
+#include "app_state.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Real-time track mixer.
+//
+// Mixing runs in raylib's audio stream callback on the audio device thread.
+// The UI never touches mixer state directly: parameter changes go through a
+// single-producer/single-consumer command queue that the callback drains at
+// the start of every block, so the audio path takes no locks and allocates
+// nothing. Gain and pan changes are ramped over one block to avoid zipper
+// noise.
+//
+// The mixer also owns the transport: the timeline frame of every block is
+// counted on the audio thread, so all sources play against one sample clock.
+// Blocks are split at the loop end, so a source never sees a wrap mid-block.
+//
+// There is one audio device, and raylib's stream callback carries no user
+// pointer, so only one mixer can exist at a time.
+
+#define MIXER_MAX_TRACKS 64
+#define MIXER_BLOCK_FRAMES 256          // Largest chunk mixed at once; device buffers are split into these
+#define MIXER_DEFAULT_SAMPLE_RATE 48000
+#define MIXER_DEFAULT_BUFFER_FRAMES 64
+#define MIXER_TRACK_SOURCES 2            // Sources summed into each track
+
+// Renders up to `frames` stereo frames, starting at timeline frame `frame`,
+// into left/right and returns how many it produced; fewer counts as an
+// underrun and the rest is silence. A frame other than where the last call
+// ended means the transport jumped. Called on the audio thread, so it must
+// not block or allocate either.
+typedef int (*MixerRenderFunc)(void* user, uint64_t frame, float* left, float* right, int frames);
+
+typedef struct Mixer Mixer;
+
+typedef struct {
+    uint64_t callbacks;
+    uint64_t framesMixed;
+    uint64_t underruns;         // Blocks where a track source produced fewer frames than asked
+    uint64_t lateCallbacks;     // Callbacks arriving over twice the buffer period apart: the device starved
+    uint64_t overloads;         // Callbacks that took longer than the audio they produced
+    uint64_t droppedCommands;   // UI changes not sent because the queue was full, retried next frame
+    float load;                 // Callback time over buffer duration, smoothed
+    float peakLoad;             // Since the last ResetMixerStats
+    float trackPeaks[MIXER_MAX_TRACKS];     // Post-fader peak of each track since the last read
+    float masterPeak[2];
+} MixerStats;
+
+// Lifetime; the audio device must already be initialized
+Mixer* CreateMixer(int sampleRate, int bufferFrames);
+void DestroyMixer(Mixer* mixer);
+
+// UI thread. Pushes only what changed since the last call.
+void SyncMixerTracks(Mixer* mixer, const Track* tracks, int trackCount);
+void SetMixerTrackSource(Mixer* mixer, int track, int slot, MixerRenderFunc render, void* user);
+void SetMixerMasterGain(Mixer* mixer, float gain);
+int GetMixerSampleRate(const Mixer* mixer);
+
+// UI thread, once per frame. Returns where the playhead should be: the audio
+// position while playing, otherwise `playhead` itself. A playhead that differs
+// from the one returned last time is sent as a seek.
+float SyncMixerTransport(Mixer* mixer, float playhead, bool playing, const TimelineState* timeline);
+uint64_t GetMixerPosition(Mixer* mixer);    // Timeline frame of the next block, or of a pending seek
+bool IsMixerSeeking(Mixer* mixer);          // A seek was sent that the audio thread has not reached yet
+
+MixerStats GetMixerStats(Mixer* mixer);     // Reading clears the peak meters
+void ResetMixerStats(Mixer* mixer);
+
+// Kernels, exposed for benchmarking. SSE2 or NEON when the target has it,
+// scalar otherwise; buffers need no particular alignment.
+void MixerAddRamped(float* dst, const float* src, int count, float gain, float gainStep);
+void MixerInterleave(float* out, const float* left, const float* right, int frames);
+float MixerPeak(const float* samples, int count, float peak);
+
+#endif // MIXER_H
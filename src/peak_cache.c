@@ -0,0 +1,468 @@
+#include "peak_cache.h"
+#include "mapped_file.h"
+#include "wav_file.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#define PEAK_PROGRESS_INTERVAL 65536    // Frames between progress updates and cancel checks
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t levelCount;
+    uint32_t sampleRate;
+    uint32_t baseDecimation;
+    uint64_t frameCount;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+} PeakFileHeader;
+
+typedef struct {
+    uint64_t offset;        // Bytes from the start of the file
+    uint64_t count;         // Pairs
+} PeakLevelInfo;
+
+struct PeakFile {
+    char path[512];
+    char sidecarPath[528];
+    PeakFile* next;
+    PeakFile* nextJob;
+
+    // Guarded by the cache lock; a queued build holds one reference
+    int refCount;
+
+    atomic_bool ready;
+    atomic_bool failed;
+    atomic_bool cancel;
+    atomic_int progress;    // Per mille
+
+    // Written once before ready is set, read-only afterwards
+    int sampleRate;
+    uint64_t frameCount;
+    int levelCount;
+    uint64_t levelCounts[PEAK_MAX_LEVELS];
+    const PeakPair* levels[PEAK_MAX_LEVELS];
+    MappedFile map;
+    unsigned char* owned;   // In-memory copy when the sidecar could not be written
+};
+
+struct PeakCache {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+
+    PeakFile* files;
+    PeakFile* queueHead;
+    PeakFile* queueTail;
+};
+
+static bool GetSourceInfo(const char* path, uint64_t* size, int64_t* mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+static void FreePeakFile(PeakFile* file) {
+    UnmapFile(&file->map);
+    free(file->owned);
+    free(file);
+}
+
+// Caller holds the cache lock
+static void UnlinkPeakFile(PeakCache* cache, PeakFile* file) {
+    for (PeakFile** link = &cache->files; *link; link = &(*link)->next) {
+        if (*link == file) {
+            *link = file->next;
+            break;
+        }
+    }
+}
+
+// Points the level table into a complete file image, checking every bound
+static bool PublishImage(PeakFile* file, const unsigned char* image, size_t size, uint64_t sourceSize, int64_t sourceMtime) {
+    if (size < sizeof(PeakFileHeader)) return false;
+    PeakFileHeader header;
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != PEAK_FILE_MAGIC || header.version != PEAK_FILE_VERSION) return false;
+    if (header.sourceSize != sourceSize || header.sourceMtime != sourceMtime) return false;
+    if (header.baseDecimation != PEAK_BASE_DECIMATION || header.sampleRate == 0) return false;
+    if (header.levelCount == 0 || header.levelCount > PEAK_MAX_LEVELS) return false;
+    if (sizeof(header) + header.levelCount * sizeof(PeakLevelInfo) > size) return false;
+
+    const PeakLevelInfo* table = (const PeakLevelInfo*)(image + sizeof(header));
+    for (int l = 0; l < header.levelCount; l++) {
+        if (table[l].offset % sizeof(PeakPair) != 0 || table[l].offset > size ||
+            table[l].count > (size - table[l].offset) / sizeof(PeakPair)) return false;
+        file->levels[l] = (const PeakPair*)(image + table[l].offset);
+        file->levelCounts[l] = table[l].count;
+    }
+    file->levelCount = header.levelCount;
+    file->sampleRate = (int)header.sampleRate;
+    file->frameCount = header.frameCount;
+    return true;
+}
+
+static bool LoadSidecar(PeakFile* file, uint64_t sourceSize, int64_t sourceMtime) {
+    if (!MapFile(file->sidecarPath, &file->map)) return false;
+    if (PublishImage(file, file->map.data, file->map.size, sourceSize, sourceMtime)) return true;
+    UnmapFile(&file->map);
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Building
+//----------------------------------------------------------------------------------
+
+static int16_t QuantizePeak(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+    return (int16_t)(value * 32767.0f);
+}
+
+static bool ScanLevelZero(PeakFile* file, const WavData* source, PeakPair* pairs) {
+    size_t frameBytes = (size_t)source->bytesPerSample * source->channels;
+
+    uint64_t pair = 0;
+    for (uint64_t start = 0; start < source->frames; start += PEAK_BASE_DECIMATION, pair++) {
+        uint64_t end = start + PEAK_BASE_DECIMATION < source->frames ? start + PEAK_BASE_DECIMATION : source->frames;
+        float lo = 1.0f, hi = -1.0f;
+        const unsigned char* p = source->data + start * frameBytes;
+        for (uint64_t f = start; f < end; f++) {
+            for (int c = 0; c < source->channels; c++, p += source->bytesPerSample) {
+                float value = ReadWavSample(p, source->format);
+                if (value < lo) lo = value;
+                if (value > hi) hi = value;
+            }
+        }
+        pairs[pair] = (PeakPair){ QuantizePeak(lo), QuantizePeak(hi) };
+
+        if (start % PEAK_PROGRESS_INTERVAL == 0) {
+            if (atomic_load_explicit(&file->cancel, memory_order_relaxed)) return false;
+            atomic_store_explicit(&file->progress, (int)(start * 1000 / source->frames), memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+static bool WriteSidecar(const char* path, const unsigned char* image, size_t size) {
+    char tmpPath[540];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) return false;
+    bool ok = fwrite(image, 1, size, out) == size;
+    ok = (fclose(out) == 0) && ok;
+    if (ok) {
+#if defined(_WIN32)
+        remove(path);
+#endif
+        ok = rename(tmpPath, path) == 0;
+    }
+    if (!ok) remove(tmpPath);
+    return ok;
+}
+
+static bool BuildPeaks(PeakFile* file, uint64_t sourceSize, int64_t sourceMtime) {
+    // WAV is scanned in place from a mapping so hour-long takes never sit in
+    // memory; anything else goes through raylib's decoders
+    MappedFile audio = { 0 };
+    Wave wave = { 0 };
+    float* decoded = NULL;
+    WavData source = { 0 };
+
+    bool haveSource = MapFile(file->path, &audio) && ParseWav(audio.data, audio.size, &source);
+    if (!haveSource) {
+        UnmapFile(&audio);
+        wave = LoadWave(file->path);
+        decoded = wave.data ? LoadWaveSamples(wave) : NULL;
+        if (decoded) {
+            source.data = (const unsigned char*)decoded;
+            source.frames = wave.frameCount;
+            source.channels = (int)wave.channels;
+            source.sampleRate = (int)wave.sampleRate;
+            source.format = WAV_SAMPLE_F32;
+            source.bytesPerSample = (int)sizeof(float);
+            haveSource = source.channels > 0 && source.sampleRate > 0;
+        }
+    }
+
+    // File image: header, level table, then every level's pairs back to back
+    unsigned char* image = NULL;
+    size_t imageSize = 0;
+    bool ok = false;
+    if (haveSource && source.frames > 0) {
+        PeakLevelInfo table[PEAK_MAX_LEVELS];
+        int levelCount = 0;
+        size_t offset = sizeof(PeakFileHeader) + sizeof(table);
+        uint64_t count = (source.frames + PEAK_BASE_DECIMATION - 1) / PEAK_BASE_DECIMATION;
+        for (;;) {
+            table[levelCount] = (PeakLevelInfo){ offset, count };
+            offset += count * sizeof(PeakPair);
+            levelCount++;
+            if (count <= 1 || levelCount == PEAK_MAX_LEVELS) break;
+            count = (count + 1) / 2;
+        }
+        memset(table + levelCount, 0, (PEAK_MAX_LEVELS - levelCount) * sizeof(PeakLevelInfo));
+
+        imageSize = offset;
+        image = malloc(imageSize);
+        if (image) {
+            PeakFileHeader header = {
+                PEAK_FILE_MAGIC, PEAK_FILE_VERSION, (uint16_t)levelCount, (uint32_t)source.sampleRate,
+                PEAK_BASE_DECIMATION, source.frames, sourceSize, sourceMtime
+            };
+            memcpy(image, &header, sizeof(header));
+            memcpy(image + sizeof(header), table, sizeof(table));
+
+            ok = ScanLevelZero(file, &source, (PeakPair*)(image + table[0].offset));
+            for (int l = 1; ok && l < levelCount; l++) {
+                const PeakPair* below = (const PeakPair*)(image + table[l - 1].offset);
+                PeakPair* level = (PeakPair*)(image + table[l].offset);
+                for (uint64_t i = 0; i < table[l].count; i++) {
+                    PeakPair a = below[2 * i];
+                    PeakPair b = 2 * i + 1 < table[l - 1].count ? below[2 * i + 1] : a;
+                    level[i].min = a.min < b.min ? a.min : b.min;
+                    level[i].max = a.max > b.max ? a.max : b.max;
+                }
+            }
+        }
+    }
+
+    UnmapFile(&audio);
+    if (decoded) UnloadWaveSamples(decoded);
+    if (wave.data) UnloadWave(wave);
+
+    if (!ok) {
+        free(image);
+        return false;
+    }
+
+    // Prefer the mapped sidecar so the pages belong to the OS cache
+    if (WriteSidecar(file->sidecarPath, image, imageSize) && LoadSidecar(file, sourceSize, sourceMtime)) {
+        free(image);
+        return true;
+    }
+    TraceLog(LOG_WARNING, "PEAKS: Could not save %s, keeping peaks in memory", file->sidecarPath);
+    file->owned = image;
+    return PublishImage(file, image, imageSize, sourceSize, sourceMtime);
+}
+
+static void* PeakBuilderThread(void* arg) {
+    PeakCache* cache = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&cache->lock);
+        while (!cache->stopping && !cache->queueHead) pthread_cond_wait(&cache->wake, &cache->lock);
+        if (cache->stopping) {
+            pthread_mutex_unlock(&cache->lock);
+            break;
+        }
+        PeakFile* job = cache->queueHead;
+        cache->queueHead = job->nextJob;
+        if (!cache->queueHead) cache->queueTail = NULL;
+        pthread_mutex_unlock(&cache->lock);
+
+        uint64_t sourceSize = 0;
+        int64_t sourceMtime = 0;
+        bool built = !atomic_load(&job->cancel) && GetSourceInfo(job->path, &sourceSize, &sourceMtime) &&
+                     BuildPeaks(job, sourceSize, sourceMtime);
+        if (built) {
+            atomic_store_explicit(&job->progress, 1000, memory_order_relaxed);
+            atomic_store_explicit(&job->ready, true, memory_order_release);
+        } else {
+            if (!atomic_load(&job->cancel)) TraceLog(LOG_WARNING, "PEAKS: Failed to read audio from %s", job->path);
+            atomic_store(&job->failed, true);
+        }
+
+        // Drop the reference taken when the job was queued
+        pthread_mutex_lock(&cache->lock);
+        bool unused = --job->refCount == 0;
+        if (unused) UnlinkPeakFile(cache, job);
+        pthread_mutex_unlock(&cache->lock);
+        if (unused) FreePeakFile(job);
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Cache
+//----------------------------------------------------------------------------------
+
+PeakCache* CreatePeakCache(void) {
+    PeakCache* cache = calloc(1, sizeof(PeakCache));
+    if (!cache) return NULL;
+
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->wake, NULL);
+    if (pthread_create(&cache->thread, NULL, PeakBuilderThread, cache) != 0) {
+        pthread_cond_destroy(&cache->wake);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void DestroyPeakCache(PeakCache* cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->lock);
+    cache->stopping = true;
+    for (PeakFile* file = cache->files; file; file = file->next) atomic_store(&file->cancel, true);
+    pthread_cond_signal(&cache->wake);
+    pthread_mutex_unlock(&cache->lock);
+    pthread_join(cache->thread, NULL);
+
+    // Files still referenced by callers or by jobs that never ran go with the cache
+    while (cache->files) {
+        PeakFile* next = cache->files->next;
+        FreePeakFile(cache->files);
+        cache->files = next;
+    }
+    pthread_cond_destroy(&cache->wake);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+PeakFile* AcquirePeaks(PeakCache* cache, const char* audioPath) {
+    if (!cache || !audioPath) return NULL;
+
+    pthread_mutex_lock(&cache->lock);
+    for (PeakFile* file = cache->files; file; file = file->next) {
+        // A cancelled build is left to finish on its own; asking again starts over
+        if (strcmp(file->path, audioPath) == 0 && !atomic_load(&file->cancel)) {
+            file->refCount++;
+            pthread_mutex_unlock(&cache->lock);
+            return file;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    PeakFile* file = calloc(1, sizeof(PeakFile));
+    if (!file) return NULL;
+    strncpy(file->path, audioPath, sizeof(file->path) - 1);
+    snprintf(file->sidecarPath, sizeof(file->sidecarPath), "%s%s", file->path, PEAK_FILE_EXTENSION);
+    file->refCount = 1;
+
+    // An up-to-date sidecar is just mapped; mapping is cheap enough for the caller's thread
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    bool queue = false;
+    if (!GetSourceInfo(file->path, &sourceSize, &sourceMtime)) {
+        atomic_store(&file->failed, true);
+    } else if (LoadSidecar(file, sourceSize, sourceMtime)) {
+        atomic_store(&file->progress, 1000);
+        atomic_store_explicit(&file->ready, true, memory_order_release);
+    } else {
+        queue = true;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    file->next = cache->files;
+    cache->files = file;
+    if (queue) {
+        file->refCount++;
+        if (cache->queueTail) cache->queueTail->nextJob = file;
+        else cache->queueHead = file;
+        cache->queueTail = file;
+        pthread_cond_signal(&cache->wake);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return file;
+}
+
+void ReleasePeaks(PeakCache* cache, PeakFile* peaks) {
+    if (!cache || !peaks) return;
+
+    pthread_mutex_lock(&cache->lock);
+    if (--peaks->refCount > 0) {
+        // Only the build reference is left; nobody wants the result any more
+        if (peaks->refCount == 1 && !PeaksReady(peaks) && !PeaksFailed(peaks)) atomic_store(&peaks->cancel, true);
+        pthread_mutex_unlock(&cache->lock);
+        return;
+    }
+    UnlinkPeakFile(cache, peaks);
+    pthread_mutex_unlock(&cache->lock);
+    FreePeakFile(peaks);
+}
+
+//----------------------------------------------------------------------------------
+// Queries
+//----------------------------------------------------------------------------------
+
+bool PeaksReady(const PeakFile* peaks) {
+    return peaks && atomic_load_explicit(&peaks->ready, memory_order_acquire);
+}
+
+bool PeaksFailed(const PeakFile* peaks) {
+    return !peaks || atomic_load(&peaks->failed);
+}
+
+float GetPeaksProgress(const PeakFile* peaks) {
+    return peaks ? atomic_load_explicit(&peaks->progress, memory_order_relaxed) / 1000.0f : 0.0f;
+}
+
+int GetPeaksSampleRate(const PeakFile* peaks) {
+    return PeaksReady(peaks) ? peaks->sampleRate : 0;
+}
+
+uint64_t GetPeaksFrameCount(const PeakFile* peaks) {
+    return PeaksReady(peaks) ? peaks->frameCount : 0;
+}
+
+double GetPeaksDuration(const PeakFile* peaks) {
+    return PeaksReady(peaks) ? (double)peaks->frameCount / peaks->sampleRate : 0.0;
+}
+
+bool GetPeakRange(const PeakFile* peaks, uint64_t startFrame, uint64_t endFrame, float* min, float* max) {
+    if (!PeaksReady(peaks) || startFrame >= peaks->frameCount || endFrame <= startFrame) return false;
+    if (endFrame > peaks->frameCount) endFrame = peaks->frameCount;
+
+    // Start a few levels below the span's own size, so the edges are resolved
+    // to a quarter of the span or better, then climb like a segment tree:
+    // odd ends are read at the current level, the middle moves up a level.
+    // That is a handful of reads per query at any zoom.
+    uint64_t span = (endFrame - startFrame) / PEAK_BASE_DECIMATION;
+    int level = 0;
+    while (level + 1 < peaks->levelCount && ((uint64_t)8 << level) <= span) level++;
+
+    uint64_t decimation = (uint64_t)PEAK_BASE_DECIMATION << level;
+    uint64_t first = startFrame / decimation;
+    uint64_t last = (endFrame - 1) / decimation;
+
+    int lo = INT16_MAX, hi = INT16_MIN;
+    for (; first <= last; level++, first >>= 1, last >>= 1) {
+        const PeakPair* pairs = peaks->levels[level];
+        if (last >= peaks->levelCounts[level]) last = peaks->levelCounts[level] - 1;
+        if (level + 1 == peaks->levelCount) {
+            for (uint64_t i = first; i <= last; i++) {
+                if (pairs[i].min < lo) lo = pairs[i].min;
+                if (pairs[i].max > hi) hi = pairs[i].max;
+            }
+            break;
+        }
+        if (first & 1) {
+            if (pairs[first].min < lo) lo = pairs[first].min;
+            if (pairs[first].max > hi) hi = pairs[first].max;
+            first++;
+        }
+        if (!(last & 1) && first <= last) {
+            if (pairs[last].min < lo) lo = pairs[last].min;
+            if (pairs[last].max > hi) hi = pairs[last].max;
+            if (last == 0) break;
+            last--;
+        }
+        if (first > last) break;
+    }
+    *min = lo / 32767.0f;
+    *max = hi / 32767.0f;
+    return true;
+}
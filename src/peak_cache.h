@@ -0,0 +1,57 @@
+#ifndef PEAK_CACHE_H
+#define PEAK_CACHE_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Min/max peak pyramids for drawing waveforms.
+//
+// Level 0 holds one min/max pair per PEAK_BASE_DECIMATION frames, every
+// level above halves the one below it. A waveform column spanning N frames
+// reads the level whose pairs are closest to N frames wide, so drawing costs
+// a couple of reads per pixel whatever the clip length.
+//
+// Pyramids are built on a background thread and saved next to the audio as
+// "<file>.gbpeaks", which later sessions map instead of decoding the audio
+// again. The sidecar remembers the source size and modification time and is
+// rebuilt when either changes.
+
+#define PEAK_FILE_EXTENSION ".gbpeaks"
+#define PEAK_FILE_MAGIC 0x4B504247u     // "GBPK"
+#define PEAK_FILE_VERSION 1
+#define PEAK_BASE_DECIMATION 64         // Frames per pair at level 0
+#define PEAK_MAX_LEVELS 32
+
+typedef struct PeakCache PeakCache;
+typedef struct PeakFile PeakFile;
+
+typedef struct {
+    int16_t min;
+    int16_t max;
+} PeakPair;
+
+// Cache lifetime, owns the builder thread
+PeakCache* CreatePeakCache(void);
+void DestroyPeakCache(PeakCache* cache);
+
+// Returns the peaks of an audio file, queueing a build when there is no
+// up-to-date sidecar. The result is usable right away and fills in once
+// PeaksReady reports true.
+PeakFile* AcquirePeaks(PeakCache* cache, const char* audioPath);
+void ReleasePeaks(PeakCache* cache, PeakFile* peaks);
+
+// Queries (safe while the build is still running)
+bool PeaksReady(const PeakFile* peaks);
+bool PeaksFailed(const PeakFile* peaks);
+float GetPeaksProgress(const PeakFile* peaks);      // 0..1 while building
+int GetPeaksSampleRate(const PeakFile* peaks);
+uint64_t GetPeaksFrameCount(const PeakFile* peaks);
+double GetPeaksDuration(const PeakFile* peaks);
+
+// Min and max over [startFrame, endFrame), normalized to -1..1, from the
+// coarsest level that still resolves the span. False outside the clip or
+// before the build finished.
+bool GetPeakRange(const PeakFile* peaks, uint64_t startFrame, uint64_t endFrame, float* min, float* max);
+
+#endif // PEAK_CACHE_H
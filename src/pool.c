@@ -0,0 +1,189 @@
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned char* SlotPointer(const Pool* pool, uint32_t slot) {
+    return pool->pages[slot >> POOL_PAGE_SHIFT] + (size_t)(slot & (POOL_PAGE_ITEMS - 1)) * pool->itemSize;
+}
+
+static bool SlotAlive(const Pool* pool, uint32_t slot) {
+    return slot < pool->slotCount && (pool->generations[slot] & 1u);
+}
+
+// Make room for the bookkeeping of slots [0, slotCount); item pages come later
+static bool GrowSlots(Pool* pool, uint32_t slotCount) {
+    uint32_t pagesNeeded = (slotCount + POOL_PAGE_ITEMS - 1) >> POOL_PAGE_SHIFT;
+    if (pagesNeeded <= pool->pageCount) return true;
+
+    unsigned char** pages = realloc(pool->pages, pagesNeeded * sizeof(unsigned char*));
+    if (!pages) return false;
+    pool->pages = pages;
+
+    size_t slotBytes = (size_t)pagesNeeded * POOL_PAGE_ITEMS * sizeof(uint32_t);
+    uint32_t* generations = realloc(pool->generations, slotBytes);
+    if (!generations) return false;
+    pool->generations = generations;
+
+    uint32_t* freePositions = realloc(pool->freePositions, slotBytes);
+    if (!freePositions) return false;
+    pool->freePositions = freePositions;
+
+    while (pool->pageCount < pagesNeeded) {
+        uint32_t first = pool->pageCount * POOL_PAGE_ITEMS;
+        memset(&pool->generations[first], 0, POOL_PAGE_ITEMS * sizeof(uint32_t));
+        for (uint32_t i = 0; i < POOL_PAGE_ITEMS; i++) pool->freePositions[first + i] = POOL_NOT_FREE;
+        pool->pages[pool->pageCount++] = NULL;
+    }
+    return true;
+}
+
+static bool FreeEntryCurrent(const Pool* pool, uint32_t position) {
+    return pool->freePositions[pool->freeSlots[position]] == position;
+}
+
+// Drop stale entries, keeping the order of the rest
+static void CompactFreeSlots(Pool* pool) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < pool->freeCount; i++) {
+        if (!FreeEntryCurrent(pool, i)) continue;
+        uint32_t slot = pool->freeSlots[i];
+        pool->freeSlots[kept] = slot;
+        pool->freePositions[slot] = kept++;
+    }
+    pool->freeCount = kept;
+}
+
+static bool ReserveFreeSlots(Pool* pool, uint32_t count) {
+    if (count <= pool->freeCapacity) return true;
+    uint32_t capacity = pool->freeCapacity ? pool->freeCapacity : 64;
+    while (capacity < count) capacity *= 2;
+    uint32_t* freeSlots = realloc(pool->freeSlots, capacity * sizeof(uint32_t));
+    if (!freeSlots) return false;
+    pool->freeSlots = freeSlots;
+    pool->freeCapacity = capacity;
+    return true;
+}
+
+static bool PushFreeSlot(Pool* pool, uint32_t slot) {
+    if (pool->freeCount == pool->freeCapacity) {
+        // Mostly stale entries left behind by PoolAllocAt: reclaim them rather than grow
+        CompactFreeSlots(pool);
+        uint32_t needed = pool->freeCount > pool->freeCapacity / 2 ? pool->freeCapacity * 2 : pool->freeCount + 1;
+        if (!ReserveFreeSlots(pool, needed)) return false;
+    }
+    pool->freePositions[slot] = pool->freeCount;
+    pool->freeSlots[pool->freeCount++] = slot;
+    return true;
+}
+
+static PoolHandle ActivateSlot(Pool* pool, uint32_t slot) {
+    unsigned char** page = &pool->pages[slot >> POOL_PAGE_SHIFT];
+    if (!*page && !(*page = malloc(POOL_PAGE_ITEMS * pool->itemSize))) return POOL_NULL_HANDLE;
+
+    pool->freePositions[slot] = POOL_NOT_FREE;
+    pool->generations[slot]++;
+    pool->liveCount++;
+    pool->version++;
+    memset(SlotPointer(pool, slot), 0, pool->itemSize);
+    return (PoolHandle){ slot, pool->generations[slot] };
+}
+
+void InitPool(Pool* pool, size_t itemSize) {
+    memset(pool, 0, sizeof(*pool));
+    pool->itemSize = itemSize;
+}
+
+void UnloadPool(Pool* pool) {
+    for (uint32_t i = 0; i < pool->pageCount; i++) free(pool->pages[i]);
+    free(pool->pages);
+    free(pool->generations);
+    free(pool->freePositions);
+    free(pool->freeSlots);
+    size_t itemSize = pool->itemSize;
+    memset(pool, 0, sizeof(*pool));
+    pool->itemSize = itemSize;
+}
+
+void ClearPool(Pool* pool) {
+    // Keep the pages, but advance the generation of every live slot so
+    // outstanding handles stop resolving
+    for (uint32_t slot = 0; slot < pool->slotCount; slot++) {
+        if (pool->generations[slot] & 1u) pool->generations[slot]++;
+    }
+    // Every slot becomes free, highest at the bottom of the stack so low
+    // slots are reused first
+    pool->freeCount = 0;
+    if (ReserveFreeSlots(pool, pool->slotCount)) {
+        for (uint32_t slot = 0; slot < pool->slotCount; slot++) {
+            uint32_t position = pool->slotCount - 1 - slot;
+            pool->freeSlots[position] = slot;
+            pool->freePositions[slot] = position;
+        }
+        pool->freeCount = pool->slotCount;
+    } else {
+        for (uint32_t slot = pool->slotCount; slot > 0; slot--) PushFreeSlot(pool, slot - 1);
+    }
+    pool->liveCount = 0;
+    pool->version++;
+}
+
+PoolHandle PoolAlloc(Pool* pool) {
+    while (pool->freeCount > 0) {
+        uint32_t position = pool->freeCount - 1;
+        uint32_t slot = pool->freeSlots[position];
+        if (!FreeEntryCurrent(pool, position)) {
+            pool->freeCount--;              // Already taken by PoolAllocAt
+            continue;
+        }
+        PoolHandle handle = ActivateSlot(pool, slot);
+        if (handle.generation) pool->freeCount--;
+        return handle;
+    }
+    if (pool->slotCount >= POOL_MAX_SLOTS || !GrowSlots(pool, pool->slotCount + 1)) return POOL_NULL_HANDLE;
+    PoolHandle handle = ActivateSlot(pool, pool->slotCount);
+    if (handle.generation) pool->slotCount++;
+    return handle;
+}
+
+PoolHandle PoolAllocAt(Pool* pool, uint32_t slot) {
+    if (slot >= POOL_MAX_SLOTS || SlotAlive(pool, slot)) return POOL_NULL_HANDLE;
+
+    if (slot >= pool->slotCount) {
+        if (!GrowSlots(pool, slot + 1)) return POOL_NULL_HANDLE;
+        // Skipped slots become free; push in reverse so low slots are reused first
+        for (uint32_t s = slot; s > pool->slotCount; s--) PushFreeSlot(pool, s - 1);
+        pool->slotCount = slot + 1;
+        PoolHandle handle = ActivateSlot(pool, slot);
+        if (!handle.generation) PushFreeSlot(pool, slot);
+        return handle;
+    }
+    // A free slot's stack entry goes stale here and is skipped by PoolAlloc
+    return ActivateSlot(pool, slot);
+}
+
+void PoolFree(Pool* pool, PoolHandle handle) {
+    if (!PoolGet(pool, handle)) return;
+    pool->generations[handle.index]++;
+    pool->liveCount--;
+    pool->version++;
+    PushFreeSlot(pool, handle.index);
+}
+
+void* PoolGet(const Pool* pool, PoolHandle handle) {
+    if (handle.index >= pool->slotCount || pool->generations[handle.index] != handle.generation) return NULL;
+    if (!(handle.generation & 1u)) return NULL;
+    return SlotPointer(pool, handle.index);
+}
+
+void* PoolAt(const Pool* pool, uint32_t slot) {
+    return SlotAlive(pool, slot) ? SlotPointer(pool, slot) : NULL;
+}
+
+PoolHandle PoolHandleAt(const Pool* pool, uint32_t slot) {
+    if (!SlotAlive(pool, slot)) return POOL_NULL_HANDLE;
+    return (PoolHandle){ slot, pool->generations[slot] };
+}
+
+bool PoolHandleEqual(PoolHandle a, PoolHandle b) {
+    return a.index == b.index && a.generation == b.generation;
+}
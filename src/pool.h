@@ -0,0 +1,64 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Growable object pool with generational handles.
+//
+// Items live in fixed-size pages that never move, so pointers stay valid
+// while the item is alive. Freed slots are recycled, and every reuse bumps
+// the slot's generation: a handle to a freed item simply stops resolving
+// instead of aliasing whatever took its place. A generation is odd while the
+// slot is alive, so a zeroed handle never resolves.
+//
+// PoolAllocAt brings back a specific slot (loading, undo, journal replay) in
+// constant time: each free slot knows its position in the free stack, and
+// taking one from the middle leaves a stale entry that allocation skips.
+// Pages are only allocated once one of their slots comes alive, so a slot
+// far past the others costs its bookkeeping and not its items.
+
+#define POOL_PAGE_SHIFT 8
+#define POOL_PAGE_ITEMS (1u << POOL_PAGE_SHIFT)
+#define POOL_MAX_SLOTS (1u << 20)           // Slot indices from files and journals are checked against this
+#define POOL_NOT_FREE UINT32_MAX
+
+typedef struct {
+    uint32_t index;
+    uint32_t generation;
+} PoolHandle;
+
+#define POOL_NULL_HANDLE ((PoolHandle){ 0, 0 })
+
+typedef struct {
+    size_t itemSize;
+    unsigned char** pages;      // NULL until a slot in the page comes alive
+    uint32_t pageCount;
+    uint32_t* generations;
+    uint32_t slotCount;         // Slots handed out so far; iterate [0, slotCount)
+    uint32_t liveCount;
+    uint32_t version;           // Bumped whenever a slot comes alive or dies
+    uint32_t* freeSlots;        // Stack, low slots on top after a clear; may hold stale entries
+    uint32_t* freePositions;    // Per slot, its entry in freeSlots, POOL_NOT_FREE when alive or taken
+    uint32_t freeCount;         // Entries, stale ones included
+    uint32_t freeCapacity;
+} Pool;
+
+// Pool lifetime
+void InitPool(Pool* pool, size_t itemSize);
+void UnloadPool(Pool* pool);
+void ClearPool(Pool* pool);
+
+// Allocation (items start zeroed)
+PoolHandle PoolAlloc(Pool* pool);
+PoolHandle PoolAllocAt(Pool* pool, uint32_t slot);     // Null handle if alive or past POOL_MAX_SLOTS
+void PoolFree(Pool* pool, PoolHandle handle);
+
+// Access
+void* PoolGet(const Pool* pool, PoolHandle handle);
+void* PoolAt(const Pool* pool, uint32_t slot);          // NULL if the slot is free
+PoolHandle PoolHandleAt(const Pool* pool, uint32_t slot);
+bool PoolHandleEqual(PoolHandle a, PoolHandle b);
+
+#endif // POOL_H
@@ -0,0 +1,525 @@
+#include "profiler.h"
+#include "spsc_queue.h"
+#include "draw_list.h"
+#include "text_cache.h"
+#include "app_state.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ZONE_TABLE_SIZE (PROFILER_MAX_ZONES * 2)   // Open addressing, power of two
+#define ZONE_SMOOTHING 0.1                          // Weight of the newest frame in the averages
+#define ZONE_PEAK_DECAY 0.98
+
+#define PANEL_HEADER_HEIGHT 24
+#define PANEL_GRAPH_HEIGHT 90
+#define PANEL_ROW_HEIGHT 18
+#define PANEL_FONT_SIZE 12
+
+typedef struct {
+    const ProfileZone* zone;
+    uint64_t start;             // Nanoseconds
+    uint64_t end;
+    uint32_t depth;
+    uint32_t thread;            // Set when captured
+} ProfileEvent;
+
+// A slot goes EMPTY -> CLAIMED -> ACTIVE when a thread first records,
+// ACTIVE -> EXITED when that thread exits, and EXITED -> FREE once the main
+// thread has drained what it left. FREE slots keep their ring and go back
+// to CLAIMED for the next new thread.
+typedef enum {
+    THREAD_SLOT_EMPTY = 0,      // No ring yet
+    THREAD_SLOT_CLAIMED,        // Being set up by its new thread
+    THREAD_SLOT_ACTIVE,
+    THREAD_SLOT_EXITED,
+    THREAD_SLOT_FREE
+} ThreadSlotState;
+
+typedef struct {
+    SpscQueue ring;             // Pushed by the owning thread, drained by the main thread
+    atomic_int state;           // ThreadSlotState
+    atomic_uint dropped;
+    char name[32];              // Written by the owner while CLAIMED
+    char label[32];             // Main thread's copy of the name, for the panel and export
+    bool labeled;               // Main thread only: label holds this owner's name
+    uint64_t nested[PROFILER_MAX_DEPTH + 1];   // Main thread only: time of finished children per depth
+} ProfilerThread;
+
+typedef struct {
+    uint64_t total;
+    uint64_t self;
+    uint32_t calls;
+} ZoneFrame;
+
+static const ProfileZone frameZone = { "Frame", __FILE__, __LINE__ };
+
+atomic_bool profilerEnabled;
+
+static struct {
+    bool initialized;
+    ProfilerThread threads[PROFILER_MAX_THREADS];
+    pthread_key_t exitKey;                      // Its destructor hands a slot back when its thread exits
+    uint64_t retiredDropped;                    // Dropped by threads whose slots were freed
+
+    ProfilerZoneStats zones[PROFILER_MAX_ZONES];
+    ZoneFrame zoneFrames[PROFILER_MAX_ZONES];
+    int16_t zoneTable[ZONE_TABLE_SIZE];         // Zone index or -1
+    int order[PROFILER_MAX_ZONES];
+    int zoneCount;
+
+    uint64_t frameStart;
+    float history[PROFILER_HISTORY_FRAMES];     // Milliseconds, ring
+    int historyHead;
+    int historyCount;
+
+    ProfileEvent* capture;                      // Ring of the most recent events
+    uint32_t captureHead;
+    uint32_t captureCount;
+
+    ProfilerStats stats;
+    float scroll;
+} profiler;
+
+static _Thread_local ProfilerThread* localThread;
+static _Thread_local bool localUnavailable;     // Registration failed, don't retry
+static _Thread_local int localDepth;
+static _Thread_local char localName[32];
+
+//----------------------------------------------------------------------------------
+// Recording
+//----------------------------------------------------------------------------------
+
+// winpthreads provides CLOCK_MONOTONIC on Windows, and windows.h can't be
+// included next to raylib.h
+static uint64_t ProfilerNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static ProfilerThread* ClaimThreadSlot(ThreadSlotState from) {
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        int expected = from;
+        if (atomic_compare_exchange_strong(&profiler.threads[i].state, &expected, THREAD_SLOT_CLAIMED)) return &profiler.threads[i];
+    }
+    return NULL;
+}
+
+// Thread exit, through the key destructor. Everything the thread pushed is
+// released with the state, so the main thread drains it all before freeing.
+static void ReleaseThreadSlot(void* data) {
+    ProfilerThread* thread = data;
+    atomic_store_explicit(&thread->state, THREAD_SLOT_EXITED, memory_order_release);
+}
+
+// Claims a slot the first time the calling thread records, reusing the ring
+// of a thread that exited before allocating a new one. The name is written
+// before the slot is published, so the main thread never sees it change.
+static ProfilerThread* GetLocalThread(void) {
+    if (localThread || localUnavailable) return localThread;
+
+    ProfilerThread* thread = ClaimThreadSlot(THREAD_SLOT_FREE);
+    if (!thread) {
+        thread = ClaimThreadSlot(THREAD_SLOT_EMPTY);
+        if (thread && !InitSpscQueue(&thread->ring, sizeof(ProfileEvent), PROFILER_RING_CAPACITY)) {
+            atomic_store(&thread->state, THREAD_SLOT_EMPTY);
+            thread = NULL;
+        }
+    }
+    if (!thread) {
+        localUnavailable = true;
+        return NULL;
+    }
+    if (localName[0]) snprintf(thread->name, sizeof(thread->name), "%s", localName);
+    else snprintf(thread->name, sizeof(thread->name), "Thread %d", (int)(thread - profiler.threads));
+    pthread_setspecific(profiler.exitKey, thread);
+    atomic_store_explicit(&thread->state, THREAD_SLOT_ACTIVE, memory_order_release);
+    localThread = thread;
+    return thread;
+}
+
+ProfileScope BeginProfileZoneSlow(const ProfileZone* zone) {
+    if (!GetLocalThread()) return (ProfileScope){ 0 };
+    localDepth++;
+    return (ProfileScope){ zone, ProfilerNow() };
+}
+
+void EndProfileZoneSlow(ProfileScope scope) {
+    uint64_t end = ProfilerNow();
+    int depth = --localDepth;
+    ProfileEvent event = { scope.zone, scope.start, end, (uint32_t)(depth > 0 ? depth : 0), 0 };
+    if (!SpscPush(&localThread->ring, &event)) atomic_fetch_add_explicit(&localThread->dropped, 1, memory_order_relaxed);
+}
+
+// Threads that never record don't take a slot, so the name waits for the first zone
+void SetProfilerThreadName(const char* name) {
+    if (name && !localThread) snprintf(localName, sizeof(localName), "%s", name);
+}
+
+//----------------------------------------------------------------------------------
+// Lifetime
+//----------------------------------------------------------------------------------
+
+void InitProfiler(void) {
+    if (profiler.initialized) return;
+    memset(&profiler, 0, sizeof(profiler));
+    memset(profiler.zoneTable, -1, sizeof(profiler.zoneTable));
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        atomic_init(&profiler.threads[i].state, THREAD_SLOT_EMPTY);
+        atomic_init(&profiler.threads[i].dropped, 0);
+    }
+    if (pthread_key_create(&profiler.exitKey, ReleaseThreadSlot) != 0) {
+        TraceLog(LOG_WARNING, "PROFILER: Could not create the thread exit key");
+        return;
+    }
+    profiler.initialized = true;
+    SetProfilerThreadName("Main");
+}
+
+void UnloadProfiler(void) {
+    if (!profiler.initialized) return;
+    atomic_store(&profilerEnabled, false);
+
+    // Threads still alive must not hand their slots back after this
+    pthread_key_delete(profiler.exitKey);
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        if (atomic_load(&profiler.threads[i].state) != THREAD_SLOT_EMPTY) UnloadSpscQueue(&profiler.threads[i].ring);
+    }
+    free(profiler.capture);
+    memset(&profiler, 0, sizeof(profiler));
+    localThread = NULL;
+    localUnavailable = false;
+    localDepth = 0;
+    localName[0] = '\0';
+}
+
+void SetProfilerEnabled(bool enabled) {
+    if (!profiler.initialized) return;
+    if (enabled && !profiler.capture) {
+        profiler.capture = malloc(PROFILER_CAPTURE_EVENTS * sizeof(ProfileEvent));
+        if (!profiler.capture) TraceLog(LOG_WARNING, "PROFILER: Out of memory for the capture, export disabled");
+    }
+    profiler.frameStart = 0;
+    atomic_store(&profilerEnabled, enabled);
+}
+
+bool IsProfilerEnabled(void) {
+    return atomic_load_explicit(&profilerEnabled, memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------
+// Frames
+//----------------------------------------------------------------------------------
+
+static void CaptureEvent(const ProfileEvent* event, uint32_t thread) {
+    if (!profiler.capture) return;
+    ProfileEvent* slot = &profiler.capture[profiler.captureHead & (PROFILER_CAPTURE_EVENTS - 1)];
+    *slot = *event;
+    slot->thread = thread;
+    profiler.captureHead++;
+    if (profiler.captureCount < PROFILER_CAPTURE_EVENTS) profiler.captureCount++;
+}
+
+static int FindZone(const ProfileZone* zone, int thread) {
+    uint32_t hash = (uint32_t)(((uintptr_t)zone >> 3) * 2654435761u) ^ (uint32_t)thread * 40503u;
+    for (uint32_t probe = 0; probe < ZONE_TABLE_SIZE; probe++) {
+        int16_t* entry = &profiler.zoneTable[(hash + probe) & (ZONE_TABLE_SIZE - 1)];
+        if (*entry < 0) {
+            if (profiler.zoneCount == PROFILER_MAX_ZONES) return -1;
+            int index = profiler.zoneCount++;
+            memset(&profiler.zones[index], 0, sizeof(profiler.zones[index]));
+            memset(&profiler.zoneFrames[index], 0, sizeof(profiler.zoneFrames[index]));
+            profiler.zones[index].zone = zone;
+            profiler.zones[index].thread = thread;
+            profiler.order[index] = index;
+            *entry = (int16_t)index;
+            return index;
+        }
+        const ProfilerZoneStats* stats = &profiler.zones[*entry];
+        if (stats->zone == zone && stats->thread == thread) return *entry;
+    }
+    return -1;
+}
+
+// Events arrive in the order zones ended, so a zone's children are always
+// drained before it and their time can be taken off its own
+static void DrainThread(int index) {
+    ProfilerThread* thread = &profiler.threads[index];
+    ProfileEvent event;
+    while (SpscPop(&thread->ring, &event)) {
+        profiler.stats.events++;
+        uint32_t depth = event.depth < PROFILER_MAX_DEPTH ? event.depth : PROFILER_MAX_DEPTH - 1;
+        uint64_t duration = event.end > event.start ? event.end - event.start : 0;
+        uint64_t nested = thread->nested[depth + 1];
+        thread->nested[depth + 1] = 0;
+        if (depth > 0) thread->nested[depth] += duration;
+
+        CaptureEvent(&event, (uint32_t)index);
+
+        int zone = FindZone(event.zone, index);
+        if (zone < 0) {
+            profiler.stats.dropped++;
+            continue;
+        }
+        ZoneFrame* frame = &profiler.zoneFrames[zone];
+        frame->total += duration;
+        frame->self += duration > nested ? duration - nested : 0;
+        frame->calls++;
+    }
+}
+
+static int CompareZones(const void* a, const void* b) {
+    double x = profiler.zones[*(const int*)a].averageTotal;
+    double y = profiler.zones[*(const int*)b].averageTotal;
+    return (x < y) - (x > y);
+}
+
+void BeginProfilerFrame(void) {
+    if (!IsProfilerEnabled()) return;
+    profiler.frameStart = ProfilerNow();
+}
+
+void EndProfilerFrame(void) {
+    if (!profiler.initialized) return;
+
+    // Rings are drained even while disabled so zones that were open when
+    // the profiler was switched off don't linger. A slot whose thread exited
+    // is freed once drained; its zones keep decaying under the old name
+    // until a new thread takes the slot.
+    int active = 0;
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        ProfilerThread* thread = &profiler.threads[i];
+        int state = atomic_load_explicit(&thread->state, memory_order_acquire);
+        if (state != THREAD_SLOT_ACTIVE && state != THREAD_SLOT_EXITED) continue;
+        if (!thread->labeled) {
+            memcpy(thread->label, thread->name, sizeof(thread->label));
+            thread->labeled = true;
+        }
+        DrainThread(i);
+        if (state == THREAD_SLOT_ACTIVE) {
+            active++;
+            continue;
+        }
+        profiler.retiredDropped += atomic_exchange_explicit(&thread->dropped, 0, memory_order_relaxed);
+        memset(thread->nested, 0, sizeof(thread->nested));
+        thread->labeled = false;
+        atomic_store_explicit(&thread->state, THREAD_SLOT_FREE, memory_order_release);
+    }
+    if (!IsProfilerEnabled() || profiler.frameStart == 0) return;
+
+    uint64_t now = ProfilerNow();
+    ProfilerThread* mainThread = GetLocalThread();
+    ProfileEvent frame = { &frameZone, profiler.frameStart, now, 0, 0 };
+    if (mainThread) CaptureEvent(&frame, (uint32_t)(mainThread - profiler.threads));
+    double milliseconds = (double)(now - profiler.frameStart) * 1e-6;
+    profiler.frameStart = 0;
+
+    profiler.history[profiler.historyHead] = (float)milliseconds;
+    profiler.historyHead = (profiler.historyHead + 1) % PROFILER_HISTORY_FRAMES;
+    if (profiler.historyCount < PROFILER_HISTORY_FRAMES) profiler.historyCount++;
+
+    ProfilerStats* stats = &profiler.stats;
+    stats->averageFrame = stats->frames == 0 ? milliseconds
+                        : stats->averageFrame + (milliseconds - stats->averageFrame) * ZONE_SMOOTHING;
+    stats->lastFrame = milliseconds;
+    stats->frames++;
+    stats->threads = active;
+    stats->zones = profiler.zoneCount;
+    stats->captured = profiler.captureCount;
+
+    uint64_t dropped = profiler.retiredDropped;
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) dropped += atomic_load_explicit(&profiler.threads[i].dropped, memory_order_relaxed);
+    if (dropped > stats->dropped) stats->dropped = dropped;
+
+    // Zones that did not run this frame decay towards zero
+    for (int i = 0; i < profiler.zoneCount; i++) {
+        ProfilerZoneStats* zone = &profiler.zones[i];
+        ZoneFrame* current = &profiler.zoneFrames[i];
+        zone->calls = current->calls;
+        zone->total = (double)current->total * 1e-6;
+        zone->self = (double)current->self * 1e-6;
+        zone->averageTotal += (zone->total - zone->averageTotal) * ZONE_SMOOTHING;
+        zone->averageSelf += (zone->self - zone->averageSelf) * ZONE_SMOOTHING;
+        zone->peakTotal = zone->total > zone->peakTotal * ZONE_PEAK_DECAY ? zone->total : zone->peakTotal * ZONE_PEAK_DECAY;
+        memset(current, 0, sizeof(*current));
+    }
+    qsort(profiler.order, (size_t)profiler.zoneCount, sizeof(int), CompareZones);
+}
+
+//----------------------------------------------------------------------------------
+// Results
+//----------------------------------------------------------------------------------
+
+ProfilerStats GetProfilerStats(void) {
+    return profiler.stats;
+}
+
+int GetProfilerZoneCount(void) {
+    return profiler.zoneCount;
+}
+
+const ProfilerZoneStats* GetProfilerZoneStats(int index) {
+    if (index < 0 || index >= profiler.zoneCount) return NULL;
+    return &profiler.zones[profiler.order[index]];
+}
+
+int GetProfilerFrameHistory(float* milliseconds, int maxFrames) {
+    int count = profiler.historyCount < maxFrames ? profiler.historyCount : maxFrames;
+    int first = profiler.historyHead - count;
+    for (int i = 0; i < count; i++) {
+        milliseconds[i] = profiler.history[(first + i + PROFILER_HISTORY_FRAMES) % PROFILER_HISTORY_FRAMES];
+    }
+    return count;
+}
+
+static void WriteJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(file, "\\%c", *c);
+        else if (*c < 0x20) fprintf(file, "\\u%04x", *c);
+        else fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+// Chrome trace event format: one complete ("X") event per zone, timestamps
+// in microseconds from the oldest captured event
+bool ExportProfilerTrace(const char* filePath) {
+    if (!filePath) return false;
+    if (profiler.captureCount == 0) {
+        TraceLog(LOG_WARNING, "PROFILER: Nothing captured, %s not written", filePath);
+        return false;
+    }
+
+    FILE* file = fopen(filePath, "w");
+    if (!file) {
+        TraceLog(LOG_WARNING, "PROFILER: Could not open %s for writing", filePath);
+        return false;
+    }
+
+    uint32_t first = profiler.captureHead - profiler.captureCount;
+    uint64_t origin = UINT64_MAX;
+    for (uint32_t i = 0; i < profiler.captureCount; i++) {
+        const ProfileEvent* event = &profiler.capture[(first + i) & (PROFILER_CAPTURE_EVENTS - 1)];
+        if (event->start < origin) origin = event->start;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool separator = false;
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++) {
+        if (!profiler.threads[i].label[0]) continue;
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", separator ? ",\n" : "", i);
+        WriteJsonString(file, profiler.threads[i].label);
+        fprintf(file, "}}");
+        separator = true;
+    }
+
+    for (uint32_t i = 0; i < profiler.captureCount; i++) {
+        const ProfileEvent* event = &profiler.capture[(first + i) & (PROFILER_CAPTURE_EVENTS - 1)];
+        const char* source = event->zone->file;
+        const char* slash = strrchr(source, '/');
+        fprintf(file, "%s{\"name\":", separator ? ",\n" : "");
+        WriteJsonString(file, event->zone->name);
+        fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"source\":",
+                event->zone == &frameZone ? "frame" : "zone", event->thread,
+                (double)(event->start - origin) * 1e-3, (double)(event->end - event->start) * 1e-3);
+        WriteJsonString(file, slash ? slash + 1 : source);
+        fprintf(file, ",\"line\":%d}}", event->zone->line);
+        separator = true;
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0) ok = false;
+    if (ok) TraceLog(LOG_INFO, "PROFILER: Wrote %u events to %s", profiler.captureCount, filePath);
+    else TraceLog(LOG_WARNING, "PROFILER: Failed writing %s", filePath);
+    return ok;
+}
+
+//----------------------------------------------------------------------------------
+// Panel
+//----------------------------------------------------------------------------------
+
+static Color FrameColor(float milliseconds) {
+    if (milliseconds <= 1000.0f / 60.0f) return (Color){ 90, 190, 90, 255 };
+    if (milliseconds <= 1000.0f / 30.0f) return (Color){ 220, 190, 60, 255 };
+    return (Color){ 220, 70, 60, 255 };
+}
+
+static void DrawFrameGraph(Rectangle area) {
+    float frames[PROFILER_HISTORY_FRAMES];
+    int count = GetProfilerFrameHistory(frames, PROFILER_HISTORY_FRAMES);
+
+    // Scaled to fit the worst frame, never tighter than the 30 fps line
+    float top = 1000.0f / 30.0f * 1.25f;
+    for (int i = 0; i < count; i++) if (frames[i] > top) top = frames[i];
+
+    UiDrawRectangle(area, COLOR_TIMELINE_BG);
+    float barWidth = area.width / PROFILER_HISTORY_FRAMES;
+    for (int i = 0; i < count; i++) {
+        float height = area.height * frames[i] / top;
+        float x = area.x + area.width - (count - i) * barWidth;
+        UiDrawRectangle((Rectangle){ x, area.y + area.height - height, fmaxf(barWidth - 1.0f, 1.0f), height }, FrameColor(frames[i]));
+    }
+
+    const float budgets[] = { 1000.0f / 60.0f, 1000.0f / 30.0f };
+    for (int i = 0; i < 2; i++) {
+        float y = area.y + area.height - area.height * budgets[i] / top;
+        UiDrawLine((Vector2){ area.x, y }, (Vector2){ area.x + area.width, y }, COLOR_TEXT_DIM);
+        UiDrawText(TextFormat("%.1f ms", budgets[i]), area.x + 4, y - PANEL_FONT_SIZE, PANEL_FONT_SIZE, COLOR_TEXT_DIM);
+    }
+}
+
+void DrawProfilerPanel(Rectangle bounds) {
+    UiDrawRectangle(bounds, COLOR_PANEL_BG);
+    UiDrawRectangle((Rectangle){ bounds.x, bounds.y, bounds.width, PANEL_HEADER_HEIGHT }, COLOR_PANEL_HEADER);
+
+    ProfilerStats stats = GetProfilerStats();
+    if (!IsProfilerEnabled()) {
+        UiDrawText("Profiler (off)", bounds.x + 8, bounds.y + 5, 14, COLOR_TEXT_DIM);
+        return;
+    }
+    UiDrawText(TextFormat("Profiler  %.2f ms (avg %.2f)  %d threads  %llu dropped", stats.lastFrame, stats.averageFrame,
+                          stats.threads, (unsigned long long)stats.dropped),
+               bounds.x + 8, bounds.y + 5, 14, COLOR_TEXT);
+
+    Rectangle graph = { bounds.x + 4, bounds.y + PANEL_HEADER_HEIGHT + 4, bounds.width - 8, PANEL_GRAPH_HEIGHT };
+    DrawFrameGraph(graph);
+
+    // Zone breakdown, heaviest first, with a bar for its share of the frame
+    Rectangle list = { bounds.x, graph.y + graph.height + 4, bounds.width, bounds.y + bounds.height - (graph.y + graph.height + 4) };
+    if (list.height <= PANEL_ROW_HEIGHT) return;
+
+    float columns[] = { 8, list.width * 0.45f, list.width * 0.62f, list.width * 0.72f, list.width * 0.86f };
+    const char* headers[] = { "Zone", "Thread", "Calls", "Avg ms", "Self ms" };
+    for (int c = 0; c < 5; c++) UiDrawText(headers[c], list.x + columns[c], list.y + 2, PANEL_FONT_SIZE, COLOR_TEXT_DIM);
+
+    Rectangle rows = { list.x, list.y + PANEL_ROW_HEIGHT, list.width, list.height - PANEL_ROW_HEIGHT };
+    int zoneCount = GetProfilerZoneCount();
+    float maxScroll = fmaxf(zoneCount * PANEL_ROW_HEIGHT - rows.height, 0.0f);
+    if (CheckCollisionPointRec(GetMousePosition(), rows)) profiler.scroll -= GetMouseWheelMove() * PANEL_ROW_HEIGHT * 3;
+    profiler.scroll = fminf(fmaxf(profiler.scroll, 0.0f), maxScroll);
+
+    double frame = stats.averageFrame > 0.0 ? stats.averageFrame : 1.0;
+    int first = (int)(profiler.scroll / PANEL_ROW_HEIGHT);
+    int last = first + (int)(rows.height / PANEL_ROW_HEIGHT) + 1;
+    UiBeginScissor(rows);
+    for (int i = first; i < last && i < zoneCount; i++) {
+        const ProfilerZoneStats* zone = GetProfilerZoneStats(i);
+        float y = rows.y + i * PANEL_ROW_HEIGHT - profiler.scroll;
+        float share = (float)fmin(zone->averageTotal / frame, 1.0);
+        UiDrawRectangle((Rectangle){ rows.x, y + 1, rows.width * share, PANEL_ROW_HEIGHT - 2 }, COLOR_SELECTION);
+
+        const char* threadName = profiler.threads[zone->thread].label;
+        UiDrawText(zone->zone->name, rows.x + columns[0], y + 3, PANEL_FONT_SIZE, COLOR_TEXT);
+        UiDrawText(threadName, rows.x + columns[1], y + 3, PANEL_FONT_SIZE, COLOR_TEXT_DIM);
+        UiDrawText(TextFormat("%u", zone->calls), rows.x + columns[2], y + 3, PANEL_FONT_SIZE, COLOR_TEXT);
+        UiDrawText(TextFormat("%.3f", zone->averageTotal), rows.x + columns[3], y + 3, PANEL_FONT_SIZE, COLOR_TEXT);
+        UiDrawText(TextFormat("%.3f", zone->averageSelf), rows.x + columns[4], y + 3, PANEL_FONT_SIZE, COLOR_TEXT);
+    }
+    UiEndScissor();
+}
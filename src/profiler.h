@@ -0,0 +1,140 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frame profiler with scoped zones.
+//
+// A zone times the code between its begin and end on whatever thread runs
+// it. When it ends, the thread pushes one event into its own SpscQueue ring.
+// A thread's first zone claims one of PROFILER_MAX_THREADS slots, which
+// allocates the slot's 512 KB ring unless an exited thread left one behind;
+// after that its zones never lock or allocate. Slots come back when their
+// thread exits, so short-lived threads do not use them up, but more threads
+// recording at once than there are slots lose the extra threads' zones.
+// Once per frame the main thread drains every ring, adds the
+// events up per zone (total and self time, calls) and keeps them in a
+// rolling capture that ExportProfilerTrace writes as Chrome trace JSON
+// (chrome://tracing, Perfetto).
+//
+// While the profiler is disabled a zone costs one relaxed atomic load and a
+// branch. Defining GEARBOX_NO_PROFILER compiles the zone macros away.
+//
+//     void DrawTimeline(AppState* app) {
+//         PROFILE_SCOPE("DrawTimeline");      // Ends when the block exits
+//         ...
+//     }
+//
+//     PROFILE_BEGIN(rows, "FileBrowser.Rows");
+//     ...
+//     PROFILE_END(rows);
+
+#define PROFILER_MAX_THREADS 32             // Threads recording at once
+#define PROFILER_MAX_DEPTH 32
+#define PROFILER_MAX_ZONES 256              // Distinct zone/thread pairs shown in the panel
+#define PROFILER_RING_CAPACITY 16384        // Events per thread between two frames
+#define PROFILER_CAPTURE_EVENTS (1u << 18)  // Most recent events kept for export
+#define PROFILER_HISTORY_FRAMES 240
+
+typedef struct {
+    const char* name;
+    const char* file;
+    int line;
+} ProfileZone;
+
+typedef struct {
+    const ProfileZone* zone;    // NULL when the profiler was off at the begin
+    uint64_t start;
+} ProfileScope;
+
+typedef struct {
+    const ProfileZone* zone;
+    int thread;
+    uint32_t calls;             // Last frame
+    double total;               // Milliseconds, last frame
+    double self;                // Without nested zones, last frame
+    double averageTotal;        // Smoothed over recent frames
+    double averageSelf;
+    double peakTotal;           // Decays slowly so short spikes stay visible
+} ProfilerZoneStats;
+
+typedef struct {
+    uint64_t frames;
+    double lastFrame;           // Milliseconds
+    double averageFrame;
+    int threads;                // Threads that recorded at least one zone
+    int zones;
+    uint64_t events;            // Drained since InitProfiler
+    uint64_t dropped;           // Lost to full rings or a full zone table
+    uint32_t captured;          // Events held for export
+} ProfilerStats;
+
+extern atomic_bool profilerEnabled;
+
+// Lifetime; call from the main thread, UnloadProfiler after worker threads stopped
+void InitProfiler(void);
+void UnloadProfiler(void);
+void SetProfilerEnabled(bool enabled);
+bool IsProfilerEnabled(void);
+void SetProfilerThreadName(const char* name);   // From the thread being named
+
+// Main thread, around each frame
+void BeginProfilerFrame(void);
+void EndProfilerFrame(void);
+
+// Zones. Prefer the macros below, which declare the zone's static site.
+ProfileScope BeginProfileZoneSlow(const ProfileZone* zone);
+void EndProfileZoneSlow(ProfileScope scope);
+
+static inline ProfileScope BeginProfileZone(const ProfileZone* zone) {
+    if (!atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) return (ProfileScope){ 0 };
+    return BeginProfileZoneSlow(zone);
+}
+
+static inline void EndProfileZone(ProfileScope scope) {
+    if (scope.zone) EndProfileZoneSlow(scope);
+}
+
+static inline void EndProfileScope(ProfileScope* scope) {
+    EndProfileZone(*scope);
+}
+
+// Results
+ProfilerStats GetProfilerStats(void);
+int GetProfilerZoneCount(void);
+const ProfilerZoneStats* GetProfilerZoneStats(int index);    // Sorted by average total, largest first
+int GetProfilerFrameHistory(float* milliseconds, int maxFrames);    // Oldest first
+bool ExportProfilerTrace(const char* filePath);
+
+// Frame graph and zone breakdown. Declared with raylib's struct tag so worker
+// code can record zones without pulling raylib.h in next to windows.h.
+struct Rectangle;
+void DrawProfilerPanel(struct Rectangle bounds);
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if defined(GEARBOX_NO_PROFILER)
+    #define PROFILE_BEGIN(var, label) ((void)0)
+    #define PROFILE_END(var) ((void)0)
+    #define PROFILE_SCOPE(label) ((void)0)
+#else
+    #define PROFILE_BEGIN(var, label) \
+        static const ProfileZone PROFILE_CONCAT(var, Zone) = { label, __FILE__, __LINE__ }; \
+        ProfileScope var = BeginProfileZone(&PROFILE_CONCAT(var, Zone))
+    #define PROFILE_END(var) EndProfileZone(var)
+
+    // Ends the zone when the enclosing block exits, returns included
+    #if defined(__GNUC__) || defined(__clang__)
+        #define PROFILE_SCOPE(label) \
+            static const ProfileZone PROFILE_CONCAT(profileZone, __LINE__) = { label, __FILE__, __LINE__ }; \
+            ProfileScope PROFILE_CONCAT(profileScope, __LINE__) __attribute__((cleanup(EndProfileScope))) = \
+                BeginProfileZone(&PROFILE_CONCAT(profileZone, __LINE__))
+    #else
+        #define PROFILE_SCOPE(label) ((void)0)     // Needs the cleanup attribute; use PROFILE_BEGIN/END
+    #endif
+#endif
+
+#endif // PROFILER_H
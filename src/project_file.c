@@ -0,0 +1,612 @@
+#include "project_file.h"
+#include "mapped_file.h"
+#include "scene.h"
+#include <stddef.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#define SECTION_ALIGNMENT 8
+#define MAX_PROJECT_SECTIONS 32
+
+// On-disk records. These are deliberately separate from the in-memory
+// structs so that runtime-only fields (bounds, textures, selection) never
+// leak into the file and the layout does not depend on the compiler.
+typedef struct {
+    char name[64];
+    uint8_t color[4];
+    uint8_t muted;
+    uint8_t solo;
+    uint8_t reserved[2];
+    float volume;
+    float pan;
+} TrackRecord;
+
+typedef struct {
+    char name[64];
+    uint32_t type;
+    int32_t id;
+    uint8_t color[4];
+    int32_t trackIndex;
+    float startTime;
+    float duration;
+    uint32_t slot;          // Version 2: pool slot, keeps journal records valid across reloads
+    int32_t sourceId;       // Appended in version 3, -1 for none
+    float sourceOffset;
+} ElementRecord;
+
+typedef struct {
+    char name[64];
+    int32_t id;
+    uint8_t color[4];
+    uint8_t folded;
+    uint8_t reserved[3];
+    uint32_t firstNote;
+    uint32_t noteCount;
+    uint32_t slot;          // Version 2
+} PatternRecord;
+
+// Versions 1-2 stored game objects as nested name/value property lists;
+// they are migrated to entities on load and no longer written
+typedef struct {
+    char name[64];
+    uint8_t selected;
+    uint8_t folded;
+    uint8_t reserved[2];
+    uint32_t firstComponent;
+    uint32_t componentCount;
+    uint32_t slot;          // Version 2
+} ObjectRecord;
+
+typedef struct {
+    char name[64];
+    uint8_t folded;
+    uint8_t reserved[3];
+    uint32_t firstProperty;
+    uint32_t propertyCount;
+} ComponentRecord;
+
+typedef struct {
+    char name[64];
+    char dataType[32];
+    float value;
+    float min;
+    float max;
+    uint8_t isActive;
+    uint8_t reserved[3];
+} PropertyRecord;
+
+typedef struct {
+    char name[64];
+    char type[32];
+    int32_t id;
+    uint32_t slot;          // Version 2
+    char path[256];         // Appended in version 3
+} AssetRecord;
+
+typedef struct {
+    uint32_t slot;
+    uint32_t reserved;
+} EntityRecord;
+
+// Component sections hold this header followed by the component's bytes,
+// padded to SECTION_ALIGNMENT
+typedef struct {
+    uint32_t entity;        // Entity slot
+    uint32_t reserved;
+} SceneComponentRecord;
+
+_Static_assert(sizeof(ProjectFileHeader) == 16, "ProjectFileHeader layout changed");
+_Static_assert(sizeof(ProjectSectionEntry) == 32, "ProjectSectionEntry layout changed");
+
+typedef struct {
+    uint32_t id;
+    uint32_t recordSize;
+    uint32_t count;
+    uint64_t offset;
+} SectionPlan;
+
+static size_t AlignUp(size_t value) {
+    return (value + SECTION_ALIGNMENT - 1) & ~(size_t)(SECTION_ALIGNMENT - 1);
+}
+
+static void CopyString(char* dst, const char* src, size_t dstSize) {
+    snprintf(dst, dstSize, "%s", src);
+}
+
+// Strings in the file sit in fixed fields that a damaged file may leave
+// unterminated, so reads stop at the end of the field
+static void ReadString(char* dst, size_t dstSize, const char* src, size_t srcSize) {
+    const char* end = memchr(src, '\0', srcSize);
+    size_t length = end ? (size_t)(end - src) : srcSize;
+    if (length >= dstSize) length = dstSize - 1;
+    memcpy(dst, src, length);
+    dst[length] = '\0';
+}
+
+#define READ_STRING(dst, field) ReadString((dst), sizeof(dst), (field), sizeof(field))
+
+static void StoreColor(uint8_t dst[4], Color color) {
+    dst[0] = color.r; dst[1] = color.g; dst[2] = color.b; dst[3] = color.a;
+}
+
+static Color LoadColor(const uint8_t src[4]) {
+    return (Color){ src[0], src[1], src[2], src[3] };
+}
+
+static void* SectionData(unsigned char* file, const SectionPlan* plan) {
+    return file + plan->offset;
+}
+
+enum {
+    SECTION_PLAN_META,
+    SECTION_PLAN_TRACKS,
+    SECTION_PLAN_ELEMENTS,
+    SECTION_PLAN_PATTERNS,
+    SECTION_PLAN_NOTES,
+    SECTION_PLAN_ASSETS,
+    SECTION_PLAN_ENTITIES,
+    SECTION_PLAN_COMPONENTS
+};
+
+_Static_assert(SECTION_PLAN_COMPONENTS + COMPONENT_TYPE_COUNT <= MAX_PROJECT_SECTIONS, "Too many project sections");
+
+static uint32_t ComponentRecordSize(int type) {
+    return (uint32_t)AlignUp(sizeof(SceneComponentRecord) + SCENE_COMPONENT_TYPES[type].size);
+}
+
+// Version 1 records carry no slot; their position stands in for it
+#define RECORD_SLOT(type, rec, stride, position) \
+    ((stride) >= offsetof(type, slot) + sizeof(uint32_t) ? (rec)->slot : (position))
+
+// Slots index the pools directly, so a corrupt one must not size them
+static bool SlotInRange(uint32_t slot, const char* record) {
+    if (slot < POOL_MAX_SLOTS) return true;
+    TraceLog(LOG_WARNING, "PROJECT: Skipping %s with out-of-range slot %u", record, slot);
+    return false;
+}
+
+// Fields appended to a record later are only read when the stride covers them
+#define RECORD_HAS(type, field, stride) \
+    ((stride) >= offsetof(type, field) + sizeof(((type*)0)->field))
+
+unsigned char* BuildProjectFile(const AppState* app, size_t* size) {
+    if (!app || !size) return NULL;
+
+    uint32_t noteCount = 0;
+    for (uint32_t slot = 0; slot < app->patterns.slotCount; slot++) {
+        const Pattern* pattern = PoolAt(&app->patterns, slot);
+        if (pattern) noteCount += (uint32_t)pattern->noteCount;
+    }
+
+    SectionPlan plan[MAX_PROJECT_SECTIONS] = {
+        [SECTION_PLAN_META]     = { PROJECT_SECTION_META,     sizeof(ProjectInfo),   1,                            0 },
+        [SECTION_PLAN_TRACKS]   = { PROJECT_SECTION_TRACKS,   sizeof(TrackRecord),   (uint32_t)app->trackCount,    0 },
+        [SECTION_PLAN_ELEMENTS] = { PROJECT_SECTION_ELEMENTS, sizeof(ElementRecord), app->elements.liveCount,      0 },
+        [SECTION_PLAN_PATTERNS] = { PROJECT_SECTION_PATTERNS, sizeof(PatternRecord), app->patterns.liveCount,      0 },
+        [SECTION_PLAN_NOTES]    = { PROJECT_SECTION_NOTES,    sizeof(int32_t),       noteCount,                    0 },
+        [SECTION_PLAN_ASSETS]   = { PROJECT_SECTION_ASSETS,   sizeof(AssetRecord),   app->assets.liveCount,        0 },
+        [SECTION_PLAN_ENTITIES] = { PROJECT_SECTION_ENTITIES, sizeof(EntityRecord),  EcsEntityCount(&app->scene),  0 },
+    };
+
+    // One section per component type, filled from its columns
+    int sectionCount = SECTION_PLAN_COMPONENTS;
+    for (int t = 0; t < COMPONENT_TYPE_COUNT; t++) {
+        uint32_t count = 0;
+        for (EcsQuery q = EcsQueryBegin(&app->scene, ECS_MASK(t), 0); EcsQueryNext(&q);) count += q.count;
+        plan[sectionCount++] = (SectionPlan){ SCENE_COMPONENT_TYPES[t].fourcc, ComponentRecordSize(t), count, 0 };
+    }
+
+
+    // Lay out the sections after the header and section table
+    size_t fileSize = AlignUp(sizeof(ProjectFileHeader) + sectionCount * sizeof(ProjectSectionEntry));
+    for (int s = 0; s < sectionCount; s++) {
+        plan[s].offset = fileSize;
+        fileSize = AlignUp(fileSize + (size_t)plan[s].recordSize * plan[s].count);
+    }
+
+    unsigned char* file = calloc(1, fileSize);
+    if (!file) return NULL;
+
+    ProjectFileHeader* header = (ProjectFileHeader*)file;
+    header->magic = PROJECT_FILE_MAGIC;
+    header->version = PROJECT_FILE_VERSION;
+    header->sectionCount = (uint16_t)sectionCount;
+
+    ProjectSectionEntry* table = (ProjectSectionEntry*)(file + sizeof(ProjectFileHeader));
+    for (int s = 0; s < sectionCount; s++) {
+        table[s].id = plan[s].id;
+        table[s].recordSize = plan[s].recordSize;
+        table[s].count = plan[s].count;
+        table[s].offset = plan[s].offset;
+        table[s].size = (uint64_t)plan[s].recordSize * plan[s].count;
+    }
+
+    ProjectInfo* info = SectionData(file, &plan[SECTION_PLAN_META]);
+    CopyString(info->name, app->projectName, sizeof(info->name));
+    info->savedAt = (int64_t)time(NULL);
+    info->trackCount = (uint32_t)app->trackCount;
+    info->elementCount = app->elements.liveCount;
+    info->patternCount = app->patterns.liveCount;
+    info->entityCount = EcsEntityCount(&app->scene);
+    info->assetCount = app->assets.liveCount;
+    info->bpm = app->timeline.bpm;
+    info->timeSignatureNumerator = app->timeline.timeSignatureNumerator;
+    info->timeSignatureDenominator = app->timeline.timeSignatureDenominator;
+    info->snapDivision = app->timeline.snapDivision;
+    info->zoom = app->timeline.zoom;
+
+    TrackRecord* tracks = SectionData(file, &plan[SECTION_PLAN_TRACKS]);
+    for (int i = 0; i < app->trackCount; i++) {
+        const Track* track = &app->tracks[i];
+        CopyString(tracks[i].name, track->name, sizeof(tracks[i].name));
+        StoreColor(tracks[i].color, track->color);
+        tracks[i].muted = track->muted;
+        tracks[i].solo = track->solo;
+        tracks[i].volume = track->volume;
+        tracks[i].pan = track->pan;
+    }
+
+    ElementRecord* elements = SectionData(file, &plan[SECTION_PLAN_ELEMENTS]);
+    uint32_t next = 0;
+    for (uint32_t slot = 0; slot < app->elements.slotCount; slot++) {
+        const TimelineElement* element = PoolAt(&app->elements, slot);
+        if (!element) continue;
+        ElementRecord* rec = &elements[next++];
+        CopyString(rec->name, element->name, sizeof(rec->name));
+        rec->type = (uint32_t)element->type;
+        rec->id = element->id;
+        StoreColor(rec->color, element->color);
+        rec->trackIndex = element->trackIndex;
+        rec->startTime = element->startTime;
+        rec->duration = element->duration;
+        rec->slot = slot;
+        rec->sourceId = element->sourceId;
+        rec->sourceOffset = element->sourceOffset;
+    }
+
+    PatternRecord* patterns = SectionData(file, &plan[SECTION_PLAN_PATTERNS]);
+    int32_t* notes = SectionData(file, &plan[SECTION_PLAN_NOTES]);
+    uint32_t nextNote = 0;
+    next = 0;
+    for (uint32_t slot = 0; slot < app->patterns.slotCount; slot++) {
+        const Pattern* pattern = PoolAt(&app->patterns, slot);
+        if (!pattern) continue;
+        PatternRecord* rec = &patterns[next++];
+        CopyString(rec->name, pattern->name, sizeof(rec->name));
+        rec->id = pattern->id;
+        StoreColor(rec->color, pattern->color);
+        rec->folded = pattern->folded;
+        rec->firstNote = nextNote;
+        rec->noteCount = (uint32_t)pattern->noteCount;
+        rec->slot = slot;
+        for (int n = 0; n < pattern->noteCount; n++) notes[nextNote++] = pattern->notes[n];
+    }
+
+    AssetRecord* assets = SectionData(file, &plan[SECTION_PLAN_ASSETS]);
+    next = 0;
+    for (uint32_t slot = 0; slot < app->assets.slotCount; slot++) {
+        const Asset* asset = PoolAt(&app->assets, slot);
+        if (!asset) continue;
+        AssetRecord* rec = &assets[next++];
+        CopyString(rec->name, asset->name, sizeof(rec->name));
+        CopyString(rec->type, asset->type, sizeof(rec->type));
+        rec->id = asset->id;
+        rec->slot = slot;
+        CopyString(rec->path, asset->path, sizeof(rec->path));
+    }
+
+    EntityRecord* entities = SectionData(file, &plan[SECTION_PLAN_ENTITIES]);
+    next = 0;
+    for (uint32_t slot = 0; slot < app->scene.entities.slotCount; slot++) {
+        if (EcsIsAlive(&app->scene, EcsEntityAt(&app->scene, slot))) entities[next++].slot = slot;
+    }
+
+    for (int t = 0; t < COMPONENT_TYPE_COUNT; t++) {
+        const SectionPlan* section = &plan[SECTION_PLAN_COMPONENTS + t];
+        uint32_t size = SCENE_COMPONENT_TYPES[t].size;
+        unsigned char* out = SectionData(file, section);
+        for (EcsQuery q = EcsQueryBegin(&app->scene, ECS_MASK(t), 0); EcsQueryNext(&q);) {
+            const unsigned char* column = EcsQueryColumn(&q, t);
+            for (uint32_t i = 0; i < q.count; i++, out += section->recordSize) {
+                ((SceneComponentRecord*)out)->entity = q.entities[i].index;
+                memcpy(out + sizeof(SceneComponentRecord), column + (size_t)i * size, size);
+            }
+        }
+    }
+
+    *size = fileSize;
+    return file;
+}
+
+bool WriteProjectFileData(const char* filePath, const unsigned char* data, size_t size) {
+    if (!filePath || !data) return false;
+
+    // Write to a temporary file and swap it in, so a crash mid-save never
+    // leaves a truncated project behind
+    char tmpPath[512];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", filePath);
+
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) {
+        TraceLog(LOG_WARNING, "PROJECT: Failed to open %s for writing", tmpPath);
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, out) == size && fflush(out) == 0;
+#if !defined(_WIN32)
+    ok = ok && fsync(fileno(out)) == 0;
+#endif
+    ok = (fclose(out) == 0) && ok;
+
+    if (ok) {
+#if defined(_WIN32)
+        remove(filePath);
+#endif
+        ok = rename(tmpPath, filePath) == 0;
+    }
+    if (!ok) {
+        TraceLog(LOG_WARNING, "PROJECT: Failed to write %s", filePath);
+        remove(tmpPath);
+    }
+    return ok;
+}
+
+bool WriteProjectFile(const AppState* app, const char* filePath) {
+    size_t size = 0;
+    unsigned char* data = BuildProjectFile(app, &size);
+    if (!data) return false;
+
+    bool ok = WriteProjectFileData(filePath, data, size);
+    free(data);
+    return ok;
+}
+
+// Returns the records of a section, or NULL if it is missing or malformed
+static const unsigned char* FindSection(const MappedFile* file, uint32_t id, size_t minRecordSize,
+                                        uint32_t* count, uint32_t* stride) {
+    const ProjectFileHeader* header = (const ProjectFileHeader*)file->data;
+    const ProjectSectionEntry* table = (const ProjectSectionEntry*)(file->data + sizeof(ProjectFileHeader));
+
+    for (int s = 0; s < header->sectionCount; s++) {
+        const ProjectSectionEntry* entry = &table[s];
+        if (entry->id != id) continue;
+
+        if (entry->recordSize < minRecordSize) return NULL;
+        if (entry->offset % SECTION_ALIGNMENT != 0) return NULL;
+        if (entry->offset > file->size || entry->size > file->size - entry->offset) return NULL;
+        if ((uint64_t)entry->recordSize * entry->count > entry->size) return NULL;
+
+        *count = entry->count;
+        *stride = entry->recordSize;
+        return file->data + entry->offset;
+    }
+
+    *count = 0;
+    *stride = 0;
+    return NULL;
+}
+
+// Versions 1-2: each game object becomes an entity; components and
+// properties are matched to scene component types and fields by name
+static void MigrateGameObjects(AppState* app, const MappedFile* file) {
+    uint32_t count, stride, componentCount, componentStride, propertyCount, propertyStride;
+    const unsigned char* base = FindSection(file, PROJECT_SECTION_OBJECTS, offsetof(ObjectRecord, slot), &count, &stride);
+    const unsigned char* components = FindSection(file, PROJECT_SECTION_COMPONENTS, sizeof(ComponentRecord),
+                                                  &componentCount, &componentStride);
+    const unsigned char* properties = FindSection(file, PROJECT_SECTION_PROPERTIES, sizeof(PropertyRecord),
+                                                  &propertyCount, &propertyStride);
+
+    for (uint32_t i = 0; base && i < count; i++) {
+        const ObjectRecord* rec = (const ObjectRecord*)(base + (size_t)i * stride);
+        uint32_t slot = RECORD_SLOT(ObjectRecord, rec, stride, i);
+        if (!SlotInRange(slot, "object")) continue;
+        Entity entity = EcsCreateEntityAt(&app->scene, slot);
+        NameComponent* label = EcsAddComponent(&app->scene, entity, COMPONENT_NAME);
+        if (!label) continue;
+        READ_STRING(label->value, rec->name);
+
+        uint32_t foldedComponents = 0;
+        for (uint32_t c = 0; components && c < rec->componentCount && rec->firstComponent + c < componentCount; c++) {
+            const ComponentRecord* crec = (const ComponentRecord*)(components + (size_t)(rec->firstComponent + c) * componentStride);
+            char componentName[sizeof(crec->name) + 1];
+            READ_STRING(componentName, crec->name);
+            int type = EcsFindComponentType(&app->scene, componentName);
+            unsigned char* component = type >= 0 ? EcsAddComponent(&app->scene, entity, type) : NULL;
+            if (!component) {
+                TraceLog(LOG_WARNING, "PROJECT: Dropping unknown component '%s' on '%s'", componentName, label->value);
+                continue;
+            }
+            if (crec->folded) foldedComponents |= ECS_MASK(type);
+
+            for (uint32_t p = 0; properties && p < crec->propertyCount && crec->firstProperty + p < propertyCount; p++) {
+                const PropertyRecord* prec = (const PropertyRecord*)(properties + (size_t)(crec->firstProperty + p) * propertyStride);
+                char name[sizeof(prec->name) + 1];
+                READ_STRING(name, prec->name);
+                const EcsField* field = EcsFindField(&SCENE_COMPONENT_TYPES[type], name);
+                if (!field) continue;
+
+                unsigned char* data = component + field->offset;
+                if (field->type == ECS_FIELD_FLOAT) memcpy(data, &prec->value, sizeof(float));
+                else if (field->type == ECS_FIELD_INT) *(int32_t*)data = (int32_t)prec->value;
+                else if (field->type == ECS_FIELD_BOOL) *data = prec->value != 0.0f;
+            }
+        }
+
+        // Adding components moves the entity between archetypes, so the
+        // editor state is written last
+        EditorComponent* editor = EcsAddComponent(&app->scene, entity, COMPONENT_EDITOR);
+        if (editor) {
+            editor->selected = rec->selected;
+            editor->folded = rec->folded;
+            editor->foldedComponents = foldedComponents;
+        }
+    }
+}
+
+static bool ValidateHeader(const ProjectFileHeader* header, size_t fileSize) {
+    if (header->magic != PROJECT_FILE_MAGIC) return false;
+    if (header->version == 0 || header->version > PROJECT_FILE_VERSION) return false;
+    if (header->sectionCount > MAX_PROJECT_SECTIONS) return false;
+    return sizeof(ProjectFileHeader) + header->sectionCount * sizeof(ProjectSectionEntry) <= fileSize;
+}
+
+bool ReadProjectFile(AppState* app, const char* filePath) {
+    if (!app || !filePath) return false;
+
+    MappedFile file;
+    if (!MapFile(filePath, &file)) {
+        TraceLog(LOG_WARNING, "PROJECT: Failed to open %s", filePath);
+        return false;
+    }
+
+    if (file.size < sizeof(ProjectFileHeader) || !ValidateHeader((const ProjectFileHeader*)file.data, file.size)) {
+        TraceLog(LOG_WARNING, "PROJECT: %s is not a valid project file", filePath);
+        UnmapFile(&file);
+        return false;
+    }
+
+    uint32_t count, stride;
+    const unsigned char* base;
+
+    base = FindSection(&file, PROJECT_SECTION_META, sizeof(ProjectInfo), &count, &stride);
+    if (base && count > 0) {
+        const ProjectInfo* info = (const ProjectInfo*)base;
+        READ_STRING(app->projectName, info->name);
+        app->timeline.bpm = info->bpm;
+        app->timeline.timeSignatureNumerator = info->timeSignatureNumerator;
+        app->timeline.timeSignatureDenominator = info->timeSignatureDenominator;
+        app->timeline.snapDivision = info->snapDivision;
+        app->timeline.zoom = info->zoom;
+    }
+
+    ClearProjectData(app);
+
+    base = FindSection(&file, PROJECT_SECTION_TRACKS, sizeof(TrackRecord), &count, &stride);
+    for (uint32_t i = 0; base && i < count && app->trackCount < MAX_TIMELINE_TRACKS; i++) {
+        const TrackRecord* rec = (const TrackRecord*)(base + (size_t)i * stride);
+        Track* track = &app->tracks[app->trackCount++];
+        memset(track, 0, sizeof(*track));
+        READ_STRING(track->name, rec->name);
+        track->color = LoadColor(rec->color);
+        track->muted = rec->muted;
+        track->solo = rec->solo;
+        track->volume = rec->volume;
+        track->pan = rec->pan;
+    }
+
+    base = FindSection(&file, PROJECT_SECTION_ELEMENTS, offsetof(ElementRecord, slot), &count, &stride);
+    for (uint32_t i = 0; base && i < count; i++) {
+        const ElementRecord* rec = (const ElementRecord*)(base + (size_t)i * stride);
+        uint32_t slot = RECORD_SLOT(ElementRecord, rec, stride, i);
+        if (!SlotInRange(slot, "element")) continue;
+        TimelineElement* element = PoolGet(&app->elements, PoolAllocAt(&app->elements, slot));
+        if (!element) continue;
+        READ_STRING(element->name, rec->name);
+        element->type = (ElementType)rec->type;
+        element->id = rec->id;
+        element->color = LoadColor(rec->color);
+        element->trackIndex = rec->trackIndex;
+        element->startTime = rec->startTime;
+        element->duration = rec->duration;
+        element->sourceId = RECORD_HAS(ElementRecord, sourceId, stride) ? rec->sourceId : -1;
+        element->sourceOffset = RECORD_HAS(ElementRecord, sourceOffset, stride) ? rec->sourceOffset : 0.0f;
+    }
+
+    uint32_t noteCount, noteStride;
+    const unsigned char* notes = FindSection(&file, PROJECT_SECTION_NOTES, sizeof(int32_t), &noteCount, &noteStride);
+
+    base = FindSection(&file, PROJECT_SECTION_PATTERNS, offsetof(PatternRecord, slot), &count, &stride);
+    for (uint32_t i = 0; base && i < count; i++) {
+        const PatternRecord* rec = (const PatternRecord*)(base + (size_t)i * stride);
+        uint32_t slot = RECORD_SLOT(PatternRecord, rec, stride, i);
+        if (!SlotInRange(slot, "pattern")) continue;
+        Pattern* pattern = PoolGet(&app->patterns, PoolAllocAt(&app->patterns, slot));
+        if (!pattern) continue;
+        READ_STRING(pattern->name, rec->name);
+        pattern->id = rec->id;
+        pattern->color = LoadColor(rec->color);
+        pattern->folded = rec->folded;
+
+        for (uint32_t n = 0; notes && n < rec->noteCount && rec->firstNote + n < noteCount; n++) {
+            AddPatternNote(pattern, *(const int32_t*)(notes + (size_t)(rec->firstNote + n) * noteStride));
+        }
+    }
+
+    base = FindSection(&file, PROJECT_SECTION_ENTITIES, sizeof(EntityRecord), &count, &stride);
+    for (uint32_t i = 0; base && i < count; i++) {
+        uint32_t slot = ((const EntityRecord*)(base + (size_t)i * stride))->slot;
+        if (SlotInRange(slot, "entity")) EcsCreateEntityAt(&app->scene, slot);
+    }
+
+    for (int t = 0; t < COMPONENT_TYPE_COUNT; t++) {
+        base = FindSection(&file, SCENE_COMPONENT_TYPES[t].fourcc, sizeof(SceneComponentRecord), &count, &stride);
+
+        // Fields appended by a newer build are skipped; missing ones keep their defaults
+        size_t size = SCENE_COMPONENT_TYPES[t].size;
+        size_t stored = stride - sizeof(SceneComponentRecord);
+        for (uint32_t i = 0; base && i < count; i++) {
+            const unsigned char* rec = base + (size_t)i * stride;
+            Entity entity = EcsEntityAt(&app->scene, ((const SceneComponentRecord*)rec)->entity);
+            unsigned char* component = EcsAddComponent(&app->scene, entity, t);
+            if (!component) continue;
+            EcsResetComponent(&app->scene, t, component);
+            memcpy(component, rec + sizeof(SceneComponentRecord), stored < size ? stored : size);
+
+            // The copy is raw, so string fields are terminated before anything draws them
+            const EcsComponentInfo* info = &SCENE_COMPONENT_TYPES[t];
+            for (int f = 0; f < info->fieldCount; f++) {
+                if (info->fields[f].type == ECS_FIELD_STRING) component[info->fields[f].offset + info->fields[f].size - 1] = '\0';
+            }
+        }
+    }
+
+    MigrateGameObjects(app, &file);
+
+    base = FindSection(&file, PROJECT_SECTION_ASSETS, offsetof(AssetRecord, slot), &count, &stride);
+    for (uint32_t i = 0; base && i < count; i++) {
+        const AssetRecord* rec = (const AssetRecord*)(base + (size_t)i * stride);
+        uint32_t slot = RECORD_SLOT(AssetRecord, rec, stride, i);
+        if (!SlotInRange(slot, "asset")) continue;
+        Asset* asset = PoolGet(&app->assets, PoolAllocAt(&app->assets, slot));
+        if (!asset) continue;
+        READ_STRING(asset->name, rec->name);
+        READ_STRING(asset->type, rec->type);
+        asset->id = rec->id;
+        if (RECORD_HAS(AssetRecord, path, stride)) READ_STRING(asset->path, rec->path);
+    }
+
+    UnmapFile(&file);
+    return true;
+}
+
+bool ReadProjectInfo(const char* filePath, ProjectInfo* info) {
+    if (!filePath || !info) return false;
+    memset(info, 0, sizeof(*info));
+
+    // Only the header, the section table and the metadata record are read
+    FILE* in = fopen(filePath, "rb");
+    if (!in) return false;
+
+    ProjectFileHeader header;
+    ProjectSectionEntry table[MAX_PROJECT_SECTIONS];
+    bool ok = fread(&header, sizeof(header), 1, in) == 1 &&
+              header.magic == PROJECT_FILE_MAGIC &&
+              header.version > 0 && header.version <= PROJECT_FILE_VERSION &&
+              header.sectionCount <= MAX_PROJECT_SECTIONS &&
+              fread(table, sizeof(ProjectSectionEntry), header.sectionCount, in) == header.sectionCount;
+
+    bool found = false;
+    for (int s = 0; ok && s < header.sectionCount; s++) {
+        if (table[s].id != PROJECT_SECTION_META || table[s].count == 0) continue;
+        if (table[s].recordSize < sizeof(ProjectInfo)) break;
+        found = fseek(in, (long)table[s].offset, SEEK_SET) == 0 &&
+                fread(info, sizeof(ProjectInfo), 1, in) == 1;
+        break;
+    }
+
+    fclose(in);
+    info->name[sizeof(info->name) - 1] = '\0';
+    return found;
+}
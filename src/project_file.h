@@ -0,0 +1,77 @@
+#ifndef PROJECT_FILE_H
+#define PROJECT_FILE_H
+
+#include "app_state.h"
+#include <stdint.h>
+
+// Project file layout (all values little-endian):
+//
+//   ProjectFileHeader
+//   ProjectSectionEntry[sectionCount]
+//   section payloads, each 8-byte aligned
+//
+// Every section is a flat array of fixed-size records, so loading maps the
+// file and reads records where they lie instead of parsing a text format.
+// Each section stores its record size; readers use it as the stride, so newer
+// writers may append fields to a record without breaking older readers.
+
+#define PROJECT_FILE_NAME "project.gbproj"
+#define PROJECT_FILE_MAGIC 0x4A504247u   // "GBPJ"
+#define PROJECT_FILE_VERSION 3
+
+#define PROJECT_FOURCC(a, b, c, d) \
+    ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#define PROJECT_SECTION_META      PROJECT_FOURCC('M','E','T','A')
+#define PROJECT_SECTION_TRACKS    PROJECT_FOURCC('T','R','A','K')
+#define PROJECT_SECTION_ELEMENTS  PROJECT_FOURCC('E','L','E','M')
+#define PROJECT_SECTION_PATTERNS  PROJECT_FOURCC('P','A','T','N')
+#define PROJECT_SECTION_NOTES     PROJECT_FOURCC('N','O','T','E')
+#define PROJECT_SECTION_OBJECTS   PROJECT_FOURCC('G','O','B','J')    // Versions 1-2, migrated to entities
+#define PROJECT_SECTION_COMPONENTS PROJECT_FOURCC('C','O','M','P')   // Versions 1-2
+#define PROJECT_SECTION_PROPERTIES PROJECT_FOURCC('P','R','O','P')   // Versions 1-2
+#define PROJECT_SECTION_ASSETS    PROJECT_FOURCC('A','S','E','T')
+#define PROJECT_SECTION_ENTITIES  PROJECT_FOURCC('E','N','T','Y')
+// Scene components are stored one section per type, see SCENE_COMPONENT_TYPES
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sectionCount;
+    uint32_t flags;
+    uint32_t reserved;
+} ProjectFileHeader;
+
+typedef struct {
+    uint32_t id;
+    uint32_t recordSize;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+} ProjectSectionEntry;
+
+// Metadata shown on the start screen, readable without loading the project
+typedef struct {
+    char name[64];
+    int64_t savedAt;
+    uint32_t trackCount;
+    uint32_t elementCount;
+    uint32_t patternCount;
+    uint32_t entityCount;
+    uint32_t assetCount;
+    float bpm;
+    float timeSignatureNumerator;
+    float timeSignatureDenominator;
+    float snapDivision;
+    float zoom;
+} ProjectInfo;
+
+// Project file functions
+unsigned char* BuildProjectFile(const AppState* app, size_t* size);   // Serialize in memory, caller frees
+bool WriteProjectFileData(const char* filePath, const unsigned char* data, size_t size);
+bool WriteProjectFile(const AppState* app, const char* filePath);
+bool ReadProjectFile(AppState* app, const char* filePath);
+bool ReadProjectInfo(const char* filePath, ProjectInfo* info);
+
+#endif // PROJECT_FILE_H
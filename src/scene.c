@@ -0,0 +1,435 @@
+#include "scene.h"
+#include "journal.h"
+#include "history.h"
+#include "project_file.h"
+#include "profiler.h"
+#include "ui_components.h"
+#include <stddef.h>
+
+#define FIELD(type, member, fieldType, lo, hi) \
+    { #member, (fieldType), (uint32_t)offsetof(type, member), (uint32_t)sizeof(((type*)0)->member), (lo), (hi) }
+
+#define PROPERTY_LABEL_WIDTH 90
+
+static const TransformComponent defaultTransform = { { 0.0f, 0.0f }, 0.0f, { 1.0f, 1.0f } };
+static const SpriteComponent defaultSprite = { -1, { 255, 255, 255, 255 }, { 32.0f, 32.0f } };
+static const AudioSourceComponent defaultAudioSource = { -1, 1.0f, 0.0f, 0, 0, { 0, 0 } };
+
+const EcsComponentInfo SCENE_COMPONENT_TYPES[COMPONENT_TYPE_COUNT] = {
+    [COMPONENT_NAME] = {
+        "Name", PROJECT_FOURCC('N','A','M','E'), sizeof(NameComponent), NULL,
+        { FIELD(NameComponent, value, ECS_FIELD_STRING, 0, 0) }, 1
+    },
+    [COMPONENT_EDITOR] = {
+        "Editor", PROJECT_FOURCC('E','D','I','T'), sizeof(EditorComponent), NULL,
+        { { 0 } }, 0
+    },
+    [COMPONENT_TRANSFORM] = {
+        "Transform", PROJECT_FOURCC('X','F','R','M'), sizeof(TransformComponent), &defaultTransform,
+        {
+            { "x", ECS_FIELD_FLOAT, offsetof(TransformComponent, position.x), sizeof(float), 0, 0 },
+            { "y", ECS_FIELD_FLOAT, offsetof(TransformComponent, position.y), sizeof(float), 0, 0 },
+            FIELD(TransformComponent, rotation, ECS_FIELD_FLOAT, -180.0f, 180.0f),
+            { "scaleX", ECS_FIELD_FLOAT, offsetof(TransformComponent, scale.x), sizeof(float), 0.0f, 10.0f },
+            { "scaleY", ECS_FIELD_FLOAT, offsetof(TransformComponent, scale.y), sizeof(float), 0.0f, 10.0f },
+        }, 5
+    },
+    [COMPONENT_SPRITE] = {
+        "Sprite", PROJECT_FOURCC('S','P','R','T'), sizeof(SpriteComponent), &defaultSprite,
+        {
+            FIELD(SpriteComponent, asset, ECS_FIELD_INT, 0, 0),
+            FIELD(SpriteComponent, tint, ECS_FIELD_COLOR, 0, 0),
+            { "width", ECS_FIELD_FLOAT, offsetof(SpriteComponent, size.x), sizeof(float), 0.0f, 1024.0f },
+            { "height", ECS_FIELD_FLOAT, offsetof(SpriteComponent, size.y), sizeof(float), 0.0f, 1024.0f },
+        }, 4
+    },
+    [COMPONENT_AUDIO_SOURCE] = {
+        "AudioSource", PROJECT_FOURCC('A','U','D','S'), sizeof(AudioSourceComponent), &defaultAudioSource,
+        {
+            FIELD(AudioSourceComponent, asset, ECS_FIELD_INT, 0, 0),
+            FIELD(AudioSourceComponent, volume, ECS_FIELD_FLOAT, 0.0f, 2.0f),
+            FIELD(AudioSourceComponent, pan, ECS_FIELD_FLOAT, -1.0f, 1.0f),
+            FIELD(AudioSourceComponent, loop, ECS_FIELD_BOOL, 0, 1),
+            FIELD(AudioSourceComponent, playOnStart, ECS_FIELD_BOOL, 0, 1),
+        }, 5
+    },
+};
+
+static bool IsSpatialComponent(int type) {
+    return type == COMPONENT_TRANSFORM || type == COMPONENT_SPRITE;
+}
+
+Entity CreateSceneEntity(AppState* app, const char* name) {
+    if (!app) return ECS_NULL_ENTITY;
+
+    Entity entity = EcsCreateEntity(&app->scene);
+    if (!EcsIsAlive(&app->scene, entity)) return ECS_NULL_ENTITY;
+    HistoryLabel(app, "Create entity", 0);
+    HistoryCaptureCreated(app, JOURNAL_OBJECT_ENTITY, entity.index, 0);
+    RecordProjectAlloc(app, JOURNAL_OBJECT_ENTITY, entity.index);
+
+    NameComponent* label = AddSceneComponent(app, entity, COMPONENT_NAME);
+    if (label) {
+        strncpy(label->value, name ? name : "Entity", sizeof(label->value) - 1);
+        RecordSceneComponent(app, entity, COMPONENT_NAME);
+    }
+    AddSceneComponent(app, entity, COMPONENT_TRANSFORM);
+    return entity;
+}
+
+void DestroySceneEntity(AppState* app, Entity entity) {
+    if (!app || !EcsIsAlive(&app->scene, entity)) return;
+
+    // Components before the entity: undo revives the entity first
+    HistoryLabel(app, "Delete entity", 0);
+    for (int type = 0; type < COMPONENT_TYPE_COUNT; type++) {
+        if (EcsGetComponent(&app->scene, entity, type)) HistoryCapture(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type);
+    }
+    HistoryCapture(app, JOURNAL_OBJECT_ENTITY, entity.index, 0);
+    EcsDestroyEntity(&app->scene, entity);
+    UpdateSceneBounds(app, entity);
+    RecordProjectFree(app, JOURNAL_OBJECT_ENTITY, entity.index);
+    if (PoolHandleEqual(app->selectedEntity, entity)) app->selectedEntity = ECS_NULL_ENTITY;
+}
+
+void* AddSceneComponent(AppState* app, Entity entity, SceneComponentType type) {
+    if (!app) return NULL;
+    bool existed = EcsGetComponent(&app->scene, entity, type) != NULL;
+    if (!existed && EcsIsAlive(&app->scene, entity)) {
+        HistoryLabel(app, "Add component", 0);
+        HistoryCapture(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type);
+    }
+    void* component = EcsAddComponent(&app->scene, entity, type);
+    if (component && !existed) {
+        JournalRecord(app->journal, JOURNAL_RECORD_ALLOC, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type, 0, NULL, 0);
+        app->projectModified = true;
+        if (IsSpatialComponent(type)) UpdateSceneBounds(app, entity);
+    }
+    return component;
+}
+
+void RemoveSceneComponent(AppState* app, Entity entity, SceneComponentType type) {
+    if (!app || !EcsGetComponent(&app->scene, entity, type)) return;
+    HistoryLabel(app, "Remove component", 0);
+    HistoryCapture(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type);
+    EcsRemoveComponent(&app->scene, entity, type);
+    JournalRecord(app->journal, JOURNAL_RECORD_FREE, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type, 0, NULL, 0);
+    app->projectModified = true;
+    if (IsSpatialComponent(type)) UpdateSceneBounds(app, entity);
+}
+
+void RecordSceneComponent(AppState* app, Entity entity, SceneComponentType type) {
+    if (!app || !EcsGetComponent(&app->scene, entity, type)) return;
+    RecordProjectObject(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type);
+    if (IsSpatialComponent(type)) UpdateSceneBounds(app, entity);
+}
+
+//----------------------------------------------------------------------------------
+// Spatial index
+//----------------------------------------------------------------------------------
+
+// World box around a sprite rotated about its center
+static Rectangle SpriteBounds(const TransformComponent* t, const SpriteComponent* sprite) {
+    float halfWidth = fabsf(sprite->size.x * t->scale.x) * 0.5f;
+    float halfHeight = fabsf(sprite->size.y * t->scale.y) * 0.5f;
+    float c = fabsf(cosf(t->rotation * DEG2RAD));
+    float s = fabsf(sinf(t->rotation * DEG2RAD));
+    float extentX = halfWidth * c + halfHeight * s;
+    float extentY = halfWidth * s + halfHeight * c;
+    return (Rectangle){ t->position.x - extentX, t->position.y - extentY, extentX * 2.0f, extentY * 2.0f };
+}
+
+static bool SpriteContains(const TransformComponent* t, const SpriteComponent* sprite, Vector2 point) {
+    float dx = point.x - t->position.x;
+    float dy = point.y - t->position.y;
+    float c = cosf(-t->rotation * DEG2RAD);
+    float s = sinf(-t->rotation * DEG2RAD);
+    return fabsf(dx * c - dy * s) <= fabsf(sprite->size.x * t->scale.x) * 0.5f &&
+           fabsf(dx * s + dy * c) <= fabsf(sprite->size.y * t->scale.y) * 0.5f;
+}
+
+static bool GetSpriteShape(const AppState* app, Entity entity, const TransformComponent** t, const SpriteComponent** sprite) {
+    *t = EcsGetComponent(&app->scene, entity, COMPONENT_TRANSFORM);
+    *sprite = EcsGetComponent(&app->scene, entity, COMPONENT_SPRITE);
+    return *t && *sprite;
+}
+
+static bool ReserveSceneProxies(AppState* app, uint32_t slot) {
+    if (slot < app->sceneProxyCapacity) return true;
+
+    uint32_t capacity = app->sceneProxyCapacity ? app->sceneProxyCapacity * 2 : 256;
+    while (capacity <= slot) capacity *= 2;
+
+    int32_t* proxies = realloc(app->sceneProxies, capacity * sizeof(int32_t));
+    if (!proxies) return false;
+    for (uint32_t i = app->sceneProxyCapacity; i < capacity; i++) proxies[i] = BVH_NULL_PROXY;
+    app->sceneProxies = proxies;
+    app->sceneProxyCapacity = capacity;
+    return true;
+}
+
+void UpdateSceneBounds(AppState* app, Entity entity) {
+    if (!app) return;
+
+    uint32_t slot = entity.index;
+    int32_t proxy = slot < app->sceneProxyCapacity ? app->sceneProxies[slot] : BVH_NULL_PROXY;
+    const TransformComponent* t;
+    const SpriteComponent* sprite;
+
+    // Destroyed entities and ones missing either component leave the index
+    if (!GetSpriteShape(app, entity, &t, &sprite)) {
+        if (proxy != BVH_NULL_PROXY) {
+            BvhRemove(&app->sceneBounds, proxy);
+            app->sceneProxies[slot] = BVH_NULL_PROXY;
+        }
+        return;
+    }
+
+    Rectangle box = SpriteBounds(t, sprite);
+    if (proxy != BVH_NULL_PROXY) {
+        BvhMove(&app->sceneBounds, proxy, box);
+    } else if (ReserveSceneProxies(app, slot)) {
+        app->sceneProxies[slot] = BvhInsert(&app->sceneBounds, box, slot);
+    }
+}
+
+void RebuildSceneBounds(AppState* app) {
+    if (!app) return;
+
+    ClearBvh(&app->sceneBounds);
+    for (uint32_t slot = 0; slot < app->sceneProxyCapacity; slot++) app->sceneProxies[slot] = BVH_NULL_PROXY;
+
+    for (EcsQuery q = EcsQueryBegin(&app->scene, ECS_MASK(COMPONENT_TRANSFORM) | ECS_MASK(COMPONENT_SPRITE), 0); EcsQueryNext(&q);) {
+        const TransformComponent* transforms = EcsQueryColumn(&q, COMPONENT_TRANSFORM);
+        const SpriteComponent* sprites = EcsQueryColumn(&q, COMPONENT_SPRITE);
+
+        for (uint32_t i = 0; i < q.count; i++) {
+            uint32_t slot = q.entities[i].index;
+            if (!ReserveSceneProxies(app, slot)) continue;
+            app->sceneProxies[slot] = BvhAppend(&app->sceneBounds, SpriteBounds(&transforms[i], &sprites[i]), slot);
+        }
+    }
+    BvhRebuild(&app->sceneBounds);
+}
+
+Vector2 SceneScreenToWorld(const AppState* app, Rectangle view, Vector2 point) {
+    if (!app) return point;
+    float zoom = app->sceneZoom > 0.0f ? app->sceneZoom : 1.0f;
+    return (Vector2){
+        (point.x - view.x - view.width * 0.5f) / zoom + app->sceneScrollPosition.x,
+        (point.y - view.y - view.height * 0.5f) / zoom + app->sceneScrollPosition.y
+    };
+}
+
+typedef struct {
+    AppState* app;
+    Vector2 point;
+    uint32_t slot;
+    bool found;
+} ScenePick;
+
+// Sprites draw in slot order, so the highest slot under the point is on top
+static bool PickCallback(void* user, int32_t proxy, uint32_t slot) {
+    ScenePick* pick = user;
+    (void)proxy;
+    if (pick->found && slot < pick->slot) return true;
+
+    const TransformComponent* t;
+    const SpriteComponent* sprite;
+    if (GetSpriteShape(pick->app, EcsEntityAt(&pick->app->scene, slot), &t, &sprite) && SpriteContains(t, sprite, pick->point)) {
+        pick->slot = slot;
+        pick->found = true;
+    }
+    return true;
+}
+
+Entity PickSceneEntity(AppState* app, Vector2 point) {
+    if (!app) return ECS_NULL_ENTITY;
+    ScenePick pick = { app, point, 0, false };
+    BvhQueryPoint(&app->sceneBounds, point, PickCallback, &pick);
+    return pick.found ? EcsEntityAt(&app->scene, pick.slot) : ECS_NULL_ENTITY;
+}
+
+typedef struct {
+    AppState* app;
+    Rectangle area;
+    Entity* results;
+    int maxResults;
+    int count;
+} SceneQuery;
+
+static bool QueryCallback(void* user, int32_t proxy, uint32_t slot) {
+    SceneQuery* query = user;
+    (void)proxy;
+
+    // The index holds fattened boxes; check against the sprite's own
+    Entity entity = EcsEntityAt(&query->app->scene, slot);
+    const TransformComponent* t;
+    const SpriteComponent* sprite;
+    if (!GetSpriteShape(query->app, entity, &t, &sprite) || !CheckCollisionRecs(SpriteBounds(t, sprite), query->area)) return true;
+
+    if (query->count < query->maxResults) query->results[query->count] = entity;
+    query->count++;
+    return true;
+}
+
+int QuerySceneEntities(AppState* app, Rectangle area, Entity* results, int maxResults) {
+    if (!app) return 0;
+    SceneQuery query = { app, area, results, results ? maxResults : 0, 0 };
+    BvhQueryRect(&app->sceneBounds, area, QueryCallback, &query);
+    return query.count;
+}
+
+static bool CollectVisible(void* user, int32_t proxy, uint32_t slot) {
+    AppState* app = user;
+    (void)proxy;
+
+    if (app->sceneVisibleCount == app->sceneVisibleCapacity) {
+        uint32_t capacity = app->sceneVisibleCapacity ? app->sceneVisibleCapacity * 2 : 1024;
+        uint32_t* visible = realloc(app->sceneVisible, capacity * sizeof(uint32_t));
+        if (!visible) return false;
+        app->sceneVisible = visible;
+        app->sceneVisibleCapacity = capacity;
+    }
+    app->sceneVisible[app->sceneVisibleCount++] = slot;
+    return true;
+}
+
+static int CompareSlots(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void DrawScene(AppState* app, Rectangle view) {
+    if (!app) return;
+    PROFILE_SCOPE("DrawScene");
+
+    float zoom = app->sceneZoom > 0.0f ? app->sceneZoom : 1.0f;
+    Vector2 origin = {
+        view.x + view.width * 0.5f - app->sceneScrollPosition.x * zoom,
+        view.y + view.height * 0.5f - app->sceneScrollPosition.y * zoom
+    };
+
+    // Only entities whose bounds reach the view are visited, drawn in slot
+    // order so overlapping sprites keep their stacking as the tree changes
+    Rectangle visibleArea = { app->sceneScrollPosition.x - view.width * 0.5f / zoom,
+                              app->sceneScrollPosition.y - view.height * 0.5f / zoom,
+                              view.width / zoom, view.height / zoom };
+    app->sceneVisibleCount = 0;
+    BvhQueryRect(&app->sceneBounds, visibleArea, CollectVisible, app);
+    if (app->sceneVisibleCount > 1) qsort(app->sceneVisible, app->sceneVisibleCount, sizeof(uint32_t), CompareSlots);
+
+    BeginScissorMode((int)view.x, (int)view.y, (int)view.width, (int)view.height);
+    for (uint32_t i = 0; i < app->sceneVisibleCount; i++) {
+        Entity entity = EcsEntityAt(&app->scene, app->sceneVisible[i]);
+        const TransformComponent* t;
+        const SpriteComponent* sprite;
+        if (!GetSpriteShape(app, entity, &t, &sprite)) continue;
+
+        float width = sprite->size.x * t->scale.x * zoom;
+        float height = sprite->size.y * t->scale.y * zoom;
+        Rectangle rect = { origin.x + t->position.x * zoom, origin.y + t->position.y * zoom, width, height };
+        DrawRectanglePro(rect, (Vector2){ width * 0.5f, height * 0.5f }, t->rotation, sprite->tint);
+
+        if (PoolHandleEqual(entity, app->selectedEntity)) {
+            DrawRectangleLines((int)(rect.x - width * 0.5f), (int)(rect.y - height * 0.5f), (int)width, (int)height, COLOR_ACCENT);
+        }
+    }
+    EndScissorMode();
+}
+
+// Called before a field changes; dragging a field undoes as one step
+static void CaptureFieldEdit(AppState* app, Entity entity, int type, const EcsField* field) {
+    char label[32];
+    snprintf(label, sizeof(label), "Edit %s", field->name);
+    HistoryLabel(app, label, HistoryMergeKey(JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type, field->offset));
+    HistoryCapture(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type);
+}
+
+static void DrawFieldValue(AppState* app, Entity entity, int type, const EcsField* field, unsigned char* component, Rectangle row) {
+    Rectangle valueRect = { row.x + PROPERTY_LABEL_WIDTH, row.y + 2, row.width - PROPERTY_LABEL_WIDTH - 4, row.height - 4 };
+    Vector2 mouse = GetMousePosition();
+    bool hovered = CheckCollisionPointRec(mouse, valueRect);
+    unsigned char* data = component + field->offset;
+    bool changed = false;
+    char text[64];
+
+    switch (field->type) {
+        case ECS_FIELD_FLOAT:
+        case ECS_FIELD_INT: {
+            float value = field->type == ECS_FIELD_FLOAT ? *(float*)data : (float)*(int32_t*)data;
+            bool ranged = field->max > field->min;
+
+            UiDrawRectangle(valueRect, COLOR_PANEL_HEADER);
+            if (ranged) {
+                float t = (value - field->min) / (field->max - field->min);
+                UiDrawRectangle((Rectangle){ valueRect.x, valueRect.y, valueRect.width * fminf(fmaxf(t, 0.0f), 1.0f), valueRect.height },
+                                COLOR_ACCENT);
+            }
+
+            // Ranged fields follow the mouse, unranged ones are dragged by delta
+            if (hovered && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+                float next = ranged
+                    ? field->min + (mouse.x - valueRect.x) / valueRect.width * (field->max - field->min)
+                    : value + GetMouseDelta().x;
+                if (ranged) next = fminf(fmaxf(next, field->min), field->max);
+                if (field->type == ECS_FIELD_INT) next = roundf(next);
+                if (next != value) {
+                    CaptureFieldEdit(app, entity, type, field);
+                    if (field->type == ECS_FIELD_FLOAT) *(float*)data = next;
+                    else *(int32_t*)data = (int32_t)next;
+                    value = next;
+                    changed = true;
+                }
+            }
+
+            if (field->type == ECS_FIELD_FLOAT) snprintf(text, sizeof(text), "%.2f", value);
+            else snprintf(text, sizeof(text), "%d", (int)value);
+            UiDrawText(text, valueRect.x + 4, valueRect.y + 3, 12, COLOR_TEXT);
+            break;
+        }
+        case ECS_FIELD_BOOL: {
+            Rectangle box = { valueRect.x, valueRect.y, valueRect.height, valueRect.height };
+            UiDrawRectangleLines(box, 1, COLOR_TEXT_DIM);
+            if (*data) UiDrawRectangle((Rectangle){ box.x + 3, box.y + 3, box.width - 6, box.height - 6 }, COLOR_ACCENT);
+            if (CheckCollisionPointRec(mouse, box) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                CaptureFieldEdit(app, entity, type, field);
+                *data = !*data;
+                changed = true;
+            }
+            break;
+        }
+        case ECS_FIELD_COLOR:
+            UiDrawRectangle(valueRect, *(Color*)data);
+            UiDrawRectangleLines(valueRect, 1, COLOR_TEXT_DIM);
+            break;
+        case ECS_FIELD_STRING:
+            UiDrawText((const char*)data, valueRect.x + 4, valueRect.y + 3, 12, COLOR_TEXT);
+            break;
+    }
+
+    if (changed) {
+        RecordProjectChange(app, JOURNAL_OBJECT_COMPONENT, entity.index, (uint32_t)type, field->offset, data, field->size);
+        if (IsSpatialComponent(type)) UpdateSceneBounds(app, entity);
+    }
+}
+
+void DrawPropertyEditor(AppState* app, Entity entity, int componentType, Rectangle bounds) {
+    if (!app || componentType < 0 || componentType >= app->scene.typeCount) return;
+    PROFILE_SCOPE("DrawPropertyEditor");
+
+    unsigned char* component = EcsGetComponent(&app->scene, entity, componentType);
+    if (!component) return;
+
+    const EcsComponentInfo* info = &app->scene.types[componentType];
+    UiDrawRectangle((Rectangle){ bounds.x, bounds.y, bounds.width, PROPERTY_ROW_HEIGHT }, COLOR_PANEL_HEADER);
+    UiDrawText(info->name, bounds.x + 4, bounds.y + 4, 14, COLOR_TEXT);
+
+    // Field names and ranges come from the type, only the values live in the column
+    for (int f = 0; f < info->fieldCount; f++) {
+        Rectangle row = { bounds.x, bounds.y + (f + 1) * PROPERTY_ROW_HEIGHT, bounds.width, PROPERTY_ROW_HEIGHT };
+        if (row.y + row.height > bounds.y + bounds.height) break;
+        UiDrawText(info->fields[f].name, row.x + 8, row.y + 5, 12, COLOR_TEXT_DIM);
+        DrawFieldValue(app, entity, componentType, &info->fields[f], component, row);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "app_state.h"
+
+#define SCENE_BOUNDS_MARGIN 8.0f    // World units a sprite may drift before its bounds are reinserted
+#define PROPERTY_ROW_HEIGHT 22      // DrawPropertyEditor uses one row per field plus a header
+
+// Scene component types. Values are stored in the project file and the
+// journal, so new types go at the end.
+typedef enum {
+    COMPONENT_NAME,
+    COMPONENT_EDITOR,
+    COMPONENT_TRANSFORM,
+    COMPONENT_SPRITE,
+    COMPONENT_AUDIO_SOURCE,
+    COMPONENT_TYPE_COUNT
+} SceneComponentType;
+
+// Component layouts are saved as raw bytes, so they only use fixed-size
+// fields and never hold pointers. Assets are referenced by pool slot, -1 for none.
+typedef struct {
+    char value[64];
+} NameComponent;
+
+typedef struct {
+    uint8_t selected;
+    uint8_t folded;
+    uint8_t reserved[2];
+    uint32_t foldedComponents;  // Bit per component type folded in the inspector
+} EditorComponent;
+
+typedef struct {
+    Vector2 position;
+    float rotation;
+    Vector2 scale;
+} TransformComponent;
+
+typedef struct {
+    int32_t asset;
+    Color tint;
+    Vector2 size;
+} SpriteComponent;
+
+typedef struct {
+    int32_t asset;
+    float volume;
+    float pan;
+    uint8_t loop;
+    uint8_t playOnStart;
+    uint8_t reserved[2];
+} AudioSourceComponent;
+
+extern const EcsComponentInfo SCENE_COMPONENT_TYPES[COMPONENT_TYPE_COUNT];
+
+// Scene editing, every change is journaled
+Entity CreateSceneEntity(AppState* app, const char* name);
+void DestroySceneEntity(AppState* app, Entity entity);
+void* AddSceneComponent(AppState* app, Entity entity, SceneComponentType type);
+void RemoveSceneComponent(AppState* app, Entity entity, SceneComponentType type);
+void RecordSceneComponent(AppState* app, Entity entity, SceneComponentType type);
+
+// Spatial index over entities with a transform and a sprite. The editing
+// calls above keep it current; code that changes those components without
+// them calls UpdateSceneBounds, and bulk loads call RebuildSceneBounds.
+void UpdateSceneBounds(AppState* app, Entity entity);
+void RebuildSceneBounds(AppState* app);
+
+// Picking and marquee selection in world coordinates
+Vector2 SceneScreenToWorld(const AppState* app, Rectangle view, Vector2 point);
+Entity PickSceneEntity(AppState* app, Vector2 point);      // Topmost sprite under the point
+// Entities whose bounds overlap area, in no particular order; returns the
+// total number of hits (which may exceed maxResults)
+int QuerySceneEntities(AppState* app, Rectangle area, Entity* results, int maxResults);
+
+// Systems
+void DrawScene(AppState* app, Rectangle view);
+
+#endif // SCENE_H
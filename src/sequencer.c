@@ -0,0 +1,760 @@
+#include "sequencer.h"
+#include "spsc_queue.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SEQUENCER_RETIRED_CAPACITY 8
+#define SEQUENCER_ATTACK_SECONDS 0.005f
+#define SEQUENCER_RELEASE_SECONDS 0.05f
+#define SEQUENCER_VOICE_GAIN 0.2f
+#define SEQUENCER_TWO_PI 6.28318530718f
+
+typedef enum {
+    EVENT_NOTE_OFF,             // Sorts before ons at the same frame so repeated notes retrigger
+    EVENT_NOTE_ON,
+    EVENT_CLIP_END              // Block-only, releases what the clip still holds
+} SequencerEventType;
+
+typedef struct {
+    uint32_t frame;             // From the pattern start
+    uint8_t type;
+    uint8_t pitch;
+    uint8_t velocity;
+} SequencerEvent;
+
+// Immutable once compiled; arrangements share it by reference count
+typedef struct {
+    int refs;                   // UI thread only
+    uint32_t lengthFrames;      // Whole bars, at least one
+    uint32_t eventCount;
+    SequencerEvent events[];
+} CompiledPattern;
+
+typedef struct {
+    uint64_t start;             // Timeline frames
+    uint64_t end;
+    uint64_t maxEnd;            // Largest end in this clip's subtree of the arrangement tree
+    uint64_t offset;            // Pattern frames already played at start
+    CompiledPattern* pattern;
+
+    // Audio thread
+    uint32_t cursor;            // Next event in the pattern
+    uint64_t cursorFrame;       // Timeline frame the cursor is valid for
+} SequencerClip;
+
+// The clips sorted by start double as an implicit balanced tree: the clip in
+// the middle of a range is its root, the halves on either side its subtrees.
+// With each clip's maxEnd covering its subtree, finding the clips playing at
+// a frame after a jump costs O(log n + playing), however long the clips are.
+typedef struct {
+    int clipCount;
+    int* playing;               // Audio thread: heap of clip indices by end, room for every clip
+    SequencerClip clips[];      // Sorted by start
+} SequencerArrangement;
+
+typedef struct {
+    bool active;
+    bool releasing;
+    uint8_t pitch;
+    uint64_t clipStart;         // Identifies the clip across arrangements
+    uint64_t clipEnd;
+    uint64_t age;
+    float phase;
+    float step;                 // Radians per frame
+    float level;
+    float target;
+} SequencerVoice;
+
+typedef struct {
+    int offset;                 // Frames into the block
+    uint8_t type;
+    uint8_t pitch;
+    uint8_t velocity;
+    uint64_t clipStart;
+    uint64_t clipEnd;
+} BlockEvent;
+
+typedef struct {
+    Sequencer* sequencer;
+    _Atomic(SequencerArrangement*) pending;     // Set by the UI thread, taken by the audio thread
+    SpscQueue retired;                          // Arrangements the audio thread is done with
+
+    // Audio thread
+    SequencerArrangement* current;
+    uint64_t nextFrame;         // Where the last block ended
+    int nextClip;               // First clip that has not started by nextFrame
+    int playingCount;           // Clips started but not ended by nextFrame, in current->playing
+    uint64_t noteCount;
+    SequencerVoice voices[SEQUENCER_MAX_VOICES];
+    BlockEvent events[SEQUENCER_BLOCK_EVENTS];
+    int eventCount;
+
+    // UI thread
+    uint64_t layoutHash;        // Of the last published arrangement
+    bool published;
+} SequencerTrack;
+
+typedef struct {
+    int id;
+    uint64_t notesHash;
+    CompiledPattern* compiled;
+} PatternEntry;
+
+typedef struct {
+    int id;
+    uint32_t slot;              // Into entries
+} PatternSlot;
+
+struct Sequencer {
+    int sampleRate;
+    float attackStep;           // Level per frame at full velocity
+    float releaseStep;
+    SequencerTrack tracks[MAX_TIMELINE_TRACKS];
+
+    // Written by the audio thread
+    atomic_uint_least64_t events;
+    atomic_uint_least64_t droppedEvents;
+
+    // UI thread
+    PatternEntry* entries;      // By pattern slot
+    uint32_t entryCount;
+    int* trackElements;         // Scratch for one track's elements in start order
+    int trackElementCapacity;
+    PatternSlot* patternSlots;  // Compiled patterns sorted by id
+    int patternSlotCount;
+    int patternSlotCapacity;
+    uint64_t tempoHash;
+    bool synced;                // Nothing below changed since the tracks were last arranged
+    uint32_t editVersion;       // AppState.editVersion when they were
+    uint32_t patternsVersion;
+    uint32_t elementsVersion;
+    int patterns;
+    uint64_t compiles;
+    uint64_t publishes;
+};
+
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#define SEQUENCER_HASH_BASIS 14695981039346656037ull
+
+static uint64_t SecondsToFrames(const Sequencer* sequencer, float seconds) {
+    return seconds > 0.0f ? (uint64_t)((double)seconds * sequencer->sampleRate + 0.5) : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Audio thread
+//----------------------------------------------------------------------------------
+
+static void StartVoice(SequencerTrack* track, const BlockEvent* event) {
+    SequencerVoice* voice = NULL;
+    for (int i = 0; i < SEQUENCER_MAX_VOICES; i++) {
+        SequencerVoice* candidate = &track->voices[i];
+        if (!candidate->active) {
+            voice = candidate;
+            break;
+        }
+        if (!voice || candidate->age < voice->age) voice = candidate;
+    }
+
+    // A stolen voice glides on from its current level and phase, so there is no click
+    if (!voice->active) {
+        voice->level = 0.0f;
+        voice->phase = 0.0f;
+    }
+    voice->active = true;
+    voice->releasing = false;
+    voice->pitch = event->pitch;
+    voice->clipStart = event->clipStart;
+    voice->clipEnd = event->clipEnd;
+    voice->age = ++track->noteCount;
+    float frequency = 440.0f * powf(2.0f, ((float)event->pitch - 69.0f) / 12.0f);
+    voice->step = SEQUENCER_TWO_PI * frequency / (float)track->sequencer->sampleRate;
+    voice->target = SEQUENCER_VOICE_GAIN * (float)event->velocity / 127.0f;
+}
+
+static void ApplyEvent(SequencerTrack* track, const BlockEvent* event) {
+    if (event->type == EVENT_NOTE_ON) {
+        StartVoice(track, event);
+        return;
+    }
+
+    // A note off releases the oldest held note of that pitch in that clip
+    SequencerVoice* oldest = NULL;
+    for (int i = 0; i < SEQUENCER_MAX_VOICES; i++) {
+        SequencerVoice* voice = &track->voices[i];
+        if (!voice->active || voice->releasing || voice->clipStart != event->clipStart) continue;
+        if (event->type == EVENT_CLIP_END) {
+            voice->releasing = true;
+        } else if (voice->pitch == event->pitch && (!oldest || voice->age < oldest->age)) {
+            oldest = voice;
+        }
+    }
+    if (oldest) oldest->releasing = true;
+}
+
+static void RenderVoices(SequencerTrack* track, float* left, float* right, int frames) {
+    if (frames <= 0) return;
+    const float attackStep = track->sequencer->attackStep;
+    const float releaseStep = track->sequencer->releaseStep;
+
+    for (int v = 0; v < SEQUENCER_MAX_VOICES; v++) {
+        SequencerVoice* voice = &track->voices[v];
+        if (!voice->active) continue;
+
+        for (int i = 0; i < frames; i++) {
+            if (voice->releasing) {
+                voice->level -= releaseStep;
+                if (voice->level <= 0.0f) {
+                    voice->active = false;
+                    break;
+                }
+            } else if (voice->level < voice->target) {
+                voice->level = fminf(voice->level + attackStep, voice->target);
+            } else if (voice->level > voice->target) {
+                voice->level = fmaxf(voice->level - releaseStep, voice->target);
+            }
+
+            float sample = sinf(voice->phase) * voice->level;
+            voice->phase += voice->step;
+            if (voice->phase >= SEQUENCER_TWO_PI) voice->phase -= SEQUENCER_TWO_PI;
+            left[i] += sample;
+            right[i] += sample;
+        }
+    }
+}
+
+static void PushBlockEvent(SequencerTrack* track, const SequencerClip* clip, int offset, uint8_t type,
+                           uint8_t pitch, uint8_t velocity) {
+    if (track->eventCount >= SEQUENCER_BLOCK_EVENTS) {
+        atomic_fetch_add_explicit(&track->sequencer->droppedEvents, 1, memory_order_relaxed);
+        return;
+    }
+    track->events[track->eventCount++] = (BlockEvent){
+        .offset = offset, .type = type, .pitch = pitch, .velocity = velocity,
+        .clipStart = clip->start, .clipEnd = clip->end
+    };
+}
+
+// First event at or after a pattern frame
+static uint32_t FindEvent(const CompiledPattern* pattern, uint32_t frame) {
+    uint32_t lo = 0, hi = pattern->eventCount;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (pattern->events[mid].frame < frame) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Events of one clip in [from, to), a range inside both the clip and the block.
+// The cursor carries over from the previous block, so only a jump searches.
+static void GatherClipEvents(SequencerTrack* track, SequencerClip* clip, uint64_t blockFrame, uint64_t from, uint64_t to) {
+    const CompiledPattern* pattern = clip->pattern;
+    uint32_t length = pattern->lengthFrames;
+    uint32_t position = (uint32_t)((from - clip->start + clip->offset) % length);
+    if (clip->cursorFrame != from) clip->cursor = FindEvent(pattern, position);
+
+    uint64_t at = from;
+    while (at < to) {
+        uint32_t span = (uint32_t)(to - at < length - position ? to - at : length - position);
+        while (clip->cursor < pattern->eventCount && pattern->events[clip->cursor].frame < position + span) {
+            const SequencerEvent* event = &pattern->events[clip->cursor++];
+            int offset = (int)(at - blockFrame) + (int)(event->frame - position);
+            PushBlockEvent(track, clip, offset, event->type, event->pitch, event->velocity);
+        }
+        at += span;
+        position += span;
+        if (position == length) {
+            position = 0;
+            clip->cursor = 0;
+        }
+    }
+    clip->cursorFrame = to;
+
+    if (clip->end <= to) PushBlockEvent(track, clip, (int)(clip->end - blockFrame) - 1, EVENT_CLIP_END, 0, 0);
+}
+
+// First clip starting at or after a frame
+static int FindClipStart(const SequencerArrangement* arrangement, uint64_t frame) {
+    int lo = 0, hi = arrangement->clipCount;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (arrangement->clips[mid].start < frame) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static bool HasClip(const SequencerArrangement* arrangement, uint64_t start, uint64_t end) {
+    for (int i = FindClipStart(arrangement, start); i < arrangement->clipCount && arrangement->clips[i].start == start; i++) {
+        if (arrangement->clips[i].end == end) return true;
+    }
+    return false;
+}
+
+static void PushPlaying(SequencerTrack* track, SequencerArrangement* arrangement, int clip) {
+    int* heap = arrangement->playing;
+    int i = track->playingCount++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (arrangement->clips[heap[parent]].end <= arrangement->clips[clip].end) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = clip;
+}
+
+static void PopPlaying(SequencerTrack* track, SequencerArrangement* arrangement) {
+    int* heap = arrangement->playing;
+    int last = heap[--track->playingCount];
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= track->playingCount) break;
+        if (child + 1 < track->playingCount && arrangement->clips[heap[child + 1]].end < arrangement->clips[heap[child]].end) child++;
+        if (arrangement->clips[last].end <= arrangement->clips[heap[child]].end) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+}
+
+// Clips in [from, to) that started before a frame and end after it
+static void CollectPlaying(SequencerTrack* track, SequencerArrangement* arrangement, int from, int to, uint64_t frame) {
+    while (from < to) {
+        int mid = from + (to - from) / 2;
+        const SequencerClip* clip = &arrangement->clips[mid];
+        if (clip->maxEnd <= frame) return;
+        CollectPlaying(track, arrangement, from, mid, frame);
+        if (clip->start >= frame) return;       // So does everything after it
+        if (clip->end > frame) PushPlaying(track, arrangement, mid);
+        from = mid + 1;
+    }
+}
+
+// After a jump or a new arrangement
+static void SeekArrangement(SequencerTrack* track, uint64_t frame) {
+    track->playingCount = 0;
+    track->nextClip = 0;
+    SequencerArrangement* arrangement = track->current;
+    if (!arrangement) return;
+    CollectPlaying(track, arrangement, 0, arrangement->clipCount, frame);
+    track->nextClip = FindClipStart(arrangement, frame);
+}
+
+static void TakePendingArrangement(SequencerTrack* track) {
+    if (!atomic_load_explicit(&track->pending, memory_order_relaxed)) return;
+    if (SpscCount(&track->retired) >= SEQUENCER_RETIRED_CAPACITY) return;      // Wait for the UI to drain it
+
+    SequencerArrangement* next = atomic_exchange_explicit(&track->pending, NULL, memory_order_acquire);
+    if (!next) return;
+    if (track->current) SpscPush(&track->retired, &track->current);
+    track->current = next;
+    SeekArrangement(track, track->nextFrame);
+
+    // Notes of clips that were edited away would never see their note off
+    for (int i = 0; i < SEQUENCER_MAX_VOICES; i++) {
+        SequencerVoice* voice = &track->voices[i];
+        if (voice->active && !HasClip(next, voice->clipStart, voice->clipEnd)) voice->releasing = true;
+    }
+}
+
+static int RenderSequencerTrack(void* user, uint64_t frame, float* left, float* right, int frames) {
+    SequencerTrack* track = user;
+    TakePendingArrangement(track);
+
+    SequencerArrangement* arrangement = track->current;
+    if (frame != track->nextFrame) {
+        for (int i = 0; i < SEQUENCER_MAX_VOICES; i++) {
+            if (track->voices[i].active) track->voices[i].releasing = true;
+        }
+        SeekArrangement(track, frame);
+    }
+    track->nextFrame = frame + (uint64_t)frames;
+
+    // Clips that ended leave the heap, the ones starting in this block join
+    // it, and only the heap is visited
+    track->eventCount = 0;
+    if (arrangement) {
+        uint64_t blockEnd = frame + (uint64_t)frames;
+        while (track->playingCount > 0 && arrangement->clips[arrangement->playing[0]].end <= frame) {
+            PopPlaying(track, arrangement);
+        }
+        while (track->nextClip < arrangement->clipCount && arrangement->clips[track->nextClip].start < blockEnd) {
+            PushPlaying(track, arrangement, track->nextClip++);
+        }
+        for (int i = 0; i < track->playingCount; i++) {
+            SequencerClip* clip = &arrangement->clips[arrangement->playing[i]];
+            uint64_t from = clip->start > frame ? clip->start : frame;
+            uint64_t to = clip->end < blockEnd ? clip->end : blockEnd;
+            GatherClipEvents(track, clip, frame, from, to);
+        }
+    }
+
+    // Each clip's events are in order already; merging them by insertion is
+    // cheap for the handful a block usually holds. Ties go by clip start, as
+    // the heap visits clips in no particular order.
+    for (int i = 1; i < track->eventCount; i++) {
+        BlockEvent event = track->events[i];
+        int j = i;
+        while (j > 0 && (track->events[j - 1].offset > event.offset ||
+                         (track->events[j - 1].offset == event.offset && track->events[j - 1].clipStart > event.clipStart))) {
+            track->events[j] = track->events[j - 1];
+            j--;
+        }
+        track->events[j] = event;
+    }
+
+    memset(left, 0, (size_t)frames * sizeof(float));
+    memset(right, 0, (size_t)frames * sizeof(float));
+    int rendered = 0;
+    for (int i = 0; i < track->eventCount; i++) {
+        const BlockEvent* event = &track->events[i];
+        RenderVoices(track, left + rendered, right + rendered, event->offset - rendered);
+        if (event->offset > rendered) rendered = event->offset;
+        ApplyEvent(track, event);
+    }
+    RenderVoices(track, left + rendered, right + rendered, frames - rendered);
+    if (track->eventCount > 0) atomic_fetch_add_explicit(&track->sequencer->events, (uint64_t)track->eventCount, memory_order_relaxed);
+    return frames;
+}
+
+//----------------------------------------------------------------------------------
+// UI thread
+//----------------------------------------------------------------------------------
+
+static void ReleasePattern(Sequencer* sequencer, CompiledPattern* pattern) {
+    if (pattern && --pattern->refs == 0) {
+        free(pattern);
+        sequencer->patterns--;
+    }
+}
+
+static void FreeArrangement(Sequencer* sequencer, SequencerArrangement* arrangement) {
+    if (!arrangement) return;
+    for (int i = 0; i < arrangement->clipCount; i++) ReleasePattern(sequencer, arrangement->clips[i].pattern);
+    free(arrangement);
+}
+
+static int CompareEvents(const void* a, const void* b) {
+    const SequencerEvent* ea = a;
+    const SequencerEvent* eb = b;
+    if (ea->frame != eb->frame) return ea->frame < eb->frame ? -1 : 1;
+    return (int)ea->type - (int)eb->type;
+}
+
+static CompiledPattern* CompilePattern(Sequencer* sequencer, const Pattern* pattern, const TimelineState* timeline) {
+    float bpm = timeline->bpm > 0.0f ? timeline->bpm : 120.0f;
+    float numerator = timeline->timeSignatureNumerator >= 1.0f ? timeline->timeSignatureNumerator : 4.0f;
+    float denominator = timeline->timeSignatureDenominator >= 1.0f ? timeline->timeSignatureDenominator : 4.0f;
+    double framesPerStep = 60.0 / bpm * sequencer->sampleRate / PATTERN_STEPS_PER_BEAT;
+
+    // Patterns last whole bars, so one that loops keeps the downbeat
+    uint32_t barSteps = (uint32_t)(numerator * 4.0f / denominator * PATTERN_STEPS_PER_BEAT + 0.5f);
+    if (barSteps == 0) barSteps = 1;
+    uint32_t lengthSteps = barSteps;
+    for (int i = 0; i < pattern->noteCount; i++) {
+        uint32_t end = PATTERN_NOTE_STEP(pattern->notes[i]) + PATTERN_NOTE_LENGTH(pattern->notes[i]);
+        if (end > lengthSteps) lengthSteps = (end + barSteps - 1) / barSteps * barSteps;
+    }
+    double lengthFrames = lengthSteps * framesPerStep;
+    if (lengthFrames < 1.0 || lengthFrames > UINT32_MAX) {
+        TraceLog(LOG_WARNING, "SEQUENCER: Pattern %d is %.0f frames long, skipped", pattern->id, lengthFrames);
+        return NULL;
+    }
+
+    size_t count = (size_t)pattern->noteCount * 2;
+    CompiledPattern* compiled = malloc(sizeof(CompiledPattern) + count * sizeof(SequencerEvent));
+    if (!compiled) return NULL;
+    compiled->refs = 1;
+    compiled->lengthFrames = (uint32_t)lengthFrames;
+    compiled->eventCount = (uint32_t)count;
+
+    for (int i = 0; i < pattern->noteCount; i++) {
+        int note = pattern->notes[i];
+        uint32_t step = PATTERN_NOTE_STEP(note);
+        uint32_t on = (uint32_t)(step * framesPerStep + 0.5);
+        uint32_t off = (uint32_t)((step + PATTERN_NOTE_LENGTH(note)) * framesPerStep + 0.5);
+
+        // A note held to the end of the pattern ends just before it loops
+        if (off >= compiled->lengthFrames) off = compiled->lengthFrames - 1;
+        if (on >= off) on = off > 0 ? off - 1 : 0;
+        uint8_t pitch = (uint8_t)PATTERN_NOTE_PITCH(note);
+        uint8_t velocity = (uint8_t)PATTERN_NOTE_VELOCITY(note);
+        compiled->events[i * 2] = (SequencerEvent){ on, EVENT_NOTE_ON, pitch, velocity };
+        compiled->events[i * 2 + 1] = (SequencerEvent){ off, EVENT_NOTE_OFF, pitch, 0 };
+    }
+    qsort(compiled->events, count, sizeof(SequencerEvent), CompareEvents);
+
+    sequencer->patterns++;
+    sequencer->compiles++;
+    return compiled;
+}
+
+static int ComparePatternSlots(const void* a, const void* b) {
+    const PatternSlot* x = a;
+    const PatternSlot* y = b;
+    if (x->id != y->id) return x->id < y->id ? -1 : 1;
+    return x->slot < y->slot ? -1 : (x->slot > y->slot);
+}
+
+// Compiled patterns by id, so arranging a track costs a search per element
+static void IndexPatterns(Sequencer* sequencer) {
+    if ((int)sequencer->entryCount > sequencer->patternSlotCapacity) {
+        PatternSlot* slots = realloc(sequencer->patternSlots, sequencer->entryCount * sizeof(PatternSlot));
+        if (!slots) {
+            sequencer->patternSlotCount = 0;
+            return;
+        }
+        sequencer->patternSlots = slots;
+        sequencer->patternSlotCapacity = (int)sequencer->entryCount;
+    }
+    int count = 0;
+    for (uint32_t slot = 0; slot < sequencer->entryCount; slot++) {
+        if (sequencer->entries[slot].compiled) sequencer->patternSlots[count++] = (PatternSlot){ sequencer->entries[slot].id, slot };
+    }
+    qsort(sequencer->patternSlots, count, sizeof(PatternSlot), ComparePatternSlots);
+    sequencer->patternSlotCount = count;
+}
+
+static uint64_t HashTempo(const TimelineState* timeline) {
+    uint64_t hash = SEQUENCER_HASH_BASIS;
+    hash = HashBytes(hash, &timeline->bpm, sizeof(float));
+    hash = HashBytes(hash, &timeline->timeSignatureNumerator, sizeof(float));
+    return HashBytes(hash, &timeline->timeSignatureDenominator, sizeof(float));
+}
+
+static void UpdatePatterns(Sequencer* sequencer, const AppState* app) {
+    uint64_t tempoHash = HashTempo(&app->timeline);
+    bool tempoChanged = tempoHash != sequencer->tempoHash;
+    sequencer->tempoHash = tempoHash;
+
+    uint32_t slotCount = app->patterns.slotCount;
+    if (slotCount > sequencer->entryCount) {
+        PatternEntry* entries = realloc(sequencer->entries, slotCount * sizeof(PatternEntry));
+        if (!entries) {
+            sequencer->synced = false;
+            return;
+        }
+        memset(entries + sequencer->entryCount, 0, (slotCount - sequencer->entryCount) * sizeof(PatternEntry));
+        sequencer->entries = entries;
+        sequencer->entryCount = slotCount;
+    }
+
+    bool changed = false;
+    for (uint32_t slot = 0; slot < sequencer->entryCount; slot++) {
+        PatternEntry* entry = &sequencer->entries[slot];
+        const Pattern* pattern = slot < slotCount ? PoolAt(&app->patterns, slot) : NULL;
+        if (!pattern) {
+            changed = changed || entry->compiled;
+            ReleasePattern(sequencer, entry->compiled);
+            entry->compiled = NULL;
+            entry->notesHash = 0;
+            continue;
+        }
+
+        uint64_t hash = HashBytes(SEQUENCER_HASH_BASIS, &pattern->id, sizeof(int));
+        hash = HashBytes(hash, pattern->notes, (size_t)pattern->noteCount * sizeof(int));
+        if (!tempoChanged && entry->compiled && hash == entry->notesHash) continue;
+
+        ReleasePattern(sequencer, entry->compiled);
+        entry->compiled = CompilePattern(sequencer, pattern, &app->timeline);
+        entry->id = pattern->id;
+        entry->notesHash = hash;
+        changed = true;
+    }
+    if (changed) IndexPatterns(sequencer);
+}
+
+static CompiledPattern* FindCompiledPattern(const Sequencer* sequencer, int id) {
+    int lo = 0, hi = sequencer->patternSlotCount;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sequencer->patternSlots[mid].id < id) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == sequencer->patternSlotCount || sequencer->patternSlots[lo].id != id) return NULL;
+    return sequencer->entries[sequencer->patternSlots[lo].slot].compiled;
+}
+
+// The implicit tree over [from, to): each clip's maxEnd covers its subtree
+static uint64_t BuildClipTree(SequencerClip* clips, int from, int to) {
+    if (from >= to) return 0;
+    int mid = from + (to - from) / 2;
+    uint64_t left = BuildClipTree(clips, from, mid);
+    uint64_t right = BuildClipTree(clips, mid + 1, to);
+    uint64_t maxEnd = clips[mid].end;
+    if (left > maxEnd) maxEnd = left;
+    if (right > maxEnd) maxEnd = right;
+    clips[mid].maxEnd = maxEnd;
+    return maxEnd;
+}
+
+// Pattern elements of one track as clips in start order, or NULL if they
+// hash to what the track published last
+static SequencerArrangement* BuildArrangement(Sequencer* sequencer, const AppState* app, int t) {
+    SequencerTrack* track = &sequencer->tracks[t];
+    int elementCount = t < app->trackCount ? GetTimelineTrackCount(&app->timelineIndex, t) : 0;
+    if (elementCount > sequencer->trackElementCapacity) {
+        int* elements = realloc(sequencer->trackElements, (size_t)elementCount * sizeof(int));
+        if (!elements) {
+            sequencer->synced = false;
+            return NULL;
+        }
+        sequencer->trackElements = elements;
+        sequencer->trackElementCapacity = elementCount;
+    }
+    if (elementCount > 0) elementCount = QueryTimelineRange(&app->timelineIndex, t, -INFINITY, INFINITY, sequencer->trackElements, elementCount);
+    int count = 0;
+    uint64_t hash = SEQUENCER_HASH_BASIS;
+    SequencerArrangement* arrangement = NULL;
+
+    // Two passes: hash and count, then fill only if the layout changed
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < elementCount; i++) {
+            const TimelineElement* element = PoolAt(&app->elements, (uint32_t)sequencer->trackElements[i]);
+            if (!element || element->type != ELEMENT_TYPE_PATTERN || element->sourceId < 0) continue;
+            CompiledPattern* pattern = FindCompiledPattern(sequencer, element->sourceId);
+            uint64_t start = SecondsToFrames(sequencer, element->startTime);
+            uint64_t end = SecondsToFrames(sequencer, element->startTime + element->duration);
+            if (!pattern || end <= start) continue;
+
+            SequencerClip clip = {
+                .start = start, .end = end, .pattern = pattern,
+                .offset = SecondsToFrames(sequencer, element->sourceOffset),
+                .cursorFrame = UINT64_MAX
+            };
+            if (pass == 0) {
+                hash = HashBytes(hash, &clip.start, sizeof(clip.start));
+                hash = HashBytes(hash, &clip.end, sizeof(clip.end));
+                hash = HashBytes(hash, &clip.offset, sizeof(clip.offset));
+                hash = HashBytes(hash, &clip.pattern, sizeof(clip.pattern));
+                count++;
+                continue;
+            }
+
+            pattern->refs++;
+            arrangement->clips[arrangement->clipCount++] = clip;
+        }
+
+        if (pass == 0) {
+            if (track->published && track->layoutHash == hash) return NULL;
+            track->layoutHash = hash;
+            arrangement = malloc(sizeof(SequencerArrangement) + (size_t)count * (sizeof(SequencerClip) + sizeof(int)));
+            if (!arrangement) {
+                track->published = false;
+                sequencer->synced = false;
+                return NULL;
+            }
+            arrangement->clipCount = 0;
+            arrangement->playing = (int*)(arrangement->clips + count);
+        }
+    }
+    BuildClipTree(arrangement->clips, 0, arrangement->clipCount);
+    return arrangement;
+}
+
+void UpdateSequencer(Sequencer* sequencer, const AppState* app) {
+    if (!sequencer || !app) return;
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SequencerArrangement* old;
+        while (SpscPop(&sequencer->tracks[t].retired, &old)) FreeArrangement(sequencer, old);
+    }
+
+    // Patterns and clips only change through recorded edits, journal replay,
+    // loading (which clears first) and the pools, so most frames stop here
+    // without hashing anything. A failed allocation leaves synced unset so
+    // the next frame tries again.
+    if (sequencer->synced && sequencer->editVersion == app->editVersion &&
+        sequencer->patternsVersion == app->patterns.version && sequencer->elementsVersion == app->elements.version &&
+        sequencer->tempoHash == HashTempo(&app->timeline)) {
+        return;
+    }
+    sequencer->synced = true;
+    sequencer->editVersion = app->editVersion;
+    sequencer->patternsVersion = app->patterns.version;
+    sequencer->elementsVersion = app->elements.version;
+
+    UpdatePatterns(sequencer, app);
+
+    // A recompiled pattern has a new address, which changes the layout hash
+    // of every track that plays it
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SequencerTrack* track = &sequencer->tracks[t];
+        SequencerArrangement* arrangement = BuildArrangement(sequencer, app, t);
+        if (!arrangement) continue;
+
+        // One the audio thread never took is replaced outright
+        SequencerArrangement* unseen = atomic_exchange_explicit(&track->pending, arrangement, memory_order_acq_rel);
+        FreeArrangement(sequencer, unseen);
+        track->published = true;
+        sequencer->publishes++;
+    }
+}
+
+SequencerStats GetSequencerStats(Sequencer* sequencer) {
+    SequencerStats stats = { 0 };
+    if (!sequencer) return stats;
+    stats.patterns = sequencer->patterns;
+    stats.compiles = sequencer->compiles;
+    stats.publishes = sequencer->publishes;
+    stats.events = atomic_load_explicit(&sequencer->events, memory_order_relaxed);
+    stats.droppedEvents = atomic_load_explicit(&sequencer->droppedEvents, memory_order_relaxed);
+    return stats;
+}
+
+Sequencer* CreateSequencer(Mixer* mixer) {
+    if (!mixer) return NULL;
+
+    Sequencer* sequencer = calloc(1, sizeof(Sequencer));
+    if (!sequencer) return NULL;
+    sequencer->sampleRate = GetMixerSampleRate(mixer);
+    sequencer->attackStep = 1.0f / (SEQUENCER_ATTACK_SECONDS * sequencer->sampleRate);
+    sequencer->releaseStep = SEQUENCER_VOICE_GAIN / (SEQUENCER_RELEASE_SECONDS * sequencer->sampleRate);
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SequencerTrack* track = &sequencer->tracks[t];
+        track->sequencer = sequencer;
+        if (!InitSpscQueue(&track->retired, sizeof(SequencerArrangement*), SEQUENCER_RETIRED_CAPACITY)) {
+            TraceLog(LOG_WARNING, "SEQUENCER: Failed to allocate track queues");
+            for (int i = 0; i < t; i++) UnloadSpscQueue(&sequencer->tracks[i].retired);
+            free(sequencer);
+            return NULL;
+        }
+    }
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SetMixerTrackSource(mixer, t, SEQUENCER_MIXER_SLOT, RenderSequencerTrack, &sequencer->tracks[t]);
+    }
+    return sequencer;
+}
+
+void DestroySequencer(Sequencer* sequencer) {
+    if (!sequencer) return;
+
+    for (int t = 0; t < MAX_TIMELINE_TRACKS; t++) {
+        SequencerTrack* track = &sequencer->tracks[t];
+        SequencerArrangement* old;
+        while (SpscPop(&track->retired, &old)) FreeArrangement(sequencer, old);
+        FreeArrangement(sequencer, atomic_load(&track->pending));
+        FreeArrangement(sequencer, track->current);
+        UnloadSpscQueue(&track->retired);
+    }
+    for (uint32_t slot = 0; slot < sequencer->entryCount; slot++) {
+        ReleasePattern(sequencer, sequencer->entries[slot].compiled);
+    }
+    free(sequencer->entries);
+    free(sequencer->trackElements);
+    free(sequencer->patternSlots);
+    free(sequencer);
+}
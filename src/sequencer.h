@@ -0,0 +1,59 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include "app_state.h"
+#include "mixer.h"
+#include <stdint.h>
+
+// Pattern sequencer.
+//
+// Patterns are compiled on the UI thread into sorted lists of note on/off
+// events, timed in frames from the start of the pattern at the current tempo.
+// A pattern is compiled again only when its notes or the tempo change.
+// Pattern elements on the timeline loop their pattern for their duration;
+// each track's elements are handed to the audio thread as an immutable
+// arrangement that replaces the previous one between blocks.
+//
+// On the audio thread every track keeps a cursor into its arrangement and
+// one into each playing pattern, so a block costs the events inside it and
+// nothing for the rest of the song; searching only happens after a jump.
+// Events split the block at their exact frame and play a small built-in synth
+// voice per note.
+
+// Notes are packed into the ints of Pattern.notes
+#define PATTERN_STEPS_PER_BEAT 4
+#define PATTERN_NOTE(step, length, pitch, velocity) \
+    ((int)(((uint32_t)(step) & 0x3FFu) << 22 | (((uint32_t)(length) - 1) & 0xFFu) << 14 | \
+           ((uint32_t)(velocity) & 0x7Fu) << 7 | ((uint32_t)(pitch) & 0x7Fu)))
+#define PATTERN_NOTE_STEP(note)     (((uint32_t)(note) >> 22) & 0x3FFu)
+#define PATTERN_NOTE_LENGTH(note)   ((((uint32_t)(note) >> 14) & 0xFFu) + 1)    // Steps
+#define PATTERN_NOTE_VELOCITY(note) (((uint32_t)(note) >> 7) & 0x7Fu)
+#define PATTERN_NOTE_PITCH(note)    ((uint32_t)(note) & 0x7Fu)                  // MIDI note number
+
+#define SEQUENCER_MIXER_SLOT 1
+#define SEQUENCER_MAX_VOICES 16         // Per track; the oldest note is stolen past this
+#define SEQUENCER_BLOCK_EVENTS 128      // Per track and block; events past this are dropped
+
+typedef struct Sequencer Sequencer;
+
+typedef struct {
+    int patterns;               // Compiled patterns alive, including ones only old arrangements hold
+    uint64_t compiles;
+    uint64_t publishes;         // Arrangements handed to the audio thread
+    uint64_t events;            // Events played
+    uint64_t droppedEvents;
+} SequencerStats;
+
+// Lifetime. Registers itself as a source of every timeline track. The audio
+// thread may hold arrangements until the mixer is gone, so destroy the mixer first.
+Sequencer* CreateSequencer(Mixer* mixer);
+void DestroySequencer(Sequencer* sequencer);
+
+// UI thread, once per frame. Recompiles edited patterns and republishes the
+// tracks whose pattern elements changed; a frame without edits only compares
+// AppState.editVersion and the pool versions.
+void UpdateSequencer(Sequencer* sequencer, const AppState* app);
+
+SequencerStats GetSequencerStats(Sequencer* sequencer);
+
+#endif // SEQUENCER_H
@@ -0,0 +1,52 @@
+#include "spsc_queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool InitSpscQueue(SpscQueue* queue, uint32_t itemSize, uint32_t capacity) {
+    if (!queue || itemSize == 0 || capacity == 0 || capacity > (1u << 30)) return false;
+
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+
+    queue->items = malloc((size_t)size * itemSize);
+    if (!queue->items) return false;
+    queue->itemSize = itemSize;
+    queue->mask = size - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    return true;
+}
+
+void UnloadSpscQueue(SpscQueue* queue) {
+    if (!queue) return;
+    free(queue->items);
+    queue->items = NULL;
+    queue->itemSize = 0;
+    queue->mask = 0;
+}
+
+bool SpscPush(SpscQueue* queue, const void* item) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head - tail > queue->mask) return false;
+
+    memcpy(queue->items + (size_t)(head & queue->mask) * queue->itemSize, item, queue->itemSize);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool SpscPop(SpscQueue* queue, void* item) {
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (head == tail) return false;
+
+    memcpy(item, queue->items + (size_t)(tail & queue->mask) * queue->itemSize, queue->itemSize);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t SpscCount(const SpscQueue* queue) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return head - tail;
+}
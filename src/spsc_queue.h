@@ -0,0 +1,37 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Bounded single-producer/single-consumer queue of fixed-size items.
+//
+// One thread pushes, one other thread pops; neither ever blocks, locks or
+// allocates, which makes it safe to drain from an audio callback. Storage
+// is allocated once by InitSpscQueue.
+
+#define SPSC_CACHE_LINE 64
+
+typedef struct {
+    unsigned char* items;
+    uint32_t itemSize;
+    uint32_t mask;                              // Capacity - 1, capacity is a power of two
+
+    // Producer and consumer indices on separate cache lines so the two
+    // threads do not invalidate each other's line on every operation
+    char padHead[SPSC_CACHE_LINE];
+    atomic_uint head;                           // Next slot to write
+    char padTail[SPSC_CACHE_LINE - sizeof(atomic_uint)];
+    atomic_uint tail;                           // Next slot to read
+    char padEnd[SPSC_CACHE_LINE - sizeof(atomic_uint)];
+} SpscQueue;
+
+bool InitSpscQueue(SpscQueue* queue, uint32_t itemSize, uint32_t capacity);   // Capacity is rounded up to a power of two
+void UnloadSpscQueue(SpscQueue* queue);
+
+bool SpscPush(SpscQueue* queue, const void* item);     // Producer only, false when full
+bool SpscPop(SpscQueue* queue, void* item);            // Consumer only, false when empty
+uint32_t SpscCount(const SpscQueue* queue);            // Approximate from any thread
+
+#endif // SPSC_QUEUE_H
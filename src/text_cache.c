@@ -0,0 +1,336 @@
+#include "text_cache.h"
+#include "profiler.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_CACHE_INITIAL_CAPACITY 1024    // Power of two
+#define TEXT_CACHE_SWEEP_FRAMES 60          // How often stale layouts are evicted
+#define TEXT_CACHE_STALE_FRAMES 120         // Unused for this long counts as stale
+#define TEXT_MAX_ATLASES 8
+#define TEXT_ATLAS_FIRST_CODEPOINT 32
+#define TEXT_ATLAS_CODEPOINTS 224           // Printable ASCII and Latin-1
+#define TEXT_ATLAS_EXACT_SIZE 16            // Every size up to this gets its own atlas
+#define TEXT_DEFAULT_FONT_SIZE 10           // DrawText never goes below this
+#define TEXT_LINE_SPACING 2                 // raylib's default textLineSpacing
+
+typedef struct {
+    Font font;
+    int pixelSize;          // 0 for the default font, which serves every size
+    uint32_t serial;        // Never reused, so layouts of an unloaded atlas stop matching
+    uint32_t lastUsedFrame;
+} TextAtlas;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t serial;
+    uint32_t lastUsedFrame;
+    int pixelSize;
+    uint32_t length;
+    char* text;             // NULL for an empty slot; the glyph run shares its allocation
+    TextLayout layout;
+} TextCacheEntry;
+
+static struct {
+    char fontPath[512];
+    bool hasFontFile;
+    TextAtlas atlases[TEXT_MAX_ATLASES];
+    int atlasCount;
+    TextAtlas defaultAtlas;
+    uint32_t nextSerial;
+    TextCacheEntry* entries;
+    uint32_t capacity;
+    uint32_t count;
+    TextCacheEntry scratch; // Used only when the table cannot grow
+    uint32_t frame;
+    uint32_t hits;
+    uint32_t misses;
+} textCache;
+
+static uint64_t HashText(const char* text, uint32_t length, int pixelSize, uint32_t serial) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= ((uint64_t)serial << 32) | (uint32_t)pixelSize;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+static int QuantizeSize(float fontSize) {
+    int pixelSize = (int)(fontSize + 0.5f);
+    return pixelSize < 1 ? 1 : pixelSize;
+}
+
+// Rung of the atlas ladder for a pixel size: exact up to 16px, then steps
+// of an eighth of the size, which keeps 20, 24, 30, 32 and 48 exact
+static int GetAtlasSize(int pixelSize) {
+    if (pixelSize <= TEXT_ATLAS_EXACT_SIZE) return pixelSize;
+    int step = pixelSize / 8;
+    return (pixelSize + step / 2) / step * step;
+}
+
+static TextAtlas* GetDefaultAtlas(void) {
+    TextAtlas* atlas = &textCache.defaultAtlas;
+    if (atlas->serial == 0) {
+        atlas->font = GetFontDefault();
+        atlas->serial = ++textCache.nextSerial;
+    }
+    atlas->lastUsedFrame = textCache.frame;
+    return atlas;
+}
+
+static TextAtlas* GetAtlas(int pixelSize) {
+    if (!textCache.hasFontFile) return GetDefaultAtlas();
+
+    TextAtlas* victim = NULL;
+    TextAtlas* nearest = NULL;
+    for (int i = 0; i < textCache.atlasCount; i++) {
+        TextAtlas* atlas = &textCache.atlases[i];
+        if (atlas->pixelSize == pixelSize) {
+            atlas->lastUsedFrame = textCache.frame;
+            return atlas;
+        }
+        if (atlas->lastUsedFrame != textCache.frame && (!victim || atlas->lastUsedFrame < victim->lastUsedFrame)) {
+            victim = atlas;
+        }
+        if (!nearest || abs(atlas->pixelSize - pixelSize) < abs(nearest->pixelSize - pixelSize)) nearest = atlas;
+    }
+
+    // Layouts handed out this frame point into their atlas, so only atlases
+    // idle this frame are replaced; past that the closest size gets scaled
+    TextAtlas* slot = NULL;
+    if (textCache.atlasCount < TEXT_MAX_ATLASES) slot = &textCache.atlases[textCache.atlasCount];
+    else if (victim) slot = victim;
+    else {
+        nearest->lastUsedFrame = textCache.frame;
+        return nearest;
+    }
+
+    int codepoints[TEXT_ATLAS_CODEPOINTS];
+    for (int i = 0; i < TEXT_ATLAS_CODEPOINTS; i++) codepoints[i] = TEXT_ATLAS_FIRST_CODEPOINT + i;
+    Font font = LoadFontEx(textCache.fontPath, pixelSize, codepoints, TEXT_ATLAS_CODEPOINTS);
+    if (font.texture.id == 0 || !font.glyphs || font.glyphCount == 0) {
+        TraceLog(LOG_WARNING, "TEXT: Failed to rasterize %s at %dpx, using the default font", textCache.fontPath, pixelSize);
+        textCache.hasFontFile = false;
+        return GetDefaultAtlas();
+    }
+
+    if (slot == victim) UnloadFont(slot->font);
+    else textCache.atlasCount++;
+    slot->font = font;
+    slot->pixelSize = pixelSize;
+    slot->serial = ++textCache.nextSerial;
+    slot->lastUsedFrame = textCache.frame;
+    return slot;
+}
+
+static void FreeEntry(TextCacheEntry* entry) {
+    free(entry->layout.glyphs ? (void*)entry->layout.glyphs : (void*)entry->text);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static bool BuildLayout(TextCacheEntry* entry, const TextAtlas* atlas, const char* text, uint32_t length, int pixelSize) {
+    // At most one glyph per byte; the string copy follows the glyph run
+    size_t runSize = (size_t)length * sizeof(TextGlyph);
+    unsigned char* block = malloc(runSize + length + 1);
+    if (!block) return false;
+    TextGlyph* glyphs = (TextGlyph*)block;
+    entry->text = (char*)block + runSize;
+    memcpy(entry->text, text, length);
+    entry->text[length] = '\0';
+    entry->length = length;
+    entry->pixelSize = pixelSize;
+    entry->serial = atlas->serial;
+
+    const Font* font = &atlas->font;
+    int clamped = pixelSize;
+    if (!textCache.hasFontFile && clamped < TEXT_DEFAULT_FONT_SIZE) clamped = TEXT_DEFAULT_FONT_SIZE;
+    float scale = (float)clamped / (float)font->baseSize;
+    float spacing = (float)(clamped / TEXT_DEFAULT_FONT_SIZE);
+
+    TextLayout layout = { 0 };
+    layout.font = *font;
+    layout.scale = scale;
+    layout.spacing = spacing;
+    layout.glyphs = length ? glyphs : NULL;
+
+    // Same metrics as MeasureTextEx: advances plus spacing, minus the trailing spacing of a line
+    Vector2 pen = { 0.0f, 0.0f };
+    float width = 0.0f;
+    for (uint32_t i = 0; i < length;) {
+        int bytes = 0;
+        int codepoint = GetCodepointNext(text + i, &bytes);
+        if (bytes < 1) bytes = 1;
+        int index = GetGlyphIndex(*font, codepoint);
+        glyphs[layout.glyphCount++] = (TextGlyph){ codepoint, index, i, pen };
+
+        if (codepoint == '\n') {
+            pen.x = 0.0f;
+            pen.y += (float)(clamped + TEXT_LINE_SPACING);
+        } else {
+            float advance = font->glyphs[index].advanceX ? (float)font->glyphs[index].advanceX : font->recs[index].width;
+            pen.x += advance * scale + spacing;
+            if (pen.x - spacing > width) width = pen.x - spacing;
+            if (codepoint != ' ' && codepoint != '\t') layout.quadCount++;
+        }
+        i += (uint32_t)bytes;
+    }
+    layout.size = (Vector2){ width, pen.y + (float)clamped };
+    layout.end = pen;
+    entry->layout = layout;
+    return true;
+}
+
+static bool ResizeTable(uint32_t capacity, uint32_t staleBefore) {
+    TextCacheEntry* entries = calloc(capacity, sizeof(TextCacheEntry));
+    if (!entries) return false;
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < textCache.capacity; i++) {
+        TextCacheEntry* entry = &textCache.entries[i];
+        if (!entry->text) continue;
+        if (entry->lastUsedFrame < staleBefore) {
+            FreeEntry(entry);
+            continue;
+        }
+        uint32_t slot = (uint32_t)entry->hash & (capacity - 1);
+        while (entries[slot].text) slot = (slot + 1) & (capacity - 1);
+        entries[slot] = *entry;
+        count++;
+    }
+
+    free(textCache.entries);
+    textCache.entries = entries;
+    textCache.capacity = capacity;
+    textCache.count = count;
+    return true;
+}
+
+void InitTextCache(const char* fontPath) {
+    UnloadTextCache();
+    if (fontPath && fontPath[0]) {
+        if (FileExists(fontPath)) {
+            strncpy(textCache.fontPath, fontPath, sizeof(textCache.fontPath) - 1);
+            textCache.hasFontFile = true;
+        } else {
+            TraceLog(LOG_INFO, "TEXT: %s not found, using the default font", fontPath);
+        }
+    }
+}
+
+void UnloadTextCache(void) {
+    for (uint32_t i = 0; i < textCache.capacity; i++) {
+        if (textCache.entries[i].text) FreeEntry(&textCache.entries[i]);
+    }
+    free(textCache.entries);
+    if (textCache.scratch.text) FreeEntry(&textCache.scratch);
+    for (int i = 0; i < textCache.atlasCount; i++) UnloadFont(textCache.atlases[i].font);
+    memset(&textCache, 0, sizeof(textCache));
+}
+
+void UpdateTextCache(void) {
+    PROFILE_SCOPE("UpdateTextCache");
+    textCache.frame++;
+    textCache.hits = 0;
+    textCache.misses = 0;
+    if (textCache.scratch.text) FreeEntry(&textCache.scratch);
+
+    if (textCache.count > 0 && textCache.frame % TEXT_CACHE_SWEEP_FRAMES == 0 && textCache.frame > TEXT_CACHE_STALE_FRAMES) {
+        ResizeTable(textCache.capacity, textCache.frame - TEXT_CACHE_STALE_FRAMES);
+    }
+}
+
+TextCacheStats GetTextCacheStats(void) {
+    TextCacheStats stats = { 0 };
+    stats.layouts = (int)textCache.count;
+    stats.atlases = textCache.atlasCount + (textCache.defaultAtlas.serial != 0);
+    stats.hits = textCache.hits;
+    stats.misses = textCache.misses;
+    return stats;
+}
+
+TextLayout GetTextLayout(const char* text, float fontSize) {
+    if (!text || !text[0]) return (TextLayout){ 0 };
+
+    int pixelSize = QuantizeSize(fontSize);
+    const TextAtlas* atlas = GetAtlas(GetAtlasSize(pixelSize));
+    // raylib loads its default font with the window, so without one
+    // (headless benchmarks) text measures and draws as nothing
+    if (!atlas->font.glyphs || atlas->font.baseSize <= 0) return (TextLayout){ 0 };
+    uint32_t length = (uint32_t)strlen(text);
+    uint64_t hash = HashText(text, length, pixelSize, atlas->serial);
+
+    if (textCache.count + 1 > textCache.capacity / 4 * 3) {
+        ResizeTable(textCache.capacity ? textCache.capacity * 2 : TEXT_CACHE_INITIAL_CAPACITY, 0);
+    }
+
+    TextCacheEntry* entry = NULL;
+    if (textCache.count + 1 <= textCache.capacity / 4 * 3) {
+        uint32_t mask = textCache.capacity - 1;
+        for (uint32_t slot = (uint32_t)hash & mask;; slot = (slot + 1) & mask) {
+            entry = &textCache.entries[slot];
+            if (!entry->text) break;
+            if (entry->hash == hash && entry->serial == atlas->serial && entry->pixelSize == pixelSize &&
+                entry->length == length && memcmp(entry->text, text, length) == 0) {
+                entry->lastUsedFrame = textCache.frame;
+                textCache.hits++;
+                return entry->layout;
+            }
+        }
+    } else {
+        // Out of memory for the table: lay out into a buffer the next miss reuses
+        if (textCache.scratch.text) FreeEntry(&textCache.scratch);
+        entry = &textCache.scratch;
+    }
+
+    textCache.misses++;
+    if (!BuildLayout(entry, atlas, text, length, pixelSize)) return (TextLayout){ 0 };
+    entry->hash = hash;
+    entry->lastUsedFrame = textCache.frame;
+    if (entry != &textCache.scratch) textCache.count++;
+    return entry->layout;
+}
+
+Vector2 MeasureTextCached(const char* text, float fontSize) {
+    return GetTextLayout(text, fontSize).size;
+}
+
+Vector2 GetTextCaretPosition(const char* text, int byteIndex, float fontSize) {
+    TextLayout layout = GetTextLayout(text, fontSize);
+    for (int i = 0; i < layout.glyphCount; i++) {
+        if ((int)layout.glyphs[i].byte >= byteIndex) return layout.glyphs[i].pen;
+    }
+    return layout.end;
+}
+
+Texture2D GetTextAtlasTexture(float fontSize) {
+    return GetAtlas(GetAtlasSize(QuantizeSize(fontSize)))->font.texture;
+}
+
+void DrawTextCached(const char* text, Vector2 position, float fontSize, Color tint) {
+    TextLayout layout = GetTextLayout(text, fontSize);
+    if (layout.quadCount == 0) return;
+
+    // Whole pixels like DrawText, so a 1:1 atlas samples texel centers
+    Vector2 origin = { floorf(position.x), floorf(position.y) };
+    const Font* font = &layout.font;
+    float padding = (float)font->glyphPadding;
+
+    for (int i = 0; i < layout.glyphCount; i++) {
+        const TextGlyph* glyph = &layout.glyphs[i];
+        if (glyph->codepoint == ' ' || glyph->codepoint == '\t' || glyph->codepoint == '\n') continue;
+
+        Rectangle rec = font->recs[glyph->glyph];
+        const GlyphInfo* info = &font->glyphs[glyph->glyph];
+        Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding };
+        Rectangle dest = {
+            origin.x + glyph->pen.x + ((float)info->offsetX - padding) * layout.scale,
+            origin.y + glyph->pen.y + ((float)info->offsetY - padding) * layout.scale,
+            source.width * layout.scale,
+            source.height * layout.scale
+        };
+        DrawTexturePro(font->texture, source, dest, (Vector2){ 0, 0 }, 0.0f, tint);
+    }
+}
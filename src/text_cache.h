@@ -0,0 +1,63 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cached text layout on top of per-size glyph atlases.
+//
+// Laying out a string (decoding UTF-8, looking up glyphs, summing advances)
+// happens once per distinct string and size; after that measuring is a hash
+// lookup and drawing walks the stored glyph run. Every 60 frames, layouts
+// nobody asked for in the last 120 are evicted.
+//
+// Sizes are in screen pixels. With a TrueType font, sizes up to 16px and
+// sizes on a ladder about an eighth apart above that get an atlas
+// rasterized at exactly that size, so text scaled with ScaleF() from
+// scaling.h stays sharp instead of magnifying a 20px bitmap. Sizes between
+// two rungs (a font size being eased) draw from the nearest rung slightly
+// scaled, so an animation rasterizes a few atlases rather than one per
+// pixel. Without a font file, raylib's default font is scaled the way
+// DrawText does.
+
+typedef struct {
+    int codepoint;
+    int glyph;          // Index into the atlas font's glyphs
+    uint32_t byte;      // Offset of the codepoint in the source string
+    Vector2 pen;        // Pen position relative to the text origin
+} TextGlyph;
+
+typedef struct {
+    Font font;          // Atlas the glyph indices refer to
+    float scale;        // Atlas pixels to screen pixels, 1 for a TrueType atlas
+    float spacing;
+    Vector2 size;       // Extents, same as MeasureText would return
+    Vector2 end;        // Pen position after the last codepoint
+    int glyphCount;     // Codepoints, whitespace included
+    int quadCount;      // Glyphs that actually draw something
+    const TextGlyph* glyphs;
+} TextLayout;
+
+typedef struct {
+    int layouts;
+    int atlases;
+    uint32_t hits;      // Lookups since the last UpdateTextCache
+    uint32_t misses;
+} TextCacheStats;
+
+// Lifetime; fontPath may be NULL or missing, in which case the default font is used
+void InitTextCache(const char* fontPath);
+void UnloadTextCache(void);
+void UpdateTextCache(void);             // Once per frame, before any text is laid out
+TextCacheStats GetTextCacheStats(void);
+
+// Layouts stay valid until the next UpdateTextCache
+TextLayout GetTextLayout(const char* text, float fontSize);
+Vector2 MeasureTextCached(const char* text, float fontSize);
+Vector2 GetTextCaretPosition(const char* text, int byteIndex, float fontSize);
+Texture2D GetTextAtlasTexture(float fontSize);
+
+void DrawTextCached(const char* text, Vector2 position, float fontSize, Color tint);
+
+#endif // TEXT_CACHE_H
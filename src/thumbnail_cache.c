@@ -0,0 +1,597 @@
+#include "thumbnail_cache.h"
+#include "mapped_file.h"
+#include "profiler.h"
+#include "vtf.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+#endif
+
+#define THUMBNAIL_INITIAL_BUCKETS 256
+
+typedef enum {
+    THUMBNAIL_IDLE,             // Nothing in memory, queued on the next request
+    THUMBNAIL_QUEUED,
+    THUMBNAIL_DECODING,
+    THUMBNAIL_DECODED,          // Pixels waiting for upload
+    THUMBNAIL_RESIDENT,
+    THUMBNAIL_FAILED
+} ThumbnailState;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t contentHash;
+    uint32_t width;
+    uint32_t height;
+} ThumbnailFileHeader;          // Followed by width * height RGBA pixels
+
+typedef struct Thumbnail {
+    char path[512];
+    uint64_t pathHash;
+    struct Thumbnail* next;     // Bucket chain
+    struct Thumbnail* nextJob;  // Job stack or ready list, guarded by the cache lock
+    atomic_int state;
+    atomic_uint_least64_t lastRequested;    // Frame
+
+    // Worker while decoding, UI thread otherwise
+    bool hashed;
+    uint64_t contentHash;
+    uint64_t sourceSize;        // The hash is reused while these match
+    int64_t sourceMtime;
+    bool seenExists;            // The source at the last attempt, compared by the recheck
+    uint64_t seenSize;
+    int64_t seenMtime;
+    unsigned char* pixels;      // RGBA while decoded
+    int width;
+    int height;
+
+    // UI thread
+    bool source;                // Has an extension thumbnails are made for
+    double checkedAt;
+    AtlasRegion region;
+    struct Thumbnail* lruPrev;  // Resident list, most recently drawn first
+    struct Thumbnail* lruNext;
+} Thumbnail;
+
+struct ThumbnailCache {
+    char directory[512];
+    size_t budget;
+
+    pthread_t workers[THUMBNAIL_WORKERS];
+    int workerCount;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+    Thumbnail* jobs;            // Stack, so what was asked for last is decoded first
+    Thumbnail* ready;
+
+    atomic_uint_least64_t frame;
+    atomic_int pending;
+    atomic_uint_least64_t diskHits;
+    atomic_uint_least64_t generated;
+    atomic_uint_least64_t failed;
+    atomic_uint tmpFiles;       // Names temporary files, two workers may write the same hash
+
+    // UI thread
+    Atlas* atlas;
+    Thumbnail** buckets;
+    uint32_t bucketCount;
+    int entryCount;
+    Thumbnail* lruHead;
+    Thumbnail* lruTail;
+    int resident;
+    uint64_t evictions;
+    uint64_t changed;
+    double now;                 // GetTime at the last update
+    int rechecks;               // Sources checked since then
+};
+
+static uint64_t HashBytes(uint64_t hash, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#define THUMBNAIL_HASH_BASIS 14695981039346656037ull
+
+static bool GetSourceInfo(const char* path, uint64_t* size, int64_t* mtime) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (uint64_t)st.st_size;
+    *mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+// ".PNG" -> ".png"; false without an extension or with a long one
+static bool GetLowerExtension(const char* path, char* lower, size_t size) {
+    const char* dot = strrchr(path, '.');
+    if (!dot) return false;
+    size_t length = strlen(dot);
+    if (length >= size) return false;
+    for (size_t i = 0; i <= length; i++) lower[i] = (char)(dot[i] >= 'A' && dot[i] <= 'Z' ? dot[i] + 32 : dot[i]);
+    return true;
+}
+
+// Formats raylib decodes by default, and Source textures
+static bool IsThumbnailSource(const char* path) {
+    static const char* extensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".qoi", ".psd", ".hdr", ".vtf" };
+    char lower[8];
+    if (!GetLowerExtension(path, lower, sizeof(lower))) return false;
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        if (strcmp(lower, extensions[i]) == 0) return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------
+// Workers
+//----------------------------------------------------------------------------------
+
+static void GetThumbnailFilePath(const ThumbnailCache* cache, uint64_t contentHash, char* buffer, size_t bufferSize) {
+    snprintf(buffer, bufferSize, "%s/%016llx%s", cache->directory, (unsigned long long)contentHash, THUMBNAIL_FILE_EXTENSION);
+}
+
+static bool ReadThumbnailFile(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    char path[560];
+    GetThumbnailFilePath(cache, thumbnail->contentHash, path, sizeof(path));
+    MappedFile map;
+    if (!MapFile(path, &map)) return false;
+
+    ThumbnailFileHeader header;
+    bool valid = map.size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, map.data, sizeof(header));
+        valid = header.magic == THUMBNAIL_FILE_MAGIC && header.version == THUMBNAIL_FILE_VERSION &&
+                header.contentHash == thumbnail->contentHash &&
+                header.width > 0 && header.width <= THUMBNAIL_SIZE && header.height > 0 && header.height <= THUMBNAIL_SIZE &&
+                map.size - sizeof(header) >= (size_t)header.width * header.height * 4;
+    }
+    if (valid) {
+        size_t bytes = (size_t)header.width * header.height * 4;
+        thumbnail->pixels = malloc(bytes);
+        valid = thumbnail->pixels != NULL;
+        if (valid) {
+            memcpy(thumbnail->pixels, map.data + sizeof(header), bytes);
+            thumbnail->width = (int)header.width;
+            thumbnail->height = (int)header.height;
+        }
+    }
+    UnmapFile(&map);
+    return valid;
+}
+
+static void WriteThumbnailFile(ThumbnailCache* cache, const Thumbnail* thumbnail) {
+    char path[560], tmpPath[580];
+    GetThumbnailFilePath(cache, thumbnail->contentHash, path, sizeof(path));
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%u.tmp", path, atomic_fetch_add(&cache->tmpFiles, 1));
+
+    ThumbnailFileHeader header = { 0 };
+    header.magic = THUMBNAIL_FILE_MAGIC;
+    header.version = THUMBNAIL_FILE_VERSION;
+    header.contentHash = thumbnail->contentHash;
+    header.width = (uint32_t)thumbnail->width;
+    header.height = (uint32_t)thumbnail->height;
+
+    FILE* out = fopen(tmpPath, "wb");
+    if (!out) return;
+    size_t bytes = (size_t)thumbnail->width * thumbnail->height * 4;
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 && fwrite(thumbnail->pixels, 1, bytes, out) == bytes;
+    ok = fclose(out) == 0 && ok;
+    if (ok) ok = rename(tmpPath, path) == 0;
+    if (!ok) remove(tmpPath);
+}
+
+static bool DecodeThumbnail(Thumbnail* thumbnail, const MappedFile* source) {
+    if (source->size > (size_t)INT32_MAX) return false;
+    // A VTF carries its own mips, so only the one nearest the thumbnail size is decoded
+    char extension[8];
+    if (!GetLowerExtension(thumbnail->path, extension, sizeof(extension))) return false;
+    Image image = strcmp(extension, ".vtf") == 0 ? LoadVtfImage(source->data, source->size, THUMBNAIL_SIZE)
+                                                 : LoadImageFromMemory(extension, source->data, (int)source->size);
+    if (!image.data || image.width <= 0 || image.height <= 0) {
+        UnloadImage(image);
+        return false;
+    }
+
+    int longest = image.width > image.height ? image.width : image.height;
+    if (longest > THUMBNAIL_SIZE) {
+        int width = (int)((long long)image.width * THUMBNAIL_SIZE / longest);
+        int height = (int)((long long)image.height * THUMBNAIL_SIZE / longest);
+        ImageResize(&image, width > 0 ? width : 1, height > 0 ? height : 1);
+    }
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    size_t bytes = (size_t)image.width * image.height * 4;
+    thumbnail->pixels = malloc(bytes);
+    if (thumbnail->pixels) {
+        memcpy(thumbnail->pixels, image.data, bytes);
+        thumbnail->width = image.width;
+        thumbnail->height = image.height;
+    }
+    UnloadImage(image);
+    return thumbnail->pixels != NULL;
+}
+
+// Hashes the source unless it is unchanged since the last time, then reads
+// the cached thumbnail or decodes the source and caches the result
+static bool LoadThumbnail(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    uint64_t size;
+    int64_t mtime;
+    thumbnail->seenExists = GetSourceInfo(thumbnail->path, &size, &mtime);
+    if (!thumbnail->seenExists) return false;
+    thumbnail->seenSize = size;
+    thumbnail->seenMtime = mtime;
+
+    MappedFile source = { 0 };
+    if (!thumbnail->hashed || size != thumbnail->sourceSize || mtime != thumbnail->sourceMtime) {
+        if (!MapFile(thumbnail->path, &source)) return false;
+        thumbnail->contentHash = HashBytes(THUMBNAIL_HASH_BASIS, source.data, source.size);
+        thumbnail->sourceSize = size;
+        thumbnail->sourceMtime = mtime;
+        thumbnail->hashed = true;
+    }
+
+    bool loaded = cache->directory[0] && ReadThumbnailFile(cache, thumbnail);
+    if (loaded) {
+        atomic_fetch_add_explicit(&cache->diskHits, 1, memory_order_relaxed);
+    } else if ((source.data || MapFile(thumbnail->path, &source)) && DecodeThumbnail(thumbnail, &source)) {
+        atomic_fetch_add_explicit(&cache->generated, 1, memory_order_relaxed);
+        if (cache->directory[0]) WriteThumbnailFile(cache, thumbnail);
+        loaded = true;
+    }
+    UnmapFile(&source);
+    return loaded;
+}
+
+static void* ThumbnailWorkerThread(void* arg) {
+    ThumbnailCache* cache = arg;
+    SetProfilerThreadName("Thumbnails");
+
+    for (;;) {
+        pthread_mutex_lock(&cache->lock);
+        while (!cache->stopping && !cache->jobs) pthread_cond_wait(&cache->wake, &cache->lock);
+        if (cache->stopping) {
+            pthread_mutex_unlock(&cache->lock);
+            break;
+        }
+        Thumbnail* job = cache->jobs;
+        cache->jobs = job->nextJob;
+        pthread_mutex_unlock(&cache->lock);
+
+        // Scrolled past before its turn came; it is queued again if it comes back
+        uint64_t frame = atomic_load_explicit(&cache->frame, memory_order_relaxed);
+        if (frame - atomic_load_explicit(&job->lastRequested, memory_order_relaxed) > THUMBNAIL_STALE_FRAMES) {
+            atomic_fetch_sub(&cache->pending, 1);
+            atomic_store_explicit(&job->state, THUMBNAIL_IDLE, memory_order_release);
+            continue;
+        }
+
+        atomic_store_explicit(&job->state, THUMBNAIL_DECODING, memory_order_relaxed);
+        PROFILE_BEGIN(load, "LoadThumbnail");
+        bool loaded = LoadThumbnail(cache, job);
+        PROFILE_END(load);
+        if (!loaded) {
+            TraceLog(LOG_WARNING, "THUMBNAIL: Failed to load %s", job->path);
+            atomic_fetch_add_explicit(&cache->failed, 1, memory_order_relaxed);
+            atomic_fetch_sub(&cache->pending, 1);
+            atomic_store_explicit(&job->state, THUMBNAIL_FAILED, memory_order_release);
+            continue;
+        }
+
+        pthread_mutex_lock(&cache->lock);
+        atomic_store_explicit(&job->state, THUMBNAIL_DECODED, memory_order_release);
+        job->nextJob = cache->ready;
+        cache->ready = job;
+        pthread_mutex_unlock(&cache->lock);
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// UI thread
+//----------------------------------------------------------------------------------
+
+static void LinkResident(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    thumbnail->lruPrev = NULL;
+    thumbnail->lruNext = cache->lruHead;
+    if (cache->lruHead) cache->lruHead->lruPrev = thumbnail;
+    cache->lruHead = thumbnail;
+    if (!cache->lruTail) cache->lruTail = thumbnail;
+}
+
+static void UnlinkResident(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    if (thumbnail->lruPrev) thumbnail->lruPrev->lruNext = thumbnail->lruNext;
+    else cache->lruHead = thumbnail->lruNext;
+    if (thumbnail->lruNext) thumbnail->lruNext->lruPrev = thumbnail->lruPrev;
+    else cache->lruTail = thumbnail->lruPrev;
+    thumbnail->lruPrev = thumbnail->lruNext = NULL;
+}
+
+static bool GrowBuckets(ThumbnailCache* cache) {
+    uint32_t count = cache->bucketCount ? cache->bucketCount * 2 : THUMBNAIL_INITIAL_BUCKETS;
+    Thumbnail** buckets = calloc(count, sizeof(Thumbnail*));
+    if (!buckets) return false;
+
+    for (uint32_t b = 0; b < cache->bucketCount; b++) {
+        Thumbnail* thumbnail = cache->buckets[b];
+        while (thumbnail) {
+            Thumbnail* next = thumbnail->next;
+            uint32_t slot = (uint32_t)thumbnail->pathHash & (count - 1);
+            thumbnail->next = buckets[slot];
+            buckets[slot] = thumbnail;
+            thumbnail = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucketCount = count;
+    return true;
+}
+
+static Thumbnail* FindOrAddThumbnail(ThumbnailCache* cache, const char* path) {
+    size_t length = strlen(path);
+    uint64_t hash = HashBytes(THUMBNAIL_HASH_BASIS, (const unsigned char*)path, length);
+    for (Thumbnail* thumbnail = cache->buckets[hash & (cache->bucketCount - 1)]; thumbnail; thumbnail = thumbnail->next) {
+        if (thumbnail->pathHash == hash && strcmp(thumbnail->path, path) == 0) return thumbnail;
+    }
+    if (length >= sizeof(((Thumbnail*)0)->path)) return NULL;
+    if ((uint32_t)cache->entryCount >= cache->bucketCount * 2 && !GrowBuckets(cache)) return NULL;
+
+    Thumbnail* thumbnail = calloc(1, sizeof(Thumbnail));
+    if (!thumbnail) return NULL;
+    memcpy(thumbnail->path, path, length + 1);
+    thumbnail->pathHash = hash;
+    thumbnail->source = IsThumbnailSource(path);
+    atomic_init(&thumbnail->state, thumbnail->source ? THUMBNAIL_IDLE : THUMBNAIL_FAILED);
+    uint32_t slot = (uint32_t)hash & (cache->bucketCount - 1);
+    thumbnail->next = cache->buckets[slot];
+    cache->buckets[slot] = thumbnail;
+    cache->entryCount++;
+    return thumbnail;
+}
+
+static void ReleaseResident(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    UnlinkResident(cache, thumbnail);
+    RemoveAtlasImage(cache->atlas, thumbnail->region);
+    cache->resident--;
+    thumbnail->region = (AtlasRegion){ 0 };
+    atomic_store_explicit(&thumbnail->state, THUMBNAIL_IDLE, memory_order_relaxed);
+}
+
+// True when the source was edited, replaced, deleted or created since the
+// thumbnail was loaded or failed to. Each one is checked at most every
+// THUMBNAIL_RECHECK_SECONDS, and only a few stat calls are made per frame.
+static bool HasSourceChanged(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    if (cache->now - thumbnail->checkedAt < THUMBNAIL_RECHECK_SECONDS || cache->rechecks >= THUMBNAIL_RECHECKS_PER_FRAME) return false;
+    cache->rechecks++;
+    thumbnail->checkedAt = cache->now;
+    uint64_t size;
+    int64_t mtime;
+    bool exists = GetSourceInfo(thumbnail->path, &size, &mtime);
+    if (exists != thumbnail->seenExists) return true;
+    return exists && (size != thumbnail->seenSize || mtime != thumbnail->seenMtime);
+}
+
+AtlasRegion RequestThumbnail(ThumbnailCache* cache, const char* path) {
+    AtlasRegion none = { 0 };
+    none.page = -1;
+    if (!cache || !path || !path[0]) return none;
+    Thumbnail* thumbnail = FindOrAddThumbnail(cache, path);
+    if (!thumbnail) return none;
+
+    atomic_store_explicit(&thumbnail->lastRequested, atomic_load_explicit(&cache->frame, memory_order_relaxed), memory_order_relaxed);
+    ThumbnailState state = atomic_load_explicit(&thumbnail->state, memory_order_acquire);
+
+    // A changed source is loaded again; the worker sees the new size or time and hashes it anew
+    if ((state == THUMBNAIL_RESIDENT || (state == THUMBNAIL_FAILED && thumbnail->source)) && HasSourceChanged(cache, thumbnail)) {
+        if (state == THUMBNAIL_RESIDENT) ReleaseResident(cache, thumbnail);
+        else atomic_store_explicit(&thumbnail->state, THUMBNAIL_IDLE, memory_order_relaxed);
+        cache->changed++;
+        state = THUMBNAIL_IDLE;
+    }
+
+    switch (state) {
+        case THUMBNAIL_RESIDENT:
+            if (cache->lruHead != thumbnail) {
+                UnlinkResident(cache, thumbnail);
+                LinkResident(cache, thumbnail);
+            }
+            return thumbnail->region;
+        case THUMBNAIL_IDLE:
+            atomic_fetch_add(&cache->pending, 1);
+            pthread_mutex_lock(&cache->lock);
+            atomic_store_explicit(&thumbnail->state, THUMBNAIL_QUEUED, memory_order_relaxed);
+            thumbnail->nextJob = cache->jobs;
+            cache->jobs = thumbnail;
+            pthread_cond_signal(&cache->wake);
+            pthread_mutex_unlock(&cache->lock);
+            return none;
+        default:
+            return none;
+    }
+}
+
+static void EvictThumbnail(ThumbnailCache* cache, Thumbnail* thumbnail) {
+    ReleaseResident(cache, thumbnail);
+    cache->evictions++;
+}
+
+// Least recently drawn on a page (any page when it is -1), or NULL; what was
+// drawn this frame is at the head of the list and never evicted
+static Thumbnail* FindEvictable(ThumbnailCache* cache, int page, uint64_t frame) {
+    for (Thumbnail* thumbnail = cache->lruTail; thumbnail; thumbnail = thumbnail->lruPrev) {
+        if (atomic_load_explicit(&thumbnail->lastRequested, memory_order_relaxed) == frame) break;
+        if (page < 0 || thumbnail->region.page == page) return thumbnail;
+    }
+    return NULL;
+}
+
+// Evicts least recently drawn first, but keeps to the page of the first one
+// evicted while it has more, so the holes are next to each other and merge
+// (or the page empties and starts over) instead of being spread over every
+// page. A thumbnail that finds no room waits for the view to move.
+static bool PlaceThumbnail(ThumbnailCache* cache, Thumbnail* thumbnail, uint64_t frame) {
+    Image image = { thumbnail->pixels, thumbnail->width, thumbnail->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    thumbnail->region = AddAtlasImage(cache->atlas, image);
+    int page = -1;
+    while (thumbnail->region.texture.id == 0) {
+        Thumbnail* victim = FindEvictable(cache, page, frame);
+        if (!victim && page >= 0) victim = FindEvictable(cache, -1, frame);
+        if (!victim) break;
+        page = victim->region.page;
+        EvictThumbnail(cache, victim);
+        thumbnail->region = AddAtlasImage(cache->atlas, image);
+    }
+    return thumbnail->region.texture.id != 0;
+}
+
+void UpdateThumbnailCache(ThumbnailCache* cache) {
+    if (!cache) return;
+    uint64_t frame = atomic_load_explicit(&cache->frame, memory_order_relaxed);
+
+    pthread_mutex_lock(&cache->lock);
+    Thumbnail* ready = cache->ready;
+    cache->ready = NULL;
+    pthread_mutex_unlock(&cache->lock);
+
+    // Upload what was asked for this frame; what nobody looked at for a while
+    // is dropped, the disk cache has it
+    Thumbnail* waiting = NULL;
+    int uploads = 0;
+    while (ready) {
+        Thumbnail* thumbnail = ready;
+        ready = thumbnail->nextJob;
+        uint64_t requested = atomic_load_explicit(&thumbnail->lastRequested, memory_order_relaxed);
+
+        if (requested == frame && uploads < THUMBNAIL_UPLOADS_PER_FRAME && PlaceThumbnail(cache, thumbnail, frame)) {
+            free(thumbnail->pixels);
+            thumbnail->pixels = NULL;
+            uploads++;
+            atomic_fetch_sub(&cache->pending, 1);
+            cache->resident++;
+            thumbnail->checkedAt = cache->now;
+            LinkResident(cache, thumbnail);
+            atomic_store_explicit(&thumbnail->state, THUMBNAIL_RESIDENT, memory_order_relaxed);
+        } else if (frame - requested > THUMBNAIL_STALE_FRAMES) {
+            free(thumbnail->pixels);
+            thumbnail->pixels = NULL;
+            atomic_fetch_sub(&cache->pending, 1);
+            atomic_store_explicit(&thumbnail->state, THUMBNAIL_IDLE, memory_order_relaxed);
+        } else {
+            thumbnail->nextJob = waiting;
+            waiting = thumbnail;
+        }
+    }
+    if (waiting) {
+        pthread_mutex_lock(&cache->lock);
+        while (waiting) {
+            Thumbnail* thumbnail = waiting;
+            waiting = thumbnail->nextJob;
+            thumbnail->nextJob = cache->ready;
+            cache->ready = thumbnail;
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+
+    atomic_store_explicit(&cache->frame, frame + 1, memory_order_relaxed);
+    cache->now = GetTime();
+    cache->rechecks = 0;
+}
+
+bool IsThumbnailWorkPending(ThumbnailCache* cache) {
+    return cache && atomic_load_explicit(&cache->pending, memory_order_relaxed) > 0;
+}
+
+ThumbnailStats GetThumbnailStats(ThumbnailCache* cache) {
+    ThumbnailStats stats = { 0 };
+    if (!cache) return stats;
+    stats.entries = cache->entryCount;
+    stats.resident = cache->resident;
+    size_t pageBytes = (size_t)THUMBNAIL_PAGE_SIZE * THUMBNAIL_PAGE_SIZE * 4;
+    stats.gpuBytes = (size_t)GetAtlasStats(cache->atlas).pages * pageBytes;
+    stats.budget = cache->budget;
+    stats.pending = atomic_load_explicit(&cache->pending, memory_order_relaxed);
+    stats.diskHits = atomic_load_explicit(&cache->diskHits, memory_order_relaxed);
+    stats.generated = atomic_load_explicit(&cache->generated, memory_order_relaxed);
+    stats.failed = atomic_load_explicit(&cache->failed, memory_order_relaxed);
+    stats.evictions = cache->evictions;
+    stats.changed = cache->changed;
+    return stats;
+}
+
+ThumbnailCache* CreateThumbnailCache(const char* cacheDirectory, size_t gpuBudget) {
+    ThumbnailCache* cache = calloc(1, sizeof(ThumbnailCache));
+    if (!cache) return NULL;
+    if (cacheDirectory && strlen(cacheDirectory) < sizeof(cache->directory)) {
+        strcpy(cache->directory, cacheDirectory);
+        mkdir(cache->directory, 0777);
+    }
+
+    // The atlas takes whole pages, at least one
+    size_t pageBytes = (size_t)THUMBNAIL_PAGE_SIZE * THUMBNAIL_PAGE_SIZE * 4;
+    size_t pages = (gpuBudget > 0 ? gpuBudget : THUMBNAIL_DEFAULT_BUDGET) / pageBytes;
+    if (pages < 1) pages = 1;
+    if (pages > ATLAS_MAX_PAGES) pages = ATLAS_MAX_PAGES;
+    cache->budget = pages * pageBytes;
+    cache->now = GetTime();
+    cache->atlas = CreateAtlas(THUMBNAIL_PAGE_SIZE, (int)pages);
+    if (!cache->atlas || !GrowBuckets(cache)) {
+        DestroyAtlas(cache->atlas);
+        free(cache);
+        return NULL;
+    }
+
+    pthread_mutex_init(&cache->lock, NULL);
+    pthread_cond_init(&cache->wake, NULL);
+    for (int i = 0; i < THUMBNAIL_WORKERS; i++) {
+        if (pthread_create(&cache->workers[cache->workerCount], NULL, ThumbnailWorkerThread, cache) == 0) {
+            cache->workerCount++;
+        }
+    }
+    if (cache->workerCount == 0) {
+        TraceLog(LOG_WARNING, "THUMBNAIL: Failed to start worker threads");
+        pthread_cond_destroy(&cache->wake);
+        pthread_mutex_destroy(&cache->lock);
+        DestroyAtlas(cache->atlas);
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void DestroyThumbnailCache(ThumbnailCache* cache) {
+    if (!cache) return;
+
+    pthread_mutex_lock(&cache->lock);
+    cache->stopping = true;
+    pthread_cond_broadcast(&cache->wake);
+    pthread_mutex_unlock(&cache->lock);
+    for (int i = 0; i < cache->workerCount; i++) pthread_join(cache->workers[i], NULL);
+
+    for (uint32_t b = 0; b < cache->bucketCount; b++) {
+        Thumbnail* thumbnail = cache->buckets[b];
+        while (thumbnail) {
+            Thumbnail* next = thumbnail->next;
+            free(thumbnail->pixels);
+            free(thumbnail);
+            thumbnail = next;
+        }
+    }
+    DestroyAtlas(cache->atlas);
+    pthread_cond_destroy(&cache->wake);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->buckets);
+    free(cache);
+}
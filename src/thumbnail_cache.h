@@ -0,0 +1,76 @@
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include "raylib.h"
+#include "atlas.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Asset thumbnails, generated in the background and uploaded on demand.
+//
+// A small pool of worker threads decodes source images and scales them to
+// THUMBNAIL_SIZE. Results are saved to the cache directory as
+// "<content hash>.gbthumb", raw RGBA behind a header, so later sessions only
+// hash the source and read the small file back. Because the key is the
+// content, a moved or copied file still hits and an edited one misses.
+//
+// Texture memory is the scarce part. Thumbnails share the pages of an atlas
+// sized from the byte budget, so a grid of them draws as one batch. Only
+// thumbnails requested this frame (the ones visible in PANEL_ASSETS) are
+// uploaded, at most THUMBNAIL_UPLOADS_PER_FRAME at a time. When the pages
+// are full, the least recently drawn ones make room. An evicted thumbnail
+// comes back from the disk cache when it scrolls into view again. Opening a
+// project costs nothing up front: thumbnails stream in as they are seen.
+//
+// Thumbnails being drawn recheck their source's size and modification time
+// every THUMBNAIL_RECHECK_SECONDS. An edited, replaced or deleted source is
+// loaded again, and one that failed is retried once it changes or appears.
+
+#define THUMBNAIL_SIZE 128                      // Longest side in pixels
+#define THUMBNAIL_FILE_EXTENSION ".gbthumb"
+#define THUMBNAIL_FILE_MAGIC 0x48544247u        // "GBTH"
+#define THUMBNAIL_FILE_VERSION 1
+#define THUMBNAIL_WORKERS 2
+#define THUMBNAIL_DEFAULT_BUDGET (32u << 20)    // Texture bytes, about 500 full-size thumbnails
+#define THUMBNAIL_PAGE_SIZE 1024
+#define THUMBNAIL_UPLOADS_PER_FRAME 8
+#define THUMBNAIL_STALE_FRAMES 30               // Queued or decoded thumbnails not requested for this long are dropped
+#define THUMBNAIL_RECHECK_SECONDS 2.0
+#define THUMBNAIL_RECHECKS_PER_FRAME 16         // Sources stat'ed by the UI thread at most per frame
+
+typedef struct ThumbnailCache ThumbnailCache;
+
+typedef struct {
+    int entries;                // Paths seen
+    int resident;               // Thumbnails in the atlas
+    size_t gpuBytes;            // Atlas pages created so far
+    size_t budget;              // Rounded down to whole pages
+    int pending;                // Queued, decoding or waiting for upload
+    uint64_t diskHits;          // Thumbnails read back from the cache directory
+    uint64_t generated;         // Thumbnails decoded from their source
+    uint64_t failed;
+    uint64_t evictions;
+    uint64_t changed;           // Resident or failed thumbnails loaded again because their source changed
+} ThumbnailStats;
+
+// Lifetime. The cache directory is created if its parent exists; NULL keeps
+// thumbnails in memory only. Destroying unloads the textures, so it needs
+// the window still open.
+ThumbnailCache* CreateThumbnailCache(const char* cacheDirectory, size_t gpuBudget);    // 0 for the default budget
+void DestroyThumbnailCache(ThumbnailCache* cache);
+
+// UI thread. Returns the thumbnail of an image file, or a region with texture
+// id 0 while it is not ready (or the file has no thumbnail). Asking marks it
+// as visible: it is generated, uploaded and kept resident for as long as it
+// keeps being asked for. The region stays valid until the next update.
+AtlasRegion RequestThumbnail(ThumbnailCache* cache, const char* path);
+
+// UI thread, once per frame after the frame's draw list is submitted.
+// Uploads finished thumbnails that were requested, evicting to make room.
+void UpdateThumbnailCache(ThumbnailCache* cache);
+
+bool IsThumbnailWorkPending(ThumbnailCache* cache);    // For RequestBackgroundFrame
+ThumbnailStats GetThumbnailStats(ThumbnailCache* cache);
+
+#endif // THUMBNAIL_CACHE_H
@@ -1,57 +1,358 @@
 #include "timeline.h"
 #include "ui_components.h"
+#include "journal.h"
+#include "history.h"
+#include "mixer.h"
+#include "disk_stream.h"
+#include "sequencer.h"
+#include "profiler.h"
+
+#define TIMELINE_HEIGHT 180
+#define TIMELINE_HEADER_HEIGHT 25
+#define TIMELINE_PIXELS_PER_SECOND 100.0f
+#define TRACK_HEADER_WIDTH 100
+#define TRACK_HEIGHT 24
+#define TRACK_SPACING 4
+#define MAX_VISIBLE_ELEMENTS 4096
+
+// Element drag state
+static bool draggingElement = false;
+static float dragTimeOffset = 0.0f;
+
+struct TimelinePeaks {
+    int assetId;
+    PeakFile* peaks;        // NULL when the asset has no file
+};
+
+static Rectangle GetTimelineBounds(const AppState* app) {
+    // Timeline is positioned at the bottom of the screen, above the Assets
+    // panel and as wide as it
+    return (Rectangle){
+        0, 
+        app->panels[PANEL_ASSETS].bounds.y - TIMELINE_HEIGHT, 
+        app->panels[PANEL_ASSETS].bounds.width, 
+        TIMELINE_HEIGHT
+    };
+}
+
+static float GetPixelsPerSecond(const AppState* app) {
+    return TIMELINE_PIXELS_PER_SECOND * (app->timeline.zoom > 0.0f ? app->timeline.zoom : 1.0f);
+}
+
+static float TimeToScreenX(const AppState* app, float time) {
+    return TRACK_HEADER_WIDTH + (time - app->timeline.scrollX) * GetPixelsPerSecond(app);
+}
+
+static float ScreenXToTime(const AppState* app, float x) {
+    return app->timeline.scrollX + (x - TRACK_HEADER_WIDTH) / GetPixelsPerSecond(app);
+}
+
+static float GetTrackY(const AppState* app, Rectangle timelineBounds, int track) {
+    return timelineBounds.y + TIMELINE_HEADER_HEIGHT + 5 + track * (TRACK_HEIGHT + TRACK_SPACING) - app->timeline.scrollY;
+}
+
+// Track lane under a screen y coordinate, or -1
+static int GetTrackAt(const AppState* app, Rectangle timelineBounds, float y) {
+    float offset = y - GetTrackY(app, timelineBounds, 0);
+    if (offset < 0) return -1;
+    int track = (int)(offset / (TRACK_HEIGHT + TRACK_SPACING));
+    return track < app->trackCount ? track : -1;
+}
+
+static float SnapTime(const AppState* app, float time) {
+    if (app->timeline.bpm <= 0.0f || app->timeline.snapDivision <= 0.0f) return time;
+    float step = 60.0f / app->timeline.bpm / app->timeline.snapDivision;
+    return roundf(time / step) * step;
+}
+
+// Peaks of an audio asset, acquired on first use. Assets are only searched
+// the first time an id shows up; after that it is a binary search.
+static PeakFile* GetTimelinePeaks(AppState* app, int assetId) {
+    if (!app->peakCache || assetId < 0) return NULL;
+
+    int lo = 0, hi = app->timelinePeakCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (app->timelinePeaks[mid].assetId < assetId) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < app->timelinePeakCount && app->timelinePeaks[lo].assetId == assetId) return app->timelinePeaks[lo].peaks;
+
+    if (app->timelinePeakCount == app->timelinePeakCapacity) {
+        int capacity = app->timelinePeakCapacity ? app->timelinePeakCapacity * 2 : 16;
+        struct TimelinePeaks* grown = realloc(app->timelinePeaks, (size_t)capacity * sizeof(*grown));
+        if (!grown) return NULL;
+        app->timelinePeaks = grown;
+        app->timelinePeakCapacity = capacity;
+    }
+
+    PeakFile* peaks = NULL;
+    for (uint32_t slot = 0; slot < app->assets.slotCount; slot++) {
+        const Asset* asset = PoolAt(&app->assets, slot);
+        if (!asset || asset->id != assetId) continue;
+        if (asset->path[0]) peaks = AcquirePeaks(app->peakCache, asset->path);
+        break;
+    }
+
+    memmove(&app->timelinePeaks[lo + 1], &app->timelinePeaks[lo],
+            (size_t)(app->timelinePeakCount - lo) * sizeof(*app->timelinePeaks));
+    app->timelinePeaks[lo] = (struct TimelinePeaks){ assetId, peaks };
+    app->timelinePeakCount++;
+    return peaks;
+}
+
+bool AreTimelinePeaksPending(const AppState* app) {
+    if (!app) return false;
+    for (int i = 0; i < app->timelinePeakCount; i++) {
+        const PeakFile* peaks = app->timelinePeaks[i].peaks;
+        if (peaks && !PeaksReady(peaks) && !PeaksFailed(peaks)) return true;
+    }
+    return false;
+}
+
+void ReleaseTimelinePeaks(AppState* app) {
+    if (!app) return;
+    for (int i = 0; i < app->timelinePeakCount; i++) ReleasePeaks(app->peakCache, app->timelinePeaks[i].peaks);
+    app->timelinePeakCount = 0;
+}
 
 void DrawTimeline(AppState* app) {
     if (!app) return;
+    PROFILE_SCOPE("DrawTimeline");
     
-    // Timeline is positioned at the bottom of the screen, above the Assets panel
-    Rectangle timelineBounds = {
-        0, 
-        app->panels[PANEL_ASSETS].bounds.y - 180, 
-        GetScreenWidth(), 
-        180
-    };
+    Rectangle timelineBounds = GetTimelineBounds(app);
     
     // Draw timeline background
-    DrawRectangleRec(timelineBounds, COLOR_TIMELINE_BG);
+    UiDrawRectangle(timelineBounds, COLOR_TIMELINE_BG);
     
     // Draw timeline header
-    DrawRectangle(0, timelineBounds.y, GetScreenWidth(), 25, COLOR_PANEL_HEADER);
-    DrawText("Timeline", 10, timelineBounds.y + 5, 18, COLOR_TEXT);
+    UiDrawRectangle((Rectangle){ 0, timelineBounds.y, timelineBounds.width, TIMELINE_HEADER_HEIGHT }, COLOR_PANEL_HEADER);
+    UiDrawText("Timeline", 10, timelineBounds.y + 5, 18, COLOR_TEXT);
     
     // Timeline controls (Patterns button)
-    if (Button((Rectangle){GetScreenWidth() - 100, timelineBounds.y + 3, 90, 20}, 
+    if (Button((Rectangle){timelineBounds.width - 100, timelineBounds.y + 3, 90, 20}, 
               "Patterns", app->showPatternEditor)) {
         app->showPatternEditor = !app->showPatternEditor;
         app->panels[PANEL_PATTERN_EDITOR].visible = app->showPatternEditor;
     }
     
     // Mixer button
-    if (Button((Rectangle){GetScreenWidth() - 200, timelineBounds.y + 3, 90, 20}, 
+    if (Button((Rectangle){timelineBounds.width - 200, timelineBounds.y + 3, 90, 20}, 
               "Mixer", app->showMixer)) {
         app->showMixer = !app->showMixer;
         app->panels[PANEL_MIXER].visible = app->showMixer;
     }
     
-    // Draw Timeline Track Area
-    int trackHeight = 130; // Space for tracks
-    int trackY = timelineBounds.y + 30; // Space below the header
-
-    // Draw track background and timeline guide
-    for (int i = 0; i < app->numTracks; i++) {
-        DrawRectangle(0, trackY + i * (trackHeight + 5), GetScreenWidth(), trackHeight, COLOR_TRACK_BG);
-        DrawLine(0, trackY + i * (trackHeight + 5), GetScreenWidth(), trackY + i * (trackHeight + 5), COLOR_TRACK_BORDER);
+    // Profiler button, same as F4; zones only record while its panel is open
+    bool profiling = IsProfilerEnabled();
+    if (Button((Rectangle){timelineBounds.width - 300, timelineBounds.y + 3, 90, 20}, 
+              "Profiler", profiling)) {
+        SetProfilerEnabled(!profiling);
+    }
+    
+    // Only the visible time window is queried from the index
+    float visibleStart = ScreenXToTime(app, TRACK_HEADER_WIDTH);
+    float visibleEnd = ScreenXToTime(app, timelineBounds.width);
+    float areaTop = timelineBounds.y + TIMELINE_HEADER_HEIGHT;
+    float areaBottom = timelineBounds.y + timelineBounds.height;
+    int visible[MAX_VISIBLE_ELEMENTS];
+    
+    for (int t = 0; t < app->trackCount; t++) {
+        float trackY = GetTrackY(app, timelineBounds, t);
+        if (trackY + TRACK_HEIGHT < areaTop || trackY > areaBottom) continue;
+        
+        // Draw track background and label
+        UiDrawRectangle((Rectangle){ 0, trackY, timelineBounds.width, TRACK_HEIGHT }, COLOR_TRACK_BG);
+        UiDrawLine((Vector2){ 0, trackY + TRACK_HEIGHT }, (Vector2){ timelineBounds.width, trackY + TRACK_HEIGHT }, COLOR_TRACK_BORDER);
+        UiDrawText(app->tracks[t].name, 10, trackY + 5, 14, app->tracks[t].muted ? COLOR_TEXT_DIM : COLOR_TEXT);
+        
+        int hits = QueryTimelineRange(&app->timelineIndex, t, visibleStart, visibleEnd, visible, MAX_VISIBLE_ELEMENTS);
+        if (hits > MAX_VISIBLE_ELEMENTS) hits = MAX_VISIBLE_ELEMENTS;
+        
+        for (int i = 0; i < hits; i++) {
+            const TimelineElement* element = PoolAt(&app->elements, (uint32_t)visible[i]);
+            if (!element) continue;
+            float x0 = fmaxf(TimeToScreenX(app, element->startTime), TRACK_HEADER_WIDTH);
+            float x1 = TimeToScreenX(app, element->startTime + element->duration);
+            Rectangle rect = { x0, trackY + 2, fmaxf(x1 - x0, 1.0f), TRACK_HEIGHT - 4 };
+            
+            UiDrawRectangle(rect, element->color);
+            if (element->type == ELEMENT_TYPE_AUDIO) {
+                // Only the on-screen part of the clip is drawn, one column per pixel
+                PeakFile* peaks = GetTimelinePeaks(app, element->sourceId);
+                Rectangle wave = { rect.x, rect.y, fminf(x1, timelineBounds.width) - x0, rect.height };
+                double offset = element->sourceOffset + (ScreenXToTime(app, x0) - element->startTime);
+                if (peaks && wave.width > 0) DrawWaveform(peaks, wave, offset, GetPixelsPerSecond(app), Fade(BLACK, 0.5f));
+            }
+            if ((uint32_t)visible[i] == app->selectedElement.index && PoolGet(&app->elements, app->selectedElement)) {
+                UiDrawRectangleLines(rect, 2, COLOR_TEXT);
+            }
+            if (rect.width > 40) {
+                UiDrawText(element->name, rect.x + 4, rect.y + 4, 12, COLOR_TEXT);
+            }
+        }
+    }
+    
+    // Draw playhead
+    float playheadX = TimeToScreenX(app, app->playheadPosition);
+    if (playheadX >= TRACK_HEADER_WIDTH) {
+        UiDrawLine((Vector2){ playheadX, areaTop }, (Vector2){ playheadX, areaBottom }, COLOR_TIMELINE_CURSOR);
     }
+}
 
-    // Draw timeline control markers
-    float timelinePosition = app->timelinePosition;
-    DrawLine(timelinePosition, timelineBounds.y + 25, timelinePosition, timelineBounds.y + 25 + trackHeight, COLOR_TIMELINE_CURSOR);
+void UpdateTimeline(AppState* app) {
+    if (!app) return;
+    PROFILE_SCOPE("UpdateTimeline");
+    
+    Rectangle timelineBounds = GetTimelineBounds(app);
+    Vector2 mouse = GetMousePosition();
+    bool hovered = CheckCollisionPointRec(mouse, timelineBounds) && mouse.y > timelineBounds.y + TIMELINE_HEADER_HEIGHT;
+    
+    // Wheel scrolls; with Ctrl held it zooms around the mouse position
+    float wheel = GetMouseWheelMove();
+    if (hovered && wheel != 0.0f) {
+        if (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)) {
+            float anchor = ScreenXToTime(app, mouse.x);
+            float zoom = app->timeline.zoom > 0.0f ? app->timeline.zoom : 1.0f;
+            app->timeline.zoom = fminf(fmaxf(zoom * powf(1.2f, wheel), 0.001f), 100.0f);
+            app->timeline.scrollX = anchor - (mouse.x - TRACK_HEADER_WIDTH) / GetPixelsPerSecond(app);
+        } else {
+            app->timeline.scrollX -= wheel * 50.0f / GetPixelsPerSecond(app);
+        }
+        if (app->timeline.scrollX < 0.0f) app->timeline.scrollX = 0.0f;
+    }
+    
+    float mouseTime = ScreenXToTime(app, mouse.x);
+    int mouseTrack = GetTrackAt(app, timelineBounds, mouse.y);
+    
+    if (hovered && mouse.x >= TRACK_HEADER_WIDTH && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        // The element drawn last (latest start) is on top
+        int hit = QueryTimelineTopmost(&app->timelineIndex, mouseTrack, mouseTime);
+        
+        if (hit >= 0) {
+            app->selectedElement = PoolHandleAt(&app->elements, (uint32_t)hit);
+            const TimelineElement* picked = PoolGet(&app->elements, app->selectedElement);
+            draggingElement = picked != NULL;
+            if (picked) dragTimeOffset = mouseTime - picked->startTime;
+        } else {
+            app->selectedElement = POOL_NULL_HANDLE;
+            app->playheadPosition = fmaxf(mouseTime, 0.0f);
+        }
+    }
     
-    // Optionally, you can draw a playback marker here if you need to visualize the timeline position
+    if (draggingElement) {
+        const TimelineElement* element = PoolGet(&app->elements, app->selectedElement);
+        if (!IsMouseButtonDown(MOUSE_LEFT_BUTTON) || !element) {
+            draggingElement = false;
+        } else {
+            float startTime = fmaxf(SnapTime(app, mouseTime - dragTimeOffset), 0.0f);
+            int track = mouseTrack >= 0 ? mouseTrack : element->trackIndex;
+            if (startTime != element->startTime || track != element->trackIndex) {
+                MoveTimelineElement(app, app->selectedElement, track, startTime);
+            }
+        }
+    }
     
-    // Draw track labels (Optional)
-    for (int i = 0; i < app->numTracks; i++) {
-        DrawText(TextFormat("Track %d", i + 1), 10, trackY + i * (trackHeight + 5) + 5, 14, COLOR_TEXT);
+    // The audio clock moves the playhead when there is one
+    if (app->mixer) {
+        app->playheadPosition = SyncMixerTransport(app->mixer, app->playheadPosition, app->isPlaying, &app->timeline);
+    } else if (app->isPlaying) {
+        app->playheadPosition += app->deltaTime;
     }
+    if (app->streamer) UpdateDiskStreamer(app->streamer, app);
+    if (app->sequencer) UpdateSequencer(app->sequencer, app);
+    
+    // Track parameters are edited in place; the mixer only hears about changes
+    SyncMixerTracks(app->mixer, app->tracks, app->trackCount);
+}
+
+void CreateTrack(AppState* app, const char* name, Color color) {
+    if (!app || app->trackCount >= MAX_TIMELINE_TRACKS) return;
+
+    HistoryLabel(app, "Add track", 0);
+    HistoryCapture(app, JOURNAL_OBJECT_TRACK, (uint32_t)app->trackCount, 0);
+
+    int index = app->trackCount++;
+    Track* track = &app->tracks[index];
+    memset(track, 0, sizeof(*track));
+    strncpy(track->name, name ? name : "Track", sizeof(track->name) - 1);
+    track->color = color;
+    track->volume = 1.0f;
+
+    RecordProjectObject(app, JOURNAL_OBJECT_TRACK, (uint32_t)index, 0);
+    RecordProjectResize(app, JOURNAL_OBJECT_TRACK, 0, 0, app->trackCount);
 }
 
+PoolHandle CreateTimelineElement(AppState* app, const char* name, ElementType type, int trackIndex, float startTime, float duration) {
+    if (!app || trackIndex < 0 || trackIndex >= app->trackCount) return POOL_NULL_HANDLE;
+
+    PoolHandle handle = PoolAlloc(&app->elements);
+    TimelineElement* element = PoolGet(&app->elements, handle);
+    if (!element) return POOL_NULL_HANDLE;
+    if (!TimelineIndexInsert(&app->timelineIndex, trackIndex, (int)handle.index, startTime, startTime + duration)) {
+        PoolFree(&app->elements, handle);
+        return POOL_NULL_HANDLE;
+    }
+
+    strncpy(element->name, name ? name : "Element", sizeof(element->name) - 1);
+    element->type = type;
+    element->id = (int)handle.index;
+    element->color = app->tracks[trackIndex].color;
+    element->trackIndex = trackIndex;
+    element->startTime = startTime;
+    element->duration = duration;
+    element->sourceId = -1;
+
+    HistoryLabel(app, "Add element", 0);
+    HistoryCaptureCreated(app, JOURNAL_OBJECT_ELEMENT, handle.index, 0);
+    RecordProjectAlloc(app, JOURNAL_OBJECT_ELEMENT, handle.index);
+    RecordProjectObject(app, JOURNAL_OBJECT_ELEMENT, handle.index, 0);
+    return handle;
+}
+
+void MoveTimelineElement(AppState* app, PoolHandle handle, int trackIndex, float startTime) {
+    if (!app || trackIndex < 0 || trackIndex >= app->trackCount) return;
+
+    TimelineElement* element = PoolGet(&app->elements, handle);
+    if (!element) return;
+
+    // A drag moves the element every frame; it undoes as one step
+    HistoryLabel(app, "Move element", HistoryMergeKey(JOURNAL_OBJECT_ELEMENT, handle.index, 0, 0));
+    HistoryCapture(app, JOURNAL_OBJECT_ELEMENT, handle.index, 0);
+    if (!TimelineIndexMove(&app->timelineIndex, (int)handle.index, element->trackIndex, element->startTime,
+                           trackIndex, startTime, startTime + element->duration)) return;
+
+    element->trackIndex = trackIndex;
+    element->startTime = startTime;
+    JOURNAL_FIELD(app, JOURNAL_OBJECT_ELEMENT, handle.index, element, trackIndex);
+    JOURNAL_FIELD(app, JOURNAL_OBJECT_ELEMENT, handle.index, element, startTime);
+}
+
+void DeleteTimelineElement(AppState* app, PoolHandle handle) {
+    if (!app) return;
+
+    const TimelineElement* element = PoolGet(&app->elements, handle);
+    if (!element) return;
+
+    HistoryLabel(app, "Delete element", 0);
+    HistoryCapture(app, JOURNAL_OBJECT_ELEMENT, handle.index, 0);
+
+    // Slots are stable, so nothing else in the index needs renaming
+    TimelineIndexRemove(&app->timelineIndex, element->trackIndex, (int)handle.index, element->startTime);
+    PoolFree(&app->elements, handle);
+    RecordProjectFree(app, JOURNAL_OBJECT_ELEMENT, handle.index);
+}
+
+void RebuildTimelineIndex(AppState* app) {
+    if (!app) return;
+
+    // Append everything unsorted and sort each track once
+    ClearTimelineIndex(&app->timelineIndex);
+    for (uint32_t slot = 0; slot < app->elements.slotCount; slot++) {
+        const TimelineElement* element = PoolAt(&app->elements, slot);
+        if (!element) continue;
+        TimelineIndexAppend(&app->timelineIndex, element->trackIndex, (int)slot, element->startTime,
+                            element->startTime + element->duration);
+    }
+    SortTimelineIndex(&app->timelineIndex);
+}
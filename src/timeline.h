@@ -7,6 +7,14 @@
 void DrawTimeline(AppState* app);
 void UpdateTimeline(AppState* app);
 void CreateTrack(AppState* app, const char* name, Color color);
-void CreateTimelineElement(AppState* app, const char* name, ElementType type, int trackIndex, float startTime, float duration);
+PoolHandle CreateTimelineElement(AppState* app, const char* name, ElementType type, int trackIndex, float startTime, float duration);
+void MoveTimelineElement(AppState* app, PoolHandle element, int trackIndex, float startTime);
+void DeleteTimelineElement(AppState* app, PoolHandle element);
+void RebuildTimelineIndex(AppState* app);
+
+// Waveforms of audio elements are acquired the first time an element shows
+// them and kept until the project is cleared
+bool AreTimelinePeaksPending(const AppState* app);
+void ReleaseTimelinePeaks(AppState* app);
 
 #endif // TIMELINE_H
@@ -0,0 +1,335 @@
+#include "timeline_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+static bool ReserveTrack(TrackIntervals* track, int count) {
+    if (count <= track->capacity) return true;
+
+    int capacity = track->capacity ? track->capacity * 2 : 64;
+    while (capacity < count) capacity *= 2;
+
+    IntervalNode* nodes = realloc(track->nodes, capacity * sizeof(IntervalNode));
+    if (!nodes) return false;
+    track->nodes = nodes;
+    track->capacity = capacity;
+    return true;
+}
+
+static void ResetTrack(TrackIntervals* track) {
+    track->root = -1;
+    track->count = 0;
+    track->used = 0;
+    track->freeList = -1;
+    track->appended = 0;
+}
+
+static TrackIntervals* GetTrack(TimelineIndex* index, int track) {
+    if (track < 0) return NULL;
+    if (track >= index->trackCount) {
+        TrackIntervals* tracks = realloc(index->tracks, (track + 1) * sizeof(TrackIntervals));
+        if (!tracks) return NULL;
+        memset(tracks + index->trackCount, 0, (track + 1 - index->trackCount) * sizeof(TrackIntervals));
+        for (int t = index->trackCount; t <= track; t++) ResetTrack(&tracks[t]);
+        index->tracks = tracks;
+        index->trackCount = track + 1;
+    }
+    return &index->tracks[track];
+}
+
+// Call ReserveTrack first
+static int AllocateNode(TrackIntervals* track, int element, float start, float end) {
+    int node = track->freeList;
+    if (node >= 0) track->freeList = track->nodes[node].left;
+    else node = track->used++;
+
+    track->nodes[node] = (IntervalNode){ start, end, end, element, -1, -1, 1 };
+    return node;
+}
+
+static void FreeNode(TrackIntervals* track, int node) {
+    track->nodes[node].element = -1;
+    track->nodes[node].left = track->freeList;
+    track->freeList = node;
+}
+
+//----------------------------------------------------------------------------------
+// AVL tree
+//----------------------------------------------------------------------------------
+
+static int Height(const TrackIntervals* track, int node) {
+    return node < 0 ? 0 : track->nodes[node].height;
+}
+
+static void UpdateNode(TrackIntervals* track, int node) {
+    IntervalNode* n = &track->nodes[node];
+    int left = Height(track, n->left), right = Height(track, n->right);
+    n->height = 1 + (left > right ? left : right);
+    n->maxEnd = n->end;
+    if (n->left >= 0 && track->nodes[n->left].maxEnd > n->maxEnd) n->maxEnd = track->nodes[n->left].maxEnd;
+    if (n->right >= 0 && track->nodes[n->right].maxEnd > n->maxEnd) n->maxEnd = track->nodes[n->right].maxEnd;
+}
+
+static int RotateRight(TrackIntervals* track, int node) {
+    int left = track->nodes[node].left;
+    track->nodes[node].left = track->nodes[left].right;
+    track->nodes[left].right = node;
+    UpdateNode(track, node);
+    UpdateNode(track, left);
+    return left;
+}
+
+static int RotateLeft(TrackIntervals* track, int node) {
+    int right = track->nodes[node].right;
+    track->nodes[node].right = track->nodes[right].left;
+    track->nodes[right].left = node;
+    UpdateNode(track, node);
+    UpdateNode(track, right);
+    return right;
+}
+
+// Returns the subtree's new root
+static int Rebalance(TrackIntervals* track, int node) {
+    UpdateNode(track, node);
+    IntervalNode* n = &track->nodes[node];
+    int balance = Height(track, n->left) - Height(track, n->right);
+    if (balance > 1) {
+        const IntervalNode* left = &track->nodes[n->left];
+        if (Height(track, left->left) < Height(track, left->right)) n->left = RotateLeft(track, n->left);
+        return RotateRight(track, node);
+    }
+    if (balance < -1) {
+        const IntervalNode* right = &track->nodes[n->right];
+        if (Height(track, right->right) < Height(track, right->left)) n->right = RotateRight(track, n->right);
+        return RotateLeft(track, node);
+    }
+    return node;
+}
+
+// Tree order: start time, then element index
+static bool OrderedBefore(float start, int element, const IntervalNode* node) {
+    return start < node->start || (start == node->start && element < node->element);
+}
+
+static int InsertNode(TrackIntervals* track, int root, int node) {
+    if (root < 0) return node;
+    const IntervalNode* n = &track->nodes[node];
+    if (OrderedBefore(n->start, n->element, &track->nodes[root])) {
+        int left = InsertNode(track, track->nodes[root].left, node);
+        track->nodes[root].left = left;
+    } else {
+        int right = InsertNode(track, track->nodes[root].right, node);
+        track->nodes[root].right = right;
+    }
+    return Rebalance(track, root);
+}
+
+static int DetachMin(TrackIntervals* track, int root, int* min) {
+    if (track->nodes[root].left < 0) {
+        *min = root;
+        return track->nodes[root].right;
+    }
+    int left = DetachMin(track, track->nodes[root].left, min);
+    track->nodes[root].left = left;
+    return Rebalance(track, root);
+}
+
+static int RemoveNode(TrackIntervals* track, int root, float start, int element, int* removed) {
+    if (root < 0) return -1;
+    IntervalNode* n = &track->nodes[root];
+    if (n->element == element && n->start == start) {
+        *removed = root;
+        if (n->left < 0) return n->right;
+        if (n->right < 0) return n->left;
+        int min;
+        int right = DetachMin(track, n->right, &min);
+        track->nodes[min].left = n->left;
+        track->nodes[min].right = right;
+        return Rebalance(track, min);
+    }
+    if (OrderedBefore(start, element, n)) {
+        int left = RemoveNode(track, n->left, start, element, removed);
+        track->nodes[root].left = left;
+    } else {
+        int right = RemoveNode(track, n->right, start, element, removed);
+        track->nodes[root].right = right;
+    }
+    return Rebalance(track, root);
+}
+
+// Nodes [from, to) are in tree order
+static int BuildTree(TrackIntervals* track, int from, int to) {
+    if (from >= to) return -1;
+    int mid = from + (to - from) / 2;
+    track->nodes[mid].left = BuildTree(track, from, mid);
+    track->nodes[mid].right = BuildTree(track, mid + 1, to);
+    UpdateNode(track, mid);
+    return mid;
+}
+
+// Unlinks an element; false when it is not in the track's tree
+static bool DetachElement(TrackIntervals* track, int element, float start) {
+    int removed = -1;
+    int root = RemoveNode(track, track->root, start, element, &removed);
+    if (removed < 0) {
+        // Fall back to a scan in case the caller's start time is out of date
+        for (int i = 0; i < track->used && removed < 0; i++) {
+            if (track->nodes[i].element != element) continue;
+            float actual = track->nodes[i].start;
+            root = RemoveNode(track, track->root, actual, element, &removed);
+        }
+        if (removed < 0) return false;
+    }
+    track->root = root;
+    FreeNode(track, removed);
+    track->count--;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Index maintenance
+//----------------------------------------------------------------------------------
+
+void InitTimelineIndex(TimelineIndex* index) {
+    memset(index, 0, sizeof(*index));
+}
+
+void UnloadTimelineIndex(TimelineIndex* index) {
+    for (int t = 0; t < index->trackCount; t++) free(index->tracks[t].nodes);
+    free(index->tracks);
+    memset(index, 0, sizeof(*index));
+}
+
+void ClearTimelineIndex(TimelineIndex* index) {
+    for (int t = 0; t < index->trackCount; t++) ResetTrack(&index->tracks[t]);
+}
+
+bool TimelineIndexInsert(TimelineIndex* index, int track, int element, float start, float end) {
+    TrackIntervals* intervals = GetTrack(index, track);
+    if (!intervals || !ReserveTrack(intervals, intervals->used + 1)) return false;
+
+    int node = AllocateNode(intervals, element, start, end);
+    intervals->root = InsertNode(intervals, intervals->root, node);
+    intervals->count++;
+    return true;
+}
+
+bool TimelineIndexAppend(TimelineIndex* index, int track, int element, float start, float end) {
+    TrackIntervals* intervals = GetTrack(index, track);
+    if (!intervals || !ReserveTrack(intervals, intervals->used + 1)) return false;
+
+    // Linked into the tree by the sort
+    intervals->nodes[intervals->used++] = (IntervalNode){ start, end, end, element, -1, -1, 1 };
+    intervals->count++;
+    intervals->appended++;
+    return true;
+}
+
+typedef struct {
+    float start;
+    float end;
+    int element;
+} IntervalEntry;
+
+static int CompareIntervals(const void* a, const void* b) {
+    const IntervalEntry* x = a;
+    const IntervalEntry* y = b;
+    if (x->start != y->start) return x->start < y->start ? -1 : 1;
+    return x->element - y->element;
+}
+
+// Sorts everything a track holds into a compact, perfectly balanced tree
+void SortTimelineIndex(TimelineIndex* index) {
+    for (int t = 0; t < index->trackCount; t++) {
+        TrackIntervals* intervals = &index->tracks[t];
+        if (intervals->appended == 0) continue;
+
+        IntervalEntry* entries = malloc(intervals->count * sizeof(IntervalEntry));
+        if (!entries) continue;
+        int count = 0;
+        for (int i = 0; i < intervals->used; i++) {
+            const IntervalNode* node = &intervals->nodes[i];
+            if (node->element >= 0) entries[count++] = (IntervalEntry){ node->start, node->end, node->element };
+        }
+        qsort(entries, count, sizeof(IntervalEntry), CompareIntervals);
+        for (int i = 0; i < count; i++) {
+            intervals->nodes[i] = (IntervalNode){ entries[i].start, entries[i].end, entries[i].end, entries[i].element, -1, -1, 1 };
+        }
+        free(entries);
+
+        ResetTrack(intervals);
+        intervals->count = count;
+        intervals->used = count;
+        intervals->root = BuildTree(intervals, 0, count);
+    }
+}
+
+bool TimelineIndexRemove(TimelineIndex* index, int track, int element, float start) {
+    if (track < 0 || track >= index->trackCount) return false;
+    return DetachElement(&index->tracks[track], element, start);
+}
+
+bool TimelineIndexMove(TimelineIndex* index, int element, int oldTrack, float oldStart,
+                       int newTrack, float newStart, float newEnd) {
+    TimelineIndexRemove(index, oldTrack, element, oldStart);
+    return TimelineIndexInsert(index, newTrack, element, newStart, newEnd);
+}
+
+//----------------------------------------------------------------------------------
+// Queries
+//----------------------------------------------------------------------------------
+
+// In order, elements that start before `to` (or at it when inclusive) and
+// end after `from`
+static int CollectOverlaps(const TrackIntervals* track, int node, float from, float to, bool inclusive,
+                           int* results, int maxResults, int hits) {
+    while (node >= 0) {
+        const IntervalNode* n = &track->nodes[node];
+        if (n->maxEnd <= from) break;
+
+        hits = CollectOverlaps(track, n->left, from, to, inclusive, results, maxResults, hits);
+        if (n->start > to || (!inclusive && n->start == to)) break;     // So does all of the right subtree
+        if (n->end > from) {
+            if (hits < maxResults) results[hits] = n->element;
+            hits++;
+        }
+        node = n->right;
+    }
+    return hits;
+}
+
+int GetTimelineTrackCount(const TimelineIndex* index, int track) {
+    return track >= 0 && track < index->trackCount ? index->tracks[track].count : 0;
+}
+
+int QueryTimelineRange(const TimelineIndex* index, int track, float from, float to, int* results, int maxResults) {
+    if (track < 0 || track >= index->trackCount) return 0;
+    const TrackIntervals* intervals = &index->tracks[track];
+    return CollectOverlaps(intervals, intervals->root, from, to, false, results, maxResults, 0);
+}
+
+int QueryTimelinePoint(const TimelineIndex* index, int track, float time, int* results, int maxResults) {
+    if (track < 0 || track >= index->trackCount) return 0;
+    const TrackIntervals* intervals = &index->tracks[track];
+    return CollectOverlaps(intervals, intervals->root, time, time, true, results, maxResults, 0);
+}
+
+// Reverse order, so the first hit is the answer
+static int FindTopmost(const TrackIntervals* track, int node, float time) {
+    while (node >= 0) {
+        const IntervalNode* n = &track->nodes[node];
+        if (n->maxEnd <= time) return -1;
+        if (n->start <= time) {
+            int right = FindTopmost(track, n->right, time);
+            if (right >= 0) return right;
+            if (n->end > time) return n->element;
+        }
+        node = n->left;
+    }
+    return -1;
+}
+
+int QueryTimelineTopmost(const TimelineIndex* index, int track, float time) {
+    if (track < 0 || track >= index->trackCount) return -1;
+    const TrackIntervals* intervals = &index->tracks[track];
+    return FindTopmost(intervals, intervals->root, time);
+}
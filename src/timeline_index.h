@@ -0,0 +1,64 @@
+#ifndef TIMELINE_INDEX_H
+#define TIMELINE_INDEX_H
+
+#include <stdbool.h>
+
+// Per-track interval index over timeline elements.
+//
+// Each track is an AVL tree of its elements ordered by start time (equal
+// starts by element index), where every node also keeps the latest end in
+// its subtree. An overlap query walks the tree in order and skips any
+// subtree whose latest end does not reach the query start, and everything
+// right of a node starting at or after the query end, so it costs
+// O(log n + hits) however long the longest element is. Inserts, moves and
+// deletes are O(log n).
+
+typedef struct {
+    float start;
+    float end;
+    float maxEnd;           // Latest end in this subtree
+    int element;            // -1 while the node is free
+    int left;               // Node indices, -1 for none
+    int right;
+    int height;
+} IntervalNode;
+
+typedef struct {
+    IntervalNode* nodes;
+    int root;               // -1 when empty
+    int count;              // Elements, appended ones included
+    int used;               // Nodes handed out so far, free ones included
+    int capacity;
+    int freeList;           // Free nodes, chained through left
+    int appended;           // Appended since the last sort, not in the tree yet
+} TrackIntervals;
+
+typedef struct {
+    TrackIntervals* tracks;
+    int trackCount;
+} TimelineIndex;
+
+// Index maintenance
+void InitTimelineIndex(TimelineIndex* index);
+void UnloadTimelineIndex(TimelineIndex* index);
+void ClearTimelineIndex(TimelineIndex* index);
+bool TimelineIndexInsert(TimelineIndex* index, int track, int element, float start, float end);
+bool TimelineIndexRemove(TimelineIndex* index, int track, int element, float start);
+bool TimelineIndexMove(TimelineIndex* index, int element, int oldTrack, float oldStart,
+                       int newTrack, float newStart, float newEnd);
+bool TimelineIndexAppend(TimelineIndex* index, int track, int element, float start, float end);   // Bulk load, call SortTimelineIndex after
+void SortTimelineIndex(TimelineIndex* index);
+
+// Elements on a track, for sizing a query of the whole track
+int GetTimelineTrackCount(const TimelineIndex* index, int track);
+
+// Queries; results are written in start time order, the return value is the
+// total number of hits (which may exceed maxResults)
+int QueryTimelineRange(const TimelineIndex* index, int track, float from, float to, int* results, int maxResults);
+int QueryTimelinePoint(const TimelineIndex* index, int track, float time, int* results, int maxResults);
+
+// The last element in start time order under a time, which is the one drawn
+// on top; -1 when there is none
+int QueryTimelineTopmost(const TimelineIndex* index, int track, float time);
+
+#endif // TIMELINE_INDEX_H
@@ -1,51 +1,64 @@
-#include "raylib.h"
+#include "ui_components.h"
 #include "raymath.h"
+#include "draw_list.h"
+#include "text_cache.h"
+#include "atlas.h"
+#include "thumbnail_cache.h"
+#include "profiler.h"
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
 
+#define ASSET_TILE_SIZE 96
+#define ASSET_TILE_LABEL 16
+#define ASSET_TILE_SPACING 8
+
 typedef struct {
     const char *text;
     Vector2 position;
     Vector2 size;
     bool hovered;
     bool clicked;
-} Button;
+} ButtonWidget;
 
 typedef struct {
     Vector2 position;
     float radius;
-    Texture2D icon;
+    AtlasRegion icon;           // Icons share atlas pages so a toolbar is one batch
     bool hovered;
     bool clicked;
-} IconButton;
+} IconButtonWidget;
 
 typedef struct {
     Rectangle bounds;
     float value;
     bool dragging;
-} Slider;
+} SliderWidget;
 
-bool ButtonLogic(Button *btn) {
+bool ButtonLogic(ButtonWidget *btn) {
+    PROFILE_SCOPE("ButtonLogic");
     Vector2 mouse = GetMousePosition();
     btn->hovered = CheckCollisionPointRec(mouse, (Rectangle){btn->position.x, btn->position.y, btn->size.x, btn->size.y});
     btn->clicked = btn->hovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
     return btn->clicked;
 }
 
-void DrawButton(Button *btn) {
+void DrawButton(ButtonWidget *btn) {
+    PROFILE_SCOPE("DrawButton");
     Color color = btn->hovered ? DARKGRAY : GRAY;
-    DrawRectangleV(btn->position, btn->size, color);
-    int textWidth = MeasureText(btn->text, 20);
+    UiDrawRectangle((Rectangle){ btn->position.x, btn->position.y, btn->size.x, btn->size.y }, color);
+    float textWidth = MeasureTextCached(btn->text, 20).x;
     Vector2 textPos = {
         btn->position.x + btn->size.x / 2 - textWidth / 2,
         btn->position.y + btn->size.y / 2 - 10
     };
-    DrawText(btn->text, textPos.x, textPos.y, 20, WHITE);
+    UiDrawText(btn->text, textPos.x, textPos.y, 20, WHITE);
 }
 
-bool IconButtonLogic(IconButton *btn) {
+bool IconButtonLogic(IconButtonWidget *btn) {
+    PROFILE_SCOPE("IconButtonLogic");
     Vector2 mouse = GetMousePosition();
     float dist = Vector2Distance(mouse, btn->position);
     btn->hovered = dist <= btn->radius;
@@ -53,16 +66,18 @@ bool IconButtonLogic(IconButton *btn) {
     return btn->clicked;
 }
 
-void DrawIconButton(IconButton *btn) {
+void DrawIconButton(IconButtonWidget *btn) {
+    PROFILE_SCOPE("DrawIconButton");
     Color color = btn->hovered ? LIGHTGRAY : GRAY;
-    DrawCircleV(btn->position, btn->radius, color);
-    DrawTexturePro(btn->icon,
-        (Rectangle){0, 0, (float)btn->icon.width, (float)btn->icon.height},
+    UiDrawCircle(btn->position, btn->radius, color);
+    if (btn->icon.texture.id == 0) return;
+    UiDrawTexture(btn->icon.texture, btn->icon.source,
         (Rectangle){btn->position.x - btn->radius / 1.5f, btn->position.y - btn->radius / 1.5f, btn->radius * 1.5f, btn->radius * 1.5f},
-        (Vector2){0, 0}, 0.0f, WHITE);
+        WHITE);
 }
 
-float SliderLogic(Slider *sld) {
+float SliderLogic(SliderWidget *sld) {
+    PROFILE_SCOPE("SliderLogic");
     Vector2 mouse = GetMousePosition();
     Rectangle knob = {
         sld->bounds.x + sld->value * sld->bounds.width - 5,
@@ -84,9 +99,143 @@ float SliderLogic(Slider *sld) {
     return sld->value;
 }
 
-void DrawSlider(Slider *sld) {
-    DrawRectangleRec(sld->bounds, DARKGRAY);
+void DrawSlider(SliderWidget *sld) {
+    PROFILE_SCOPE("DrawSlider");
+    UiDrawRectangle(sld->bounds, DARKGRAY);
     float knobX = sld->bounds.x + sld->value * sld->bounds.width;
-    DrawRectangle(knobX - 5, sld->bounds.y - 5, 10, sld->bounds.height + 10, RAYWHITE);
+    UiDrawRectangle((Rectangle){ knobX - 5, sld->bounds.y - 5, 10, sld->bounds.height + 10 }, RAYWHITE);
+}
+
+bool Button(Rectangle bounds, const char* text, bool isActive) {
+    PROFILE_SCOPE("Button");
+    bool hovered = CheckCollisionPointRec(GetMousePosition(), bounds);
+
+    // Same colors as the menu buttons, accent while the toggled thing is shown
+    Color color = isActive ? COLOR_ACCENT : hovered ? (Color){ 81, 113, 144, 255 } : (Color){ 59, 91, 118, 255 };
+    UiDrawRectangle(bounds, color);
+    UiDrawRectangleLines(bounds, 1, hovered ? COLOR_TEXT : COLOR_TRACK_BORDER);
+
+    float fontSize = fminf(20.0f, bounds.height - 4.0f);
+    Vector2 textSize = MeasureTextCached(text, fontSize);
+    UiDrawText(text, bounds.x + (bounds.width - textSize.x) / 2, bounds.y + (bounds.height - textSize.y) / 2, (int)fontSize, COLOR_TEXT);
+
+    return hovered && IsMouseButtonReleased(MOUSE_LEFT_BUTTON);
+}
+
+// One column per pixel, each from GetPeakRange, so the cost follows the
+// width of the view and not the length of the clip
+void DrawWaveform(const PeakFile* peaks, Rectangle bounds, double startSeconds, double pixelsPerSecond, Color color) {
+    PROFILE_SCOPE("DrawWaveform");
+    float center = bounds.y + bounds.height * 0.5f;
+    float halfHeight = bounds.height * 0.5f;
+    if (!PeaksReady(peaks) || pixelsPerSecond <= 0.0) {
+        // Placeholder line until the build finishes, growing with its progress
+        float width = PeaksFailed(peaks) ? 0.0f : bounds.width * GetPeaksProgress(peaks);
+        UiDrawRectangle((Rectangle){ bounds.x, center, width, 1 }, Fade(color, 0.5f));
+        return;
+    }
+
+    int sampleRate = GetPeaksSampleRate(peaks);
+    uint64_t frameCount = GetPeaksFrameCount(peaks);
+    double framesPerPixel = sampleRate / pixelsPerSecond;
+    double startFrame = startSeconds * sampleRate;
+    int columns = (int)bounds.width;
+    for (int x = 0; x < columns; x++) {
+        double from = startFrame + x * framesPerPixel;
+        double to = from + framesPerPixel;
+        if (to <= 0.0) continue;
+        if (from < 0.0) from = 0.0;
+
+        float lo, hi;
+        if (!GetPeakRange(peaks, (uint64_t)from, (uint64_t)to + 1, &lo, &hi)) {
+            if ((uint64_t)from >= frameCount) break;
+            continue;
+        }
+        float top = center - hi * halfHeight;
+        float bottom = center - lo * halfHeight;
+        UiDrawRectangle((Rectangle){ bounds.x + x, top, 1, fmaxf(bottom - top, 1.0f) }, color);
+    }
 }
 
+// Live asset slots in pool order, so the grid can index straight into the
+// rows in view. Only rebuilt when an asset came alive or died.
+static bool UpdateAssetOrder(AppState* app) {
+    if (app->assetOrderVersion == app->assets.version) return true;
+
+    if (app->assets.liveCount > app->assetOrderCapacity) {
+        uint32_t capacity = app->assetOrderCapacity ? app->assetOrderCapacity : 64;
+        while (capacity < app->assets.liveCount) capacity *= 2;
+        uint32_t* grown = realloc(app->assetOrder, capacity * sizeof(uint32_t));
+        if (!grown) return false;
+        app->assetOrder = grown;
+        app->assetOrderCapacity = capacity;
+    }
+    app->assetOrderCount = 0;
+    for (uint32_t slot = 0; slot < app->assets.slotCount; slot++) {
+        if (PoolAt(&app->assets, slot)) app->assetOrder[app->assetOrderCount++] = slot;
+    }
+    app->assetOrderVersion = app->assets.version;
+    return true;
+}
+
+// Only the rows in view are visited, so only their thumbnails are requested,
+// generated and kept on the GPU
+void DrawAssetGrid(AppState* app, Rectangle bounds) {
+    PROFILE_SCOPE("DrawAssetGrid");
+    if (!UpdateAssetOrder(app)) return;
+
+    Panel* panel = &app->panels[PANEL_ASSETS];
+    float cell = ASSET_TILE_SIZE + ASSET_TILE_SPACING;
+    float rowHeight = cell + ASSET_TILE_LABEL;
+    int columns = (int)((bounds.width - ASSET_TILE_SPACING) / cell);
+    if (columns < 1) columns = 1;
+    int count = (int)app->assetOrderCount;
+    int rows = (count + columns - 1) / columns;
+
+    Vector2 mouse = GetMousePosition();
+    bool hovered = CheckCollisionPointRec(mouse, bounds);
+    float maxScroll = rows * rowHeight + ASSET_TILE_SPACING - bounds.height;
+    if (hovered) panel->scrollPosition.y -= GetMouseWheelMove() * rowHeight;
+    if (panel->scrollPosition.y > maxScroll) panel->scrollPosition.y = maxScroll;
+    if (panel->scrollPosition.y < 0.0f) panel->scrollPosition.y = 0.0f;
+
+    int firstRow = (int)(panel->scrollPosition.y / rowHeight);
+    int lastRow = (int)((panel->scrollPosition.y + bounds.height) / rowHeight);
+    int first = firstRow * columns;
+    int last = (lastRow + 1) * columns;
+    if (last > count) last = count;
+
+    UiBeginScissor(bounds);
+    for (int i = first; i < last; i++) {
+        uint32_t slot = app->assetOrder[i];
+        const Asset* asset = PoolAt(&app->assets, slot);
+        Rectangle tile = {
+            bounds.x + ASSET_TILE_SPACING + (i % columns) * cell,
+            bounds.y + ASSET_TILE_SPACING + (i / columns) * rowHeight - panel->scrollPosition.y,
+            ASSET_TILE_SIZE, ASSET_TILE_SIZE
+        };
+        UiDrawRectangle(tile, COLOR_TRACK_BG);
+
+        AtlasRegion thumbnail = RequestThumbnail(app->thumbnails, asset->path);
+        if (thumbnail.texture.id != 0) {
+            // Fit inside the tile, keeping the aspect ratio
+            float scale = fminf(tile.width / thumbnail.source.width, tile.height / thumbnail.source.height);
+            Rectangle dest = { 0, 0, thumbnail.source.width * scale, thumbnail.source.height * scale };
+            dest.x = tile.x + (tile.width - dest.width) * 0.5f;
+            dest.y = tile.y + (tile.height - dest.height) * 0.5f;
+            UiDrawTexture(thumbnail.texture, thumbnail.source, dest, WHITE);
+        } else {
+            UiDrawText(asset->type, tile.x + 6, tile.y + tile.height * 0.5f - 6, 12, COLOR_TEXT_DIM);
+        }
+
+        bool selected = PoolGet(&app->assets, app->selectedAsset) == asset;
+        if (selected) UiDrawRectangleLines(tile, 2, COLOR_ACCENT);
+        UiDrawText(asset->name, tile.x, tile.y + tile.height + 2, 12, selected ? COLOR_TEXT : COLOR_TEXT_DIM);
+
+        Rectangle hit = { tile.x, tile.y, tile.width, tile.height + ASSET_TILE_LABEL };
+        if (hovered && CheckCollisionPointRec(mouse, hit) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            app->selectedAsset = PoolHandleAt(&app->assets, slot);
+        }
+    }
+    UiEndScissor();
+}
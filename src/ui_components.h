@@ -2,6 +2,8 @@
 #define UI_COMPONENTS_H
 
 #include "app_state.h"
+#include "draw_list.h"
+#include "peak_cache.h"
 
 // UI Component declarations
 bool Button(Rectangle bounds, const char* text, bool isActive);
@@ -9,9 +11,10 @@ bool IconButton(Rectangle bounds, const char* icon, const char* tooltip, bool is
 void Slider(Rectangle bounds, float* value, float min, float max, const char* label);
 void UpdateTextInput(TextInput* input);
 bool Dropdown(Rectangle bounds, const char* label, const char** options, int optionCount, int* selectedIndex);
-void DrawPropertyEditor(AppState* app, ComponentProperty* property, Rectangle bounds);
+void DrawPropertyEditor(AppState* app, Entity entity, int componentType, Rectangle bounds);
 void DrawTabBar(Rectangle bounds, const char** tabNames, int tabCount, int* selectedTab);
-void DrawWaveform(Rectangle bounds, Color color);
+void DrawWaveform(const PeakFile* peaks, Rectangle bounds, double startSeconds, double pixelsPerSecond, Color color);
+void DrawAssetGrid(AppState* app, Rectangle bounds);
 void DrawContextMenu(AppState* app);
 
 #endif // UI_COMPONENTS_H
@@ -1,15 +1,22 @@
 #include "utils.h"
+#include "project_file.h"
+#include "journal.h"
+#include "timeline.h"
+#include "scene.h"
+#include "history.h"
 #include <sys/stat.h>
 
 #if defined(_WIN32)
     #include <windows.h>
     #include <direct.h>  // For _mkdir
     #define DEFAULT_PROJECT_PATH "C:/ProgramFiles/BlockiroLLC/HarmonyBox/Projects"
+    #define DEFAULT_CACHE_PARENT "C:/ProgramFiles/BlockiroLLC/GearBox"
     #define mkdir(path, mode) _mkdir(path)
 #else
     #include <unistd.h>
     #include <pwd.h>
     #define DEFAULT_PROJECT_PATH_PREFIX "/.HarmonyBox/Projects"
+    #define DEFAULT_CACHE_PARENT_PREFIX "/.GearBox"
 #endif
 
 char* GetDefaultProjectPath(void) {
@@ -28,17 +35,37 @@ char* GetDefaultProjectPath(void) {
 #endif
 }
 
+char* GetCacheDirectory(void) {
+#if defined(_WIN32)
+    const char* parent = DEFAULT_CACHE_PARENT;
+#else
+    struct passwd* pw = getpwuid(getuid());
+    char parent[512];
+    snprintf(parent, sizeof(parent), "%s%s", pw ? pw->pw_dir : "/tmp", DEFAULT_CACHE_PARENT_PREFIX);
+#endif
+    size_t len = strlen(parent) + strlen(DIR_SEPARATOR "Cache") + 1;
+    char* path = malloc(len);
+    if (!path) return NULL;
+    snprintf(path, len, "%s%sCache", parent, DIR_SEPARATOR);
+
+    // Shared by every project, so it lives next to the projects folder
+    EnsureDirectoryExists(parent);
+    EnsureDirectoryExists(path);
+    return path;
+}
+
 void EnsureDirectoryExists(const char* path) {
     if (!path) return;
     mkdir(path, 0777);
 }
 
-FileBrowser InitFileBrowser(const char* directory) {
+FileBrowser InitFileBrowser(DirScanner* scanner, const char* directory) {
     FileBrowser browser;
     
     strncpy(browser.currentDirectory, directory ? directory : ".", 511);
     browser.currentDirectory[511] = '\0';
-    browser.files = LoadDirectoryFiles(browser.currentDirectory);
+    browser.scanner = scanner;
+    browser.listing = AcquireDirectory(scanner, browser.currentDirectory);
     browser.selectedFile = -1;
     browser.scrollPosition = (Vector2){0};
     
@@ -47,23 +74,59 @@ FileBrowser InitFileBrowser(const char* directory) {
 
 void UnloadFileBrowser(FileBrowser* browser) {
     if (browser) {
-        UnloadDirectoryFiles(browser->files);
+        ReleaseDirectory(browser->scanner, browser->listing);
+        browser->listing = NULL;
     }
 }
 
+// Build "<projectDir>/project.gbproj" into buffer
+static void GetProjectFilePath(const char* projectDir, char* buffer, size_t bufferSize) {
+    snprintf(buffer, bufferSize, "%s%s%s", projectDir, DIR_SEPARATOR, PROJECT_FILE_NAME);
+}
+
 void SaveProject(AppState* app) {
-    // Placeholder for saving project functionality
     if (app && app->projectPath[0] != '\0') {
-        TraceLog(LOG_INFO, "Saving project to: %s", app->projectPath);
-        app->projectModified = false;
+        char filePath[512];
+        GetProjectFilePath(app->projectPath, filePath, sizeof(filePath));
+        TraceLog(LOG_INFO, "Saving project to: %s", filePath);
+
+        // With a journal open the write happens on its background thread and
+        // UpdateJournal clears projectModified once it is confirmed
+        EnsureDirectoryExists(app->projectPath);
+        if (app->journal) {
+            if (!SaveProjectJournal(app)) TraceLog(LOG_WARNING, "Failed to save project to: %s", filePath);
+        } else if (WriteProjectFile(app, filePath)) {
+            app->projectModified = false;
+        }
     }
 }
 
 void LoadProject(AppState* app, const char* path) {
-    // Placeholder for loading project functionality
     if (app && path) {
-        TraceLog(LOG_INFO, "Loading project from: %s", path);
+        char filePath[512];
+        GetProjectFilePath(path, filePath, sizeof(filePath));
+        TraceLog(LOG_INFO, "Loading project from: %s", filePath);
+
+        CloseJournal(app->journal);
+        app->journal = NULL;
+        app->saveTicket = 0;
+
         strncpy(app->projectPath, path, sizeof(app->projectPath) - 1);
+        app->projectPath[sizeof(app->projectPath) - 1] = '\0';
         app->projectModified = false;
+
+        // A missing project file just means a freshly created project
+        if (FileExists(filePath)) {
+            ReadProjectFile(app, filePath);
+        }
+
+        // Apply edits that were journaled but never compacted (e.g. after a
+        // crash) and fold them into the project file straight away
+        int recovered = ReplayJournal(app, path);
+        app->journal = OpenJournal(path);
+        if (recovered > 0) SaveProjectJournal(app);
+        RebuildTimelineIndex(app);
+        RebuildSceneBounds(app);
+        ClearHistory(app->history);
     }
 }
@@ -12,8 +12,9 @@
 
 // Function declarations
 char* GetDefaultProjectPath(void);
+char* GetCacheDirectory(void);     // Created if missing; caller frees
 void EnsureDirectoryExists(const char* path);
-FileBrowser InitFileBrowser(const char* directory);
+FileBrowser InitFileBrowser(DirScanner* scanner, const char* directory);
 void UnloadFileBrowser(FileBrowser* browser);
 void SaveProject(AppState* app);
 void LoadProject(AppState* app, const char* path);
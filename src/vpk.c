@@ -0,0 +1,346 @@
+#include "vpk.h"
+#include "mapped_file.h"
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VPK_HEADER_V1_SIZE 12
+#define VPK_HEADER_V2_SIZE 28
+#define VPK_ENTRY_SIZE 18               // crc, preload size, archive, offset, length, terminator
+#define VPK_ENTRY_TERMINATOR 0xFFFF
+#define VPK_HASH_BASIS 14695981039346656037ull
+#define VPK_NONE UINT32_MAX
+
+// Offsets into the mapped directory file, so a file costs 16 bytes of index
+typedef struct {
+    uint32_t directory;                 // VPK_NONE at the root
+    uint32_t name;
+    uint32_t extension;                 // VPK_NONE when the file has none
+    uint32_t record;                    // VPK_ENTRY_SIZE bytes, then the preload bytes
+} VpkEntry;
+
+typedef struct {
+    uint32_t tag;                       // Top half of the path hash, 0 marks an empty slot
+    uint32_t entry;
+} VpkSlot;
+
+struct Vpk {
+    MappedFile directory;
+    const unsigned char* data;          // After the tree, for VPK_DIR_ARCHIVE
+    size_t dataSize;
+    MappedFile* archives;               // By chunk index; unmapped when missing
+    int archiveCount;
+    int missingArchives;
+    VpkEntry* entries;
+    uint32_t entryCount;
+    VpkSlot* slots;
+    uint32_t slotMask;
+};
+
+static uint16_t ReadU16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//----------------------------------------------------------------------------------
+// Paths
+//----------------------------------------------------------------------------------
+
+static unsigned char FoldPathChar(char c) {
+    if (c == '\\') return '/';
+    if (c >= 'A' && c <= 'Z') return (unsigned char)(c + ('a' - 'A'));
+    return (unsigned char)c;
+}
+
+static uint64_t HashPathChar(uint64_t hash, char c) {
+    hash ^= FoldPathChar(c);
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+static uint64_t HashPathPart(uint64_t hash, const char* part) {
+    for (; *part; part++) hash = HashPathChar(hash, *part);
+    return hash;
+}
+
+static uint32_t HashTag(uint64_t hash) {
+    uint32_t tag = (uint32_t)(hash >> 32);
+    return tag ? tag : 1;
+}
+
+static const char* EntryString(const Vpk* vpk, uint32_t offset) {
+    return offset != VPK_NONE ? (const char*)vpk->directory.data + offset : NULL;
+}
+
+// Hashes "directory/name.extension" the way the query string would hash
+static uint64_t HashEntry(const Vpk* vpk, const VpkEntry* entry) {
+    uint64_t hash = VPK_HASH_BASIS;
+    if (entry->directory != VPK_NONE) hash = HashPathChar(HashPathPart(hash, EntryString(vpk, entry->directory)), '/');
+    hash = HashPathPart(hash, EntryString(vpk, entry->name));
+    if (entry->extension != VPK_NONE) hash = HashPathPart(HashPathChar(hash, '.'), EntryString(vpk, entry->extension));
+    return hash;
+}
+
+static const char* MatchPathPart(const char* query, const char* part) {
+    for (; *part; part++, query++) {
+        if (!*query || FoldPathChar(*query) != FoldPathChar(*part)) return NULL;
+    }
+    return query;
+}
+
+static bool MatchEntry(const Vpk* vpk, const VpkEntry* entry, const char* query) {
+    if (entry->directory != VPK_NONE) {
+        query = MatchPathPart(query, EntryString(vpk, entry->directory));
+        if (!query || FoldPathChar(*query++) != '/') return false;
+    }
+    query = MatchPathPart(query, EntryString(vpk, entry->name));
+    if (!query) return false;
+    if (entry->extension != VPK_NONE) {
+        if (*query++ != '.') return false;
+        query = MatchPathPart(query, EntryString(vpk, entry->extension));
+        if (!query) return false;
+    }
+    return *query == '\0';
+}
+
+//----------------------------------------------------------------------------------
+// Tree
+//----------------------------------------------------------------------------------
+
+static const char* ReadTreeString(const unsigned char** p, const unsigned char* end) {
+    const unsigned char* terminator = memchr(*p, 0, (size_t)(end - *p));
+    if (!terminator) return NULL;
+    const char* string = (const char*)*p;
+    *p = terminator + 1;
+    return string;
+}
+
+// The tree is extension -> directory -> name, each level ended by an empty
+// string, and a single space stands for "none". Walked twice: once to count
+// (entries NULL), once to fill.
+static bool WalkTree(const unsigned char* base, const unsigned char* p, const unsigned char* end,
+                     VpkEntry* entries, uint32_t* count, int* archiveCount) {
+    uint32_t n = 0;
+    for (;;) {
+        const char* extension = ReadTreeString(&p, end);
+        if (!extension) return false;
+        if (!*extension) break;
+        for (;;) {
+            const char* directory = ReadTreeString(&p, end);
+            if (!directory) return false;
+            if (!*directory) break;
+            for (;;) {
+                const char* name = ReadTreeString(&p, end);
+                if (!name) return false;
+                if (!*name) break;
+                if ((size_t)(end - p) < VPK_ENTRY_SIZE) return false;
+                const unsigned char* record = p;
+                uint16_t preload = ReadU16(record + 4);
+                uint16_t archive = ReadU16(record + 6);
+                if (ReadU16(record + 16) != VPK_ENTRY_TERMINATOR) return false;
+                if ((size_t)(end - p) - VPK_ENTRY_SIZE < preload) return false;
+                p += VPK_ENTRY_SIZE + preload;
+
+                if (archive != VPK_DIR_ARCHIVE) {
+                    if (archive >= VPK_MAX_ARCHIVES) return false;
+                    if (archive + 1 > *archiveCount) *archiveCount = archive + 1;
+                }
+                if (entries) {
+                    entries[n] = (VpkEntry){
+                        strcmp(directory, " ") != 0 ? (uint32_t)((const unsigned char*)directory - base) : VPK_NONE,
+                        (uint32_t)((const unsigned char*)name - base),
+                        strcmp(extension, " ") != 0 ? (uint32_t)((const unsigned char*)extension - base) : VPK_NONE,
+                        (uint32_t)(record - base)
+                    };
+                }
+                n++;
+            }
+        }
+    }
+    *count = n;
+    return true;
+}
+
+static void BuildIndex(Vpk* vpk) {
+    for (uint32_t i = 0; i < vpk->entryCount; i++) {
+        uint64_t hash = HashEntry(vpk, &vpk->entries[i]);
+        uint32_t slot = (uint32_t)hash & vpk->slotMask;
+        while (vpk->slots[slot].tag != 0) slot = (slot + 1) & vpk->slotMask;
+        vpk->slots[slot] = (VpkSlot){ HashTag(hash), i };
+    }
+}
+
+// "<name>_dir.vpk" -> "<name>_NNN.vpk"; packages not named like that have no chunks
+static void MapArchives(Vpk* vpk, const char* dirPath) {
+    size_t length = strlen(dirPath);
+    const char* suffix = "_dir.vpk";
+    size_t suffixLength = strlen(suffix);
+    bool split = length > suffixLength;
+    for (size_t i = 0; split && i < suffixLength; i++) {
+        if (FoldPathChar(dirPath[length - suffixLength + i]) != (unsigned char)suffix[i]) split = false;
+    }
+
+    for (int i = 0; i < vpk->archiveCount; i++) {
+        char path[1024];
+        if (split && length - suffixLength + 9 < sizeof(path)) {
+            snprintf(path, sizeof(path), "%.*s_%03d.vpk", (int)(length - suffixLength), dirPath, i);
+            if (MapFile(path, &vpk->archives[i])) continue;
+            TraceLog(LOG_WARNING, "VPK: Missing archive %s", path);
+        }
+        vpk->missingArchives++;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Files
+//----------------------------------------------------------------------------------
+
+static bool ResolveEntry(const Vpk* vpk, const VpkEntry* entry, VpkFile* file) {
+    const unsigned char* record = vpk->directory.data + entry->record;
+    uint16_t archive = ReadU16(record + 6);
+    uint64_t offset = ReadU32(record + 8);
+    uint32_t size = ReadU32(record + 12);
+
+    const unsigned char* base;
+    size_t available;
+    if (archive == VPK_DIR_ARCHIVE) {
+        base = vpk->data;
+        available = vpk->dataSize;
+    } else {
+        if (archive >= vpk->archiveCount || !vpk->archives[archive].data) return false;
+        base = vpk->archives[archive].data;
+        available = vpk->archives[archive].size;
+    }
+    if (size > 0 && offset + size > available) return false;
+
+    file->crc = ReadU32(record);
+    file->preloadSize = ReadU16(record + 4);
+    file->preload = file->preloadSize > 0 ? record + VPK_ENTRY_SIZE : NULL;
+    file->size = size;
+    file->data = size > 0 ? base + offset : NULL;
+    return true;
+}
+
+bool FindVpkFile(const Vpk* vpk, const char* path, VpkFile* file) {
+    if (!vpk || !path || !file || vpk->entryCount == 0) return false;
+    while (*path == '/' || *path == '\\') path++;
+
+    uint64_t hash = HashPathPart(VPK_HASH_BASIS, path);
+    uint32_t tag = HashTag(hash);
+    for (uint32_t slot = (uint32_t)hash & vpk->slotMask; vpk->slots[slot].tag != 0; slot = (slot + 1) & vpk->slotMask) {
+        if (vpk->slots[slot].tag != tag) continue;
+        const VpkEntry* entry = &vpk->entries[vpk->slots[slot].entry];
+        if (MatchEntry(vpk, entry, path)) return ResolveEntry(vpk, entry, file);
+    }
+    return false;
+}
+
+size_t GetVpkFileSize(const VpkFile* file) {
+    return file ? (size_t)file->preloadSize + file->size : 0;
+}
+
+void ReadVpkFile(const VpkFile* file, void* buffer) {
+    if (!file || !buffer) return;
+    if (file->preloadSize > 0) memcpy(buffer, file->preload, file->preloadSize);
+    if (file->size > 0) memcpy((unsigned char*)buffer + file->preloadSize, file->data, file->size);
+}
+
+uint32_t GetVpkFileCount(const Vpk* vpk) {
+    return vpk ? vpk->entryCount : 0;
+}
+
+bool GetVpkFileAt(const Vpk* vpk, uint32_t index, VpkFile* file) {
+    if (!vpk || !file || index >= vpk->entryCount) return false;
+    return ResolveEntry(vpk, &vpk->entries[index], file);
+}
+
+bool GetVpkFilePath(const Vpk* vpk, uint32_t index, char* buffer, size_t capacity) {
+    if (!vpk || !buffer || capacity == 0 || index >= vpk->entryCount) return false;
+    const VpkEntry* entry = &vpk->entries[index];
+    const char* directory = EntryString(vpk, entry->directory);
+    const char* extension = EntryString(vpk, entry->extension);
+    int length = snprintf(buffer, capacity, "%s%s%s%s%s",
+        directory ? directory : "", directory ? "/" : "",
+        EntryString(vpk, entry->name), extension ? "." : "", extension ? extension : "");
+    return length >= 0 && (size_t)length < capacity;
+}
+
+VpkStats GetVpkStats(const Vpk* vpk) {
+    VpkStats stats = { 0 };
+    if (!vpk) return stats;
+    stats.files = vpk->entryCount;
+    stats.archives = vpk->archiveCount;
+    stats.missingArchives = vpk->missingArchives;
+    stats.indexBytes = (size_t)vpk->entryCount * sizeof(VpkEntry) + ((size_t)vpk->slotMask + 1) * sizeof(VpkSlot);
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lifetime
+//----------------------------------------------------------------------------------
+
+Vpk* MountVpk(const char* dirPath) {
+    Vpk* vpk = calloc(1, sizeof(Vpk));
+    if (!vpk) return NULL;
+    if (!MapFile(dirPath, &vpk->directory)) {
+        TraceLog(LOG_WARNING, "VPK: Could not open %s", dirPath ? dirPath : "(null)");
+        free(vpk);
+        return NULL;
+    }
+
+    const unsigned char* base = vpk->directory.data;
+    size_t size = vpk->directory.size;
+    uint32_t version = size >= VPK_HEADER_V1_SIZE ? ReadU32(base + 4) : 0;
+    size_t headerSize = version == 1 ? VPK_HEADER_V1_SIZE : VPK_HEADER_V2_SIZE;
+    if (size < headerSize || ReadU32(base) != VPK_SIGNATURE || (version != 1 && version != 2) ||
+        ReadU32(base + 8) > size - headerSize) {
+        TraceLog(LOG_WARNING, "VPK: %s is not a VPK directory", dirPath);
+        UnmountVpk(vpk);
+        return NULL;
+    }
+    const unsigned char* tree = base + headerSize;
+    const unsigned char* treeEnd = tree + ReadU32(base + 8);
+    vpk->data = treeEnd;
+    vpk->dataSize = size - (size_t)(treeEnd - base);
+    if (version == 2 && ReadU32(base + 12) < vpk->dataSize) vpk->dataSize = ReadU32(base + 12);
+
+    // Count, then fill, so the index is two allocations however many files there are
+    uint32_t count = 0;
+    if (size >= VPK_NONE || !WalkTree(base, tree, treeEnd, NULL, &count, &vpk->archiveCount)) {
+        TraceLog(LOG_WARNING, "VPK: Directory tree of %s is corrupt", dirPath);
+        UnmountVpk(vpk);
+        return NULL;
+    }
+    uint32_t slots = 16;
+    while (slots < count * 2u && slots < (1u << 31)) slots <<= 1;
+    vpk->entries = malloc((size_t)(count > 0 ? count : 1) * sizeof(VpkEntry));
+    vpk->slots = calloc(slots, sizeof(VpkSlot));
+    vpk->archives = calloc((size_t)(vpk->archiveCount > 0 ? vpk->archiveCount : 1), sizeof(MappedFile));
+    if (!vpk->entries || !vpk->slots || !vpk->archives) {
+        TraceLog(LOG_WARNING, "VPK: Out of memory indexing %u files of %s", count, dirPath);
+        UnmountVpk(vpk);
+        return NULL;
+    }
+    vpk->slotMask = slots - 1;
+    int archiveCount = 0;
+    WalkTree(base, tree, treeEnd, vpk->entries, &vpk->entryCount, &archiveCount);
+    BuildIndex(vpk);
+    MapArchives(vpk, dirPath);
+    return vpk;
+}
+
+void UnmountVpk(Vpk* vpk) {
+    if (!vpk) return;
+    if (vpk->archives) {
+        for (int i = 0; i < vpk->archiveCount; i++) UnmapFile(&vpk->archives[i]);
+    }
+    UnmapFile(&vpk->directory);
+    free(vpk->archives);
+    free(vpk->slots);
+    free(vpk->entries);
+    free(vpk);
+}
@@ -0,0 +1,64 @@
+#ifndef VPK_H
+#define VPK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reader for Valve VPK packages, versions 1 and 2.
+//
+// A package set is a "<name>_dir.vpk" holding the directory tree (and some
+// small files) plus numbered "<name>_NNN.vpk" chunks holding the rest. All
+// of them are mapped, nothing is read up front. Mounting walks the tree once
+// and builds a hash index over full paths pointing back into the mapping, so
+// a set with hundreds of thousands of files costs two allocations and a
+// lookup is a hash probe. File data is handed out as views into the mapped
+// chunks and never copied.
+//
+// Paths match case-insensitively, with either slash, like the engine does.
+// A mounted package is read-only, so any thread can look files up.
+
+#define VPK_SIGNATURE 0x55AA1234u
+#define VPK_DIR_ARCHIVE 0x7FFF          // Archive index of data stored in the _dir.vpk itself
+#define VPK_MAX_ARCHIVES 1000           // _000.vpk to _999.vpk
+
+typedef struct Vpk Vpk;
+
+// A file inside a package. Most files are one contiguous view; a file can
+// also keep its first bytes in the directory ("preload") and the rest in a
+// chunk, so readers that need one buffer go through ReadVpkFile.
+typedef struct {
+    const unsigned char* preload;       // NULL when preloadSize is 0
+    uint32_t preloadSize;
+    const unsigned char* data;          // NULL when size is 0
+    uint32_t size;
+    uint32_t crc;                       // CRC32 of the whole file, as stored
+} VpkFile;
+
+typedef struct {
+    uint32_t files;
+    int archives;                       // Chunks referenced by the tree
+    int missingArchives;                // Their files fail to open
+    size_t indexBytes;
+} VpkStats;
+
+// Mounts a "_dir.vpk" (or a single-file package) and the chunks next to it.
+// Returns NULL if the directory is missing or malformed.
+Vpk* MountVpk(const char* dirPath);
+void UnmountVpk(Vpk* vpk);
+
+// Looks up "materials/foo/bar.vtf". False when there is no such file or its
+// data lies outside the mapped chunk.
+bool FindVpkFile(const Vpk* vpk, const char* path, VpkFile* file);
+size_t GetVpkFileSize(const VpkFile* file);
+// Copies preload and data into buffer, which holds at least GetVpkFileSize bytes
+void ReadVpkFile(const VpkFile* file, void* buffer);
+
+// Enumeration in tree order, for filling the asset browser
+uint32_t GetVpkFileCount(const Vpk* vpk);
+bool GetVpkFileAt(const Vpk* vpk, uint32_t index, VpkFile* file);
+bool GetVpkFilePath(const Vpk* vpk, uint32_t index, char* buffer, size_t capacity);
+
+VpkStats GetVpkStats(const Vpk* vpk);
+
+#endif // VPK_H
@@ -0,0 +1,618 @@
+#include "vtf.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define VTF_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define VTF_NEON
+#endif
+
+#define VTF_HEADER_MIN_SIZE 63          // 7.0 header, through the low-res image size
+#define VTF_RESOURCES_OFFSET 80         // 7.3 and later
+#define VTF_RESOURCE_SIZE 8
+#define VTF_RESOURCE_HIGH_RES 0x30
+#define VTF_RESOURCE_NO_DATA 0x02
+
+// Bytes per pixel, 0 for block formats
+static const int formatBytes[VTF_FORMAT_COUNT] = {
+    4, 4, 3, 3, 2, 1, 2, 1, 1, 3, 3, 4, 4, 0, 0, 0, 4, 2, 2, 2, 0, 2, 2, 4, 8, 8, 4
+};
+
+static uint16_t ReadU16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool IsDxtFormat(VtfFormat format) {
+    return format == VTF_FORMAT_DXT1 || format == VTF_FORMAT_DXT1_ONEBITALPHA ||
+           format == VTF_FORMAT_DXT3 || format == VTF_FORMAT_DXT5;
+}
+
+//----------------------------------------------------------------------------------
+// Kernels
+//----------------------------------------------------------------------------------
+
+static void Expand565(uint16_t color, unsigned char* rgb) {
+    int r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    rgb[0] = (unsigned char)((r << 3) | (r >> 2));
+    rgb[1] = (unsigned char)((g << 2) | (g >> 4));
+    rgb[2] = (unsigned char)((b << 3) | (b >> 2));
+}
+
+// DXT3 and DXT5 always use four colors; DXT1 drops to three plus black (or
+// transparent) when the endpoints are in ascending order
+static void BuildColorPaletteScalar(const unsigned char* block, bool fourColor, bool oneBitAlpha, uint32_t palette[4]) {
+    uint16_t c0 = ReadU16(block), c1 = ReadU16(block + 2);
+    unsigned char p[4][4];
+    Expand565(c0, p[0]);
+    Expand565(c1, p[1]);
+    p[0][3] = p[1][3] = 255;
+    if (fourColor || c0 > c1) {
+        for (int i = 0; i < 3; i++) {
+            p[2][i] = (unsigned char)((2 * p[0][i] + p[1][i] + 1) / 3);
+            p[3][i] = (unsigned char)((p[0][i] + 2 * p[1][i] + 1) / 3);
+        }
+        p[2][3] = p[3][3] = 255;
+    } else {
+        for (int i = 0; i < 3; i++) {
+            p[2][i] = (unsigned char)((p[0][i] + p[1][i] + 1) / 2);
+            p[3][i] = 0;
+        }
+        p[2][3] = 255;
+        p[3][3] = oneBitAlpha ? 0 : 255;
+    }
+    memcpy(palette, p, sizeof(p));
+}
+
+// Both interpolated entries at once, every channel in a 16-bit lane; the
+// endpoints are expanded as above
+static void BuildColorPalette(const unsigned char* block, bool fourColor, bool oneBitAlpha, uint32_t palette[4]) {
+#if defined(VTF_SSE2)
+    uint16_t c0 = ReadU16(block), c1 = ReadU16(block + 2);
+    unsigned char ends[8];
+    Expand565(c0, ends);
+    Expand565(c1, ends + 4);
+    ends[3] = ends[7] = 255;
+    memcpy(palette, ends, sizeof(ends));
+
+    __m128i packed = _mm_loadl_epi64((const __m128i*)ends);
+    __m128i swapped = _mm_shuffle_epi32(packed, _MM_SHUFFLE(3, 2, 0, 1));
+    __m128i middle;
+    if (fourColor || c0 > c1) {
+        // (2 * p0 + p1 + 1) / 3 and (p0 + 2 * p1 + 1) / 3; x * 0xAAAB >> 17 is x / 3 for 16-bit x
+        __m128i zero = _mm_setzero_si128();
+        __m128i near = _mm_unpacklo_epi8(packed, zero);
+        __m128i far = _mm_unpacklo_epi8(swapped, zero);
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(near, near), _mm_add_epi16(far, _mm_set1_epi16(1)));
+        __m128i third = _mm_srli_epi16(_mm_mulhi_epu16(sum, _mm_set1_epi16((short)0xAAAB)), 1);
+        middle = _mm_packus_epi16(third, third);
+    } else {
+        // The rounded average, then black, opaque or not
+        uint32_t average = (uint32_t)_mm_cvtsi128_si32(_mm_avg_epu8(packed, swapped));
+        middle = _mm_cvtsi32_si128((int)average);
+        if (!oneBitAlpha) middle = _mm_or_si128(middle, _mm_set_epi32(0, 0, (int)0xFF000000u, 0));
+    }
+    _mm_storel_epi64((__m128i*)(palette + 2), middle);
+#else
+    BuildColorPaletteScalar(block, fourColor, oneBitAlpha, palette);
+#endif
+}
+
+// Picks each pixel's palette entry by its 2-bit index. With alpha (16 bytes,
+// row-major), it replaces the palette's alpha.
+typedef void (*ColorBlockWriter)(const uint32_t palette[4], uint32_t indices, const unsigned char* alpha, unsigned char* rgba, int stride);
+
+static void WriteColorBlockScalar(const uint32_t palette[4], uint32_t indices, const unsigned char* alpha, unsigned char* rgba, int stride) {
+    for (int y = 0; y < 4; y++) {
+        unsigned char* out = rgba + (size_t)y * stride;
+        for (int x = 0; x < 4; x++) {
+            memcpy(out + x * 4, &palette[(indices >> (2 * (4 * y + x))) & 3], 4);
+            if (alpha) out[x * 4 + 3] = alpha[4 * y + x];
+        }
+    }
+}
+
+static void WriteColorBlock(const uint32_t palette[4], uint32_t indices, const unsigned char* alpha, unsigned char* rgba, int stride) {
+#if defined(VTF_SSE2)
+    __m128i p0 = _mm_set1_epi32((int)palette[0]);
+    __m128i p1 = _mm_set1_epi32((int)palette[1]);
+    __m128i p2 = _mm_set1_epi32((int)palette[2]);
+    __m128i p3 = _mm_set1_epi32((int)palette[3]);
+    __m128i three = _mm_set1_epi32(3);
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+    __m128i zero = _mm_setzero_si128();
+    for (int y = 0; y < 4; y++) {
+        uint32_t row = indices >> (8 * y);
+        __m128i index = _mm_and_si128(_mm_setr_epi32((int)row, (int)(row >> 2), (int)(row >> 4), (int)(row >> 6)), three);
+        __m128i c = _mm_and_si128(_mm_cmpeq_epi32(index, zero), p0);
+        c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(index, one), p1));
+        c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(index, two), p2));
+        c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(index, three), p3));
+        if (alpha) {
+            int bytes;
+            memcpy(&bytes, alpha + 4 * y, sizeof(bytes));
+            // Four alpha bytes into the top byte of each pixel
+            __m128i a = _mm_unpacklo_epi8(zero, _mm_cvtsi32_si128(bytes));
+            a = _mm_unpacklo_epi16(zero, a);
+            c = _mm_or_si128(_mm_and_si128(c, colorMask), a);
+        }
+        _mm_storeu_si128((__m128i*)(rgba + (size_t)y * stride), c);
+    }
+#elif defined(VTF_NEON)
+    uint32x4_t p0 = vdupq_n_u32(palette[0]);
+    uint32x4_t p1 = vdupq_n_u32(palette[1]);
+    uint32x4_t p2 = vdupq_n_u32(palette[2]);
+    uint32x4_t p3 = vdupq_n_u32(palette[3]);
+    uint32x4_t three = vdupq_n_u32(3);
+    uint32x4_t colorMask = vdupq_n_u32(0x00FFFFFF);
+    static const int32_t shiftValues[4] = { 0, -2, -4, -6 };
+    int32x4_t shifts = vld1q_s32(shiftValues);
+    for (int y = 0; y < 4; y++) {
+        uint32x4_t index = vandq_u32(vshlq_u32(vdupq_n_u32(indices >> (8 * y)), shifts), three);
+        uint32x4_t c = vandq_u32(vceqq_u32(index, vdupq_n_u32(0)), p0);
+        c = vorrq_u32(c, vandq_u32(vceqq_u32(index, vdupq_n_u32(1)), p1));
+        c = vorrq_u32(c, vandq_u32(vceqq_u32(index, vdupq_n_u32(2)), p2));
+        c = vorrq_u32(c, vandq_u32(vceqq_u32(index, three), p3));
+        if (alpha) {
+            uint32_t bytes;
+            memcpy(&bytes, alpha + 4 * y, sizeof(bytes));
+            uint32x4_t a = vmovl_u16(vget_low_u16(vmovl_u8(vcreate_u8(bytes))));
+            c = vorrq_u32(vandq_u32(c, colorMask), vshlq_n_u32(a, 24));
+        }
+        vst1q_u8(rgba + (size_t)y * stride, vreinterpretq_u8_u32(c));
+    }
+#else
+    WriteColorBlockScalar(palette, indices, alpha, rgba, stride);
+#endif
+}
+
+// DXT5 alpha: eight levels from two endpoints and a 3-bit index per pixel
+static void BuildAlphaLevels(const unsigned char* block, unsigned char levels[8]) {
+    int a0 = block[0], a1 = block[1];
+    levels[0] = (unsigned char)a0;
+    levels[1] = (unsigned char)a1;
+    if (a0 > a1) {
+        for (int k = 1; k <= 6; k++) levels[k + 1] = (unsigned char)(((7 - k) * a0 + k * a1 + 3) / 7);
+    } else {
+        for (int k = 1; k <= 4; k++) levels[k + 1] = (unsigned char)(((5 - k) * a0 + k * a1 + 2) / 5);
+        levels[6] = 0;
+        levels[7] = 255;
+    }
+}
+
+static void DecodeAlphaBlockScalar(const unsigned char* block, unsigned char alpha[16]) {
+    unsigned char levels[8];
+    BuildAlphaLevels(block, levels);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++) alpha[i] = levels[(bits >> (3 * i)) & 7];
+}
+
+#if defined(VTF_SSE2)
+// Eight 3-bit indices into the low bits of eight bytes
+static uint64_t SpreadAlphaIndices(uint32_t bits) {
+    uint64_t v = bits & 0xFFFFFFu;
+    v = (v | (v << 20)) & 0x00000FFF00000FFFull;
+    v = (v | (v << 10)) & 0x003F003F003F003Full;
+    return (v | (v << 5)) & 0x0707070707070707ull;
+}
+#endif
+
+// The levels stay scalar (eight bytes, six of them interpolated); the
+// indices are spread to bytes with a few shifts and every pixel picks its
+// level with one compare per level
+static void DecodeAlphaBlock(const unsigned char* block, unsigned char alpha[16]) {
+#if defined(VTF_SSE2)
+    unsigned char levels[8];
+    BuildAlphaLevels(block, levels);
+    uint32_t low = (uint32_t)block[2] | ((uint32_t)block[3] << 8) | ((uint32_t)block[4] << 16);
+    uint32_t high = (uint32_t)block[5] | ((uint32_t)block[6] << 8) | ((uint32_t)block[7] << 16);
+    __m128i index = _mm_set_epi64x((long long)SpreadAlphaIndices(high), (long long)SpreadAlphaIndices(low));
+    __m128i result = _mm_setzero_si128();
+    for (int k = 0; k < 8; k++) {
+        __m128i match = _mm_cmpeq_epi8(index, _mm_set1_epi8((char)k));
+        result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi8((char)levels[k])));
+    }
+    _mm_storeu_si128((__m128i*)alpha, result);
+#else
+    DecodeAlphaBlockScalar(block, alpha);
+#endif
+}
+
+// One set of block routines: the SIMD ones, or the scalar ones to check them against
+typedef struct {
+    void (*palette)(const unsigned char* block, bool fourColor, bool oneBitAlpha, uint32_t palette[4]);
+    void (*alpha)(const unsigned char* block, unsigned char alpha[16]);
+    ColorBlockWriter write;
+} DxtKernel;
+
+static const DxtKernel simdKernel = { BuildColorPalette, DecodeAlphaBlock, WriteColorBlock };
+static const DxtKernel scalarKernel = { BuildColorPaletteScalar, DecodeAlphaBlockScalar, WriteColorBlockScalar };
+
+static inline void DecodeDxt1(const unsigned char* block, bool oneBitAlpha, unsigned char* rgba, int stride, const DxtKernel* kernel) {
+    uint32_t palette[4];
+    kernel->palette(block, false, oneBitAlpha, palette);
+    kernel->write(palette, ReadU32(block + 4), NULL, rgba, stride);
+}
+
+static inline void DecodeDxt3(const unsigned char* block, unsigned char* rgba, int stride, const DxtKernel* kernel) {
+    unsigned char alpha[16];
+    for (int i = 0; i < 16; i++) alpha[i] = (unsigned char)(((block[i / 2] >> (4 * (i & 1))) & 0x0F) * 17);
+    uint32_t palette[4];
+    kernel->palette(block + 8, true, false, palette);
+    kernel->write(palette, ReadU32(block + 12), alpha, rgba, stride);
+}
+
+static inline void DecodeDxt5(const unsigned char* block, unsigned char* rgba, int stride, const DxtKernel* kernel) {
+    unsigned char alpha[16];
+    kernel->alpha(block, alpha);
+    uint32_t palette[4];
+    kernel->palette(block + 8, true, false, palette);
+    kernel->write(palette, ReadU32(block + 12), alpha, rgba, stride);
+}
+
+void DecodeDxt1Block(const unsigned char* block, bool oneBitAlpha, unsigned char* rgba, int stride) {
+    DecodeDxt1(block, oneBitAlpha, rgba, stride, &simdKernel);
+}
+
+void DecodeDxt3Block(const unsigned char* block, unsigned char* rgba, int stride) {
+    DecodeDxt3(block, rgba, stride, &simdKernel);
+}
+
+void DecodeDxt5Block(const unsigned char* block, unsigned char* rgba, int stride) {
+    DecodeDxt5(block, rgba, stride, &simdKernel);
+}
+
+static inline void DecodeDxtBlocks(VtfFormat format, const unsigned char* blocks, int width, int height, unsigned char* rgba, const DxtKernel* kernel) {
+    if (!IsDxtFormat(format) || !blocks || !rgba || width <= 0 || height <= 0) return;
+    int blockBytes = format == VTF_FORMAT_DXT1 || format == VTF_FORMAT_DXT1_ONEBITALPHA ? 8 : 16;
+    int blocksWide = (width + 3) / 4;
+    int blocksHigh = (height + 3) / 4;
+    int stride = width * 4;
+    unsigned char tile[4 * 4 * 4];
+
+    for (int by = 0; by < blocksHigh; by++) {
+        for (int bx = 0; bx < blocksWide; bx++) {
+            const unsigned char* block = blocks + ((size_t)by * blocksWide + bx) * blockBytes;
+            int x = bx * 4, y = by * 4;
+            bool full = x + 4 <= width && y + 4 <= height;
+            unsigned char* out = full ? rgba + ((size_t)y * width + x) * 4 : tile;
+            int outStride = full ? stride : 16;
+
+            switch (format) {
+                case VTF_FORMAT_DXT1:             DecodeDxt1(block, false, out, outStride, kernel); break;
+                case VTF_FORMAT_DXT1_ONEBITALPHA: DecodeDxt1(block, true, out, outStride, kernel); break;
+                case VTF_FORMAT_DXT3:             DecodeDxt3(block, out, outStride, kernel); break;
+                default:                          DecodeDxt5(block, out, outStride, kernel); break;
+            }
+            if (!full) {
+                int columns = width - x < 4 ? width - x : 4;
+                int rows = height - y < 4 ? height - y : 4;
+                for (int row = 0; row < rows; row++) {
+                    memcpy(rgba + ((size_t)(y + row) * width + x) * 4, tile + row * 16, (size_t)columns * 4);
+                }
+            }
+        }
+    }
+}
+
+void DecodeDxtImage(VtfFormat format, const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+    DecodeDxtBlocks(format, blocks, width, height, rgba, &simdKernel);
+}
+
+void DecodeDxtImageScalar(VtfFormat format, const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+    DecodeDxtBlocks(format, blocks, width, height, rgba, &scalarKernel);
+}
+
+//----------------------------------------------------------------------------------
+// Uncompressed formats
+//----------------------------------------------------------------------------------
+
+static float HalfToFloat(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    float value;
+    if (exponent == 0) value = mantissa / 16777216.0f;                // 2^-24
+    else if (exponent == 31) value = mantissa ? 0.0f : 65504.0f;     // NaN to black, infinity to the max
+    else value = (1.0f + mantissa / 1024.0f) * (float)(1 << exponent) / 32768.0f;
+    return half & 0x8000 ? -value : value;
+}
+
+static unsigned char UnitToByte(float value) {
+    if (!(value > 0.0f)) return 0;
+    if (value >= 1.0f) return 255;
+    return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+// Byte offset of each channel within a pixel, -1 for opaque alpha
+typedef struct {
+    int r, g, b, a;
+} ChannelOrder;
+
+static void DecodePixels(VtfFormat format, const unsigned char* src, size_t count, unsigned char* rgba) {
+    int bytes = formatBytes[format];
+    ChannelOrder order = { 0, 1, 2, 3 };
+    switch (format) {
+        case VTF_FORMAT_ABGR8888:          order = (ChannelOrder){ 3, 2, 1, 0 }; break;
+        case VTF_FORMAT_RGB888:
+        case VTF_FORMAT_RGB888_BLUESCREEN: order = (ChannelOrder){ 0, 1, 2, -1 }; break;
+        case VTF_FORMAT_BGR888:
+        case VTF_FORMAT_BGR888_BLUESCREEN: order = (ChannelOrder){ 2, 1, 0, -1 }; break;
+        case VTF_FORMAT_ARGB8888:          order = (ChannelOrder){ 1, 2, 3, 0 }; break;
+        case VTF_FORMAT_BGRA8888:          order = (ChannelOrder){ 2, 1, 0, 3 }; break;
+        case VTF_FORMAT_BGRX8888:          order = (ChannelOrder){ 2, 1, 0, -1 }; break;
+        default: break;
+    }
+
+    for (size_t i = 0; i < count; i++, src += bytes, rgba += 4) {
+        uint16_t packed = bytes == 2 ? ReadU16(src) : 0;
+        switch (format) {
+            case VTF_FORMAT_I8:
+                rgba[0] = rgba[1] = rgba[2] = src[0];
+                rgba[3] = 255;
+                break;
+            case VTF_FORMAT_IA88:
+                rgba[0] = rgba[1] = rgba[2] = src[0];
+                rgba[3] = src[1];
+                break;
+            case VTF_FORMAT_A8:
+                rgba[0] = rgba[1] = rgba[2] = 0;
+                rgba[3] = src[0];
+                break;
+            case VTF_FORMAT_UV88:
+                rgba[0] = src[0];
+                rgba[1] = src[1];
+                rgba[2] = 0;
+                rgba[3] = 255;
+                break;
+            case VTF_FORMAT_RGB565:
+                // Red in the low bits, the reverse of BGR565
+                Expand565((uint16_t)(((packed & 0x1F) << 11) | (packed & 0x07E0) | (packed >> 11)), rgba);
+                rgba[3] = 255;
+                break;
+            case VTF_FORMAT_BGR565:
+                Expand565(packed, rgba);
+                rgba[3] = 255;
+                break;
+            case VTF_FORMAT_BGRX5551:
+            case VTF_FORMAT_BGRA5551: {
+                int b = packed & 0x1F, g = (packed >> 5) & 0x1F, r = (packed >> 10) & 0x1F;
+                rgba[0] = (unsigned char)((r << 3) | (r >> 2));
+                rgba[1] = (unsigned char)((g << 3) | (g >> 2));
+                rgba[2] = (unsigned char)((b << 3) | (b >> 2));
+                rgba[3] = format == VTF_FORMAT_BGRX5551 || (packed & 0x8000) ? 255 : 0;
+                break;
+            }
+            case VTF_FORMAT_BGRA4444:
+                rgba[0] = (unsigned char)(((packed >> 8) & 0x0F) * 17);
+                rgba[1] = (unsigned char)(((packed >> 4) & 0x0F) * 17);
+                rgba[2] = (unsigned char)((packed & 0x0F) * 17);
+                rgba[3] = (unsigned char)((packed >> 12) * 17);
+                break;
+            case VTF_FORMAT_RGBA16161616F:
+                for (int c = 0; c < 4; c++) rgba[c] = UnitToByte(HalfToFloat(ReadU16(src + 2 * c)));
+                break;
+            case VTF_FORMAT_RGBA16161616:
+                for (int c = 0; c < 4; c++) rgba[c] = src[2 * c + 1];
+                break;
+            default:
+                rgba[0] = src[order.r];
+                rgba[1] = src[order.g];
+                rgba[2] = src[order.b];
+                rgba[3] = order.a >= 0 ? src[order.a] : 255;
+                if ((format == VTF_FORMAT_RGB888_BLUESCREEN || format == VTF_FORMAT_BGR888_BLUESCREEN) &&
+                    rgba[0] == 0 && rgba[1] == 0 && rgba[2] == 255) {
+                    rgba[2] = rgba[3] = 0;
+                }
+                break;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Textures
+//----------------------------------------------------------------------------------
+
+size_t GetVtfImageSize(VtfFormat format, int width, int height) {
+    if (format < 0 || format >= VTF_FORMAT_COUNT || width <= 0 || height <= 0) return 0;
+    if (IsDxtFormat(format)) {
+        size_t blocks = (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4);
+        return blocks * (format == VTF_FORMAT_DXT1 || format == VTF_FORMAT_DXT1_ONEBITALPHA ? 8 : 16);
+    }
+    return (size_t)width * height * formatBytes[format];
+}
+
+void GetVtfMipSize(const VtfTexture* vtf, int mip, int* width, int* height) {
+    int w = vtf->width >> mip, h = vtf->height >> mip;
+    if (width) *width = w > 0 ? w : 1;
+    if (height) *height = h > 0 ? h : 1;
+}
+
+static int GetVtfMipDepth(const VtfTexture* vtf, int mip) {
+    int depth = vtf->depth >> mip;
+    return depth > 0 ? depth : 1;
+}
+
+// Every frame, face and slice of one mip
+static size_t GetVtfMipBytes(const VtfTexture* vtf, int mip) {
+    int width, height;
+    GetVtfMipSize(vtf, mip, &width, &height);
+    return GetVtfImageSize(vtf->format, width, height) * vtf->frameCount * vtf->faceCount * GetVtfMipDepth(vtf, mip);
+}
+
+int FindVtfMip(const VtfTexture* vtf, int maxSize) {
+    if (!vtf || vtf->mipCount <= 0) return 0;
+    for (int mip = 0; mip < vtf->mipCount; mip++) {
+        int width, height;
+        GetVtfMipSize(vtf, mip, &width, &height);
+        if (width <= maxSize && height <= maxSize) return mip;
+    }
+    return vtf->mipCount - 1;
+}
+
+bool ParseVtf(const unsigned char* data, size_t size, VtfTexture* vtf) {
+    if (!data || !vtf || size < VTF_HEADER_MIN_SIZE) return false;
+    memset(vtf, 0, sizeof(*vtf));
+    if (ReadU32(data) != VTF_SIGNATURE || ReadU32(data + 4) != 7) return false;
+
+    uint32_t version = ReadU32(data + 8);
+    uint32_t headerSize = ReadU32(data + 12);
+    if (version > 5 || headerSize < VTF_HEADER_MIN_SIZE || headerSize > size) return false;
+
+    vtf->version = (int)version;
+    vtf->width = ReadU16(data + 16);
+    vtf->height = ReadU16(data + 18);
+    vtf->flags = ReadU32(data + 20);
+    vtf->frameCount = ReadU16(data + 24);
+    uint16_t firstFrame = ReadU16(data + 26);
+    int32_t format = (int32_t)ReadU32(data + 52);
+    vtf->mipCount = data[56];
+    int32_t lowResFormat = (int32_t)ReadU32(data + 57);
+    int lowResWidth = data[61], lowResHeight = data[62];
+    vtf->depth = version >= 2 && headerSize >= 65 ? ReadU16(data + 63) : 1;
+    if (vtf->depth == 0) vtf->depth = 1;
+    if (vtf->frameCount == 0) vtf->frameCount = 1;
+
+    if (vtf->width == 0 || vtf->width > VTF_MAX_SIZE || vtf->height == 0 || vtf->height > VTF_MAX_SIZE) return false;
+    if (vtf->mipCount == 0 || vtf->mipCount > VTF_MAX_MIPS) return false;
+    if (format < 0 || format >= VTF_FORMAT_COUNT || format == VTF_FORMAT_P8) return false;
+    vtf->format = (VtfFormat)format;
+
+    // Before 7.5 a cube map may carry a seventh, spherical face
+    if (vtf->flags & VTF_FLAG_ENVMAP) vtf->faceCount = version < 5 && firstFrame != 0xFFFF ? 7 : 6;
+    else vtf->faceCount = 1;
+
+    size_t offset = 0;
+    if (version >= 3) {
+        uint32_t resources = headerSize >= VTF_RESOURCES_OFFSET ? ReadU32(data + 68) : 0;
+        if (resources > (headerSize - VTF_RESOURCES_OFFSET) / VTF_RESOURCE_SIZE) return false;
+        bool found = false;
+        for (uint32_t i = 0; i < resources && !found; i++) {
+            const unsigned char* resource = data + VTF_RESOURCES_OFFSET + i * VTF_RESOURCE_SIZE;
+            if (resource[0] == VTF_RESOURCE_HIGH_RES && resource[1] == 0 && resource[2] == 0 &&
+                !(resource[3] & VTF_RESOURCE_NO_DATA)) {
+                offset = ReadU32(resource + 4);
+                found = true;
+            }
+        }
+        if (!found) return false;
+    } else {
+        // The low-res image sits between the header and the mips
+        offset = headerSize;
+        if (lowResFormat >= 0 && lowResFormat < VTF_FORMAT_COUNT) {
+            offset += GetVtfImageSize((VtfFormat)lowResFormat, lowResWidth, lowResHeight);
+        }
+    }
+    if (offset > size) return false;
+
+    // Checked by division, a crafted header could overflow the product
+    size_t available = size - offset, total = 0;
+    for (int mip = 0; mip < vtf->mipCount; mip++) {
+        int width, height;
+        GetVtfMipSize(vtf, mip, &width, &height);
+        size_t imageBytes = GetVtfImageSize(vtf->format, width, height);
+        uint64_t images = (uint64_t)vtf->frameCount * vtf->faceCount * GetVtfMipDepth(vtf, mip);
+        if (images > (available - total) / imageBytes) return false;
+        total += imageBytes * (size_t)images;
+    }
+    vtf->imageData = data + offset;
+    vtf->imageSize = total;
+    return true;
+}
+
+bool DecodeVtf(const VtfTexture* vtf, int mip, int frame, int face, int slice, unsigned char* rgba) {
+    if (!vtf || !vtf->imageData || !rgba) return false;
+    if (mip < 0 || mip >= vtf->mipCount || frame < 0 || frame >= vtf->frameCount ||
+        face < 0 || face >= vtf->faceCount || slice < 0 || slice >= GetVtfMipDepth(vtf, mip)) {
+        return false;
+    }
+
+    // Smallest mip first; within a mip, frame by face by slice
+    size_t offset = 0;
+    for (int m = vtf->mipCount - 1; m > mip; m--) offset += GetVtfMipBytes(vtf, m);
+    int width, height;
+    GetVtfMipSize(vtf, mip, &width, &height);
+    size_t imageBytes = GetVtfImageSize(vtf->format, width, height);
+    offset += (((size_t)frame * vtf->faceCount + face) * GetVtfMipDepth(vtf, mip) + slice) * imageBytes;
+    const unsigned char* src = vtf->imageData + offset;
+
+    if (IsDxtFormat(vtf->format)) {
+        VtfFormat format = vtf->format;
+        if (format == VTF_FORMAT_DXT1 && (vtf->flags & VTF_FLAG_ONEBITALPHA)) format = VTF_FORMAT_DXT1_ONEBITALPHA;
+        DecodeDxtImage(format, src, width, height, rgba);
+    } else {
+        DecodePixels(vtf->format, src, (size_t)width * height, rgba);
+    }
+    return true;
+}
+
+Image LoadVtfImage(const unsigned char* data, size_t size, int maxSize) {
+    Image image = { 0 };
+    VtfTexture vtf;
+    if (!ParseVtf(data, size, &vtf)) return image;
+
+    int mip = maxSize > 0 ? FindVtfMip(&vtf, maxSize) : 0;
+    int width, height;
+    GetVtfMipSize(&vtf, mip, &width, &height);
+    size_t bytes = (size_t)width * height * 4;
+    if (bytes > UINT_MAX) return image;
+    unsigned char* pixels = MemAlloc((unsigned int)bytes);
+    if (!pixels) return image;
+    if (!DecodeVtf(&vtf, mip, 0, 0, 0, pixels)) {
+        MemFree(pixels);
+        return image;
+    }
+    image.data = pixels;
+    image.width = width;
+    image.height = height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return image;
+}
+
+//----------------------------------------------------------------------------------
+// Batches
+//----------------------------------------------------------------------------------
+
+typedef struct {
+    VtfBatchItem* items;
+    int count;
+    atomic_int next;
+} VtfBatch;
+
+static void RunVtfBatch(VtfBatch* batch) {
+    for (int i = atomic_fetch_add(&batch->next, 1); i < batch->count; i = atomic_fetch_add(&batch->next, 1)) {
+        VtfBatchItem* item = &batch->items[i];
+        item->image = LoadVtfImage(item->data, item->size, item->maxSize);
+    }
+}
+
+static void VtfBatchJob(void* data) {
+    RunVtfBatch(data);
+}
+
+void LoadVtfBatch(JobSystem* jobs, VtfBatchItem* items, int count) {
+    if (!items || count <= 0) return;
+    VtfBatch batch = { items, count, 0 };
+
+    // Items are handed out one at a time, so a few large textures do not
+    // leave the other workers idle. Someone is waiting, hence interactive.
+    JobHandle helpers[JOB_SYSTEM_MAX_WORKERS];
+    int helperCount = GetJobWorkerCount(jobs);
+    if (helperCount > count - 1) helperCount = count - 1;
+    for (int i = 0; i < helperCount; i++) {
+        helpers[i] = ScheduleJob(jobs, (JobDesc){ VtfBatchJob, NULL, &batch, JOB_PRIORITY_INTERACTIVE }, NULL, 0);
+    }
+    RunVtfBatch(&batch);
+    for (int i = 0; i < helperCount; i++) WaitForJob(jobs, helpers[i]);
+}
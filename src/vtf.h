@@ -0,0 +1,108 @@
+#ifndef VTF_H
+#define VTF_H
+
+#include "raylib.h"
+#include "job_system.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Valve texture (.vtf) reader, versions 7.0 to 7.5.
+//
+// Works over a file already in memory (a mapping or a VPK view). Mips are
+// stored smallest first, so decoding a small level for a thumbnail touches a
+// few kilobytes near the start of the image data and never the full-size
+// image. DXT blocks decode with SSE2 (palettes, DXT5 alpha and the pixel
+// writes) or NEON (the pixel writes) when the target has it.
+
+#define VTF_SIGNATURE 0x00465456u       // "VTF\0"
+#define VTF_MAX_MIPS 16
+#define VTF_MAX_SIZE 32768
+
+#define VTF_FLAG_ONEBITALPHA 0x1000u
+#define VTF_FLAG_ENVMAP 0x4000u
+
+typedef enum {
+    VTF_FORMAT_RGBA8888 = 0,
+    VTF_FORMAT_ABGR8888,
+    VTF_FORMAT_RGB888,
+    VTF_FORMAT_BGR888,
+    VTF_FORMAT_RGB565,
+    VTF_FORMAT_I8,
+    VTF_FORMAT_IA88,
+    VTF_FORMAT_P8,                      // Palette is not stored in the file, unsupported
+    VTF_FORMAT_A8,
+    VTF_FORMAT_RGB888_BLUESCREEN,
+    VTF_FORMAT_BGR888_BLUESCREEN,
+    VTF_FORMAT_ARGB8888,
+    VTF_FORMAT_BGRA8888,
+    VTF_FORMAT_DXT1,
+    VTF_FORMAT_DXT3,
+    VTF_FORMAT_DXT5,
+    VTF_FORMAT_BGRX8888,
+    VTF_FORMAT_BGR565,
+    VTF_FORMAT_BGRX5551,
+    VTF_FORMAT_BGRA4444,
+    VTF_FORMAT_DXT1_ONEBITALPHA,
+    VTF_FORMAT_BGRA5551,
+    VTF_FORMAT_UV88,
+    VTF_FORMAT_UVWQ8888,
+    VTF_FORMAT_RGBA16161616F,           // Clamped to 0..1
+    VTF_FORMAT_RGBA16161616,
+    VTF_FORMAT_UVLX8888,
+    VTF_FORMAT_COUNT
+} VtfFormat;
+
+typedef struct {
+    int version;                        // Minor version, 0 to 5
+    int width;
+    int height;
+    int depth;
+    int mipCount;
+    int frameCount;
+    int faceCount;                      // 6 or 7 for cube maps, 1 otherwise
+    VtfFormat format;
+    uint32_t flags;
+    const unsigned char* imageData;     // Every mip, frame, face and slice, smallest mip first
+    size_t imageSize;
+} VtfTexture;
+
+// Reads the header. False for anything that is not a VTF, an unsupported
+// format, or image data running past the end of the file.
+bool ParseVtf(const unsigned char* data, size_t size, VtfTexture* vtf);
+
+size_t GetVtfImageSize(VtfFormat format, int width, int height);   // Bytes of one 2D image
+void GetVtfMipSize(const VtfTexture* vtf, int mip, int* width, int* height);
+// Largest mip whose longest side is at most maxSize, or the smallest mip there is
+int FindVtfMip(const VtfTexture* vtf, int maxSize);
+
+// Decodes one image to RGBA8, width * height * 4 bytes of the mip
+bool DecodeVtf(const VtfTexture* vtf, int mip, int frame, int face, int slice, unsigned char* rgba);
+
+// First frame and face at the mip FindVtfMip picks (0 for the full size).
+// Returns an RGBA8 image to free with UnloadImage, or an empty one on failure.
+Image LoadVtfImage(const unsigned char* data, size_t size, int maxSize);
+
+// Loads many textures on the job system's workers and the calling thread,
+// returning once all are done; with no job system, only on the calling
+// thread. Each item gets its image, empty when it failed.
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    int maxSize;
+    Image image;
+} VtfBatchItem;
+
+void LoadVtfBatch(JobSystem* jobs, VtfBatchItem* items, int count);
+
+// Kernels, exposed for benchmarking. Write a 4x4 block of RGBA8 pixels,
+// stride bytes apart per row; buffers need no particular alignment.
+void DecodeDxt1Block(const unsigned char* block, bool oneBitAlpha, unsigned char* rgba, int stride);
+void DecodeDxt3Block(const unsigned char* block, unsigned char* rgba, int stride);
+void DecodeDxt5Block(const unsigned char* block, unsigned char* rgba, int stride);
+// A whole DXT image; partial blocks at the right and bottom edges are cropped
+void DecodeDxtImage(VtfFormat format, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+// The same through the plain C kernel whatever the target, to check the SIMD one against
+void DecodeDxtImageScalar(VtfFormat format, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+
+#endif // VTF_H
@@ -0,0 +1,74 @@
+#include "wav_file.h"
+#include <string.h>
+
+static uint16_t ReadU16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+float ReadWavSample(const unsigned char* p, WavSampleFormat format) {
+    switch (format) {
+        case WAV_SAMPLE_U8:  return ((int)p[0] - 128) / 128.0f;
+        case WAV_SAMPLE_S16: return (int16_t)ReadU16(p) / 32768.0f;
+        case WAV_SAMPLE_S24: return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) / 2147483648.0f;
+        case WAV_SAMPLE_S32: return (int32_t)ReadU32(p) / 2147483648.0f;
+        case WAV_SAMPLE_F32: {
+            float value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    }
+    return 0.0f;
+}
+
+void ReadWavFrame(const WavData* wav, uint64_t frame, float* left, float* right) {
+    const unsigned char* p = wav->data + frame * (uint64_t)(wav->bytesPerSample * wav->channels);
+    *left = ReadWavSample(p, wav->format);
+    *right = wav->channels > 1 ? ReadWavSample(p + wav->bytesPerSample, wav->format) : *left;
+}
+
+bool ParseWav(const unsigned char* data, size_t size, WavData* wav) {
+    if (!data || !wav) return false;
+    memset(wav, 0, sizeof(*wav));
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+    int format = 0, bits = 0, blockAlign = 0;
+    const unsigned char* samples = NULL;
+    uint64_t sampleBytes = 0;
+    for (size_t offset = 12; offset + 8 <= size;) {
+        const unsigned char* chunk = data + offset;
+        uint64_t chunkSize = ReadU32(chunk + 4);
+        uint64_t available = size - offset - 8;
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && chunkSize <= available) {
+            format = ReadU16(chunk + 8);
+            wav->channels = ReadU16(chunk + 10);
+            wav->sampleRate = (int)ReadU32(chunk + 12);
+            blockAlign = ReadU16(chunk + 20);
+            bits = ReadU16(chunk + 22);
+            if (format == 0xFFFE && chunkSize >= 26) format = ReadU16(chunk + 32);     // WAVE_FORMAT_EXTENSIBLE subformat
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            // Recorders that crashed leave the size at zero or past the end of the file
+            samples = chunk + 8;
+            sampleBytes = (chunkSize == 0 || chunkSize > available) ? available : chunkSize;
+            if (chunkSize == 0) break;
+        }
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+    if (!samples || wav->channels <= 0 || wav->sampleRate <= 0) return false;
+
+    if (format == 1 && bits == 8) wav->format = WAV_SAMPLE_U8;
+    else if (format == 1 && bits == 16) wav->format = WAV_SAMPLE_S16;
+    else if (format == 1 && bits == 24) wav->format = WAV_SAMPLE_S24;
+    else if (format == 1 && bits == 32) wav->format = WAV_SAMPLE_S32;
+    else if (format == 3 && bits == 32) wav->format = WAV_SAMPLE_F32;
+    else return false;
+
+    wav->bytesPerSample = bits / 8;
+    if (blockAlign != wav->bytesPerSample * wav->channels) return false;
+    wav->data = samples;
+    wav->frames = sampleBytes / (uint64_t)blockAlign;
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef WAV_FILE_H
+#define WAV_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// RIFF/WAVE reader over a file already in memory (usually a mapping).
+// Samples are decoded where they lie, so long takes are never copied.
+
+typedef enum {
+    WAV_SAMPLE_U8,
+    WAV_SAMPLE_S16,
+    WAV_SAMPLE_S24,
+    WAV_SAMPLE_S32,
+    WAV_SAMPLE_F32
+} WavSampleFormat;
+
+typedef struct {
+    const unsigned char* data;      // First frame of the data chunk
+    uint64_t frames;
+    int channels;
+    int sampleRate;
+    WavSampleFormat format;
+    int bytesPerSample;
+} WavData;
+
+// Integer or float PCM, including WAVE_FORMAT_EXTENSIBLE. False for anything else.
+bool ParseWav(const unsigned char* data, size_t size, WavData* wav);
+
+float ReadWavSample(const unsigned char* p, WavSampleFormat format);
+
+// One frame as stereo; mono is copied to both sides, channels past the second are dropped
+void ReadWavFrame(const WavData* wav, uint64_t frame, float* left, float* right);
+
+#endif // WAV_FILE_H